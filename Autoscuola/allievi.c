@@ -14,9 +14,16 @@
 #include "pagamenti.h"  // Solo per inizializzaPagamento
 #include "esami.h"      // Solo per inizializzaEsame
 #include "util.h"
+#include "indice.h"
+#include "modifiche.h"
+#include "codifica.h"
+#include "formato.h"
 
 //DEFINIZIONI STRUTTURE (PRIVATE)
 #define MAX_ALLIEVI 100
+#define TABELLA_ALLIEVI 'A' /**< Identificativo della tabella nel formato codificato */
+#define MAX_ALLIEVO_CODIFICATO (sizeof(Allievo) + 2 * CODIFICA_MAX_VARINT)
+#define DIM_RIGA_ALLIEVO (sizeof(Allievo) + FORMATO_MAX_INTERO + 64) /**< Riga di stampaAllievi */
 
 /**
  * @struct Allievo
@@ -38,9 +45,155 @@ struct Allievo {
 struct ListaAllievi {
     Allievo elenco[MAX_ALLIEVI];
     int n_allievi;
+    IndiceID indice_id; /**< Posizione dei record per ID allievo */
+    RegistroModifiche modifiche; /**< Generazioni di modifica per record e blocco */
     int id_corrente;
 };
 
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Ricostruisce l'indice per ID a partire dall'elenco corrente.
+ */
+static void ricostruisciIndiceAllievi(ListaAllievi* lista) {
+    svuotaIndice(&lista->indice_id);
+    for (int i = 0; i < lista->n_allievi; i++) {
+        inserisciInIndice(&lista->indice_id, lista->elenco[i].id, i);
+    }
+}
+
+/**
+ * @brief Valori ricorrenti codificati con un solo byte (0 = stringa esplicita).
+ */
+static const char* const CATEGORIE_NOTE[] = { "A", "B", "AM" };
+static const char* const STATI_NOTI[] = { "iscritto", "sospeso" };
+
+/**
+ * @brief Codifica un campo con pochi valori ricorrenti: un byte, piu' la stringa se non e' tra i noti.
+ */
+static bool codificaValoreNoto(Buffer* buf, const char* valore, size_t capacita,
+                               const char* const noti[], int n_noti) {
+    for (int i = 0; i < n_noti; i++) {
+        if (strncmp(valore, noti[i], capacita) == 0) {
+            return scriviByte(buf, (unsigned char)(i + 1));
+        }
+    }
+    return scriviByte(buf, 0) && scriviStringa(buf, valore, capacita);
+}
+
+/**
+ * @brief Decodifica un campo scritto da codificaValoreNoto().
+ */
+static bool decodificaValoreNoto(Lettore* lettore, char* valore, size_t capacita,
+                                 const char* const noti[], int n_noti) {
+    unsigned char codice = leggiByte(lettore);
+    if (codice == 0) {
+        return leggiStringa(lettore, valore, capacita);
+    }
+    if (codice > n_noti) {
+        return false;
+    }
+    memset(valore, 0, capacita);
+    strcpy(valore, noti[codice - 1]);
+    return !lettore->errore;
+}
+
+/**
+ * @brief Codifica un allievo: ID come differenza dal precedente, stringhe con prefisso di lunghezza.
+ */
+static bool codificaAllievo(const Allievo* a, int id_precedente, Buffer* buf) {
+    return scriviVarintConSegno(buf, (int64_t)a->id - id_precedente) &&
+           scriviStringa(buf, a->nome, sizeof(a->nome)) &&
+           scriviStringa(buf, a->cognome, sizeof(a->cognome)) &&
+           scriviStringa(buf, a->codice_fiscale, sizeof(a->codice_fiscale)) &&
+           codificaValoreNoto(buf, a->categoria_patente, sizeof(a->categoria_patente), CATEGORIE_NOTE, 3) &&
+           codificaValoreNoto(buf, a->stato, sizeof(a->stato), STATI_NOTI, 2);
+}
+
+/**
+ * @brief Legge una tabella nel formato codificato.
+ * @return Numero di allievi letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaCodificata(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza) {
+    Lettore lettore;
+    inizializzaLettore(&lettore, dati, lunghezza);
+    if (!leggiIntestazioneCodifica(&lettore, TABELLA_ALLIEVI)) return -1;
+
+    uint64_t n = leggiVarint(&lettore);
+    int id_corrente = (int)leggiVarintConSegno(&lettore);
+    if (lettore.errore || n > MAX_ALLIEVI) return -1;
+
+    int id = 0;
+    for (int i = 0; i < (int)n; i++) {
+        Allievo* a = &lista->elenco[i];
+        id += (int)leggiVarintConSegno(&lettore);
+        a->id = id;
+        if (!leggiStringa(&lettore, a->nome, sizeof(a->nome)) ||
+            !leggiStringa(&lettore, a->cognome, sizeof(a->cognome)) ||
+            !leggiStringa(&lettore, a->codice_fiscale, sizeof(a->codice_fiscale)) ||
+            !decodificaValoreNoto(&lettore, a->categoria_patente, sizeof(a->categoria_patente), CATEGORIE_NOTE, 3) ||
+            !decodificaValoreNoto(&lettore, a->stato, sizeof(a->stato), STATI_NOTI, 2)) {
+            lista->n_allievi = 0;
+            return -1;
+        }
+    }
+
+    lista->n_allievi = (int)n;
+    lista->id_corrente = id_corrente;
+    return (int)n;
+}
+
+/**
+ * @brief Legge una tabella nel formato precedente (array di struct grezze).
+ * @return Numero di allievi letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaGrezza(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza) {
+    const size_t intestazione = 2 * sizeof(int);
+    if (lunghezza < intestazione) return -1;
+
+    int n, id_corrente;
+    memcpy(&n, dati, sizeof(int));
+    memcpy(&id_corrente, dati + sizeof(int), sizeof(int));
+
+    if (n < 0 || n > MAX_ALLIEVI) return -1;
+    if (lunghezza < intestazione + sizeof(Allievo) * n) return -1;
+
+    memcpy(lista->elenco, dati + intestazione, sizeof(Allievo) * n);
+    lista->n_allievi = n;
+    lista->id_corrente = id_corrente;
+    return n;
+}
+
+/**
+ * @brief Copia una stringa in un campo a dimensione fissa.
+ * @return false se la stringa non entra nel campo.
+ */
+static bool copiaCampo(char* campo, size_t dimensione, const char* valore) {
+    size_t lunghezza = strlen(valore);
+    if (lunghezza >= dimensione) return false;
+    memcpy(campo, valore, lunghezza + 1);
+    return true;
+}
+
+/**
+ * @brief Completa e accoda un nuovo allievo (ID, stato iniziale, categoria in maiuscolo).
+ * @return ID assegnato.
+ */
+static int accodaAllievo(ListaAllievi* lista, Allievo* nuovo) {
+    // Converti in maiuscolo
+    for (int i = 0; nuovo->categoria_patente[i]; i++)
+        nuovo->categoria_patente[i] = toupper(nuovo->categoria_patente[i]);
+
+    nuovo->id = lista->id_corrente++;
+    strcpy(nuovo->stato, "iscritto");
+
+    inserisciInIndice(&lista->indice_id, nuovo->id, lista->n_allievi);
+    segnaModifica(&lista->modifiche, lista->n_allievi);
+    lista->elenco[lista->n_allievi++] = *nuovo;
+
+    return nuovo->id;
+}
+
 //FUNZIONI DI CREAZIONE/DISTRUZIONE
 
 ListaAllievi* creaListaAllievi(void) {
@@ -48,12 +201,19 @@ ListaAllievi* creaListaAllievi(void) {
     if (lista != NULL) {
         lista->n_allievi = 0;
         lista->id_corrente = 1;
+        svuotaIndice(&lista->indice_id);
+        if (!inizializzaRegistroModifiche(&lista->modifiche, lista->elenco,
+                                          sizeof(Allievo), MAX_ALLIEVI)) {
+            free(lista);
+            return NULL;
+        }
     }
     return lista;
 }
 
 void distruggiListaAllievi(ListaAllievi** lista) {
     if (lista != NULL && *lista != NULL) {
+        liberaRegistroModifiche(&(*lista)->modifiche);
         free(*lista);
         *lista = NULL;
     }
@@ -63,6 +223,8 @@ void inizializzaLista(ListaAllievi* lista) {
     if (lista == NULL) return;
     lista->n_allievi = 0;
     lista->id_corrente = 1;
+    svuotaIndice(&lista->indice_id);
+    segnaModificaStruttura(&lista->modifiche);
 }
 
 //FUNZIONI DI ACCESSO (GETTER)
@@ -108,6 +270,7 @@ bool setAllievoStato(Allievo* allievo, const char* nuovo_stato) {
     if (allievo == NULL || nuovo_stato == NULL) return false;
     strncpy(allievo->stato, nuovo_stato, sizeof(allievo->stato) - 1);
     allievo->stato[sizeof(allievo->stato) - 1] = '\0';
+    segnaModificaRecord(allievo);
     return true;
 }
 
@@ -151,12 +314,8 @@ Allievo* cercaAllievoPerNome(ListaAllievi* lista, const char* nome, const char*
 Allievo* cercaAllievoPerID(ListaAllievi* lista, int id) {
     if (lista == NULL || id <= 0) return NULL;
 
-    for (int i = 0; i < lista->n_allievi; i++) {
-        if (lista->elenco[i].id == id) {
-            return &lista->elenco[i];
-        }
-    }
-    return NULL;
+    int pos = cercaInIndice(&lista->indice_id, id);
+    return (pos >= 0) ? &lista->elenco[pos] : NULL;
 }
 
 int inserisciAllievoBase(ListaAllievi* lista) {
@@ -178,16 +337,28 @@ int inserisciAllievoBase(ListaAllievi* lista) {
         inputString(nuovo.categoria_patente, 5);
     } while (!validaCategoria(nuovo.categoria_patente));
 
-    // Converti in maiuscolo
-    for (int i = 0; nuovo.categoria_patente[i]; i++)
-        nuovo.categoria_patente[i] = toupper(nuovo.categoria_patente[i]);
+    return accodaAllievo(lista, &nuovo);
+}
 
-    nuovo.id = lista->id_corrente++;
-    strcpy(nuovo.stato, "iscritto");
+int aggiungiAllievo(ListaAllievi* lista, const char* nome, const char* cognome,
+                    const char* codice_fiscale, const char* categoria) {
+    if (lista == NULL || nome == NULL || cognome == NULL ||
+        codice_fiscale == NULL || categoria == NULL) {
+        return -1;
+    }
+    if (lista->n_allievi >= MAX_ALLIEVI) return -1;
 
-    lista->elenco[lista->n_allievi++] = nuovo;
+    Allievo nuovo;
+    memset(&nuovo, 0, sizeof(nuovo));
+    if (!copiaCampo(nuovo.nome, sizeof(nuovo.nome), nome) ||
+        !copiaCampo(nuovo.cognome, sizeof(nuovo.cognome), cognome) ||
+        !copiaCampo(nuovo.codice_fiscale, sizeof(nuovo.codice_fiscale), codice_fiscale) ||
+        !copiaCampo(nuovo.categoria_patente, sizeof(nuovo.categoria_patente), categoria) ||
+        !validaCategoria(nuovo.categoria_patente)) {
+        return -1;
+    }
 
-    return nuovo.id;
+    return accodaAllievo(lista, &nuovo);
 }
 
 void inserisciAllievo(ListaAllievi* lista, void* listaP, void* listaE) {
@@ -222,6 +393,7 @@ void inserisciAllievo(ListaAllievi* lista, void* listaP, void* listaE) {
 void ordinaAllieviAlfabetico(ListaAllievi* lista) {
     if (lista == NULL || lista->n_allievi <= 1) return;
 
+    bool scambiati = false;
     for (int i = 0; i < lista->n_allievi - 1; i++) {
         for (int j = i + 1; j < lista->n_allievi; j++) {
             Allievo* a = &lista->elenco[i];
@@ -231,23 +403,54 @@ void ordinaAllieviAlfabetico(ListaAllievi* lista) {
                 Allievo temp = *a;
                 *a = *b;
                 *b = temp;
+                segnaModifica(&lista->modifiche, i);
+                segnaModifica(&lista->modifiche, j);
+                scambiati = true;
             }
         }
     }
+
+    // Se le posizioni sono cambiate l'indice per ID va ricostruito
+    // (una lista gia' ordinata mantiene l'indice caricato da file)
+    if (scambiati) {
+        ricostruisciIndiceAllievi(lista);
+    }
 }
 
-void stampaAllievi(const ListaAllievi* lista) {
+void stampaAllievi(const ListaAllievi* lista, Uscita* uscita) {
     if (lista == NULL) {
         printf("Lista non valida.\n");
         return;
     }
 
-    printf("\n--- Elenco Allievi ---\n");
-    for (int i = 0; i < lista->n_allievi; i++) {
+    Uscita* terminale = NULL;
+    if (uscita == NULL) uscita = terminale = creaUscitaStandard();
+    if (uscita == NULL) return;
+
+    scriviTestoUscita(uscita, "\n--- Elenco Allievi ---\n");
+    for (int i = 0; i < lista->n_allievi && !uscitaInterrotta(uscita); i++) {
         const Allievo* a = &lista->elenco[i];
-        printf("ID: %d | %s %s | CF: %s | Patente: %s | Stato: %s\n",
-               a->id, a->nome, a->cognome, a->codice_fiscale, a->categoria_patente, a->stato);
+        char* riga = riservaUscita(uscita, DIM_RIGA_ALLIEVO);
+        if (riga == NULL) break;
+
+        char* r = riga;
+        r += formattaTesto(r, "ID: ");
+        r += formattaIntero(r, a->id);
+        r += formattaTesto(r, " | ");
+        r += formattaTesto(r, a->nome);
+        *r++ = ' ';
+        r += formattaTesto(r, a->cognome);
+        r += formattaTesto(r, " | CF: ");
+        r += formattaTesto(r, a->codice_fiscale);
+        r += formattaTesto(r, " | Patente: ");
+        r += formattaTesto(r, a->categoria_patente);
+        r += formattaTesto(r, " | Stato: ");
+        r += formattaTesto(r, a->stato);
+        *r++ = '\n';
+        avanzaUscita(uscita, (size_t)(r - riga));
     }
+
+    if (terminale != NULL) chiudiUscita(&terminale);
 }
 
 void filtraPerPatente(const ListaAllievi* lista) {
@@ -334,9 +537,18 @@ void cercaAllievo(const ListaAllievi* listaA, const void* listaP, const void* li
         const ListaPagamenti* pagamenti = (const ListaPagamenti*)listaP;
         Pagamento* p = cercaPagamentoPerID(pagamenti, id);
         if (p != NULL) {
-            printf("\n--- PAGAMENTI ---\n");
-            printf("Prima: %.2f\nSeconda: %.2f\nTerza: %.2f\nExtra: %.2f\n",
-                   getPrimaRata(p), getSecondaRata(p), getTerzaRata(p), getExtra(p));
+            char riga[64 + 4 * FORMATO_MAX_IMPORTO];
+            char* r = riga;
+            r += formattaTesto(r, "\n--- PAGAMENTI ---\nPrima: ");
+            r += formattaImporto(r, getPrimaRata(p));
+            r += formattaTesto(r, "\nSeconda: ");
+            r += formattaImporto(r, getSecondaRata(p));
+            r += formattaTesto(r, "\nTerza: ");
+            r += formattaImporto(r, getTerzaRata(p));
+            r += formattaTesto(r, "\nExtra: ");
+            r += formattaImporto(r, getExtra(p));
+            *r++ = '\n';
+            fwrite(riga, 1, (size_t)(r - riga), stdout);
         }
     }
 
@@ -355,41 +567,96 @@ void cercaAllievo(const ListaAllievi* listaA, const void* listaP, const void* li
 
 //FUNZIONI I/O FILE
 
-bool salvaAllievi(const ListaAllievi* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+int copiaModificheAllievi(ListaAllievi* copia, const ListaAllievi* originale, unsigned long generazione) {
+    if (copia == NULL || originale == NULL) return -1;
 
-    FILE* file = fopen(filename, "wb");
-    if (file == NULL) {
-        printf("Errore: impossibile aprire il file %s per la scrittura.\n", filename);
-        return false;
+    int copiati = copiaBlocchiModificati(&originale->modifiche, &copia->modifiche,
+                                         copia->elenco, originale->n_allievi, generazione);
+    copia->n_allievi = originale->n_allievi;
+    if (originale->modifiche.generazione > generazione) {
+        copia->indice_id = originale->indice_id;
     }
+    copia->id_corrente = originale->id_corrente;
+    return copiati;
+}
 
-    // Salva numero allievi e ID corrente
-    fwrite(&lista->n_allievi, sizeof(int), 1, file);
-    fwrite(&lista->id_corrente, sizeof(int), 1, file);
+const RegistroModifiche* getRegistroModificheAllievi(const ListaAllievi* lista) {
+    return (lista != NULL) ? &lista->modifiche : NULL;
+}
 
-    // Salva array allievi
-    fwrite(lista->elenco, sizeof(Allievo), lista->n_allievi, file);
+bool serializzaIntestazioneGrezzaAllievi(const ListaAllievi* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    fclose(file);
-    return true;
+    bool ok = scriviBuffer(buf, &lista->n_allievi, sizeof(int));
+    ok &= scriviBuffer(buf, &lista->id_corrente, sizeof(int));
+    return ok;
 }
 
-bool caricaAllievi(ListaAllievi* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+bool serializzaAllievi(const ListaAllievi* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        return false; // File non esiste, non  un errore
+    // Stima per eccesso: una sola riallocazione per l'intera tabella
+    riservaBuffer(buf, buf->lunghezza + CODIFICA_DIM_INTESTAZIONE + 2 * CODIFICA_MAX_VARINT +
+                       (size_t)lista->n_allievi * MAX_ALLIEVO_CODIFICATO);
+
+    // Intestazione: numero allievi e ID corrente
+    bool ok = scriviIntestazioneCodifica(buf, TABELLA_ALLIEVI);
+    ok &= scriviVarint(buf, (uint64_t)lista->n_allievi);
+    ok &= scriviVarintConSegno(buf, lista->id_corrente);
+
+    // Record codificati
+    int id_precedente = 0;
+    for (int i = 0; i < lista->n_allievi && ok; i++) {
+        ok = codificaAllievo(&lista->elenco[i], id_precedente, buf);
+        id_precedente = lista->elenco[i].id;
     }
+    return ok;
+}
+
+bool serializzaIndiceAllievi(const ListaAllievi* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+    return scriviBuffer(buf, &lista->indice_id, sizeof(IndiceID));
+}
+
+bool deserializzaAllievi(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza) {
+    return deserializzaAllieviConIndice(lista, dati, lunghezza, NULL, 0);
+}
 
-    // Carica numero allievi e ID corrente
-    fread(&lista->n_allievi, sizeof(int), 1, file);
-    fread(&lista->id_corrente, sizeof(int), 1, file);
+bool deserializzaAllieviConIndice(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza,
+                                  const unsigned char* indice, size_t lunghezza_indice) {
+    if (lista == NULL || dati == NULL) return false;
 
-    // Carica array allievi
-    fread(lista->elenco, sizeof(Allievo), lista->n_allievi, file);
+    int n = isTabellaCodificata(dati, lunghezza) ?
+            leggiTabellaCodificata(lista, dati, lunghezza) :
+            leggiTabellaGrezza(lista, dati, lunghezza);
+    if (n < 0) return false;
 
-    fclose(file);
+    segnaModificaTotale(&lista->modifiche, n);
+    // L'indice salvato viene adottato se compatibile, altrimenti viene
+    // ricostruito dallo stesso thread che carica la tabella
+    if (indice == NULL || !adottaIndice(&lista->indice_id, indice, lunghezza_indice, n)) {
+        ricostruisciIndiceAllievi(lista);
+    }
     return true;
 }
+
+bool salvaAllievi(const ListaAllievi* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = serializzaAllievi(lista, &buf) && scriviBufferSuFile(&buf, filename);
+    liberaBuffer(&buf);
+    return ok;
+}
+
+bool caricaAllievi(ListaAllievi* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = leggiFileInBuffer(filename, &buf) && // File mancante: non e' un errore
+              deserializzaAllievi(lista, buf.dati, buf.lunghezza);
+    liberaBuffer(&buf);
+    return ok;
+}
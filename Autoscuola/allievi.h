@@ -15,6 +15,9 @@
 #define ALLIEVI_H
 
 #include <stdbool.h>
+#include "buffer.h"
+#include "modifiche.h"
+#include "uscita.h"
 
 //TIPI OPACHI
 /**
@@ -156,6 +159,22 @@ Allievo* cercaAllievoPerID(ListaAllievi* lista, int id);
  */
 int inserisciAllievoBase(ListaAllievi* lista);
 
+/**
+ * @brief Aggiunge un allievo con dati gia' acquisiti (senza interazione).
+ *
+ * Usata dalle importazioni in blocco: non riordina la lista e non crea
+ * pagamenti ed esami, che restano a carico del chiamante.
+ *
+ * @param lista Puntatore alla lista degli allievi.
+ * @param nome Nome (max 29 caratteri).
+ * @param cognome Cognome (max 29 caratteri).
+ * @param codice_fiscale Codice fiscale (max 16 caratteri).
+ * @param categoria Categoria patente (A, B, AM, anche minuscola).
+ * @return ID del nuovo allievo, -1 se la lista e' piena o i dati non entrano nei campi.
+ */
+int aggiungiAllievo(ListaAllievi* lista, const char* nome, const char* cognome,
+                    const char* codice_fiscale, const char* categoria);
+
 /**
  * @brief Inserisce un nuovo allievo e inizializza i suoi pagamenti ed esami.
  * Questa  la funzione da chiamare dal menu principale.
@@ -174,8 +193,9 @@ void ordinaAllieviAlfabetico(ListaAllievi* lista);
 /**
  * @brief Stampa l'elenco completo degli allievi.
  * @param lista Lista da stampare.
+ * @param uscita Destinazione dell'elenco (NULL per il terminale).
  */
-void stampaAllievi(const ListaAllievi* lista);
+void stampaAllievi(const ListaAllievi* lista, Uscita* uscita);
 
 /**
  * @brief Filtra e stampa gli allievi per categoria di patente.
@@ -198,6 +218,95 @@ void filtraPerStato(const ListaAllievi* lista);
 void cercaAllievo(const ListaAllievi* listaA, const void* listaP, const void* listaE);
 
 //FUNZIONI I/O FILE
+/**
+ * @brief Aggiorna una copia della lista con i soli blocchi modificati dopo una generazione.
+ *
+ * Usata dall'autosalvataggio e dalle viste di condivisi.h per mantenere
+ * un'istantanea coerente senza ricopiare l'intera lista a ogni ciclo. Se la
+ * lista e' cambiata viene copiato anche l'indice per ID, cosi' le ricerche
+ * funzionano anche sulla copia; i record copiati conservano la loro
+ * generazione (getGenerazioneRecord()).
+ *
+ * @param copia Lista di destinazione (creata con creaListaAllievi()).
+ * @param originale Lista da cui copiare.
+ * @param generazione Generazione dell'ultima copia (0 = copia completa).
+ * @return Numero di blocchi copiati, -1 se i parametri non sono validi.
+ */
+int copiaModificheAllievi(ListaAllievi* copia, const ListaAllievi* originale, unsigned long generazione);
+
+/**
+ * @brief Restituisce il registro delle modifiche della lista degli allievi.
+ *
+ * Il registro descrive anche l'array dei record (indirizzo, dimensione,
+ * capacita'): l'istantanea differenziale lo usa per riscrivere solo i
+ * blocchi modificati.
+ *
+ * @param lista Lista degli allievi.
+ * @return Puntatore al registro (read-only), NULL se lista e' NULL.
+ */
+const RegistroModifiche* getRegistroModificheAllievi(const ListaAllievi* lista);
+
+/**
+ * @brief Serializza l'intestazione del formato a record fissi (contatori senza record).
+ *
+ * Seguita da `n` record grezzi forma un'area leggibile da deserializzaAllievi().
+ *
+ * @param lista Lista degli allievi.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIntestazioneGrezzaAllievi(const ListaAllievi* lista, Buffer* buf);
+
+/**
+ * @brief Serializza la lista degli allievi in un buffer in memoria.
+ *
+ * Il formato e' lo stesso del file `allievi.dat` e viene usato sia per i file
+ * separati sia per le sezioni dell'archivio unico. I record sono codificati
+ * in forma compatta (vedi codifica.h).
+ *
+ * @param lista Lista da serializzare.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaAllievi(const ListaAllievi* lista, Buffer* buf);
+
+/**
+ * @brief Ricostruisce la lista degli allievi da un'area di memoria serializzata.
+ *
+ * Riconosce anche il formato precedente a struct grezze.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaAllievi().
+ * @param lunghezza Numero di byte disponibili.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaAllievi(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Come deserializzaAllievi(), adottando un indice per ID salvato in precedenza.
+ *
+ * L'indice viene adottato solo se ha la dimensione attesa e punta a
+ * posizioni esistenti; altrimenti viene ricostruito. Il chiamante deve
+ * garantire che l'indice sia stato prodotto per gli stessi dati.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaAllievi().
+ * @param lunghezza Numero di byte disponibili.
+ * @param indice Byte prodotti da serializzaIndiceAllievi() (NULL = ricostruisci).
+ * @param lunghezza_indice Numero di byte dell'indice.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaAllieviConIndice(ListaAllievi* lista, const unsigned char* dati, size_t lunghezza,
+                                  const unsigned char* indice, size_t lunghezza_indice);
+
+/**
+ * @brief Serializza l'indice per ID della lista degli allievi (immagine della tabella hash).
+ * @param lista Lista di cui salvare l'indice.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIndiceAllievi(const ListaAllievi* lista, Buffer* buf);
+
 /**
  * @brief Salva la lista degli allievi su file binario.
  * @param lista Lista da salvare.
@@ -0,0 +1,347 @@
+/**
+ * @file archivio.c
+ * @brief Implementazione del formato a file unico (intestazione + sezioni allineate).
+ *
+ * Layout del file:
+ * - Intestazione fissa (`IntestazioneArchivio`, 128 byte) con indice delle sezioni
+ * - Sezioni nell'ordine di TipoSezione, ciascuna allineata a ALLINEAMENTO_SEZIONI
+ *
+ * I campi numerici sono scritti nell'ordine dei byte della macchina, come
+ * gia' avviene per i file `.dat` dei singoli ADT.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "archivio.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define MAGIC_ARCHIVIO "AUTOSCDB"
+#define VERSIONE_ARCHIVIO 1
+
+/**
+ * @struct VoceIndice
+ * @brief Voce dell'indice: descrive una sezione dell'archivio.
+ */
+typedef struct {
+    uint32_t tipo;      /**< TipoSezione */
+    uint32_t checksum;  /**< Checksum dei byte della sezione */
+    uint64_t offset;    /**< Posizione della sezione dall'inizio del file */
+    uint64_t lunghezza; /**< Lunghezza della sezione in byte */
+} VoceIndice;
+
+/**
+ * @struct IntestazioneArchivio
+ * @brief Intestazione fissa posta all'inizio del file archivio.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t versione;
+    uint32_t n_sezioni;
+    uint64_t generazione;
+    VoceIndice indice[NUM_SEZIONI];
+    uint32_t checksum_intestazione; /**< Checksum dei campi precedenti */
+    uint32_t riservato;
+} IntestazioneArchivio;
+
+//STATO DEL MODULO
+#ifdef _WIN32
+static BackendPersistenza backend_corrente = BACKEND_STDIO;
+#else
+static BackendPersistenza backend_corrente = BACKEND_VETTORIALE;
+#endif
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Arrotonda una posizione al multiplo successivo di ALLINEAMENTO_SEZIONI.
+ */
+static uint64_t allinea(uint64_t posizione) {
+    return (posizione + ALLINEAMENTO_SEZIONI - 1) / ALLINEAMENTO_SEZIONI * ALLINEAMENTO_SEZIONI;
+}
+
+/**
+ * @brief Forza sul disco i dati del file prima del rename di commit.
+ */
+static bool forzaSuDisco(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * @brief Rende definitivo il file temporaneo sostituendo l'archivio precedente.
+ */
+static bool rendiDefinitivo(const char* temporaneo, const char* filename) {
+#ifdef _WIN32
+    // Su Windows rename() non sovrascrive un file esistente
+    remove(filename);
+#endif
+    return rename(temporaneo, filename) == 0;
+}
+
+/**
+ * @brief Scrive intestazione e sezioni con lo stream stdio (backend portabile).
+ */
+static bool scriviStdio(const char* temporaneo, const IntestazioneArchivio* intestazione,
+                        const Buffer sezioni[NUM_SEZIONI]) {
+    FILE* file = fopen(temporaneo, "wb");
+    if (file == NULL) {
+        printf("Errore: impossibile aprire il file %s per la scrittura.\n", temporaneo);
+        return false;
+    }
+
+    // Scrittura sequenziale: intestazione, poi ogni sezione preceduta dal riempimento
+    static const unsigned char zeri[ALLINEAMENTO_SEZIONI] = {0};
+    bool ok = (fwrite(intestazione, sizeof(*intestazione), 1, file) == 1);
+    uint64_t scritti = sizeof(*intestazione);
+
+    for (int i = 0; i < NUM_SEZIONI && ok; i++) {
+        size_t riempimento = (size_t)(intestazione->indice[i].offset - scritti);
+        ok &= (fwrite(zeri, 1, riempimento, file) == riempimento);
+        ok &= (fwrite(sezioni[i].dati, 1, sezioni[i].lunghezza, file) == sezioni[i].lunghezza);
+        scritti = intestazione->indice[i].offset + sezioni[i].lunghezza;
+    }
+
+    ok &= forzaSuDisco(file);
+    ok &= (fclose(file) == 0);
+    return ok;
+}
+
+#ifndef _WIN32
+/**
+ * @brief Scrive un elenco di blocchi con writev, ripetendo in caso di scrittura parziale.
+ */
+static bool scriviTuttiIBlocchi(int fd, struct iovec* blocchi, int n_blocchi) {
+    while (n_blocchi > 0) {
+        ssize_t scritti = writev(fd, blocchi, n_blocchi);
+        if (scritti < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        // Salta i blocchi completati e accorcia quello scritto a meta'
+        size_t restanti = (size_t)scritti;
+        while (n_blocchi > 0 && restanti >= blocchi->iov_len) {
+            restanti -= blocchi->iov_len;
+            blocchi++;
+            n_blocchi--;
+        }
+        if (n_blocchi > 0) {
+            blocchi->iov_base = (char*)blocchi->iov_base + restanti;
+            blocchi->iov_len -= restanti;
+        }
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief Scrive l'intero archivio con un'unica richiesta vettoriale (writev).
+ *
+ * Intestazione, riempimenti e sezioni vengono consegnati al kernel in un
+ * solo lotto, senza copie intermedie nel buffer di stdio. Se il backend non
+ * e' disponibile si ripiega sul percorso stdio.
+ */
+static bool scriviVettoriale(const char* temporaneo, const IntestazioneArchivio* intestazione,
+                             const Buffer sezioni[NUM_SEZIONI]) {
+#ifdef _WIN32
+    return scriviStdio(temporaneo, intestazione, sezioni);
+#else
+    int fd = open(temporaneo, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return scriviStdio(temporaneo, intestazione, sezioni);
+    }
+
+    static const unsigned char zeri[ALLINEAMENTO_SEZIONI] = {0};
+    struct iovec blocchi[1 + 2 * NUM_SEZIONI];
+    int n_blocchi = 0;
+
+    blocchi[n_blocchi].iov_base = (void*)intestazione;
+    blocchi[n_blocchi++].iov_len = sizeof(*intestazione);
+    uint64_t scritti = sizeof(*intestazione);
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        size_t riempimento = (size_t)(intestazione->indice[i].offset - scritti);
+        if (riempimento > 0) {
+            blocchi[n_blocchi].iov_base = (void*)zeri;
+            blocchi[n_blocchi++].iov_len = riempimento;
+        }
+        if (sezioni[i].lunghezza > 0) {
+            blocchi[n_blocchi].iov_base = sezioni[i].dati;
+            blocchi[n_blocchi++].iov_len = sezioni[i].lunghezza;
+        }
+        scritti = intestazione->indice[i].offset + sezioni[i].lunghezza;
+    }
+
+    bool ok = scriviTuttiIBlocchi(fd, blocchi, n_blocchi);
+    ok &= (fsync(fd) == 0);
+    ok &= (close(fd) == 0);
+    return ok;
+#endif
+}
+
+/**
+ * @brief Legge l'intero file archivio con il backend corrente.
+ *
+ * Il backend vettoriale usa una sola read() dimensionata con fstat();
+ * quello stdio delega a leggiFileInBuffer().
+ */
+static bool leggiFileArchivio(const char* filename, Buffer* contenuto) {
+#ifndef _WIN32
+    if (backend_corrente == BACKEND_VETTORIALE) {
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        bool ok = (fstat(fd, &info) == 0 && info.st_size >= 0);
+        if (ok) {
+            size_t dimensione = (size_t)info.st_size;
+            svuotaBuffer(contenuto);
+            ok = riservaBuffer(contenuto, dimensione + 1);
+            while (ok && contenuto->lunghezza < dimensione) {
+                ssize_t letti = read(fd, contenuto->dati + contenuto->lunghezza,
+                                     dimensione - contenuto->lunghezza);
+                if (letti < 0 && errno == EINTR) continue;
+                if (letti <= 0) ok = false;
+                else contenuto->lunghezza += (size_t)letti;
+            }
+        }
+        close(fd);
+        return ok;
+    }
+#endif
+    return leggiFileInBuffer(filename, contenuto);
+}
+
+//FUNZIONI PUBBLICHE
+
+void impostaBackendPersistenza(BackendPersistenza backend) {
+#ifdef _WIN32
+    (void)backend;
+    backend_corrente = BACKEND_STDIO; // Unico backend disponibile
+#else
+    backend_corrente = backend;
+#endif
+}
+
+BackendPersistenza getBackendPersistenza(void) {
+    return backend_corrente;
+}
+
+uint32_t checksumArchivio(const void* dati, size_t lunghezza) {
+    const unsigned char* p = (const unsigned char*)dati;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < lunghezza; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool scriviArchivio(const char* filename, const Buffer sezioni[NUM_SEZIONI],
+                    uint64_t generazione) {
+    if (filename == NULL || sezioni == NULL) return false;
+
+    // Costruzione dell'intestazione: tutte le posizioni sono note in anticipo
+    IntestazioneArchivio intestazione;
+    memset(&intestazione, 0, sizeof(intestazione));
+    memcpy(intestazione.magic, MAGIC_ARCHIVIO, sizeof(intestazione.magic));
+    intestazione.versione = VERSIONE_ARCHIVIO;
+    intestazione.n_sezioni = NUM_SEZIONI;
+    intestazione.generazione = generazione;
+
+    uint64_t posizione = allinea(sizeof(IntestazioneArchivio));
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        intestazione.indice[i].tipo = (uint32_t)i;
+        intestazione.indice[i].checksum = checksumArchivio(sezioni[i].dati, sezioni[i].lunghezza);
+        intestazione.indice[i].offset = posizione;
+        intestazione.indice[i].lunghezza = sezioni[i].lunghezza;
+        posizione = allinea(posizione + sezioni[i].lunghezza);
+    }
+    intestazione.checksum_intestazione =
+        checksumArchivio(&intestazione, offsetof(IntestazioneArchivio, checksum_intestazione));
+
+    char temporaneo[256];
+    snprintf(temporaneo, sizeof(temporaneo), "%s.tmp", filename);
+
+    bool ok;
+    if (backend_corrente == BACKEND_VETTORIALE) {
+        ok = scriviVettoriale(temporaneo, &intestazione, sezioni);
+    } else {
+        ok = scriviStdio(temporaneo, &intestazione, sezioni);
+    }
+
+    // Punto di commit unico: fino al rename resta valido l'archivio precedente
+    if (!ok || !rendiDefinitivo(temporaneo, filename)) {
+        remove(temporaneo);
+        printf("Errore: impossibile completare il salvataggio di %s.\n", filename);
+        return false;
+    }
+    return true;
+}
+
+bool leggiArchivio(const char* filename, Buffer* contenuto,
+                   VistaSezione sezioni[NUM_SEZIONI], uint64_t* generazione) {
+    if (filename == NULL || contenuto == NULL || sezioni == NULL) return false;
+
+    if (!leggiFileArchivio(filename, contenuto)) return false;
+    if (contenuto->lunghezza < sizeof(IntestazioneArchivio)) return false;
+
+    IntestazioneArchivio intestazione;
+    memcpy(&intestazione, contenuto->dati, sizeof(intestazione));
+
+    if (memcmp(intestazione.magic, MAGIC_ARCHIVIO, sizeof(intestazione.magic)) != 0 ||
+        intestazione.versione != VERSIONE_ARCHIVIO ||
+        intestazione.n_sezioni != NUM_SEZIONI) {
+        return false;
+    }
+    if (intestazione.checksum_intestazione !=
+        checksumArchivio(&intestazione, offsetof(IntestazioneArchivio, checksum_intestazione))) {
+        return false;
+    }
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        const VoceIndice* voce = &intestazione.indice[i];
+        if (voce->tipo != (uint32_t)i ||
+            voce->offset > contenuto->lunghezza ||
+            voce->lunghezza > contenuto->lunghezza - voce->offset) {
+            return false;
+        }
+
+        sezioni[i].dati = contenuto->dati + voce->offset;
+        sezioni[i].lunghezza = (size_t)voce->lunghezza;
+        sezioni[i].checksum = voce->checksum;
+
+        if (checksumArchivio(sezioni[i].dati, sezioni[i].lunghezza) != voce->checksum) {
+            return false;
+        }
+    }
+
+    if (generazione != NULL) {
+        *generazione = intestazione.generazione;
+    }
+    return true;
+}
+
+bool esisteArchivio(const char* filename) {
+    if (filename == NULL) return false;
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) return false;
+    fclose(file);
+    return true;
+}
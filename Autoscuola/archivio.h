@@ -0,0 +1,121 @@
+/**
+ * @file archivio.h
+ * @brief Formato a file unico per la persistenza di tutte le tabelle.
+ *
+ * L'archivio raccoglie in un solo file le quattro tabelle del gestionale
+ * (allievi, pagamenti, esami, guide). Il file inizia con un'intestazione che
+ * contiene un indice (tabella dei contenuti) con posizione, lunghezza e
+ * checksum di ogni sezione; le sezioni seguono allineate a
+ * `ALLINEAMENTO_SEZIONI` byte.
+ *
+ * Il salvataggio scrive l'intero archivio su un file temporaneo e lo rende
+ * definitivo con un unico `rename`: le quattro tabelle vengono quindi
+ * sostituite insieme oppure non vengono sostituite affatto.
+ *
+ * Il modulo non conosce il contenuto delle sezioni: riceve e restituisce
+ * byte gia' serializzati dagli ADT.
+ */
+#ifndef ARCHIVIO_H
+#define ARCHIVIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "buffer.h"
+
+//COSTANTI PUBBLICHE
+#define ARCHIVIO_FILE_PREDEFINITO "autoscuola.db"
+#define INDICI_FILE_PREDEFINITO "autoscuola.idx"
+#define ALLINEAMENTO_SEZIONI 64
+
+/**
+ * @brief Sezioni (tabelle) contenute nell'archivio.
+ */
+typedef enum {
+    SEZIONE_ALLIEVI = 0,
+    SEZIONE_PAGAMENTI = 1,
+    SEZIONE_ESAMI = 2,
+    SEZIONE_GUIDE = 3,
+    NUM_SEZIONI = 4
+} TipoSezione;
+
+/**
+ * @brief Meccanismo usato per le letture e scritture dell'archivio.
+ */
+typedef enum {
+    BACKEND_STDIO = 0,     /**< fopen/fwrite/fread: portabile, usato come ripiego */
+    BACKEND_VETTORIALE = 1 /**< open/writev/read: un'unica richiesta per tutte le sezioni (POSIX) */
+} BackendPersistenza;
+
+/**
+ * @struct VistaSezione
+ * @brief Riferimento in sola lettura ai byte di una sezione letta dall'archivio.
+ */
+typedef struct {
+    const unsigned char* dati; /**< Inizio della sezione */
+    size_t lunghezza;          /**< Lunghezza in byte */
+    uint32_t checksum;         /**< Checksum della sezione (verificato in lettura) */
+} VistaSezione;
+
+/**
+ * @brief Seleziona il backend di persistenza.
+ *
+ * Sui sistemi senza I/O vettoriale (Windows) resta comunque attivo BACKEND_STDIO.
+ *
+ * @param backend Backend desiderato.
+ */
+void impostaBackendPersistenza(BackendPersistenza backend);
+
+/**
+ * @brief Restituisce il backend di persistenza attivo.
+ * @return Backend corrente (predefinito: BACKEND_VETTORIALE dove disponibile).
+ */
+BackendPersistenza getBackendPersistenza(void);
+
+/**
+ * @brief Calcola il checksum (FNV-1a a 32 bit) di un'area di memoria.
+ * @param dati Byte di cui calcolare il checksum.
+ * @param lunghezza Numero di byte.
+ * @return Checksum calcolato.
+ */
+uint32_t checksumArchivio(const void* dati, size_t lunghezza);
+
+/**
+ * @brief Scrive un archivio completo in modo atomico.
+ *
+ * Apre un solo file temporaneo, scrive in sequenza intestazione e sezioni,
+ * lo forza su disco e lo rinomina sul file definitivo. Con BACKEND_VETTORIALE
+ * tutte le sezioni vengono consegnate in un'unica writev().
+ *
+ * @param filename Nome del file archivio (es. "autoscuola.db").
+ * @param sezioni Array di `NUM_SEZIONI` buffer serializzati, nell'ordine di TipoSezione.
+ * @param generazione Numero progressivo del salvataggio, memorizzato nell'intestazione.
+ * @return true se l'archivio e' stato scritto e reso definitivo, false altrimenti.
+ */
+bool scriviArchivio(const char* filename, const Buffer sezioni[NUM_SEZIONI],
+                    uint64_t generazione);
+
+/**
+ * @brief Legge e verifica un archivio completo.
+ *
+ * Il file viene letto con un'unica lettura sequenziale in `contenuto`;
+ * le viste restituite puntano all'interno di quel buffer e restano valide
+ * finche' il buffer non viene liberato.
+ *
+ * @param filename Nome del file archivio.
+ * @param contenuto Buffer che riceve l'intero file.
+ * @param sezioni Array di `NUM_SEZIONI` viste da compilare.
+ * @param generazione Se non NULL, riceve il numero progressivo del salvataggio.
+ * @return true se l'archivio esiste ed e' integro, false altrimenti.
+ */
+bool leggiArchivio(const char* filename, Buffer* contenuto,
+                   VistaSezione sezioni[NUM_SEZIONI], uint64_t* generazione);
+
+/**
+ * @brief Verifica se esiste un file archivio.
+ * @param filename Nome del file archivio.
+ * @return true se il file esiste, false altrimenti.
+ */
+bool esisteArchivio(const char* filename);
+
+#endif // ARCHIVIO_H
@@ -0,0 +1,186 @@
+/**
+ * @file autosalvataggio.c
+ * @brief Implementazione dell'autosalvataggio su istantanea incrementale.
+ *
+ * L'istantanea e' formata da quattro liste private, aggiornate solo dal
+ * thread principale e lette solo dal thread di lavoro: il passaggio di
+ * proprieta' avviene tramite il flag `in_scrittura`, protetto dal mutex.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include "autosalvataggio.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "archivio.h"
+#include "modifiche.h"
+
+//STATO DEL MODULO
+static ListaAllievi* copiaA = NULL;
+static ListaPagamenti* copiaP = NULL;
+static ListaEsami* copiaE = NULL;
+static ListaGuide* copiaG = NULL;
+
+static pthread_t thread_lavoro;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condizione = PTHREAD_COND_INITIALIZER;
+
+static bool attivo = false;
+static bool in_scrittura = false;   /**< L'istantanea appartiene al thread di lavoro */
+static bool arresto = false;
+static int intervallo = AUTOSALVATAGGIO_INTERVALLO_PREDEFINITO;
+static time_t ultimo_avvio = 0;
+static unsigned long generazione_copia = 0; /**< Modifiche gia' presenti nell'istantanea */
+static uint64_t numero_autosalvataggio = 0;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Serializza l'istantanea e la scrive nel file di autosalvataggio.
+ */
+static bool scriviIstantanea(void) {
+    Buffer sezioni[NUM_SEZIONI];
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        inizializzaBuffer(&sezioni[i]);
+    }
+
+    bool ok = serializzaAllievi(copiaA, &sezioni[SEZIONE_ALLIEVI]) &&
+              serializzaPagamenti(copiaP, &sezioni[SEZIONE_PAGAMENTI]) &&
+              serializzaEsami(copiaE, &sezioni[SEZIONE_ESAMI]) &&
+              serializzaGuide(copiaG, &sezioni[SEZIONE_GUIDE]);
+
+    ok = ok && scriviArchivio(AUTOSALVATAGGIO_FILE, sezioni, ++numero_autosalvataggio);
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        liberaBuffer(&sezioni[i]);
+    }
+    return ok;
+}
+
+/**
+ * @brief Ciclo del thread di lavoro: attende una richiesta e scrive l'istantanea.
+ */
+static void* threadAutosalvataggio(void* arg) {
+    (void)arg;
+
+#ifndef _WIN32
+    // I segnali (es. l'arresto della modalita' servizio) spettano al thread principale
+    sigset_t tutti;
+    sigfillset(&tutti);
+    pthread_sigmask(SIG_BLOCK, &tutti, NULL);
+#endif
+
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (!in_scrittura && !arresto) {
+            pthread_cond_wait(&condizione, &mutex);
+        }
+        if (!in_scrittura && arresto) break;
+
+        pthread_mutex_unlock(&mutex);
+        scriviIstantanea();
+        pthread_mutex_lock(&mutex);
+
+        in_scrittura = false;
+        pthread_cond_broadcast(&condizione);
+    }
+    pthread_mutex_unlock(&mutex);
+    return NULL;
+}
+
+/**
+ * @brief Libera le liste dell'istantanea.
+ */
+static void distruggiIstantanea(void) {
+    if (copiaA != NULL) distruggiListaAllievi(&copiaA);
+    if (copiaP != NULL) distruggiListaPagamenti(&copiaP);
+    if (copiaE != NULL) distruggiListaEsami(&copiaE);
+    if (copiaG != NULL) distruggiListaGuide(&copiaG);
+}
+
+//FUNZIONI PUBBLICHE
+
+bool avviaAutosalvataggio(int intervallo_secondi) {
+    if (attivo) return true;
+
+    copiaA = creaListaAllievi();
+    copiaP = creaListaPagamenti();
+    copiaE = creaListaEsami();
+    copiaG = creaListaGuide();
+    if (copiaA == NULL || copiaP == NULL || copiaE == NULL || copiaG == NULL) {
+        printf("Attenzione: impossibile creare le copie di lavoro, autosalvataggio disattivato.\n");
+        distruggiIstantanea();
+        return false;
+    }
+
+    intervallo = (intervallo_secondi >= 0) ? intervallo_secondi : AUTOSALVATAGGIO_INTERVALLO_PREDEFINITO;
+    in_scrittura = false;
+    arresto = false;
+    generazione_copia = 0;
+    ultimo_avvio = time(NULL);
+
+    if (pthread_create(&thread_lavoro, NULL, threadAutosalvataggio, NULL) != 0) {
+        printf("Attenzione: impossibile avviare l'autosalvataggio.\n");
+        distruggiIstantanea();
+        return false;
+    }
+
+    attivo = true;
+    return true;
+}
+
+void puntoDiAutosalvataggio(const ListaAllievi* listaA,
+                            const ListaPagamenti* listaP,
+                            const ListaEsami* listaE,
+                            const ListaGuide* listaG) {
+    if (!attivo || listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return;
+
+    unsigned long generazione = getGenerazioneCorrente();
+    if (generazione == generazione_copia) return;
+
+    time_t adesso = time(NULL);
+    if (difftime(adesso, ultimo_avvio) < intervallo) return;
+
+    pthread_mutex_lock(&mutex);
+    bool occupato = in_scrittura;
+    pthread_mutex_unlock(&mutex);
+    if (occupato) return; // Si riprova al prossimo punto sicuro
+
+    // Il thread di lavoro e' fermo: l'istantanea puo' essere aggiornata
+    copiaModificheAllievi(copiaA, listaA, generazione_copia);
+    copiaModifichePagamenti(copiaP, listaP, generazione_copia);
+    copiaModificheEsami(copiaE, listaE, generazione_copia);
+    copiaModificheGuide(copiaG, listaG, generazione_copia);
+    generazione_copia = generazione;
+    ultimo_avvio = adesso;
+
+    pthread_mutex_lock(&mutex);
+    in_scrittura = true;
+    pthread_cond_signal(&condizione);
+    pthread_mutex_unlock(&mutex);
+}
+
+void arrestaAutosalvataggio(bool rimuovi_file) {
+    if (attivo) {
+        pthread_mutex_lock(&mutex);
+        arresto = true;
+        pthread_cond_broadcast(&condizione);
+        pthread_mutex_unlock(&mutex);
+
+        pthread_join(thread_lavoro, NULL);
+        distruggiIstantanea();
+        attivo = false;
+    }
+
+    if (rimuovi_file) {
+        remove(AUTOSALVATAGGIO_FILE);
+    }
+}
+
+bool esisteAutosalvataggio(void) {
+    return esisteArchivio(AUTOSALVATAGGIO_FILE);
+}
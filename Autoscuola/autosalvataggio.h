@@ -0,0 +1,67 @@
+/**
+ * @file autosalvataggio.h
+ * @brief Salvataggio periodico in background durante l'uso del menu.
+ *
+ * Il thread principale, nei punti sicuri del menu (tra un'operazione e
+ * l'altra), aggiorna un'istantanea delle quattro liste copiando soltanto i
+ * blocchi di record modificati dall'ultima copia (vedi modifiche.h). Un thread
+ * di lavoro serializza poi l'istantanea e la scrive in `AUTOSALVATAGGIO_FILE`
+ * mentre l'utente continua a lavorare: il costo sul thread principale e'
+ * proporzionale ai dati modificati, non alla dimensione delle liste.
+ *
+ * Alla chiusura regolare il file di autosalvataggio viene rimosso; se al
+ * successivo avvio e' ancora presente, la sessione precedente si e'
+ * interrotta e i dati possono essere ripristinati da li'.
+ */
+#ifndef AUTOSALVATAGGIO_H
+#define AUTOSALVATAGGIO_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define AUTOSALVATAGGIO_FILE "autosalvataggio.db"
+#define AUTOSALVATAGGIO_INTERVALLO_PREDEFINITO 60 /**< Secondi tra due autosalvataggi */
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Avvia il thread di autosalvataggio.
+ * @param intervallo_secondi Tempo minimo tra due autosalvataggi (0 = a ogni punto sicuro).
+ * @return true se avviato, false in caso di errore (l'applicazione prosegue senza autosalvataggio).
+ */
+bool avviaAutosalvataggio(int intervallo_secondi);
+
+/**
+ * @brief Punto sicuro del thread principale: eventualmente avvia un autosalvataggio.
+ *
+ * Non fa nulla se l'autosalvataggio non e' attivo, se il thread di lavoro sta
+ * ancora scrivendo, se non e' trascorso l'intervallo o se nessuna lista e'
+ * stata modificata dall'ultima istantanea. Non blocca mai sul disco.
+ *
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ */
+void puntoDiAutosalvataggio(const ListaAllievi* listaA,
+                            const ListaPagamenti* listaP,
+                            const ListaEsami* listaE,
+                            const ListaGuide* listaG);
+
+/**
+ * @brief Arresta il thread di autosalvataggio attendendo la scrittura in corso.
+ * @param rimuovi_file true per cancellare il file (chiusura regolare dopo il salvataggio finale).
+ */
+void arrestaAutosalvataggio(bool rimuovi_file);
+
+/**
+ * @brief Verifica se e' presente un autosalvataggio lasciato da una sessione interrotta.
+ * @return true se il file di autosalvataggio esiste.
+ */
+bool esisteAutosalvataggio(void);
+
+#endif // AUTOSALVATAGGIO_H
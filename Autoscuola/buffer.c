@@ -0,0 +1,104 @@
+/**
+ * @file buffer.c
+ * @brief Implementazione del buffer di byte usato per la serializzazione.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "buffer.h"
+
+#define CAPACITA_INIZIALE_BUFFER 256
+
+void inizializzaBuffer(Buffer* buf) {
+    if (buf == NULL) return;
+    buf->dati = NULL;
+    buf->lunghezza = 0;
+    buf->capacita = 0;
+}
+
+void liberaBuffer(Buffer* buf) {
+    if (buf == NULL) return;
+    free(buf->dati);
+    inizializzaBuffer(buf);
+}
+
+void svuotaBuffer(Buffer* buf) {
+    if (buf == NULL) return;
+    buf->lunghezza = 0;
+}
+
+bool riservaBuffer(Buffer* buf, size_t capacita_minima) {
+    if (buf == NULL) return false;
+    if (buf->capacita >= capacita_minima) return true;
+
+    size_t nuova = (buf->capacita > 0) ? buf->capacita : CAPACITA_INIZIALE_BUFFER;
+    while (nuova < capacita_minima) {
+        nuova *= 2;
+    }
+
+    unsigned char* dati = (unsigned char*)realloc(buf->dati, nuova);
+    if (dati == NULL) return false;
+
+    buf->dati = dati;
+    buf->capacita = nuova;
+    return true;
+}
+
+bool scriviBuffer(Buffer* buf, const void* dati, size_t n) {
+    if (buf == NULL || (dati == NULL && n > 0)) return false;
+    if (n == 0) return true;
+    if (!riservaBuffer(buf, buf->lunghezza + n)) return false;
+
+    memcpy(buf->dati + buf->lunghezza, dati, n);
+    buf->lunghezza += n;
+    return true;
+}
+
+bool riempiBuffer(Buffer* buf, size_t n) {
+    if (buf == NULL) return false;
+    if (n == 0) return true;
+    if (!riservaBuffer(buf, buf->lunghezza + n)) return false;
+
+    memset(buf->dati + buf->lunghezza, 0, n);
+    buf->lunghezza += n;
+    return true;
+}
+
+bool leggiFileInBuffer(const char* filename, Buffer* buf) {
+    if (filename == NULL || buf == NULL) return false;
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return false; // File non esiste, non e' un errore
+    }
+
+    bool ok = false;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long dimensione = ftell(file);
+        if (dimensione >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+            svuotaBuffer(buf);
+            if (riservaBuffer(buf, (size_t)dimensione + 1)) {
+                buf->lunghezza = fread(buf->dati, 1, (size_t)dimensione, file);
+                ok = (buf->lunghezza == (size_t)dimensione);
+            }
+        }
+    }
+
+    fclose(file);
+    return ok;
+}
+
+bool scriviBufferSuFile(const Buffer* buf, const char* filename) {
+    if (buf == NULL || filename == NULL) return false;
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("Errore: impossibile aprire il file %s per la scrittura.\n", filename);
+        return false;
+    }
+
+    bool ok = (fwrite(buf->dati, 1, buf->lunghezza, file) == buf->lunghezza);
+    ok &= (fclose(file) == 0);
+    return ok;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file buffer.h
+ * @brief Buffer di byte a crescita dinamica usato per la serializzazione dei dati.
+ *
+ * Ogni ADT serializza la propria lista in un `Buffer` in memoria; il modulo
+ * di I/O decide poi come scriverlo su disco (file separato o archivio unico).
+ * In questo modo il formato dei dati resta privato dell'ADT, mentre la
+ * strategia di persistenza resta privata del modulo fileio.
+ */
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @struct Buffer
+ * @brief Sequenza di byte con capacita' gestita automaticamente.
+ */
+typedef struct {
+    unsigned char* dati; /**< Area di memoria (NULL se vuoto) */
+    size_t lunghezza;    /**< Byte effettivamente scritti */
+    size_t capacita;     /**< Byte allocati */
+} Buffer;
+
+/**
+ * @brief Inizializza un buffer vuoto (nessuna allocazione).
+ * @param buf Buffer da inizializzare.
+ */
+void inizializzaBuffer(Buffer* buf);
+
+/**
+ * @brief Libera la memoria del buffer e lo riporta allo stato vuoto.
+ * @param buf Buffer da liberare.
+ */
+void liberaBuffer(Buffer* buf);
+
+/**
+ * @brief Azzera la lunghezza del buffer mantenendo la memoria allocata.
+ * @param buf Buffer da svuotare.
+ */
+void svuotaBuffer(Buffer* buf);
+
+/**
+ * @brief Garantisce che il buffer possa contenere almeno `capacita_minima` byte.
+ * @param buf Buffer da espandere.
+ * @param capacita_minima Capacita' richiesta.
+ * @return true se la memoria e' disponibile, false in caso di errore di allocazione.
+ */
+bool riservaBuffer(Buffer* buf, size_t capacita_minima);
+
+/**
+ * @brief Accoda `n` byte al buffer.
+ * @param buf Buffer di destinazione.
+ * @param dati Byte da accodare.
+ * @param n Numero di byte.
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviBuffer(Buffer* buf, const void* dati, size_t n);
+
+/**
+ * @brief Accoda `n` byte nulli al buffer (riempimento/allineamento).
+ * @param buf Buffer di destinazione.
+ * @param n Numero di byte nulli.
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool riempiBuffer(Buffer* buf, size_t n);
+
+/**
+ * @brief Legge l'intero contenuto di un file in un buffer.
+ * @param filename Nome del file.
+ * @param buf Buffer di destinazione (il contenuto precedente viene sostituito).
+ * @return true se successo, false se il file non esiste o errore.
+ */
+bool leggiFileInBuffer(const char* filename, Buffer* buf);
+
+/**
+ * @brief Scrive il contenuto di un buffer su file (sovrascrivendolo).
+ * @param buf Buffer da scrivere.
+ * @param filename Nome del file.
+ * @return true se successo, false altrimenti.
+ */
+bool scriviBufferSuFile(const Buffer* buf, const char* filename);
+
+#endif // BUFFER_H
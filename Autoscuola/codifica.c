@@ -0,0 +1,140 @@
+/**
+ * @file codifica.c
+ * @brief Implementazione delle primitive di codifica compatta (varint, zigzag, stringhe).
+ */
+
+#include <string.h>
+#include "codifica.h"
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Segna il lettore come non valido e lo porta alla fine dell'area.
+ */
+static void erroreLettura(Lettore* lettore) {
+    lettore->errore = true;
+    lettore->pos = lettore->fine;
+}
+
+//SCRITTURA
+
+bool scriviIntestazioneCodifica(Buffer* buf, char tabella) {
+    const unsigned char intestazione[CODIFICA_DIM_INTESTAZIONE] = {
+        CODIFICA_MAGIC_0, CODIFICA_MAGIC_1, (unsigned char)tabella, CODIFICA_VERSIONE
+    };
+    return scriviBuffer(buf, intestazione, sizeof(intestazione));
+}
+
+bool scriviVarint(Buffer* buf, uint64_t valore) {
+    unsigned char tmp[CODIFICA_MAX_VARINT];
+    size_t n = 0;
+    while (valore >= 0x80) {
+        tmp[n++] = (unsigned char)(valore | 0x80);
+        valore >>= 7;
+    }
+    tmp[n++] = (unsigned char)valore;
+    return scriviBuffer(buf, tmp, n);
+}
+
+bool scriviVarintConSegno(Buffer* buf, int64_t valore) {
+    uint64_t zigzag = ((uint64_t)valore << 1) ^ (uint64_t)(valore >> 63);
+    return scriviVarint(buf, zigzag);
+}
+
+bool scriviByte(Buffer* buf, unsigned char valore) {
+    return scriviBuffer(buf, &valore, 1);
+}
+
+bool scriviStringa(Buffer* buf, const char* testo, size_t capacita) {
+    size_t lunghezza = (testo != NULL) ? strnlen(testo, capacita) : 0;
+    return scriviVarint(buf, lunghezza) && scriviBuffer(buf, testo, lunghezza);
+}
+
+//LETTURA
+
+void inizializzaLettore(Lettore* lettore, const unsigned char* dati, size_t lunghezza) {
+    lettore->pos = dati;
+    lettore->fine = dati + lunghezza;
+    lettore->errore = (dati == NULL);
+}
+
+bool isTabellaCodificata(const unsigned char* dati, size_t lunghezza) {
+    return dati != NULL && lunghezza >= CODIFICA_DIM_INTESTAZIONE &&
+           dati[0] == CODIFICA_MAGIC_0 && dati[1] == CODIFICA_MAGIC_1;
+}
+
+bool leggiIntestazioneCodifica(Lettore* lettore, char tabella) {
+    if ((size_t)(lettore->fine - lettore->pos) < CODIFICA_DIM_INTESTAZIONE) {
+        erroreLettura(lettore);
+        return false;
+    }
+
+    const unsigned char* p = lettore->pos;
+    if (p[0] != CODIFICA_MAGIC_0 || p[1] != CODIFICA_MAGIC_1 ||
+        p[2] != (unsigned char)tabella || p[3] != CODIFICA_VERSIONE) {
+        erroreLettura(lettore);
+        return false;
+    }
+    lettore->pos += CODIFICA_DIM_INTESTAZIONE;
+    return true;
+}
+
+uint64_t leggiVarint(Lettore* lettore) {
+    const unsigned char* p = lettore->pos;
+
+    // Caso piu' frequente (valori < 128): un solo byte
+    if (p < lettore->fine && *p < 0x80) {
+        lettore->pos = p + 1;
+        return *p;
+    }
+
+    uint64_t valore = 0;
+    for (int spostamento = 0; spostamento < 64 && p < lettore->fine; spostamento += 7) {
+        unsigned char byte = *p++;
+        valore |= (uint64_t)(byte & 0x7F) << spostamento;
+        if (byte < 0x80) {
+            lettore->pos = p;
+            return valore;
+        }
+    }
+
+    erroreLettura(lettore);
+    return 0;
+}
+
+int64_t leggiVarintConSegno(Lettore* lettore) {
+    uint64_t zigzag = leggiVarint(lettore);
+    return (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+}
+
+unsigned char leggiByte(Lettore* lettore) {
+    if (lettore->pos >= lettore->fine) {
+        erroreLettura(lettore);
+        return 0;
+    }
+    return *lettore->pos++;
+}
+
+bool leggiStringa(Lettore* lettore, char* dest, size_t capacita) {
+    uint64_t lunghezza = leggiVarint(lettore);
+    if (lettore->errore || lunghezza >= capacita ||
+        lunghezza > (uint64_t)(lettore->fine - lettore->pos)) {
+        erroreLettura(lettore);
+        return false;
+    }
+
+    memcpy(dest, lettore->pos, (size_t)lunghezza);
+    memset(dest + lunghezza, 0, capacita - (size_t)lunghezza);
+    lettore->pos += lunghezza;
+    return true;
+}
+
+bool leggiByteGrezzi(Lettore* lettore, void* dest, size_t n) {
+    if (n > (size_t)(lettore->fine - lettore->pos)) {
+        erroreLettura(lettore);
+        return false;
+    }
+    memcpy(dest, lettore->pos, n);
+    lettore->pos += n;
+    return true;
+}
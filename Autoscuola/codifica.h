@@ -0,0 +1,160 @@
+/**
+ * @file codifica.h
+ * @brief Primitive di codifica compatta per il formato su disco delle tabelle.
+ *
+ * Le tabelle vengono salvate con interi a lunghezza variabile (varint, 7 bit
+ * per byte), interi con segno in codifica zigzag, stringhe precedute dalla
+ * lunghezza e campi opzionali protetti da una maschera di bit. Il formato di
+ * ogni record resta privato dell'ADT; questo modulo fornisce solo le
+ * primitive di scrittura su `Buffer` e di lettura con controllo dei limiti.
+ *
+ * Ogni tabella codificata inizia con un'intestazione di 4 byte
+ * (`CODIFICA_MAGIC_0`, `CODIFICA_MAGIC_1`, tabella, versione). Il primo byte
+ * non puo' comparire all'inizio dei vecchi file a struct grezze (che iniziano
+ * con un conteggio <= 100), quindi i due formati si distinguono senza
+ * ambiguita' e i file esistenti restano leggibili.
+ */
+#ifndef CODIFICA_H
+#define CODIFICA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "buffer.h"
+
+//COSTANTI PUBBLICHE
+#define CODIFICA_MAGIC_0 0xA5
+#define CODIFICA_MAGIC_1 'C'
+#define CODIFICA_VERSIONE 1
+#define CODIFICA_DIM_INTESTAZIONE 4
+
+/** Byte massimi occupati da un varint a 64 bit. */
+#define CODIFICA_MAX_VARINT 10
+
+/**
+ * @struct Lettore
+ * @brief Cursore di lettura su un'area di memoria codificata.
+ *
+ * Le funzioni di lettura non superano mai `fine`: in caso di dati troncati o
+ * non validi impostano `errore` e restituiscono 0, cosi' il chiamante puo'
+ * controllare l'esito una sola volta alla fine del record.
+ */
+typedef struct {
+    const unsigned char* pos;  /**< Prossimo byte da leggere */
+    const unsigned char* fine; /**< Primo byte oltre l'area */
+    bool errore;               /**< true dopo la prima lettura non valida */
+} Lettore;
+
+//SCRITTURA
+
+/**
+ * @brief Accoda l'intestazione di una tabella codificata.
+ * @param buf Buffer di destinazione.
+ * @param tabella Identificativo della tabella (es. 'A' per gli allievi).
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviIntestazioneCodifica(Buffer* buf, char tabella);
+
+/**
+ * @brief Accoda un intero senza segno in formato varint.
+ * @param buf Buffer di destinazione.
+ * @param valore Valore da codificare.
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviVarint(Buffer* buf, uint64_t valore);
+
+/**
+ * @brief Accoda un intero con segno (zigzag + varint).
+ * @param buf Buffer di destinazione.
+ * @param valore Valore da codificare.
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviVarintConSegno(Buffer* buf, int64_t valore);
+
+/**
+ * @brief Accoda un singolo byte.
+ * @param buf Buffer di destinazione.
+ * @param valore Byte da scrivere.
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviByte(Buffer* buf, unsigned char valore);
+
+/**
+ * @brief Accoda una stringa preceduta dalla sua lunghezza (senza terminatore).
+ * @param buf Buffer di destinazione.
+ * @param testo Stringa terminata da '\0'.
+ * @param capacita Dimensione del campo di origine (limita la lettura).
+ * @return true se successo, false in caso di errore di allocazione.
+ */
+bool scriviStringa(Buffer* buf, const char* testo, size_t capacita);
+
+//LETTURA
+
+/**
+ * @brief Posiziona un lettore all'inizio di un'area di memoria.
+ * @param lettore Lettore da inizializzare.
+ * @param dati Inizio dell'area.
+ * @param lunghezza Numero di byte disponibili.
+ */
+void inizializzaLettore(Lettore* lettore, const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Verifica se un'area di memoria contiene una tabella codificata.
+ * @param dati Inizio dell'area.
+ * @param lunghezza Numero di byte disponibili.
+ * @return true se inizia con l'intestazione della codifica compatta.
+ */
+bool isTabellaCodificata(const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Legge e verifica l'intestazione di una tabella codificata.
+ * @param lettore Lettore posizionato all'inizio della tabella.
+ * @param tabella Identificativo atteso.
+ * @return true se l'intestazione e' valida per la tabella richiesta.
+ */
+bool leggiIntestazioneCodifica(Lettore* lettore, char tabella);
+
+/**
+ * @brief Legge un intero senza segno in formato varint.
+ * @param lettore Lettore.
+ * @return Valore letto, 0 in caso di errore.
+ */
+uint64_t leggiVarint(Lettore* lettore);
+
+/**
+ * @brief Legge un intero con segno (zigzag + varint).
+ * @param lettore Lettore.
+ * @return Valore letto, 0 in caso di errore.
+ */
+int64_t leggiVarintConSegno(Lettore* lettore);
+
+/**
+ * @brief Legge un singolo byte.
+ * @param lettore Lettore.
+ * @return Byte letto, 0 in caso di errore.
+ */
+unsigned char leggiByte(Lettore* lettore);
+
+/**
+ * @brief Legge una stringa con prefisso di lunghezza in un campo a dimensione fissa.
+ *
+ * Il campo viene azzerato e riempito; una stringa che non entra nel campo
+ * (terminatore compreso) e' un errore.
+ *
+ * @param lettore Lettore.
+ * @param dest Campo di destinazione.
+ * @param capacita Dimensione del campo.
+ * @return true se successo, false in caso di errore.
+ */
+bool leggiStringa(Lettore* lettore, char* dest, size_t capacita);
+
+/**
+ * @brief Copia `n` byte senza interpretarli.
+ * @param lettore Lettore.
+ * @param dest Destinazione.
+ * @param n Numero di byte.
+ * @return true se successo, false se i dati sono troncati.
+ */
+bool leggiByteGrezzi(Lettore* lettore, void* dest, size_t n);
+
+#endif // CODIFICA_H
@@ -0,0 +1,392 @@
+/**
+ * @file comandi.c
+ * @brief Implementazione dei comandi non interattivi.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include "comandi.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "fileio.h"
+#include "importa.h"
+#include "esporta.h"
+#include "integrita.h"
+#include "referenze.h"
+#include "giornale.h"
+#include "autosalvataggio.h"
+#include "difensiva.h"
+#include "util.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+
+/**
+ * @brief Esegue un comando sulle liste caricate.
+ * @param argv Argomenti del comando (senza il nome).
+ * @param argc Numero di argomenti, gia' verificato.
+ * @return Codice di uscita.
+ */
+typedef int (*FunzioneComando)(char* argv[], int argc,
+                               ListaAllievi* listaA, ListaPagamenti* listaP,
+                               ListaEsami* listaE, ListaGuide* listaG);
+
+/**
+ * @struct Comando
+ * @brief Voce della tabella dei comandi.
+ */
+typedef struct {
+    const char* nome;
+    const char* argomenti;       /**< Sintassi mostrata da `help` */
+    int min_argomenti;
+    int max_argomenti;
+    bool modifica;               /**< Se riuscito, i dati vanno salvati */
+    FunzioneComando esegui;
+} Comando;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Converte un intero decimale, rifiutando caratteri in eccesso.
+ */
+static bool leggiIntero(const char* testo, int* valore) {
+    char* fine = NULL;
+    errno = 0;
+    long n = strtol(testo, &fine, 10);
+    if (fine == testo || *fine != '\0' || errno != 0 || n < -2147483647L || n > 2147483647L) {
+        return false;
+    }
+    *valore = (int)n;
+    return true;
+}
+
+/**
+ * @brief Converte un importo (punto o virgola come separatore decimale).
+ */
+static bool leggiImporto(const char* testo, float* importo) {
+    char copia[32];
+    if (strlen(testo) >= sizeof(copia)) return false;
+    strcpy(copia, testo);
+    char* virgola = strchr(copia, ',');
+    if (virgola != NULL) *virgola = '.';
+
+    char* fine = NULL;
+    errno = 0;
+    float n = strtof(copia, &fine);
+    if (fine == copia || *fine != '\0' || errno != 0) return false;
+    *importo = n;
+    return true;
+}
+
+/**
+ * @brief Cerca l'allievo indicato da un argomento, segnalando gli errori.
+ * @return ID dell'allievo, -1 se l'argomento non e' valido o l'allievo non esiste.
+ */
+static int allievoDaArgomento(ListaAllievi* listaA, const char* testo) {
+    int id = 0;
+    if (!leggiIntero(testo, &id) || !validaID(id)) {
+        printf("Errore: ID allievo non valido: %s\n", testo);
+        return -1;
+    }
+    if (cercaAllievoPerID(listaA, id) == NULL) {
+        printf("Errore: nessun allievo con ID %d.\n", id);
+        return -1;
+    }
+    return id;
+}
+
+//COMANDI (PRIVATE)
+
+static int comandoAggiungiAllievo(char* argv[], int argc,
+                                  ListaAllievi* listaA, ListaPagamenti* listaP,
+                                  ListaEsami* listaE, ListaGuide* listaG) {
+    (void)argc; (void)listaG;
+
+    char codice_fiscale[17];
+    if (strlen(argv[2]) >= sizeof(codice_fiscale)) {
+        printf("Errore: codice fiscale non valido: %s\n", argv[2]);
+        return COMANDO_FALLITO;
+    }
+    for (size_t i = 0; i <= strlen(argv[2]); i++) {
+        codice_fiscale[i] = (char)toupper((unsigned char)argv[2][i]);
+    }
+    if (!verificaCodiceFiscale(codice_fiscale)) {
+        printf("Errore: codice fiscale non valido: %s\n", argv[2]);
+        return COMANDO_FALLITO;
+    }
+    for (int i = 0; i < getNumeroAllievi(listaA); i++) {
+        if (equalsIgnoreCase(getAllievoCodiceFiscale(getAllievoAtIndex(listaA, i)), codice_fiscale)) {
+            printf("Errore: codice fiscale gia' presente: %s\n", codice_fiscale);
+            return COMANDO_FALLITO;
+        }
+    }
+
+    int id = aggiungiAllievo(listaA, argv[0], argv[1], codice_fiscale, argv[3]);
+    if (id <= 0) {
+        printf("Errore: allievo non inserito (campi troppo lunghi, patente non valida o lista piena).\n");
+        return COMANDO_FALLITO;
+    }
+    inizializzaPagamento(listaP, id);
+    inizializzaEsame(listaE, id);
+    ordinaAllieviAlfabetico(listaA);
+
+    printf("Allievo inserito con ID: %d\n", id);
+    return COMANDO_OK;
+}
+
+static int comandoRegistraOre(char* argv[], int argc,
+                              ListaAllievi* listaA, ListaPagamenti* listaP,
+                              ListaEsami* listaE, ListaGuide* listaG) {
+    (void)listaP; (void)listaE;
+
+    if (argc % 2 != 0) {
+        printf("Errore: ogni ID deve essere seguito dalle sue ore.\n");
+        return COMANDO_NON_VALIDO;
+    }
+    int n = argc / 2;
+    LezioneGuida* lezioni = (LezioneGuida*)calloc((size_t)n, sizeof(LezioneGuida));
+    if (lezioni == NULL) {
+        printf("Errore: memoria insufficiente.\n");
+        return COMANDO_FALLITO;
+    }
+
+    // Tutte le coppie vengono verificate prima di registrare qualcosa
+    int esito = COMANDO_OK;
+    for (int i = 0; i < n && esito == COMANDO_OK; i++) {
+        lezioni[i].id_allievo = allievoDaArgomento(listaA, argv[2 * i]);
+        if (lezioni[i].id_allievo < 0) {
+            esito = COMANDO_FALLITO;
+        } else if (!leggiIntero(argv[2 * i + 1], &lezioni[i].ore) || lezioni[i].ore <= 0) {
+            printf("Errore: numero di ore non valido: %s\n", argv[2 * i + 1]);
+            esito = COMANDO_FALLITO;
+        }
+    }
+
+    // Un errore lascia le liste a meta', ma i dati non vengono salvati
+    if (esito == COMANDO_OK && registraOreGuidaInBlocco(listaG, lezioni, n, NULL) < n) {
+        printf("Errore: ore non registrate, nessuna modifica salvata.\n");
+        esito = COMANDO_FALLITO;
+    }
+    if (esito == COMANDO_OK) {
+        for (int i = 0; i < n; i++) {
+            bool gia_stampato = false;
+            for (int k = 0; k < i && !gia_stampato; k++) {
+                gia_stampato = lezioni[k].id_allievo == lezioni[i].id_allievo;
+            }
+            if (!gia_stampato) {
+                printf("Ore di guida dell'allievo %d: %d\n", lezioni[i].id_allievo,
+                       getOreSvolte(cercaGuidaPerID(listaG, lezioni[i].id_allievo)));
+            }
+        }
+    }
+    free(lezioni);
+    return esito;
+}
+
+static int comandoAggiungiRata(char* argv[], int argc,
+                               ListaAllievi* listaA, ListaPagamenti* listaP,
+                               ListaEsami* listaE, ListaGuide* listaG) {
+    (void)argc; (void)listaE; (void)listaG;
+
+    int id = allievoDaArgomento(listaA, argv[0]);
+    if (id < 0) return COMANDO_FALLITO;
+
+    int rata = 0;
+    float importo = 0.0f;
+    if (!leggiIntero(argv[1], &rata) || !validaTipoRata(rata)) {
+        printf("Errore: rata non valida: %s (1-3, 4 = extra)\n", argv[1]);
+        return COMANDO_FALLITO;
+    }
+    if (!leggiImporto(argv[2], &importo) || !validaImporto(importo)) {
+        printf("Errore: importo non valido: %s\n", argv[2]);
+        return COMANDO_FALLITO;
+    }
+    if (!aggiungiRata(listaP, id, rata, importo)) {
+        printf("Errore: rata non registrata.\n");
+        return COMANDO_FALLITO;
+    }
+
+    printf("Rata registrata per l'allievo %d.\n", id);
+    return COMANDO_OK;
+}
+
+static int comandoImportaAllievi(char* argv[], int argc,
+                                 ListaAllievi* listaA, ListaPagamenti* listaP,
+                                 ListaEsami* listaE, ListaGuide* listaG) {
+    (void)argc; (void)listaG;
+
+    EsitoImportazione esito;
+    if (!importaAllieviCSV(argv[0], listaA, listaP, listaE, &esito)) return COMANDO_FALLITO;
+    stampaEsitoImportazione(&esito, argv[0]);
+    ordinaAllieviAlfabetico(listaA);
+    return COMANDO_OK;
+}
+
+static int comandoImportaEsami(char* argv[], int argc,
+                               ListaAllievi* listaA, ListaPagamenti* listaP,
+                               ListaEsami* listaE, ListaGuide* listaG) {
+    (void)argc;
+
+    EsitoImportazioneEsami esito;
+    if (!importaEsitiEsamiCSV(argv[0], listaA, listaP, listaE, listaG, &esito)) return COMANDO_FALLITO;
+    stampaEsitoImportazioneEsami(&esito, argv[0]);
+    return COMANDO_OK;
+}
+
+static int comandoEsporta(char* argv[], int argc,
+                          ListaAllievi* listaA, ListaPagamenti* listaP,
+                          ListaEsami* listaE, ListaGuide* listaG) {
+    FormatoEsportazione formato = ESPORTA_CSV;
+    const char* prefisso = PREFISSO_ESPORTAZIONE_PREDEFINITO;
+    bool prefisso_letto = false;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            formato = ESPORTA_CSV;
+        } else if (strcmp(argv[i], "--jsonl") == 0) {
+            formato = ESPORTA_JSONL;
+        } else if (argv[i][0] != '-' && !prefisso_letto) {
+            prefisso = argv[i];
+            prefisso_letto = true;
+        } else {
+            printf("Errore: argomento non valido: %s\n", argv[i]);
+            return COMANDO_NON_VALIDO;
+        }
+    }
+
+    if (!esportaTutto(listaA, listaP, listaE, listaG, prefisso, formato)) return COMANDO_FALLITO;
+    printf("Dati esportati nei file %s_*.%s\n", prefisso, (formato == ESPORTA_CSV) ? "csv" : "jsonl");
+    return COMANDO_OK;
+}
+
+static int comandoControlla(char* argv[], int argc,
+                            ListaAllievi* listaA, ListaPagamenti* listaP,
+                            ListaEsami* listaE, ListaGuide* listaG) {
+    bool ripara = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--repair") != 0) {
+            printf("Errore: argomento non valido: %s\n", argv[i]);
+            return COMANDO_NON_VALIDO;
+        }
+        ripara = true;
+    }
+
+    RisultatoIntegrita risultato;
+    if (!verificaIntegrita(listaA, listaP, listaE, listaG, &risultato)) return COMANDO_FALLITO;
+    stampaRisultatoIntegrita(&risultato);
+    int violazioni = risultato.n_violazioni;
+    liberaRisultatoIntegrita(&risultato);
+
+    printf("\nControllo dei riferimenti tra le tabelle...\n\n");
+    RisultatoReferenze referenze;
+    if (!verificaReferenze(listaA, listaP, listaE, listaG, &referenze)) return COMANDO_FALLITO;
+    stampaRisultatoReferenze(&referenze);
+    int problemi = contaProblemiReferenze(&referenze);
+    if (ripara && problemi > 0) {
+        printf("Record rimossi o creati: %d\n", riparaReferenze(listaP, listaE, listaG, &referenze));
+        problemi = salvaTuttiDati(listaA, listaP, listaE, listaG) ? 0 : problemi;
+    }
+    liberaRisultatoReferenze(&referenze);
+
+    return (violazioni == 0 && problemi == 0) ? COMANDO_OK : COMANDO_FALLITO;
+}
+
+//TABELLA DEI COMANDI
+
+static const Comando COMANDI[] = {
+    { "add-student", "<nome> <cognome> <codice_fiscale> <patente>", 4, 4, true, comandoAggiungiAllievo },
+    { "register-hours", "<id> <ore> [<id> <ore> ...]", 2, INT_MAX, true, comandoRegistraOre },
+    { "add-payment", "<id> <rata 1-4> <importo>", 3, 3, true, comandoAggiungiRata },
+    { "import-students", "<file.csv>", 1, 1, true, comandoImportaAllievi },
+    { "import-exams", "<file.csv>", 1, 1, true, comandoImportaEsami },
+    { "export", "[--csv | --jsonl] [prefisso]", 0, 2, false, comandoEsporta },
+    { "check", "[--repair]", 0, 1, false, comandoControlla }  // Salva da se' solo dopo una riparazione
+};
+#define NUM_COMANDI ((int)(sizeof(COMANDI) / sizeof(COMANDI[0])))
+
+static void stampaUtilizzo(void) {
+    printf("Uso: autoscuola [comando [argomenti]]\n");
+    printf("Senza comando si apre il menu interattivo; con --servizio [socket] [lavoratori]\n");
+    printf("il programma serve i dati su un socket Unix.\n\nComandi:\n");
+    for (int i = 0; i < NUM_COMANDI; i++) {
+        printf("  %-16s %s\n", COMANDI[i].nome, COMANDI[i].argomenti);
+    }
+    printf("  help\n");
+}
+
+//FUNZIONI PUBBLICHE
+
+int eseguiComando(int argc, char* argv[]) {
+    if (argc < 1) {
+        stampaUtilizzo();
+        return COMANDO_NON_VALIDO;
+    }
+    if (strcmp(argv[0], "help") == 0 || strcmp(argv[0], "--help") == 0) {
+        stampaUtilizzo();
+        return COMANDO_OK;
+    }
+
+    const Comando* comando = NULL;
+    for (int i = 0; i < NUM_COMANDI && comando == NULL; i++) {
+        if (strcmp(argv[0], COMANDI[i].nome) == 0) comando = &COMANDI[i];
+    }
+    if (comando == NULL) {
+        printf("Errore: comando sconosciuto: %s\n\n", argv[0]);
+        stampaUtilizzo();
+        return COMANDO_NON_VALIDO;
+    }
+    int n_argomenti = argc - 1;
+    if (n_argomenti < comando->min_argomenti || n_argomenti > comando->max_argomenti) {
+        printf("Uso: autoscuola %s %s\n", comando->nome, comando->argomenti);
+        return COMANDO_NON_VALIDO;
+    }
+
+    // Menu, servizio o un altro comando in corso: i loro dati non sono ancora sui file
+    if (!acquisisciBloccoDati()) return COMANDO_FALLITO;
+
+    // Una sessione interrotta ha dati piu' recenti dei file
+    if (esisteGiornale() || esisteAutosalvataggio()) {
+        printf("Errore: la sessione precedente non e' stata chiusa correttamente.\n");
+        printf("Avviare il programma senza argomenti per recuperare i dati.\n");
+        rilasciaBloccoDati();
+        return COMANDO_FALLITO;
+    }
+    impostaMessaggiAvanzamento(false);
+
+    ListaAllievi* listaA = creaListaAllievi();
+    ListaPagamenti* listaP = creaListaPagamenti();
+    ListaEsami* listaE = creaListaEsami();
+    ListaGuide* listaG = creaListaGuide();
+    int esito = COMANDO_FALLITO;
+
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) {
+        printf("Errore critico: impossibile allocare memoria.\n");
+    } else {
+        inizializzaLista(listaA);
+        inizializzaListaPagamenti(listaP);
+        inizializzaListaEsami(listaE);
+        inizializzaListaGuide(listaG);
+        caricaTuttiDati(listaA, listaP, listaE, listaG);
+
+        // Con dati illeggibili le liste sono vuote: export e check riuscirebbero sul nulla
+        if (!datiIlleggibili()) {
+            esito = comando->esegui(argv + 1, n_argomenti, listaA, listaP, listaE, listaG);
+            if (esito == COMANDO_OK && comando->modifica &&
+                !salvaTuttiDati(listaA, listaP, listaE, listaG)) {
+                esito = COMANDO_FALLITO;
+            }
+        }
+    }
+
+    if (listaA != NULL) distruggiListaAllievi(&listaA);
+    if (listaP != NULL) distruggiListaPagamenti(&listaP);
+    if (listaE != NULL) distruggiListaEsami(&listaE);
+    if (listaG != NULL) distruggiListaGuide(&listaG);
+    rilasciaBloccoDati();
+    return esito;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file comandi.h
+ * @brief Comandi non interattivi per script e procedure notturne.
+ *
+ * `autoscuola <comando> [argomenti]` carica i dati, esegue una sola
+ * operazione chiamando direttamente le funzioni di dominio e, se i dati sono
+ * cambiati, li salva. Nessun menu, nessuna pulizia dello schermo, nessuna
+ * domanda: i comandi si possono concatenare in uno script e il codice di
+ * uscita dice se l'operazione e' riuscita.
+ *
+ * Comandi disponibili:
+ * - `add-student <nome> <cognome> <codice_fiscale> <patente>`
+ * - `register-hours <id> <ore> [<id> <ore> ...]`: piu' lezioni registrate in blocco
+ * - `add-payment <id> <rata> <importo>` (rata 1-3, 4 = extra)
+ * - `import-students <file.csv>` (vedi importaAllieviCSV())
+ * - `import-exams <file.csv>` (vedi importaEsitiEsamiCSV())
+ * - `export [--csv | --jsonl] [prefisso]` (vedi esportaTutto())
+ * - `check [--repair]`: integrita' e riferimenti; con `--repair` ripara i riferimenti
+ * - `help`
+ *
+ * I comandi acquisiscono lo stesso blocco esclusivo del menu e del servizio
+ * (acquisisciBloccoDati() in fileio.h) e non partono se un'altra istanza
+ * usa i dati. Non partono neppure se sono presenti il giornale di un servizio
+ * o un autosalvataggio: una sessione si e' interrotta e i suoi dati vanno
+ * prima recuperati avviando il programma senza argomenti. Se l'istantanea o
+ * l'archivio non si leggono, ogni comando tranne `help` fallisce.
+ *
+ * I messaggi di avanzamento di caricamento e salvataggio non vengono
+ * stampati: l'output contiene solo il risultato del comando o gli errori.
+ */
+#ifndef COMANDI_H
+#define COMANDI_H
+
+//COSTANTI PUBBLICHE
+#define COMANDO_OK 0              /**< Operazione eseguita (e dati salvati) */
+#define COMANDO_FALLITO 1         /**< Operazione rifiutata, problemi trovati o errore di I/O */
+#define COMANDO_NON_VALIDO 2      /**< Comando sconosciuto o argomenti errati */
+
+/**
+ * @brief Esegue un comando non interattivo dall'inizio alla fine.
+ * @param argc Numero di argomenti, comando compreso.
+ * @param argv Comando seguito dai suoi argomenti.
+ * @return Codice di uscita: COMANDO_OK, COMANDO_FALLITO o COMANDO_NON_VALIDO.
+ */
+int eseguiComando(int argc, char* argv[]);
+
+#endif // COMANDI_H
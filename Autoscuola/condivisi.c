@@ -0,0 +1,510 @@
+/**
+ * @file condivisi.c
+ * @brief Implementazione dell'accesso concorrente alle liste.
+ *
+ * Struttura:
+ * - un pthread_rwlock_t per lista, presi in ordine fisso
+ * - una coda di richieste di scrittura: il thread che trova la coda libera
+ *   diventa esecutore, svuota la coda ed esegue il lotto in una sola
+ *   sezione di scrittura; gli altri attendono che la propria richiesta sia
+ *   eseguita (le richieste vivono sullo stack di chi le ha fatte)
+ * - viste: la versione corrente e' un puntatore atomico a quattro copie
+ *   (CopiaLista, condivise tra versioni se la lista non e' cambiata). Chi
+ *   apre una vista scrive l'epoca corrente in un posto libero e poi legge il
+ *   puntatore; chi pubblica sostituisce il puntatore, fa avanzare l'epoca e
+ *   ritira la versione vecchia con l'epoca nuova. Una versione ritirata
+ *   all'epoca `r` e' recuperabile quando ogni posto occupato ha epoca >= r:
+ *   quei lettori hanno letto il puntatore dopo la sostituzione. Tutte le
+ *   operazioni atomiche sono sequenzialmente coerenti.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE   // pthread_rwlockattr_setkind_np
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "condivisi.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "modifiche.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define NUM_LISTE_CONDIVISE 4
+
+/**
+ * @struct RichiestaScrittura
+ * @brief Operazione in attesa di essere eseguita in un lotto.
+ */
+typedef struct RichiestaScrittura {
+    unsigned int accesso;
+    OperazioneCondivisa operazione;
+    void* contesto;
+    bool eseguita;
+    struct RichiestaScrittura* successiva;
+} RichiestaScrittura;
+
+/**
+ * @struct CopiaLista
+ * @brief Copia privata di una lista, usata da una o piu' versioni.
+ */
+typedef struct CopiaLista {
+    void* lista;
+    unsigned long generazione;       /**< Generazione globale al momento della copia */
+    int riferimenti;                 /**< Versioni che la usano */
+    struct CopiaLista* successiva;   /**< Nella riserva delle copie riutilizzabili */
+} CopiaLista;
+
+/**
+ * @struct Versione
+ * @brief Stato delle quattro liste pubblicato alla chiusura di una scrittura.
+ */
+typedef struct Versione {
+    ListeCondivise liste;                    /**< Liste delle copie, per le viste */
+    CopiaLista* copie[NUM_LISTE_CONDIVISE];
+    unsigned long epoca;                     /**< Epoca di pubblicazione */
+    unsigned long epoca_ritiro;              /**< Epoca in cui e' stata sostituita */
+    struct Versione* successiva;             /**< Nell'elenco delle versioni ritirate */
+} Versione;
+
+/**
+ * @struct DescrittoreCopia
+ * @brief Operazioni sulle copie di una lista, nell'ordine dei bit ACCESSO_*.
+ */
+typedef struct {
+    void* (*crea)(void);
+    void (*distruggi)(void* lista);
+    int (*copia)(void* copia, const void* originale, unsigned long generazione);
+    const RegistroModifiche* (*registro)(const void* lista);
+} DescrittoreCopia;
+
+/**
+ * @struct DatiCondivisi
+ * @brief Liste, lock per lista, coda delle scritture e versioni per le viste.
+ */
+struct DatiCondivisi {
+    ListeCondivise liste;
+    pthread_rwlock_t lock[NUM_LISTE_CONDIVISE];  /**< Nell'ordine dei bit ACCESSO_* */
+    pthread_mutex_t mutex_coda;
+    pthread_cond_t lotto_eseguito;
+    RichiestaScrittura* prima;                   /**< Coda in ordine di arrivo */
+    RichiestaScrittura* ultima;
+    bool lotto_in_corso;
+
+    atomic_bool viste_attive;
+    _Atomic(Versione*) corrente;                 /**< Ultima versione pubblicata */
+    atomic_ulong epoca;                          /**< Epoca corrente (da 1) */
+    atomic_ulong posti[MAX_VISTE_APERTE];        /**< Epoca fissata da ogni vista, 0 = libero */
+    pthread_mutex_t mutex_versioni;              /**< Tra scrittori: pubblicazione e recupero */
+    Versione* ritirate;
+    CopiaLista* riserva[NUM_LISTE_CONDIVISE];
+};
+
+//DESCRITTORI DELLE COPIE (PRIVATE)
+
+static void* creaA(void) { return creaListaAllievi(); }
+static void* creaP(void) { return creaListaPagamenti(); }
+static void* creaE(void) { return creaListaEsami(); }
+static void* creaG(void) { return creaListaGuide(); }
+
+static void distruggiA(void* l) { ListaAllievi* p = l; distruggiListaAllievi(&p); }
+static void distruggiP(void* l) { ListaPagamenti* p = l; distruggiListaPagamenti(&p); }
+static void distruggiE(void* l) { ListaEsami* p = l; distruggiListaEsami(&p); }
+static void distruggiG(void* l) { ListaGuide* p = l; distruggiListaGuide(&p); }
+
+static int copiaA(void* c, const void* o, unsigned long g) { return copiaModificheAllievi(c, o, g); }
+static int copiaP(void* c, const void* o, unsigned long g) { return copiaModifichePagamenti(c, o, g); }
+static int copiaE(void* c, const void* o, unsigned long g) { return copiaModificheEsami(c, o, g); }
+static int copiaG(void* c, const void* o, unsigned long g) { return copiaModificheGuide(c, o, g); }
+
+static const RegistroModifiche* registroA(const void* l) { return getRegistroModificheAllievi(l); }
+static const RegistroModifiche* registroP(const void* l) { return getRegistroModifichePagamenti(l); }
+static const RegistroModifiche* registroE(const void* l) { return getRegistroModificheEsami(l); }
+static const RegistroModifiche* registroG(const void* l) { return getRegistroModificheGuide(l); }
+
+static const DescrittoreCopia COPIE[NUM_LISTE_CONDIVISE] = {
+    { creaA, distruggiA, copiaA, registroA },
+    { creaP, distruggiP, copiaP, registroP },
+    { creaE, distruggiE, copiaE, registroE },
+    { creaG, distruggiG, copiaG, registroG }
+};
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+static void prendiLock(DatiCondivisi* d, unsigned int accesso, bool scrittura) {
+    for (int i = 0; i < NUM_LISTE_CONDIVISE; i++) {
+        if (!(accesso & (1u << i))) continue;
+        if (scrittura) {
+            pthread_rwlock_wrlock(&d->lock[i]);
+        } else {
+            pthread_rwlock_rdlock(&d->lock[i]);
+        }
+    }
+}
+
+static void rilasciaLock(DatiCondivisi* d, unsigned int accesso) {
+    for (int i = NUM_LISTE_CONDIVISE - 1; i >= 0; i--) {
+        if (accesso & (1u << i)) pthread_rwlock_unlock(&d->lock[i]);
+    }
+}
+
+static const void* listaViva(const DatiCondivisi* d, int t) {
+    switch (t) {
+        case 0: return d->liste.listaA;
+        case 1: return d->liste.listaP;
+        case 2: return d->liste.listaE;
+        default: return d->liste.listaG;
+    }
+}
+
+/**
+ * @brief Copia aggiornata della lista `t`: riusa una copia della riserva o ne crea una.
+ * @pre Il chiamante detiene la scrittura sulla lista.
+ */
+static CopiaLista* nuovaCopia(DatiCondivisi* d, int t) {
+    CopiaLista* c = d->riserva[t];
+    if (c != NULL) {
+        d->riserva[t] = c->successiva;
+    } else {
+        c = (CopiaLista*)calloc(1, sizeof(CopiaLista));
+        if (c == NULL) return NULL;
+        c->lista = COPIE[t].crea();
+        if (c->lista == NULL) {
+            free(c);
+            return NULL;
+        }
+    }
+
+    // Solo i blocchi cambiati dopo la copia precedente (0 = copia completa)
+    COPIE[t].copia(c->lista, listaViva(d, t), c->generazione);
+    c->generazione = getGenerazioneCorrente();
+    c->riferimenti = 0;
+    c->successiva = NULL;
+    return c;
+}
+
+static void rilasciaCopia(DatiCondivisi* d, int t, CopiaLista* c) {
+    if (c == NULL || --c->riferimenti > 0) return;
+    c->successiva = d->riserva[t];
+    d->riserva[t] = c;
+}
+
+static void liberaVersione(DatiCondivisi* d, Versione* v) {
+    for (int t = 0; t < NUM_LISTE_CONDIVISE; t++) {
+        rilasciaCopia(d, t, v->copie[t]);
+    }
+    free(v);
+}
+
+/**
+ * @brief Recupera le versioni ritirate che nessuna vista aperta puo' vedere.
+ * @pre mutex_versioni acquisito.
+ */
+static void recuperaVersioni(DatiCondivisi* d) {
+    unsigned long minima = (unsigned long)-1;
+    for (int i = 0; i < MAX_VISTE_APERTE; i++) {
+        unsigned long e = atomic_load(&d->posti[i]);
+        if (e != 0 && e < minima) minima = e;
+    }
+
+    Versione** p = &d->ritirate;
+    while (*p != NULL) {
+        Versione* v = *p;
+        if (v->epoca_ritiro <= minima) {
+            *p = v->successiva;
+            liberaVersione(d, v);
+        } else {
+            p = &v->successiva;
+        }
+    }
+}
+
+/**
+ * @brief Pubblica una versione con le liste modificate dalla sezione che si chiude.
+ * @pre Il chiamante detiene la scrittura sulle liste di `accesso`.
+ */
+static void pubblicaVersione(DatiCondivisi* d, unsigned int accesso) {
+    if (!atomic_load(&d->viste_attive)) return;
+
+    pthread_mutex_lock(&d->mutex_versioni);
+    recuperaVersioni(d);  // Riempie la riserva prima di copiare
+
+    Versione* vecchia = atomic_load(&d->corrente);
+    Versione* nuova = (Versione*)calloc(1, sizeof(Versione));
+    bool cambiata = false;
+    bool ok = (nuova != NULL);
+    for (int t = 0; t < NUM_LISTE_CONDIVISE && ok; t++) {
+        CopiaLista* c = vecchia->copie[t];
+        if ((accesso & (1u << t)) &&
+            COPIE[t].registro(listaViva(d, t))->generazione > c->generazione) {
+            c = nuovaCopia(d, t);
+            ok = (c != NULL);
+            cambiata = true;
+        }
+        if (ok) {
+            nuova->copie[t] = c;
+            c->riferimenti++;
+        }
+    }
+
+    if (!ok || !cambiata) {
+        // Senza memoria le viste restano sulla versione precedente: le copie
+        // verranno aggiornate alla prossima pubblicazione
+        if (!ok) printf("Attenzione: memoria insufficiente, viste non aggiornate.\n");
+        if (nuova != NULL) liberaVersione(d, nuova);
+        pthread_mutex_unlock(&d->mutex_versioni);
+        return;
+    }
+
+    nuova->liste.listaA = nuova->copie[0]->lista;
+    nuova->liste.listaP = nuova->copie[1]->lista;
+    nuova->liste.listaE = nuova->copie[2]->lista;
+    nuova->liste.listaG = nuova->copie[3]->lista;
+    nuova->epoca = atomic_load(&d->epoca) + 1;
+
+    atomic_store(&d->corrente, nuova);
+    vecchia->epoca_ritiro = atomic_fetch_add(&d->epoca, 1) + 1;
+    vecchia->successiva = d->ritirate;
+    d->ritirate = vecchia;
+
+    recuperaVersioni(d);
+    pthread_mutex_unlock(&d->mutex_versioni);
+}
+
+/**
+ * @brief Esegue in ordine le richieste del lotto in una sola sezione di scrittura.
+ */
+static void eseguiLotto(DatiCondivisi* d, RichiestaScrittura* lotto) {
+    unsigned int accesso = 0;
+    for (RichiestaScrittura* r = lotto; r != NULL; r = r->successiva) {
+        accesso |= r->accesso;
+    }
+
+    prendiLock(d, accesso, true);
+    for (RichiestaScrittura* r = lotto; r != NULL; r = r->successiva) {
+        r->operazione(&d->liste, r->contesto);
+    }
+    pubblicaVersione(d, accesso);
+    rilasciaLock(d, accesso);
+}
+
+//FUNZIONI DI CREAZIONE/DISTRUZIONE
+
+DatiCondivisi* creaDatiCondivisi(ListaAllievi* listaA, ListaPagamenti* listaP,
+                                 ListaEsami* listaE, ListaGuide* listaG) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return NULL;
+
+    DatiCondivisi* d = (DatiCondivisi*)calloc(1, sizeof(DatiCondivisi));
+    if (d == NULL) {
+        printf("Errore: memoria insufficiente.\n");
+        return NULL;
+    }
+    d->liste.listaA = listaA;
+    d->liste.listaP = listaP;
+    d->liste.listaE = listaE;
+    d->liste.listaG = listaG;
+
+    // Con la politica predefinita di glibc un flusso continuo di lettori
+    // lascerebbe gli scrittori in attesa indefinitamente
+    pthread_rwlockattr_t attributi;
+    pthread_rwlockattr_init(&attributi);
+#if defined(__GLIBC__)
+    pthread_rwlockattr_setkind_np(&attributi, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    for (int i = 0; i < NUM_LISTE_CONDIVISE; i++) {
+        pthread_rwlock_init(&d->lock[i], &attributi);
+    }
+    pthread_rwlockattr_destroy(&attributi);
+
+    pthread_mutex_init(&d->mutex_coda, NULL);
+    pthread_cond_init(&d->lotto_eseguito, NULL);
+
+    pthread_mutex_init(&d->mutex_versioni, NULL);
+    atomic_init(&d->viste_attive, false);
+    atomic_init(&d->corrente, NULL);
+    atomic_init(&d->epoca, 1);
+    for (int i = 0; i < MAX_VISTE_APERTE; i++) {
+        atomic_init(&d->posti[i], 0);
+    }
+    return d;
+}
+
+void distruggiDatiCondivisi(DatiCondivisi** dati) {
+    if (dati == NULL || *dati == NULL) return;
+
+    DatiCondivisi* d = *dati;
+    Versione* corrente = atomic_load(&d->corrente);
+    if (corrente != NULL) liberaVersione(d, corrente);
+    while (d->ritirate != NULL) {
+        Versione* v = d->ritirate;
+        d->ritirate = v->successiva;
+        liberaVersione(d, v);
+    }
+    for (int t = 0; t < NUM_LISTE_CONDIVISE; t++) {
+        while (d->riserva[t] != NULL) {
+            CopiaLista* c = d->riserva[t];
+            d->riserva[t] = c->successiva;
+            COPIE[t].distruggi(c->lista);
+            free(c);
+        }
+    }
+
+    for (int i = 0; i < NUM_LISTE_CONDIVISE; i++) {
+        pthread_rwlock_destroy(&d->lock[i]);
+    }
+    pthread_mutex_destroy(&d->mutex_coda);
+    pthread_cond_destroy(&d->lotto_eseguito);
+    pthread_mutex_destroy(&d->mutex_versioni);
+    free(d);
+    *dati = NULL;
+}
+
+//FUNZIONI DI ACCESSO (GETTER)
+
+const ListeCondivise* getListeCondivise(const DatiCondivisi* dati) {
+    return (dati != NULL) ? &dati->liste : NULL;
+}
+
+//SEZIONI
+
+void iniziaLettura(DatiCondivisi* dati, unsigned int accesso) {
+    if (dati != NULL) prendiLock(dati, accesso, false);
+}
+
+void terminaLettura(DatiCondivisi* dati, unsigned int accesso) {
+    if (dati != NULL) rilasciaLock(dati, accesso);
+}
+
+void iniziaScrittura(DatiCondivisi* dati, unsigned int accesso) {
+    if (dati != NULL) prendiLock(dati, accesso, true);
+}
+
+void terminaScrittura(DatiCondivisi* dati, unsigned int accesso) {
+    if (dati == NULL) return;
+    pubblicaVersione(dati, accesso);
+    rilasciaLock(dati, accesso);
+}
+
+void leggiCondivisi(DatiCondivisi* dati, unsigned int accesso,
+                    OperazioneCondivisa operazione, void* contesto) {
+    if (dati == NULL || operazione == NULL) return;
+
+    prendiLock(dati, accesso, false);
+    operazione(&dati->liste, contesto);
+    rilasciaLock(dati, accesso);
+}
+
+void scriviInLotto(DatiCondivisi* dati, unsigned int accesso,
+                   OperazioneCondivisa operazione, void* contesto) {
+    if (dati == NULL || operazione == NULL) return;
+
+    RichiestaScrittura richiesta = { accesso, operazione, contesto, false, NULL };
+
+    pthread_mutex_lock(&dati->mutex_coda);
+    if (dati->ultima != NULL) {
+        dati->ultima->successiva = &richiesta;
+    } else {
+        dati->prima = &richiesta;
+    }
+    dati->ultima = &richiesta;
+
+    while (!richiesta.eseguita) {
+        if (dati->lotto_in_corso) {
+            pthread_cond_wait(&dati->lotto_eseguito, &dati->mutex_coda);
+            continue;
+        }
+
+        // Nessun esecutore: questo thread esegue tutte le richieste in coda
+        RichiestaScrittura* lotto = dati->prima;
+        dati->prima = NULL;
+        dati->ultima = NULL;
+        dati->lotto_in_corso = true;
+        pthread_mutex_unlock(&dati->mutex_coda);
+
+        eseguiLotto(dati, lotto);
+
+        pthread_mutex_lock(&dati->mutex_coda);
+        for (RichiestaScrittura* r = lotto; r != NULL; r = r->successiva) {
+            r->eseguita = true;
+        }
+        dati->lotto_in_corso = false;
+        pthread_cond_broadcast(&dati->lotto_eseguito);
+    }
+    pthread_mutex_unlock(&dati->mutex_coda);
+}
+
+//VISTE COERENTI
+
+bool attivaVisteCondivise(DatiCondivisi* dati) {
+    if (dati == NULL) return false;
+
+    prendiLock(dati, ACCESSO_TUTTE, true);
+    pthread_mutex_lock(&dati->mutex_versioni);
+    bool ok = true;
+    if (!atomic_load(&dati->viste_attive)) {
+        Versione* v = (Versione*)calloc(1, sizeof(Versione));
+        ok = (v != NULL);
+        for (int t = 0; t < NUM_LISTE_CONDIVISE && ok; t++) {
+            v->copie[t] = nuovaCopia(dati, t);
+            ok = (v->copie[t] != NULL);
+            if (ok) v->copie[t]->riferimenti = 1;
+        }
+
+        if (ok) {
+            v->liste.listaA = v->copie[0]->lista;
+            v->liste.listaP = v->copie[1]->lista;
+            v->liste.listaE = v->copie[2]->lista;
+            v->liste.listaG = v->copie[3]->lista;
+            v->epoca = atomic_load(&dati->epoca);
+            atomic_store(&dati->corrente, v);
+            atomic_store(&dati->viste_attive, true);
+        } else {
+            printf("Errore: memoria insufficiente per le viste.\n");
+            if (v != NULL) liberaVersione(dati, v);
+        }
+    }
+    pthread_mutex_unlock(&dati->mutex_versioni);
+    rilasciaLock(dati, ACCESSO_TUTTE);
+    return ok;
+}
+
+bool apriVista(DatiCondivisi* dati, VistaCondivisa* vista) {
+    if (vista == NULL) return false;
+    vista->liste = NULL;
+    if (dati == NULL || !atomic_load(&dati->viste_attive)) return false;
+
+    for (int i = 0; i < MAX_VISTE_APERTE; i++) {
+        unsigned long libero = 0;
+        unsigned long epoca = atomic_load(&dati->epoca);
+        if (!atomic_compare_exchange_strong(&dati->posti[i], &libero, epoca)) continue;
+
+        // L'epoca e' fissata: la versione letta ora non verra' recuperata
+        Versione* v = atomic_load(&dati->corrente);
+        vista->liste = &v->liste;
+        vista->epoca = v->epoca;
+        vista->posto = i;
+        return true;
+    }
+    return false;
+}
+
+void chiudiVista(DatiCondivisi* dati, VistaCondivisa* vista) {
+    if (dati == NULL || vista == NULL || vista->liste == NULL) return;
+
+    atomic_store(&dati->posti[vista->posto], 0);
+    vista->liste = NULL;
+}
+
+bool leggiVista(DatiCondivisi* dati, OperazioneCondivisa operazione, void* contesto) {
+    if (operazione == NULL) return false;
+
+    VistaCondivisa vista;
+    if (!apriVista(dati, &vista)) return false;
+    operazione(vista.liste, contesto);
+    chiudiVista(dati, &vista);
+    return true;
+}
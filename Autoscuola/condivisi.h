@@ -0,0 +1,229 @@
+/**
+ * @file condivisi.h
+ * @brief Accesso concorrente alle quattro liste (lock lettori/scrittori).
+ *
+ * Le liste degli ADT non sono protette: vanno usate da un thread alla
+ * volta. Chi vuole lavorarci da piu' thread (servizi in background,
+ * resoconti, piu' postazioni) le affida a un DatiCondivisi e vi accede solo
+ * dentro una sezione:
+ * - lettura: piu' lettori insieme sulle stesse liste
+ * - scrittura: un solo scrittore per lista, nessun lettore
+ *
+ * Ogni sezione dichiara le liste che usa (maschera di ACCESSO_*); i lock
+ * vengono presi sempre nello stesso ordine (allievi, pagamenti, esami,
+ * guide), quindi sezioni su liste diverse procedono in parallelo senza
+ * rischio di stallo. Gli scrittori hanno la precedenza sui nuovi lettori.
+ *
+ * scriviInLotto() raggruppa le scritture concorrenti: la prima arrivata
+ * apre una sola sezione di scrittura ed esegue anche le operazioni accodate
+ * nel frattempo dagli altri thread, che attendono il completamento della
+ * propria. Molte scritture brevi costano cosi' poche acquisizioni dei lock.
+ *
+ * Uso tipico:
+ *
+ *     iniziaLettura(dati, ACCESSO_ALLIEVI | ACCESSO_PAGAMENTI);
+ *     const Allievo* a = cercaAllievoPerID(getListeCondivise(dati)->listaA, id);
+ *     ...
+ *     terminaLettura(dati, ACCESSO_ALLIEVI | ACCESSO_PAGAMENTI);
+ *
+ * Viste coerenti (versioni multiple): le letture lunghe, come un resoconto
+ * completo, in una sezione di lettura fermerebbero gli scrittori per tutta
+ * la loro durata. Con attivaVisteCondivise() ogni sezione di scrittura, alla
+ * chiusura, pubblica una nuova versione delle liste: copie private
+ * aggiornate con i soli blocchi modificati (vedi modifiche.h), sostituite
+ * tutte insieme con un'unica operazione atomica. Una vista fissa l'epoca
+ * corrente e legge la versione pubblicata in quel momento, che resta
+ * invariata finche' la vista e' aperta: vede tutte le scritture di una
+ * sezione o nessuna. Aprire e chiudere una vista non prende lock, quindi i
+ * resoconti non fermano mai gli scrittori (e viceversa). Le versioni che
+ * nessuna vista puo' piu' vedere vengono recuperate dagli scrittori
+ * (recupero per epoche) e le loro copie riusate per le versioni successive.
+ * Le copie conservano le generazioni dei record, quindi anche su una vista
+ * il resoconto riformatta solo gli allievi modificati.
+ *
+ *     VistaCondivisa vista;
+ *     if (apriVista(dati, &vista)) {
+ *         esportaResocontoCompleto(vista.liste->listaA, vista.liste->listaP,
+ *                                  vista.liste->listaE, vista.liste->listaG);
+ *         chiudiVista(dati, &vista);
+ *     }
+ */
+#ifndef CONDIVISI_H
+#define CONDIVISI_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define ACCESSO_ALLIEVI   0x1u
+#define ACCESSO_PAGAMENTI 0x2u
+#define ACCESSO_ESAMI     0x4u
+#define ACCESSO_GUIDE     0x8u
+#define ACCESSO_TUTTE     0xFu
+
+#define MAX_VISTE_APERTE 64   /**< Viste aperte contemporaneamente */
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+typedef struct DatiCondivisi DatiCondivisi;
+
+/**
+ * @struct ListeCondivise
+ * @brief Le quattro liste affidate a un DatiCondivisi.
+ */
+typedef struct {
+    ListaAllievi* listaA;
+    ListaPagamenti* listaP;
+    ListaEsami* listaE;
+    ListaGuide* listaG;
+} ListeCondivise;
+
+/**
+ * @brief Operazione eseguita dentro una sezione.
+ * @param liste Liste (da usare solo quelle dichiarate nella maschera).
+ * @param contesto Dati dell'operazione.
+ */
+typedef void (*OperazioneCondivisa)(const ListeCondivise* liste, void* contesto);
+
+/**
+ * @struct VistaCondivisa
+ * @brief Vista aperta con apriVista() su una versione delle liste.
+ */
+typedef struct {
+    const ListeCondivise* liste;  /**< Copie in sola lettura, NULL se la vista e' chiusa */
+    unsigned long epoca;          /**< Epoca in cui la versione e' stata pubblicata */
+    int posto;                    /**< Uso interno */
+} VistaCondivisa;
+
+//FUNZIONI DI CREAZIONE/DISTRUZIONE
+
+/**
+ * @brief Affida le quattro liste a un nuovo DatiCondivisi.
+ *
+ * Da questo momento le liste vanno usate solo dentro le sezioni.
+ *
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @return Puntatore ai dati condivisi, NULL per argomenti non validi o memoria insufficiente.
+ */
+DatiCondivisi* creaDatiCondivisi(ListaAllievi* listaA, ListaPagamenti* listaP,
+                                 ListaEsami* listaE, ListaGuide* listaG);
+
+/**
+ * @brief Libera lock e versioni (le liste restano al chiamante). Nessuna sezione o vista deve essere aperta.
+ * @param dati Indirizzo del puntatore (azzerato).
+ */
+void distruggiDatiCondivisi(DatiCondivisi** dati);
+
+//FUNZIONI DI ACCESSO (GETTER)
+
+/**
+ * @brief Liste affidate ai dati condivisi.
+ * @param dati Dati condivisi.
+ * @return Le quattro liste, NULL se `dati` e' NULL.
+ */
+const ListeCondivise* getListeCondivise(const DatiCondivisi* dati);
+
+//SEZIONI
+
+/**
+ * @brief Apre una sezione di lettura sulle liste indicate (attende gli scrittori in corso).
+ * @param dati Dati condivisi.
+ * @param accesso Maschera di ACCESSO_*.
+ */
+void iniziaLettura(DatiCondivisi* dati, unsigned int accesso);
+
+/**
+ * @brief Chiude una sezione aperta con iniziaLettura() con la stessa maschera.
+ * @param dati Dati condivisi.
+ * @param accesso Maschera usata all'apertura.
+ */
+void terminaLettura(DatiCondivisi* dati, unsigned int accesso);
+
+/**
+ * @brief Apre una sezione di scrittura esclusiva sulle liste indicate.
+ * @param dati Dati condivisi.
+ * @param accesso Maschera di ACCESSO_*.
+ */
+void iniziaScrittura(DatiCondivisi* dati, unsigned int accesso);
+
+/**
+ * @brief Chiude una sezione aperta con iniziaScrittura() con la stessa maschera.
+ * @param dati Dati condivisi.
+ * @param accesso Maschera usata all'apertura.
+ */
+void terminaScrittura(DatiCondivisi* dati, unsigned int accesso);
+
+/**
+ * @brief Esegue un'operazione in una sezione di lettura.
+ * @param dati Dati condivisi.
+ * @param accesso Liste lette dall'operazione.
+ * @param operazione Operazione (non deve modificare le liste).
+ * @param contesto Passato all'operazione.
+ */
+void leggiCondivisi(DatiCondivisi* dati, unsigned int accesso,
+                    OperazioneCondivisa operazione, void* contesto);
+
+/**
+ * @brief Esegue un'operazione di scrittura, raggruppata con quelle concorrenti.
+ *
+ * Se un altro thread sta gia' eseguendo un lotto, l'operazione viene
+ * accodata ed eseguita da lui nel lotto successivo; in ogni caso la funzione
+ * ritorna solo a operazione eseguita. Le operazioni di un lotto vengono
+ * eseguite nell'ordine di arrivo, in una sola sezione di scrittura sulle
+ * liste richieste da tutte.
+ *
+ * @param dati Dati condivisi.
+ * @param accesso Liste modificate (o lette) dall'operazione.
+ * @param operazione Operazione da eseguire.
+ * @param contesto Passato all'operazione.
+ */
+void scriviInLotto(DatiCondivisi* dati, unsigned int accesso,
+                   OperazioneCondivisa operazione, void* contesto);
+
+//VISTE COERENTI
+
+/**
+ * @brief Attiva le viste: da ora ogni sezione di scrittura pubblica una versione.
+ *
+ * Crea la prima versione copiando per intero le quattro liste (attende gli
+ * scrittori in corso). Chiamarla di nuovo non ha effetto.
+ *
+ * @param dati Dati condivisi.
+ * @return true se le viste sono attive, false per memoria insufficiente.
+ */
+bool attivaVisteCondivise(DatiCondivisi* dati);
+
+/**
+ * @brief Apre una vista sull'ultima versione pubblicata, senza attendere nessuno.
+ *
+ * Le liste della vista vanno usate solo con le funzioni di lettura (ricerca,
+ * stampa, resoconti) e non dopo chiudiVista().
+ *
+ * @param dati Dati condivisi.
+ * @param vista Riceve la vista.
+ * @return true se aperta, false se le viste non sono attive o ce ne sono gia' MAX_VISTE_APERTE.
+ */
+bool apriVista(DatiCondivisi* dati, VistaCondivisa* vista);
+
+/**
+ * @brief Chiude una vista; la sua versione potra' essere recuperata.
+ * @param dati Dati condivisi.
+ * @param vista Vista aperta con apriVista() (chiuderla di nuovo non ha effetto).
+ */
+void chiudiVista(DatiCondivisi* dati, VistaCondivisa* vista);
+
+/**
+ * @brief Esegue un'operazione su una vista aperta per l'occasione.
+ * @param dati Dati condivisi.
+ * @param operazione Operazione di sola lettura.
+ * @param contesto Passato all'operazione.
+ * @return true se eseguita, false se non e' stato possibile aprire la vista.
+ */
+bool leggiVista(DatiCondivisi* dati, OperazioneCondivisa operazione, void* contesto);
+
+#endif // CONDIVISI_H
@@ -16,37 +16,272 @@
 #include <ctype.h>
 #include "difensiva.h"
 
-//VALIDAZIONE STRINGHE E FORMATI
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CF_SSE2 1
+#endif
+#if defined(CF_SSE2) && defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define CF_AVX2 1
+#endif
 
-bool validaCodiceFiscale(const char* codice_fiscale) {
-    if (codice_fiscale == NULL) return false;
+//VALIDAZIONE CODICE FISCALE (PRIVATE)
 
-    size_t len = strlen(codice_fiscale);
-    if (len != 16) return false;
+#define LUNGHEZZA_CF 16
 
+/**
+ * @brief Controlla le 16 posizioni di un codice fiscale (senza guardare il terminatore).
+ */
+static bool formatoCFValido(const char* codice_fiscale) {
     // Primi 6 caratteri alfabetici (cognome + nome)
     for (int i = 0; i < 6; i++) {
-        if (!isalpha(codice_fiscale[i])) return false;
+        if (!isalpha((unsigned char)codice_fiscale[i])) return false;
     }
 
     // Caratteri 7-8: anno (numerici)
-    if (!isdigit(codice_fiscale[6]) || !isdigit(codice_fiscale[7])) return false;
+    if (!isdigit((unsigned char)codice_fiscale[6]) || !isdigit((unsigned char)codice_fiscale[7])) return false;
 
     // Carattere 9: mese (alfabetico)
-    if (!isalpha(codice_fiscale[8])) return false;
+    if (!isalpha((unsigned char)codice_fiscale[8])) return false;
 
     // Caratteri 10-11: giorno (numerici)
-    if (!isdigit(codice_fiscale[9]) || !isdigit(codice_fiscale[10])) return false;
+    if (!isdigit((unsigned char)codice_fiscale[9]) || !isdigit((unsigned char)codice_fiscale[10])) return false;
 
     // Caratteri 12-15: codice comune (alfanumerici)
     for (int i = 11; i < 15; i++) {
-        if (!isalnum(codice_fiscale[i])) return false;
+        if (!isalnum((unsigned char)codice_fiscale[i])) return false;
     }
 
     // Carattere 16: carattere di controllo (alfabetico)
-    if (!isalpha(codice_fiscale[15])) return false;
+    return isalpha((unsigned char)codice_fiscale[15]) != 0;
+}
 
-    return true;
+/*
+ * Tabelle del carattere di controllo, indicizzate con il byte del carattere
+ * (maiuscole e minuscole hanno lo stesso valore). Il valore 0 di una cifra o
+ * lettera non ammessa non conta: il formato viene controllato a parte.
+ */
+#define CF_LETTERA(c, v) [c] = (v), [(c) | 0x20] = (v)
+
+/** Valore dei caratteri in posizione dispari (1a, 3a, ..., 15a) */
+static const unsigned char VALORE_DISPARI_CF[256] = {
+    ['0'] = 1,  ['1'] = 0,  ['2'] = 5,  ['3'] = 7,  ['4'] = 9,
+    ['5'] = 13, ['6'] = 15, ['7'] = 17, ['8'] = 19, ['9'] = 21,
+    CF_LETTERA('A', 1),  CF_LETTERA('B', 0),  CF_LETTERA('C', 5),  CF_LETTERA('D', 7),
+    CF_LETTERA('E', 9),  CF_LETTERA('F', 13), CF_LETTERA('G', 15), CF_LETTERA('H', 17),
+    CF_LETTERA('I', 19), CF_LETTERA('J', 21), CF_LETTERA('K', 2),  CF_LETTERA('L', 4),
+    CF_LETTERA('M', 18), CF_LETTERA('N', 20), CF_LETTERA('O', 11), CF_LETTERA('P', 3),
+    CF_LETTERA('Q', 6),  CF_LETTERA('R', 8),  CF_LETTERA('S', 12), CF_LETTERA('T', 14),
+    CF_LETTERA('U', 16), CF_LETTERA('V', 10), CF_LETTERA('W', 22), CF_LETTERA('X', 25),
+    CF_LETTERA('Y', 24), CF_LETTERA('Z', 23)
+};
+
+/** Valore dei caratteri in posizione pari (2a, 4a, ..., 14a): cifra o indice della lettera */
+static const unsigned char VALORE_PARI_CF[256] = {
+    ['0'] = 0,  ['1'] = 1,  ['2'] = 2,  ['3'] = 3,  ['4'] = 4,
+    ['5'] = 5,  ['6'] = 6,  ['7'] = 7,  ['8'] = 8,  ['9'] = 9,
+    CF_LETTERA('A', 0),  CF_LETTERA('B', 1),  CF_LETTERA('C', 2),  CF_LETTERA('D', 3),
+    CF_LETTERA('E', 4),  CF_LETTERA('F', 5),  CF_LETTERA('G', 6),  CF_LETTERA('H', 7),
+    CF_LETTERA('I', 8),  CF_LETTERA('J', 9),  CF_LETTERA('K', 10), CF_LETTERA('L', 11),
+    CF_LETTERA('M', 12), CF_LETTERA('N', 13), CF_LETTERA('O', 14), CF_LETTERA('P', 15),
+    CF_LETTERA('Q', 16), CF_LETTERA('R', 17), CF_LETTERA('S', 18), CF_LETTERA('T', 19),
+    CF_LETTERA('U', 20), CF_LETTERA('V', 21), CF_LETTERA('W', 22), CF_LETTERA('X', 23),
+    CF_LETTERA('Y', 24), CF_LETTERA('Z', 25)
+};
+
+/** Giorni del mese codificato dalla lettera in 9a posizione (0: lettera non valida, febbraio 29) */
+static const unsigned char GIORNI_MESE_CF[256] = {
+    CF_LETTERA('A', 31), CF_LETTERA('B', 29), CF_LETTERA('C', 31), CF_LETTERA('D', 30),
+    CF_LETTERA('E', 31), CF_LETTERA('H', 30), CF_LETTERA('L', 31), CF_LETTERA('M', 31),
+    CF_LETTERA('P', 30), CF_LETTERA('R', 31), CF_LETTERA('S', 30), CF_LETTERA('T', 31)
+};
+
+/**
+ * @brief Mese (9a lettera) e giorno (caratteri 10-11, +40 per le donne) coerenti.
+ */
+static bool dataCFCoerente(const char* codice_fiscale) {
+    const unsigned char* c = (const unsigned char*)codice_fiscale;
+    if (!isdigit(c[9]) || !isdigit(c[10])) return false;
+
+    int giorno = (c[9] - '0') * 10 + (c[10] - '0');
+    if (giorno > 40) giorno -= 40;
+    return giorno >= 1 && giorno <= GIORNI_MESE_CF[c[8]];
+}
+
+/**
+ * @brief Carattere di controllo atteso per i primi 15 caratteri, '\0' se uno non e' alfanumerico.
+ */
+static char carattereControlloCF(const char* codice_fiscale) {
+    const unsigned char* c = (const unsigned char*)codice_fiscale;
+    unsigned int somma = 0;
+    for (int i = 0; i < LUNGHEZZA_CF - 1; i++) {
+        if (!isalnum(c[i])) return '\0';
+        somma += (i % 2 == 0) ? VALORE_DISPARI_CF[c[i]] : VALORE_PARI_CF[c[i]];
+    }
+    return (char)('A' + somma % 26);
+}
+
+static bool controlloCFCorretto(const char* codice_fiscale) {
+    char atteso = carattereControlloCF(codice_fiscale);
+    return atteso != '\0' && toupper((unsigned char)codice_fiscale[LUNGHEZZA_CF - 1]) == atteso;
+}
+
+/**
+ * @brief Vero se il codice in posizione e' seguito dal terminatore (o i codici sono contigui).
+ */
+static inline bool terminatoreCF(const char* codice_fiscale, size_t passo) {
+    return passo == LUNGHEZZA_CF || codice_fiscale[LUNGHEZZA_CF] == '\0';
+}
+
+#if defined(CF_SSE2)
+
+/*
+ * Classi richieste per posizione, come maschere di byte: una posizione
+ * alfanumerica compare in entrambe. Un byte e' alfabetico se (c | 0x20) - 'a'
+ * vale al piu' 25 e numerico se c - '0' vale al piu' 9 (confronti senza segno
+ * fatti con min_epu8), cioe' le classi di ctype.h nella localizzazione "C".
+ */
+static const unsigned char MASCHERA_ALFA_CF[LUNGHEZZA_CF] __attribute__((aligned(16))) = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
+    0xFF, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+static const unsigned char MASCHERA_CIFRA_CF[LUNGHEZZA_CF] __attribute__((aligned(16))) = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00
+};
+
+/**
+ * @brief Byte a 0xFF nelle posizioni la cui classe corrisponde allo schema.
+ */
+static inline __m128i classiCF_SSE2(__m128i c) {
+    __m128i lettera = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i cifra = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i e_lettera = _mm_cmpeq_epi8(_mm_min_epu8(lettera, _mm_set1_epi8(25)), lettera);
+    __m128i e_cifra = _mm_cmpeq_epi8(_mm_min_epu8(cifra, _mm_set1_epi8(9)), cifra);
+    return _mm_or_si128(_mm_and_si128(e_lettera, _mm_load_si128((const __m128i*)MASCHERA_ALFA_CF)),
+                        _mm_and_si128(e_cifra, _mm_load_si128((const __m128i*)MASCHERA_CIFRA_CF)));
+}
+
+static size_t validaBloccoCF_SSE2(const char* codici, size_t n, size_t passo, uint64_t* validi) {
+    size_t conteggio = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* cf = codici + i * passo;
+        __m128i ok = classiCF_SSE2(_mm_loadu_si128((const __m128i*)cf));
+        if (_mm_movemask_epi8(ok) == 0xFFFF && terminatoreCF(cf, passo)) {
+            validi[i / 64] |= (uint64_t)1 << (i % 64);
+            conteggio++;
+        }
+    }
+    return conteggio;
+}
+#endif
+
+#if defined(CF_AVX2)
+
+/**
+ * @brief Come validaBloccoCF_SSE2, ma due codici per registro (scelta a tempo di esecuzione).
+ */
+__attribute__((target("avx2")))
+static size_t validaBloccoCF_AVX2(const char* codici, size_t n, size_t passo, uint64_t* validi) {
+    const __m256i alfa = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)MASCHERA_ALFA_CF));
+    const __m256i cifra_attesa = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)MASCHERA_CIFRA_CF));
+    size_t conteggio = 0;
+    size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        const char* cf = codici + i * passo;
+        __m256i c = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)cf)),
+            _mm_loadu_si128((const __m128i*)(cf + passo)), 1);
+        __m256i lettera = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i cifra = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+        __m256i e_lettera = _mm256_cmpeq_epi8(_mm256_min_epu8(lettera, _mm256_set1_epi8(25)), lettera);
+        __m256i e_cifra = _mm256_cmpeq_epi8(_mm256_min_epu8(cifra, _mm256_set1_epi8(9)), cifra);
+        __m256i ok = _mm256_or_si256(_mm256_and_si256(e_lettera, alfa), _mm256_and_si256(e_cifra, cifra_attesa));
+        unsigned int maschera = (unsigned int)_mm256_movemask_epi8(ok);
+
+        for (size_t k = 0; k < 2; k++) {
+            if (((maschera >> (16 * k)) & 0xFFFF) == 0xFFFF && terminatoreCF(cf + k * passo, passo)) {
+                validi[(i + k) / 64] |= (uint64_t)1 << ((i + k) % 64);
+                conteggio++;
+            }
+        }
+    }
+    if (i < n) {
+        // Codice dispari in coda
+        const char* cf = codici + i * passo;
+        __m128i ok = classiCF_SSE2(_mm_loadu_si128((const __m128i*)cf));
+        if (_mm_movemask_epi8(ok) == 0xFFFF && terminatoreCF(cf, passo)) {
+            validi[i / 64] |= (uint64_t)1 << (i % 64);
+            conteggio++;
+        }
+    }
+    return conteggio;
+}
+#endif
+
+#if !defined(CF_SSE2)
+/**
+ * @brief Controllo in blocco senza SIMD (architetture diverse da x86).
+ */
+static size_t validaBloccoCFScalare(const char* codici, size_t n, size_t passo, uint64_t* validi) {
+    size_t conteggio = 0;
+    for (size_t i = 0; i < n; i++) {
+        const char* cf = codici + i * passo;
+        if (terminatoreCF(cf, passo) && formatoCFValido(cf)) {
+            validi[i / 64] |= (uint64_t)1 << (i % 64);
+            conteggio++;
+        }
+    }
+    return conteggio;
+}
+#endif
+
+//VALIDAZIONE STRINGHE E FORMATI
+
+bool validaCodiceFiscale(const char* codice_fiscale) {
+    if (codice_fiscale == NULL) return false;
+
+    size_t len = strlen(codice_fiscale);
+    if (len != LUNGHEZZA_CF) return false;
+
+    return formatoCFValido(codice_fiscale);
+}
+
+bool verificaDataCodiceFiscale(const char* codice_fiscale) {
+    if (codice_fiscale == NULL || strlen(codice_fiscale) != LUNGHEZZA_CF) return false;
+    return dataCFCoerente(codice_fiscale);
+}
+
+char calcolaControlloCodiceFiscale(const char* codice_fiscale) {
+    if (codice_fiscale == NULL) return '\0';
+    return carattereControlloCF(codice_fiscale);
+}
+
+bool verificaControlloCodiceFiscale(const char* codice_fiscale) {
+    if (codice_fiscale == NULL || strlen(codice_fiscale) != LUNGHEZZA_CF) return false;
+    return controlloCFCorretto(codice_fiscale);
+}
+
+bool verificaCodiceFiscale(const char* codice_fiscale) {
+    if (codice_fiscale == NULL || strlen(codice_fiscale) != LUNGHEZZA_CF) return false;
+    return formatoCFValido(codice_fiscale) && dataCFCoerente(codice_fiscale) &&
+           controlloCFCorretto(codice_fiscale);
+}
+
+size_t validaCodiciFiscaliInBlocco(const char* codici, size_t n, size_t passo, uint64_t* validi) {
+    if (validi == NULL || n == 0) return 0;
+    memset(validi, 0, PAROLE_BITMAP_CF(n) * sizeof(uint64_t));
+    if (codici == NULL || passo < LUNGHEZZA_CF) return 0;
+
+#if defined(CF_AVX2)
+    if (__builtin_cpu_supports("avx2")) return validaBloccoCF_AVX2(codici, n, passo, validi);
+#endif
+#if defined(CF_SSE2)
+    return validaBloccoCF_SSE2(codici, n, passo, validi);
+#else
+    return validaBloccoCFScalare(codici, n, passo, validi);
+#endif
 }
 
 bool validaStato(const char* stato) {
@@ -16,6 +16,11 @@
 #define DIFENSIVA_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//COSTANTI PUBBLICHE
+#define PAROLE_BITMAP_CF(n) (((n) + 63) / 64) /**< Parole a 64 bit della bitmap per `n` codici */
 
 //VALIDAZIONE STRINGHE E FORMATI
 
@@ -31,11 +36,77 @@
  * - Caratteri 12-15 alfanumerici
  * - Carattere 16 alfabetico (check)
  *
+ * Il valore del carattere di controllo non viene verificato: vedi
+ * verificaCodiceFiscale().
+ *
  * @param codice_fiscale Stringa da validare (16 caratteri).
  * @return true se valido, false altrimenti.
  */
 bool validaCodiceFiscale(const char* codice_fiscale);
 
+/**
+ * @brief Verifica la data di nascita codificata in un codice fiscale.
+ *
+ * La 9a lettera deve indicare un mese (A B C D E H L M P R S T) e i
+ * caratteri 10-11 un giorno di quel mese, aumentato di 40 per le donne
+ * (febbraio fino al 29: l'anno ha due sole cifre).
+ *
+ * @param codice_fiscale Codice di 16 caratteri.
+ * @return true se mese e giorno sono coerenti, false altrimenti.
+ */
+bool verificaDataCodiceFiscale(const char* codice_fiscale);
+
+/**
+ * @brief Calcola il carattere di controllo dai primi 15 caratteri.
+ *
+ * Algoritmo ufficiale: somma dei valori dei caratteri in posizione dispari
+ * e pari (tabelle diverse), modulo 26, convertita in lettera.
+ *
+ * @param codice_fiscale Codice di almeno 15 caratteri (maiuscole o minuscole).
+ * @return Lettera maiuscola attesa in 16a posizione, '\0' se un carattere non e' alfanumerico.
+ */
+char calcolaControlloCodiceFiscale(const char* codice_fiscale);
+
+/**
+ * @brief Verifica il carattere di controllo (16a posizione) di un codice fiscale.
+ * @param codice_fiscale Codice di 16 caratteri.
+ * @return true se coincide con calcolaControlloCodiceFiscale(), false altrimenti.
+ */
+bool verificaControlloCodiceFiscale(const char* codice_fiscale);
+
+/**
+ * @brief Verifica completa di un codice fiscale.
+ *
+ * validaCodiceFiscale(), verificaDataCodiceFiscale() e
+ * verificaControlloCodiceFiscale() insieme: oltre al formato controlla il
+ * mese, il giorno e il carattere di controllo, dove si manifesta la maggior
+ * parte degli errori di battitura. Usa solo tabelle costanti.
+ *
+ * @param codice_fiscale Stringa da verificare.
+ * @return true se il codice e' corretto, false altrimenti.
+ */
+bool verificaCodiceFiscale(const char* codice_fiscale);
+
+/**
+ * @brief Valida il formato di molti codici fiscali in una sola chiamata.
+ *
+ * Applica le stesse regole di validaCodiceFiscale() a `n` codici posti a
+ * distanza di `passo` byte (es. il campo codice fiscale di un array di
+ * strutture). Se `passo` supera 16, il byte dopo i 16 caratteri deve essere
+ * il terminatore; con `passo` uguale a 16 i codici sono contigui e senza
+ * terminatore. Vengono sempre letti 16 byte per codice.
+ *
+ * Dove disponibile il controllo usa SSE2 o AVX2 (scelto a tempo di
+ * esecuzione), altrimenti la versione scalare; il risultato e' lo stesso.
+ *
+ * @param codici Primo codice.
+ * @param n Numero di codici.
+ * @param passo Distanza in byte tra un codice e il successivo (>= 16).
+ * @param validi Bitmap di PAROLE_BITMAP_CF(n) parole: il bit i e' 1 se il codice i e' valido.
+ * @return Numero di codici validi.
+ */
+size_t validaCodiciFiscaliInBlocco(const char* codici, size_t n, size_t passo, uint64_t* validi);
+
 /**
  * @brief Valida uno stato allievo.
  * @param stato Stato da validare (es. "iscritto", "sospeso").
@@ -17,9 +17,15 @@
 #include "pagamenti.h"  // Per setRata, azzeraPagamento
 #include "guida.h"      // Per getOreSvolte
 #include "util.h"
+#include "indice.h"
+#include "modifiche.h"
+#include "codifica.h"
+#include "formato.h"
 
 //DEFINIZIONI STRUTTURE (PRIVATO)
 #define MAX_ESAMI 100
+#define TABELLA_ESAMI 'E' /**< Identificativo della tabella nel formato codificato */
+#define MAX_ESAME_CODIFICATO (sizeof(Esame) + CODIFICA_MAX_VARINT)
 
 /**
  * @struct Esame
@@ -42,20 +48,248 @@ struct Esame {
 struct ListaEsami {
     Esame elenco_esami[MAX_ESAMI];
     int n_esami;
+    IndiceID indice_id; /**< Posizione dei record per ID allievo */
+    RegistroModifiche modifiche; /**< Generazioni di modifica per record e blocco */
 };
 
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Penalita' del secondo teorico fallito: sospensione e prima rata da ripagare.
+ */
+static void applicaPenalitaTeorico(int id_allievo, void* listaA, void* listaP) {
+    // Cast dei puntatori void
+    ListaAllievi* allievi = (ListaAllievi*)listaA;
+    ListaPagamenti* pagamenti = (ListaPagamenti*)listaP;
+
+    if (allievi != NULL) {
+        Allievo* a = cercaAllievoPerID(allievi, id_allievo);
+        if (a != NULL) {
+            setAllievoStato(a, "sospeso");
+        }
+    }
+
+    if (pagamenti != NULL) {
+        Pagamento* p = cercaPagamentoPerID(pagamenti, id_allievo);
+        if (p != NULL) {
+            setRata(p, 1, 250.0);
+        }
+    }
+}
+
+/**
+ * @brief Penalita' del secondo pratico fallito: tutte le rate da ripagare.
+ */
+static void applicaPenalitaPratico(int id_allievo, void* listaP) {
+    ListaPagamenti* pagamenti = (ListaPagamenti*)listaP;
+    if (pagamenti != NULL) {
+        Pagamento* p = cercaPagamentoPerID(pagamenti, id_allievo);
+        if (p != NULL) {
+            setRata(p, 1, 250.0);
+            setRata(p, 2, 250.0);
+            setRata(p, 3, 250.0);
+        }
+    }
+}
+
+/**
+ * @brief Ricostruisce l'indice per ID a partire dall'elenco corrente.
+ */
+static void ricostruisciIndiceEsami(ListaEsami* lista) {
+    svuotaIndice(&lista->indice_id);
+    for (int i = 0; i < lista->n_esami; i++) {
+        inserisciInIndice(&lista->indice_id, lista->elenco_esami[i].id_allievo, i);
+    }
+}
+
+/**
+ * @brief Codifica una data come tre interi zigzag (giorno, mese, anno).
+ */
+static bool codificaData(const Data* d, Buffer* buf) {
+    return scriviVarintConSegno(buf, d->giorno) &&
+           scriviVarintConSegno(buf, d->mese) &&
+           scriviVarintConSegno(buf, d->anno);
+}
+
+/**
+ * @brief Indica se una data e' stata registrata (le date mai usate sono azzerate).
+ */
+static bool isDataPresente(const Data* d) {
+    return d->giorno != 0 || d->mese != 0 || d->anno != 0;
+}
+
+/**
+ * @brief Codifica un esame: ID come differenza dal precedente, contatori, poi
+ * maschera delle date registrate seguita solo da quelle.
+ */
+static bool codificaEsame(const Esame* e, int id_precedente, Buffer* buf) {
+    const Data* date[4] = { &e->dataTeorico[0], &e->dataTeorico[1],
+                            &e->dataPratico[0], &e->dataPratico[1] };
+    unsigned char maschera = 0;
+    for (int i = 0; i < 4; i++) {
+        if (isDataPresente(date[i])) maschera |= (unsigned char)(1u << i);
+    }
+
+    bool ok = scriviVarintConSegno(buf, (int64_t)e->id_allievo - id_precedente) &&
+              scriviVarintConSegno(buf, e->tentativiTeorico) &&
+              scriviVarintConSegno(buf, e->tentativiPratico) &&
+              scriviVarintConSegno(buf, e->superatoTeorico) &&
+              scriviVarintConSegno(buf, e->superatoPratico) &&
+              scriviByte(buf, maschera);
+    for (int i = 0; i < 4 && ok; i++) {
+        if (maschera & (1u << i)) ok = codificaData(date[i], buf);
+    }
+    return ok;
+}
+
+/**
+ * @brief Decodifica un esame scritto da codificaEsame().
+ */
+static bool decodificaEsame(Lettore* lettore, Esame* e, int* id) {
+    *id += (int)leggiVarintConSegno(lettore);
+    e->id_allievo = *id;
+    e->tentativiTeorico = (int)leggiVarintConSegno(lettore);
+    e->tentativiPratico = (int)leggiVarintConSegno(lettore);
+    e->superatoTeorico = (int)leggiVarintConSegno(lettore);
+    e->superatoPratico = (int)leggiVarintConSegno(lettore);
+
+    unsigned char maschera = leggiByte(lettore);
+    if (maschera > 0x0F) return false;
+
+    Data* date[4] = { &e->dataTeorico[0], &e->dataTeorico[1],
+                      &e->dataPratico[0], &e->dataPratico[1] };
+    for (int i = 0; i < 4; i++) {
+        *date[i] = (Data){0, 0, 0};
+        if (maschera & (1u << i)) {
+            date[i]->giorno = (int)leggiVarintConSegno(lettore);
+            date[i]->mese = (int)leggiVarintConSegno(lettore);
+            date[i]->anno = (int)leggiVarintConSegno(lettore);
+        }
+    }
+    return !lettore->errore;
+}
+
+/**
+ * @brief Legge una tabella nel formato codificato.
+ * @return Numero di esami letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaCodificata(ListaEsami* lista, const unsigned char* dati, size_t lunghezza) {
+    Lettore lettore;
+    inizializzaLettore(&lettore, dati, lunghezza);
+    if (!leggiIntestazioneCodifica(&lettore, TABELLA_ESAMI)) return -1;
+
+    uint64_t n = leggiVarint(&lettore);
+    if (lettore.errore || n > MAX_ESAMI) return -1;
+
+    int id = 0;
+    for (int i = 0; i < (int)n; i++) {
+        if (!decodificaEsame(&lettore, &lista->elenco_esami[i], &id)) {
+            lista->n_esami = 0;
+            return -1;
+        }
+    }
+
+    lista->n_esami = (int)n;
+    return (int)n;
+}
+
+/**
+ * @brief Legge una tabella nel formato precedente (array di struct grezze).
+ * @return Numero di esami letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaGrezza(ListaEsami* lista, const unsigned char* dati, size_t lunghezza) {
+    const size_t intestazione = sizeof(int);
+    if (lunghezza < intestazione) return -1;
+
+    int n;
+    memcpy(&n, dati, sizeof(int));
+
+    if (n < 0 || n > MAX_ESAMI) return -1;
+    if (lunghezza < intestazione + sizeof(Esame) * n) return -1;
+
+    memcpy(lista->elenco_esami, dati + intestazione, sizeof(Esame) * n);
+    lista->n_esami = n;
+    return n;
+}
+
+/**
+ * @brief Scrive la riga " - Tentativo <tipo> <n>: gg/mm/aaaa".
+ */
+static void scriviTentativo(Uscita* uscita, const char* tipo, int numero, const Data* data) {
+    char* riga = riservaUscita(uscita, 32 + FORMATO_MAX_INTERO + FORMATO_MAX_DATA);
+    if (riga == NULL) return;
+
+    char* r = riga;
+    r += formattaTesto(r, " - Tentativo ");
+    r += formattaTesto(r, tipo);
+    *r++ = ' ';
+    r += formattaIntero(r, numero);
+    r += formattaTesto(r, ": ");
+    r += formattaData(r, data);
+    *r++ = '\n';
+    avanzaUscita(uscita, (size_t)(r - riga));
+}
+
+/**
+ * @brief Scrive "<tipo>: <n> tentativi - <esito>".
+ */
+static void scriviTentativi(Uscita* uscita, const char* tipo, int tentativi, bool superato) {
+    char* riga = riservaUscita(uscita, 64 + FORMATO_MAX_INTERO);
+    if (riga == NULL) return;
+
+    char* r = riga;
+    r += formattaTesto(r, tipo);
+    r += formattaTesto(r, ": ");
+    r += formattaIntero(r, tentativi);
+    r += formattaTesto(r, superato ? " tentativi - Superato\n" : " tentativi - Non superato\n");
+    avanzaUscita(uscita, (size_t)(r - riga));
+}
+
+/**
+ * @brief Scrive il blocco di stampaDettagliEsame().
+ */
+static void scriviDettagliEsame(Uscita* uscita, const Esame* esame) {
+    char* riga = riservaUscita(uscita, 64 + FORMATO_MAX_INTERO);
+    if (riga == NULL) return;
+
+    char* r = riga;
+    r += formattaTesto(r, "\n--- STATO ESAMI ---\nID Allievo: ");
+    r += formattaIntero(r, esame->id_allievo);
+    *r++ = '\n';
+    avanzaUscita(uscita, (size_t)(r - riga));
+
+    scriviTentativi(uscita, "Teorico", esame->tentativiTeorico, esame->superatoTeorico);
+    for (int t = 0; t < esame->tentativiTeorico; t++) {
+        if (esame->dataTeorico[t].giorno != 0)
+            scriviTentativo(uscita, "teorico", t + 1, &esame->dataTeorico[t]);
+    }
+
+    scriviTentativi(uscita, "Pratico", esame->tentativiPratico, esame->superatoPratico);
+    for (int p = 0; p < esame->tentativiPratico; p++) {
+        if (esame->dataPratico[p].giorno != 0)
+            scriviTentativo(uscita, "pratico", p + 1, &esame->dataPratico[p]);
+    }
+}
+
 //FUNZIONI DI CREAZIONE/DISTRUZIONE
 
 ListaEsami* creaListaEsami(void) {
     ListaEsami* lista = (ListaEsami*)malloc(sizeof(ListaEsami));
     if (lista != NULL) {
         lista->n_esami = 0;
+        svuotaIndice(&lista->indice_id);
+        if (!inizializzaRegistroModifiche(&lista->modifiche, lista->elenco_esami,
+                                          sizeof(Esame), MAX_ESAMI)) {
+            free(lista);
+            return NULL;
+        }
     }
     return lista;
 }
 
 void distruggiListaEsami(ListaEsami** lista) {
     if (lista != NULL && *lista != NULL) {
+        liberaRegistroModifiche(&(*lista)->modifiche);
         free(*lista);
         *lista = NULL;
     }
@@ -64,6 +298,8 @@ void distruggiListaEsami(ListaEsami** lista) {
 void inizializzaListaEsami(ListaEsami* listaE) {
     if (listaE == NULL) return;
     listaE->n_esami = 0;
+    svuotaIndice(&listaE->indice_id);
+    segnaModificaStruttura(&listaE->modifiche);
 }
 
 // FUNZIONI DI ACCESSO (GETTER)
@@ -75,12 +311,8 @@ int getNumeroEsami(const ListaEsami* lista) {
 Esame* cercaEsamePerID(const ListaEsami* lista, int id_allievo) {
     if (lista == NULL || id_allievo <= 0) return NULL;
 
-    for (int i = 0; i < lista->n_esami; i++) {
-        if (lista->elenco_esami[i].id_allievo == id_allievo) {
-            return &lista->elenco_esami[i];
-        }
-    }
-    return NULL;
+    int pos = cercaInIndice(&lista->indice_id, id_allievo);
+    return (pos >= 0) ? &lista->elenco_esami[pos] : NULL;
 }
 
 const Esame* getEsameAtIndex(const ListaEsami* lista, int index) {
@@ -165,10 +397,50 @@ bool inizializzaEsame(ListaEsami* listaE, int id_allievo) {
         nuovo.dataPratico[i] = (Data){0, 0, 0};
     }
 
+    inserisciInIndice(&listaE->indice_id, nuovo.id_allievo, listaE->n_esami);
+    segnaModifica(&listaE->modifiche, listaE->n_esami);
     listaE->elenco_esami[listaE->n_esami++] = nuovo;
     return true;
 }
 
+int rimuoviEsamiPerID(ListaEsami* listaE, const int id_allievi[], int n) {
+    if (listaE == NULL || id_allievi == NULL || n <= 0) return 0;
+
+    // ID da rimuovere in un indice temporaneo: una sola passata sull'elenco,
+    // anche con piu' record per lo stesso allievo
+    IndiceID da_rimuovere;
+    svuotaIndice(&da_rimuovere);
+    bool non_validi = false;   // L'indice non accetta ID <= 0: quei record si riconoscono a parte
+    for (int i = 0; i < n; i++) {
+        if (id_allievi[i] > 0) {
+            inserisciInIndice(&da_rimuovere, id_allievi[i], i);
+        } else {
+            non_validi = true;
+        }
+    }
+
+    int scritti = 0;
+    int primo_spostato = -1;
+    for (int i = 0; i < listaE->n_esami; i++) {
+        int id = listaE->elenco_esami[i].id_allievo;
+        if ((id <= 0) ? non_validi : cercaInIndice(&da_rimuovere, id) >= 0) {
+            if (primo_spostato < 0) primo_spostato = i;
+            continue;
+        }
+        if (scritti != i) listaE->elenco_esami[scritti] = listaE->elenco_esami[i];
+        scritti++;
+    }
+
+    int rimossi = listaE->n_esami - scritti;
+    if (rimossi == 0) return 0;
+
+    listaE->n_esami = scritti;
+    for (int i = primo_spostato; i < scritti; i++) segnaModifica(&listaE->modifiche, i);
+    segnaModificaStruttura(&listaE->modifiche);
+    ricostruisciIndiceEsami(listaE);
+    return rimossi;
+}
+
 CodiceEsame registraTentativoTeoricoBase(ListaEsami* lista, int id_allievo,
                                          EsitoEsame esito, Data data) {
     if (lista == NULL || id_allievo <= 0) return ESAME_ERRORE_GENERICO;
@@ -182,6 +454,7 @@ CodiceEsame registraTentativoTeoricoBase(ListaEsami* lista, int id_allievo,
     int idx = e->tentativiTeorico;
     e->tentativiTeorico++;
     e->dataTeorico[idx] = data;
+    segnaModificaRecord(e);
 
     if (esito == ESITO_SUPERATO) {
         e->superatoTeorico = 1;
@@ -210,6 +483,7 @@ CodiceEsame registraTentativoPraticoBase(ListaEsami* lista, int id_allievo,
     int idx = e->tentativiPratico;
     e->tentativiPratico++;
     e->dataPratico[idx] = data;
+    segnaModificaRecord(e);
 
     if (esito == ESITO_SUPERATO) {
         e->superatoPratico = 1;
@@ -222,6 +496,44 @@ CodiceEsame registraTentativoPraticoBase(ListaEsami* lista, int id_allievo,
     }
 }
 
+CodiceEsame registraEsitoTeorico(ListaEsami* listaE, int id_allievo,
+                                 EsitoEsame esito, Data data,
+                                 void* listaA, void* listaP, bool* penalita) {
+    if (penalita != NULL) *penalita = false;
+
+    const Esame* e = cercaEsamePerID(listaE, id_allievo);
+    int tentativi_prima = (e != NULL) ? e->tentativiTeorico : 0;
+
+    CodiceEsame codice = registraTentativoTeoricoBase(listaE, id_allievo, esito, data);
+
+    // ESAURITI con un tentativo in piu' = secondo tentativo appena fallito
+    if (codice == ESAME_TENTATIVI_ESAURITI && e != NULL &&
+        e->tentativiTeorico > tentativi_prima) {
+        applicaPenalitaTeorico(id_allievo, listaA, listaP);
+        if (penalita != NULL) *penalita = true;
+    }
+    return codice;
+}
+
+CodiceEsame registraEsitoPratico(ListaEsami* listaE, int id_allievo,
+                                 EsitoEsame esito, Data data,
+                                 int ore_guida_svolte, void* listaP, bool* penalita) {
+    if (penalita != NULL) *penalita = false;
+
+    const Esame* e = cercaEsamePerID(listaE, id_allievo);
+    int tentativi_prima = (e != NULL) ? e->tentativiPratico : 0;
+
+    CodiceEsame codice = registraTentativoPraticoBase(listaE, id_allievo, esito,
+                                                      data, ore_guida_svolte);
+
+    if (codice == ESAME_TENTATIVI_ESAURITI && e != NULL &&
+        e->tentativiPratico > tentativi_prima) {
+        applicaPenalitaPratico(id_allievo, listaP);
+        if (penalita != NULL) *penalita = true;
+    }
+    return codice;
+}
+
 void registraTentativoTeorico(ListaEsami* listaE, int id_allievo, int esito,
                               void* listaA, void* listaP) {
     if (listaE == NULL) {
@@ -249,6 +561,7 @@ void registraTentativoTeorico(ListaEsami* listaE, int id_allievo, int esito,
           &e->dataTeorico[idx].giorno,
           &e->dataTeorico[idx].mese,
           &e->dataTeorico[idx].anno);
+    segnaModificaRecord(e);
 
     if (esito == 1) {
         e->superatoTeorico = 1;
@@ -258,24 +571,7 @@ void registraTentativoTeorico(ListaEsami* listaE, int id_allievo, int esito,
 
         // Penalit: sospensione + ripagamento prima rata
         if (e->tentativiTeorico == 2 && !e->superatoTeorico) {
-            // Cast dei puntatori void
-            ListaAllievi* allievi = (ListaAllievi*)listaA;
-            ListaPagamenti* pagamenti = (ListaPagamenti*)listaP;
-
-            if (allievi != NULL) {
-                Allievo* a = cercaAllievoPerID(allievi, id_allievo);
-                if (a != NULL) {
-                    setAllievoStato(a, "sospeso");
-                }
-            }
-
-            if (pagamenti != NULL) {
-                Pagamento* p = cercaPagamentoPerID(pagamenti, id_allievo);
-                if (p != NULL) {
-                    setRata(p, 1, 250.0);
-                }
-            }
-
+            applicaPenalitaTeorico(id_allievo, listaA, listaP);
             printf("Allievo sospeso. Deve ripagare la prima rata.\n");
         }
     }
@@ -329,6 +625,7 @@ void registraTentativoPratico(ListaEsami* listaE, int id_allievo, int esito,
           &e->dataPratico[idx].giorno,
           &e->dataPratico[idx].mese,
           &e->dataPratico[idx].anno);
+    segnaModificaRecord(e);
 
     if (esito == 1) {
         e->superatoPratico = 1;
@@ -338,15 +635,7 @@ void registraTentativoPratico(ListaEsami* listaE, int id_allievo, int esito,
 
         // Penalit: ripagamento tutte le rate
         if (e->tentativiPratico == 2 && !e->superatoPratico) {
-            ListaPagamenti* pagamenti = (ListaPagamenti*)listaP;
-            if (pagamenti != NULL) {
-                Pagamento* p = cercaPagamentoPerID(pagamenti, id_allievo);
-                if (p != NULL) {
-                    setRata(p, 1, 250.0);
-                    setRata(p, 2, 250.0);
-                    setRata(p, 3, 250.0);
-                }
-            }
+            applicaPenalitaPratico(id_allievo, listaP);
             printf("Due tentativi falliti. Deve ripagare tutte le rate.\n");
         }
     }
@@ -358,37 +647,28 @@ void stampaDettagliEsame(const Esame* esame) {
         return;
     }
 
-    printf("\n--- STATO ESAMI ---\n");
-    printf("ID Allievo: %d\n", esame->id_allievo);
-    printf("Teorico: %d tentativi - %s\n",
-           esame->tentativiTeorico, esame->superatoTeorico ? "Superato" : "Non superato");
-
-    for (int t = 0; t < esame->tentativiTeorico; t++) {
-        Data dt = esame->dataTeorico[t];
-        if (dt.giorno != 0)
-            printf(" - Tentativo teorico %d: %02d/%02d/%04d\n", t + 1, dt.giorno, dt.mese, dt.anno);
-    }
-
-    printf("Pratico: %d tentativi - %s\n",
-           esame->tentativiPratico, esame->superatoPratico ? "Superato" : "Non superato");
-
-    for (int p = 0; p < esame->tentativiPratico; p++) {
-        Data dp = esame->dataPratico[p];
-        if (dp.giorno != 0)
-            printf(" - Tentativo pratico %d: %02d/%02d/%04d\n", p + 1, dp.giorno, dp.mese, dp.anno);
-    }
+    Uscita* terminale = creaUscitaStandard();
+    if (terminale == NULL) return;
+    scriviDettagliEsame(terminale, esame);
+    chiudiUscita(&terminale);
 }
 
-void stampaTuttiEsami(const ListaEsami* lista) {
+void stampaTuttiEsami(const ListaEsami* lista, Uscita* uscita) {
     if (lista == NULL) {
         printf("Lista non valida.\n");
         return;
     }
 
-    printf("\n--- Elenco Esami ---\n");
-    for (int i = 0; i < lista->n_esami; i++) {
-        stampaDettagliEsame(&lista->elenco_esami[i]);
+    Uscita* terminale = NULL;
+    if (uscita == NULL) uscita = terminale = creaUscitaStandard();
+    if (uscita == NULL) return;
+
+    scriviTestoUscita(uscita, "\n--- Elenco Esami ---\n");
+    for (int i = 0; i < lista->n_esami && !uscitaInterrotta(uscita); i++) {
+        scriviDettagliEsame(uscita, &lista->elenco_esami[i]);
     }
+
+    if (terminale != NULL) chiudiUscita(&terminale);
 }
 
 void stampaEsame(const ListaEsami* listaE, const void* listaA) {
@@ -422,39 +702,93 @@ void stampaEsame(const ListaEsami* listaE, const void* listaA) {
 
 //FUNZIONI I/O FILE
 
-bool salvaEsami(const ListaEsami* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+int copiaModificheEsami(ListaEsami* copia, const ListaEsami* originale, unsigned long generazione) {
+    if (copia == NULL || originale == NULL) return -1;
 
-    FILE* file = fopen(filename, "wb");
-    if (file == NULL) {
-        printf("Errore: impossibile aprire il file %s per la scrittura.\n", filename);
-        return false;
+    int copiati = copiaBlocchiModificati(&originale->modifiche, &copia->modifiche,
+                                         copia->elenco_esami, originale->n_esami, generazione);
+    copia->n_esami = originale->n_esami;
+    if (originale->modifiche.generazione > generazione) {
+        copia->indice_id = originale->indice_id;
     }
+    return copiati;
+}
 
-    // Salva numero esami
-    fwrite(&lista->n_esami, sizeof(int), 1, file);
+const RegistroModifiche* getRegistroModificheEsami(const ListaEsami* lista) {
+    return (lista != NULL) ? &lista->modifiche : NULL;
+}
 
-    // Salva array esami
-    fwrite(lista->elenco_esami, sizeof(Esame), lista->n_esami, file);
+bool serializzaIntestazioneGrezzaEsami(const ListaEsami* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    fclose(file);
-    return true;
+    bool ok = scriviBuffer(buf, &lista->n_esami, sizeof(int));
+    return ok;
 }
 
-bool caricaEsami(ListaEsami* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+bool serializzaEsami(const ListaEsami* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+
+    // Stima per eccesso: una sola riallocazione per l'intera tabella
+    riservaBuffer(buf, buf->lunghezza + CODIFICA_DIM_INTESTAZIONE + CODIFICA_MAX_VARINT +
+                       (size_t)lista->n_esami * MAX_ESAME_CODIFICATO);
+
+    // Intestazione: numero esami
+    bool ok = scriviIntestazioneCodifica(buf, TABELLA_ESAMI);
+    ok &= scriviVarint(buf, (uint64_t)lista->n_esami);
 
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        return false; // File non esiste, non  un errore
+    // Record codificati
+    int id_precedente = 0;
+    for (int i = 0; i < lista->n_esami && ok; i++) {
+        ok = codificaEsame(&lista->elenco_esami[i], id_precedente, buf);
+        id_precedente = lista->elenco_esami[i].id_allievo;
     }
+    return ok;
+}
+
+bool serializzaIndiceEsami(const ListaEsami* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+    return scriviBuffer(buf, &lista->indice_id, sizeof(IndiceID));
+}
+
+bool deserializzaEsami(ListaEsami* lista, const unsigned char* dati, size_t lunghezza) {
+    return deserializzaEsamiConIndice(lista, dati, lunghezza, NULL, 0);
+}
 
-    // Carica numero esami
-    fread(&lista->n_esami, sizeof(int), 1, file);
+bool deserializzaEsamiConIndice(ListaEsami* lista, const unsigned char* dati, size_t lunghezza,
+                                const unsigned char* indice, size_t lunghezza_indice) {
+    if (lista == NULL || dati == NULL) return false;
 
-    // Carica array esami
-    fread(lista->elenco_esami, sizeof(Esame), lista->n_esami, file);
+    int n = isTabellaCodificata(dati, lunghezza) ?
+            leggiTabellaCodificata(lista, dati, lunghezza) :
+            leggiTabellaGrezza(lista, dati, lunghezza);
+    if (n < 0) return false;
 
-    fclose(file);
+    segnaModificaTotale(&lista->modifiche, n);
+    // L'indice salvato viene adottato se compatibile, altrimenti viene
+    // ricostruito dallo stesso thread che carica la tabella
+    if (indice == NULL || !adottaIndice(&lista->indice_id, indice, lunghezza_indice, n)) {
+        ricostruisciIndiceEsami(lista);
+    }
     return true;
 }
+
+bool salvaEsami(const ListaEsami* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = serializzaEsami(lista, &buf) && scriviBufferSuFile(&buf, filename);
+    liberaBuffer(&buf);
+    return ok;
+}
+
+bool caricaEsami(ListaEsami* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = leggiFileInBuffer(filename, &buf) && // File mancante: non e' un errore
+              deserializzaEsami(lista, buf.dati, buf.lunghezza);
+    liberaBuffer(&buf);
+    return ok;
+}
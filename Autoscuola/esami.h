@@ -14,6 +14,9 @@
 #define ESAMI_H
 
 #include <stdbool.h>
+#include "buffer.h"
+#include "modifiche.h"
+#include "uscita.h"
 #include "data.h"
 
 //TIPI OPACHI
@@ -170,6 +173,20 @@ bool getDataPratico(const Esame* esame, int tentativo, Data* data);
  * @return true se creato con successo, false altrimenti.
  */
 bool inizializzaEsame(ListaEsami* listaE, int id_allievo);
+/**
+ * @brief Rimuove le schede esami degli allievi indicati (es. record orfani).
+ *
+ * L'elenco viene compattato in una sola passata mantenendo l'ordine; i
+ * record spostati risultano modificati per il salvataggio differenziale.
+ *
+ * @param listaE Puntatore alla lista.
+ * @param id_allievi ID degli allievi i cui record vanno rimossi (un ID <= 0
+ *                   rimuove tutti i record con ID non valido).
+ * @param n Numero di ID.
+ * @return Numero di record rimossi.
+ */
+int rimuoviEsamiPerID(ListaEsami* listaE, const int id_allievi[], int n);
+
 
 /**
  * @brief Registra un tentativo di esame teorico.
@@ -203,6 +220,46 @@ CodiceEsame registraTentativoPraticoBase(ListaEsami* lista, int id_allievo,
                                          EsitoEsame esito, Data data,
                                          int ore_guida_svolte);
 
+/**
+ * @brief Registra un tentativo teorico senza interazione, applicando le penalita'.
+ *
+ * Ha la semantica di registraTentativoTeoricoBase(); se il tentativo
+ * registrato e' il secondo fallito applica le stesse penalita' di
+ * registraTentativoTeorico() (allievo sospeso, prima rata da ripagare).
+ *
+ * @param listaE Lista degli esami.
+ * @param id_allievo ID dell'allievo.
+ * @param esito Esito del tentativo.
+ * @param data Data del tentativo.
+ * @param listaA Puntatore opaco alla lista allievi (per aggiornare lo stato).
+ * @param listaP Puntatore opaco alla lista pagamenti (per penalit).
+ * @param penalita Se non NULL, riceve true se sono state applicate penalit.
+ * @return Codice di ritorno di registraTentativoTeoricoBase().
+ */
+CodiceEsame registraEsitoTeorico(ListaEsami* listaE, int id_allievo,
+                                 EsitoEsame esito, Data data,
+                                 void* listaA, void* listaP, bool* penalita);
+
+/**
+ * @brief Registra un tentativo pratico senza interazione, applicando le penalita'.
+ *
+ * Ha la semantica di registraTentativoPraticoBase(); se il tentativo
+ * registrato e' il secondo fallito tutte le rate tornano da pagare, come in
+ * registraTentativoPratico().
+ *
+ * @param listaE Lista degli esami.
+ * @param id_allievo ID dell'allievo.
+ * @param esito Esito del tentativo.
+ * @param data Data del tentativo.
+ * @param ore_guida_svolte Ore di guida completate (per verifica prerequisiti).
+ * @param listaP Puntatore opaco alla lista pagamenti (per penalit).
+ * @param penalita Se non NULL, riceve true se sono state applicate penalit.
+ * @return Codice di ritorno di registraTentativoPraticoBase().
+ */
+CodiceEsame registraEsitoPratico(ListaEsami* listaE, int id_allievo,
+                                 EsitoEsame esito, Data data,
+                                 int ore_guida_svolte, void* listaP, bool* penalita);
+
 /**
  * @brief Registra un tentativo d'esame teorico e aggiorna lo stato.
  *
@@ -242,8 +299,9 @@ void stampaDettagliEsame(const Esame* esame);
 /**
  * @brief Stampa tutti gli esami registrati.
  * @param lista Lista degli esami.
+ * @param uscita Destinazione dell'elenco (NULL per il terminale).
  */
-void stampaTuttiEsami(const ListaEsami* lista);
+void stampaTuttiEsami(const ListaEsami* lista, Uscita* uscita);
 
 /**
  * @brief Visualizza lo stato dettagliato degli esami (tentativi, esito, date).
@@ -253,6 +311,95 @@ void stampaTuttiEsami(const ListaEsami* lista);
 void stampaEsame(const ListaEsami* listaE, const void* listaA);
 
 //FUNZIONI I/O FILE
+/**
+ * @brief Aggiorna una copia della lista con i soli blocchi modificati dopo una generazione.
+ *
+ * Usata dall'autosalvataggio e dalle viste di condivisi.h per mantenere
+ * un'istantanea coerente senza ricopiare l'intera lista a ogni ciclo. Se la
+ * lista e' cambiata viene copiato anche l'indice per ID, cosi' le ricerche
+ * funzionano anche sulla copia; i record copiati conservano la loro
+ * generazione (getGenerazioneRecord()).
+ *
+ * @param copia Lista di destinazione (creata con creaListaEsami()).
+ * @param originale Lista da cui copiare.
+ * @param generazione Generazione dell'ultima copia (0 = copia completa).
+ * @return Numero di blocchi copiati, -1 se i parametri non sono validi.
+ */
+int copiaModificheEsami(ListaEsami* copia, const ListaEsami* originale, unsigned long generazione);
+
+/**
+ * @brief Restituisce il registro delle modifiche della lista degli esami.
+ *
+ * Il registro descrive anche l'array dei record (indirizzo, dimensione,
+ * capacita'): l'istantanea differenziale lo usa per riscrivere solo i
+ * blocchi modificati.
+ *
+ * @param lista Lista degli esami.
+ * @return Puntatore al registro (read-only), NULL se lista e' NULL.
+ */
+const RegistroModifiche* getRegistroModificheEsami(const ListaEsami* lista);
+
+/**
+ * @brief Serializza l'intestazione del formato a record fissi (contatori senza record).
+ *
+ * Seguita da `n` record grezzi forma un'area leggibile da deserializzaEsami().
+ *
+ * @param lista Lista degli esami.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIntestazioneGrezzaEsami(const ListaEsami* lista, Buffer* buf);
+
+/**
+ * @brief Serializza la lista degli esami in un buffer in memoria.
+ *
+ * Il formato e' lo stesso del file `esami.dat` e viene usato sia per i file
+ * separati sia per le sezioni dell'archivio unico. I record sono codificati
+ * in forma compatta (vedi codifica.h).
+ *
+ * @param lista Lista da serializzare.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaEsami(const ListaEsami* lista, Buffer* buf);
+
+/**
+ * @brief Ricostruisce la lista degli esami da un'area di memoria serializzata.
+ *
+ * Riconosce anche il formato precedente a struct grezze.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaEsami().
+ * @param lunghezza Numero di byte disponibili.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaEsami(ListaEsami* lista, const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Come deserializzaEsami(), adottando un indice per ID salvato in precedenza.
+ *
+ * L'indice viene adottato solo se ha la dimensione attesa e punta a
+ * posizioni esistenti; altrimenti viene ricostruito. Il chiamante deve
+ * garantire che l'indice sia stato prodotto per gli stessi dati.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaEsami().
+ * @param lunghezza Numero di byte disponibili.
+ * @param indice Byte prodotti da serializzaIndiceEsami() (NULL = ricostruisci).
+ * @param lunghezza_indice Numero di byte dell'indice.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaEsamiConIndice(ListaEsami* lista, const unsigned char* dati, size_t lunghezza,
+                                const unsigned char* indice, size_t lunghezza_indice);
+
+/**
+ * @brief Serializza l'indice per ID della lista degli esami (immagine della tabella hash).
+ * @param lista Lista di cui salvare l'indice.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIndiceEsami(const ListaEsami* lista, Buffer* buf);
+
 /**
  * @brief Salva la lista degli esami su file binario.
  * @param lista Lista da salvare.
@@ -0,0 +1,405 @@
+/**
+ * @file esporta.c
+ * @brief Implementazione dell'esportazione in CSV e JSON Lines.
+ *
+ * Struttura:
+ * - Esportazione: uscita su file a blocchi (uscita.h) e stato del record
+ * - Testi con escape; interi, importi e date da formato.h
+ * - Campi: la stessa sequenza di chiamate produce una riga CSV o un oggetto JSON
+ * - Un esportatore per tabella e uno per la vista per allievo
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "esporta.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "data.h"
+#include "formato.h"
+#include "uscita.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+/**
+ * @struct Esportazione
+ * @brief File di destinazione (scritto a blocchi, vedi uscita.h) e record in corso.
+ */
+typedef struct {
+    Uscita* uscita;
+    FormatoEsportazione formato;
+    int n_campi;                 /**< Campi gia' scritti nel record corrente */
+} Esportazione;
+
+static const char* const COLONNE_ALLIEVI[] = {
+    "id", "nome", "cognome", "codice_fiscale", "categoria_patente", "stato"
+};
+
+static const char* const COLONNE_PAGAMENTI[] = {
+    "id_allievo", "prima_rata", "seconda_rata", "terza_rata", "extra", "totale_pagato"
+};
+
+static const char* const COLONNE_ESAMI[] = {
+    "id_allievo", "tentativi_teorico", "teorico_superato", "data_teorico_1", "data_teorico_2",
+    "tentativi_pratico", "pratico_superato", "data_pratico_1", "data_pratico_2"
+};
+
+static const char* const COLONNE_GUIDE[] = {
+    "id_allievo", "ore_svolte", "ore_extra"
+};
+
+static const char* const COLONNE_VISTA[] = {
+    "id", "nome", "cognome", "codice_fiscale", "categoria_patente", "stato",
+    "prima_rata", "seconda_rata", "terza_rata", "extra", "totale_pagato",
+    "tentativi_teorico", "teorico_superato", "tentativi_pratico", "pratico_superato",
+    "ore_svolte", "ore_extra"
+};
+
+#define NUM_COLONNE(colonne) ((int)(sizeof(colonne) / sizeof((colonne)[0])))
+
+//APERTURA E CHIUSURA (PRIVATE)
+
+static bool apriEsportazione(Esportazione* u, const char* filename, FormatoEsportazione formato) {
+    u->formato = formato;
+    u->n_campi = 0;
+    u->uscita = creaUscitaFile(filename);
+    return u->uscita != NULL;
+}
+
+/**
+ * @brief Scrive il testo rimasto e chiude il file.
+ * @return true se tutti i byte sono stati scritti.
+ */
+static bool chiudiEsportazione(Esportazione* u, const char* filename) {
+    bool ok = chiudiUscita(&u->uscita);
+    if (!ok) printf("Errore: scrittura del file %s non riuscita.\n", filename);
+    return ok;
+}
+
+//FORMATTAZIONE (PRIVATE)
+
+static void scriviTestoCSV(Esportazione* u, const char* testo) {
+    size_t n = strcspn(testo, ",\"\r\n");
+    if (testo[n] == '\0') {
+        scriviUscita(u->uscita, testo, n);
+        return;
+    }
+
+    // Tra virgolette, con le virgolette interne raddoppiate
+    scriviCarattereUscita(u->uscita, '"');
+    for (const char* p = testo; *p; p++) {
+        if (*p == '"') scriviCarattereUscita(u->uscita, '"');
+        scriviCarattereUscita(u->uscita, *p);
+    }
+    scriviCarattereUscita(u->uscita, '"');
+}
+
+static void scriviTestoJSON(Esportazione* u, const char* testo) {
+    static const char esadecimali[] = "0123456789abcdef";
+
+    scriviCarattereUscita(u->uscita, '"');
+    const char* inizio = testo;
+    for (const char* p = testo; ; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '\0' && c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // Copia in blocco il tratto che non richiede escape
+        scriviUscita(u->uscita, inizio, (size_t)(p - inizio));
+        if (c == '\0') break;
+
+        char escape[6] = {'\\', (char)c, 0, 0, 0, 0};
+        size_t n = 2;
+        if (c == '\n') escape[1] = 'n';
+        else if (c == '\r') escape[1] = 'r';
+        else if (c == '\t') escape[1] = 't';
+        else if (c < 0x20) {
+            escape[1] = 'u'; escape[2] = '0'; escape[3] = '0';
+            escape[4] = esadecimali[c >> 4];
+            escape[5] = esadecimali[c & 0x0F];
+            n = 6;
+        }
+        scriviUscita(u->uscita, escape, n);
+        inizio = p + 1;
+    }
+    scriviCarattereUscita(u->uscita, '"');
+}
+
+//CAMPI E RECORD (PRIVATE)
+
+static void scriviIntestazioneCSV(Esportazione* u, const char* const colonne[], int n) {
+    if (u->formato != ESPORTA_CSV) return;
+    for (int i = 0; i < n; i++) {
+        if (i > 0) scriviCarattereUscita(u->uscita, ',');
+        scriviUscita(u->uscita, colonne[i], strlen(colonne[i]));
+    }
+    scriviCarattereUscita(u->uscita, '\n');
+}
+
+static void inizioRecord(Esportazione* u) {
+    u->n_campi = 0;
+    if (u->formato == ESPORTA_JSONL) scriviCarattereUscita(u->uscita, '{');
+}
+
+static void fineRecord(Esportazione* u) {
+    if (u->formato == ESPORTA_JSONL) scriviCarattereUscita(u->uscita, '}');
+    scriviCarattereUscita(u->uscita, '\n');
+}
+
+/**
+ * @brief Separatore e, in JSON, nome del campo.
+ */
+static void nomeCampo(Esportazione* u, const char* nome) {
+    if (u->n_campi++ > 0) scriviCarattereUscita(u->uscita, ',');
+    if (u->formato == ESPORTA_JSONL) {
+        size_t n = strlen(nome);
+        char* dest = riservaUscita(u->uscita, n + 3);
+        if (dest == NULL) return;
+        dest[0] = '"';
+        memcpy(dest + 1, nome, n);
+        dest[n + 1] = '"';
+        dest[n + 2] = ':';
+        avanzaUscita(u->uscita, n + 3);
+    }
+}
+
+static void campoIntero(Esportazione* u, const char* nome, long long valore) {
+    nomeCampo(u, nome);
+    char* dest = riservaUscita(u->uscita, FORMATO_MAX_INTERO);
+    if (dest == NULL) return;
+    avanzaUscita(u->uscita, formattaIntero(dest, valore));
+}
+
+static void campoImporto(Esportazione* u, const char* nome, float importo) {
+    nomeCampo(u, nome);
+    char* dest = riservaUscita(u->uscita, FORMATO_MAX_IMPORTO);
+    if (dest == NULL) return;
+    avanzaUscita(u->uscita, formattaImporto(dest, importo));
+}
+
+static void campoBooleano(Esportazione* u, const char* nome, bool valore) {
+    nomeCampo(u, nome);
+    if (u->formato == ESPORTA_JSONL) {
+        if (valore) scriviUscita(u->uscita, "true", 4);
+        else scriviUscita(u->uscita, "false", 5);
+    } else {
+        scriviCarattereUscita(u->uscita, valore ? '1' : '0');
+    }
+}
+
+static void campoNullo(Esportazione* u, const char* nome) {
+    nomeCampo(u, nome);
+    if (u->formato == ESPORTA_JSONL) scriviUscita(u->uscita, "null", 4);
+}
+
+static void campoTesto(Esportazione* u, const char* nome, const char* testo) {
+    nomeCampo(u, nome);
+    if (u->formato == ESPORTA_JSONL) scriviTestoJSON(u, testo);
+    else scriviTestoCSV(u, testo);
+}
+
+/**
+ * @brief Data del tentativo, oppure campo nullo se il tentativo non e' stato sostenuto.
+ */
+static void campoData(Esportazione* u, const char* nome, bool presente, const Data* d) {
+    if (!presente) {
+        campoNullo(u, nome);
+        return;
+    }
+    nomeCampo(u, nome);
+    bool json = (u->formato == ESPORTA_JSONL);
+    char* dest = riservaUscita(u->uscita, FORMATO_MAX_DATA + 2);
+    if (dest == NULL) return;
+    size_t n = 0;
+    if (json) dest[n++] = '"';
+    n += formattaDataISO(dest + n, d);
+    if (json) dest[n++] = '"';
+    avanzaUscita(u->uscita, n);
+}
+
+//RECORD DELLE TABELLE (PRIVATE)
+
+static void scriviRecordAllievo(Esportazione* u, const Allievo* a) {
+    campoIntero(u, "id", getAllievoID(a));
+    campoTesto(u, "nome", getAllievoNome(a));
+    campoTesto(u, "cognome", getAllievoCognome(a));
+    campoTesto(u, "codice_fiscale", getAllievoCodiceFiscale(a));
+    campoTesto(u, "categoria_patente", getAllievoCategoriaPatente(a));
+    campoTesto(u, "stato", getAllievoStato(a));
+}
+
+static void scriviCampiPagamento(Esportazione* u, const Pagamento* p) {
+    if (p == NULL) {
+        for (int i = 1; i < NUM_COLONNE(COLONNE_PAGAMENTI); i++) {
+            campoNullo(u, COLONNE_PAGAMENTI[i]);
+        }
+        return;
+    }
+    campoImporto(u, "prima_rata", getPrimaRata(p));
+    campoImporto(u, "seconda_rata", getSecondaRata(p));
+    campoImporto(u, "terza_rata", getTerzaRata(p));
+    campoImporto(u, "extra", getExtra(p));
+    campoImporto(u, "totale_pagato", calcolaTotalePagato(p));
+}
+
+static void scriviCampiGuida(Esportazione* u, const Guida* g) {
+    if (g == NULL) {
+        campoNullo(u, "ore_svolte");
+        campoNullo(u, "ore_extra");
+        return;
+    }
+    campoIntero(u, "ore_svolte", getOreSvolte(g));
+    campoIntero(u, "ore_extra", getOreExtra(g));
+}
+
+static void scriviRecordEsame(Esportazione* u, const Esame* e) {
+    Data d = {0, 0, 0};
+    bool presente;
+
+    campoIntero(u, "id_allievo", getEsameIDAllievo(e));
+    campoIntero(u, "tentativi_teorico", getTentativiTeorico(e));
+    campoBooleano(u, "teorico_superato", isTeoricoSuperato(e));
+    presente = getDataTeorico(e, 0, &d);
+    campoData(u, "data_teorico_1", presente, &d);
+    presente = getDataTeorico(e, 1, &d);
+    campoData(u, "data_teorico_2", presente, &d);
+    campoIntero(u, "tentativi_pratico", getTentativiPratico(e));
+    campoBooleano(u, "pratico_superato", isPraticoSuperato(e));
+    presente = getDataPratico(e, 0, &d);
+    campoData(u, "data_pratico_1", presente, &d);
+    presente = getDataPratico(e, 1, &d);
+    campoData(u, "data_pratico_2", presente, &d);
+}
+
+//FUNZIONI PUBBLICHE
+
+bool esportaAllievi(const ListaAllievi* listaA, const char* filename,
+                    FormatoEsportazione formato) {
+    if (listaA == NULL || filename == NULL) return false;
+
+    Esportazione u;
+    if (!apriEsportazione(&u, filename, formato)) return false;
+
+    scriviIntestazioneCSV(&u, COLONNE_ALLIEVI, NUM_COLONNE(COLONNE_ALLIEVI));
+    int n = getNumeroAllievi(listaA);
+    for (int i = 0; i < n && !uscitaInterrotta(u.uscita); i++) {
+        inizioRecord(&u);
+        scriviRecordAllievo(&u, getAllievoAtIndex(listaA, i));
+        fineRecord(&u);
+    }
+    return chiudiEsportazione(&u, filename);
+}
+
+bool esportaPagamenti(const ListaPagamenti* listaP, const char* filename,
+                      FormatoEsportazione formato) {
+    if (listaP == NULL || filename == NULL) return false;
+
+    Esportazione u;
+    if (!apriEsportazione(&u, filename, formato)) return false;
+
+    scriviIntestazioneCSV(&u, COLONNE_PAGAMENTI, NUM_COLONNE(COLONNE_PAGAMENTI));
+    int n = getNumeroPagamenti(listaP);
+    for (int i = 0; i < n && !uscitaInterrotta(u.uscita); i++) {
+        const Pagamento* p = getPagamentoAtIndex(listaP, i);
+        inizioRecord(&u);
+        campoIntero(&u, "id_allievo", getPagamentoIDAllievo(p));
+        scriviCampiPagamento(&u, p);
+        fineRecord(&u);
+    }
+    return chiudiEsportazione(&u, filename);
+}
+
+bool esportaEsami(const ListaEsami* listaE, const char* filename,
+                  FormatoEsportazione formato) {
+    if (listaE == NULL || filename == NULL) return false;
+
+    Esportazione u;
+    if (!apriEsportazione(&u, filename, formato)) return false;
+
+    scriviIntestazioneCSV(&u, COLONNE_ESAMI, NUM_COLONNE(COLONNE_ESAMI));
+    int n = getNumeroEsami(listaE);
+    for (int i = 0; i < n && !uscitaInterrotta(u.uscita); i++) {
+        inizioRecord(&u);
+        scriviRecordEsame(&u, getEsameAtIndex(listaE, i));
+        fineRecord(&u);
+    }
+    return chiudiEsportazione(&u, filename);
+}
+
+bool esportaGuide(const ListaGuide* listaG, const char* filename,
+                  FormatoEsportazione formato) {
+    if (listaG == NULL || filename == NULL) return false;
+
+    Esportazione u;
+    if (!apriEsportazione(&u, filename, formato)) return false;
+
+    scriviIntestazioneCSV(&u, COLONNE_GUIDE, NUM_COLONNE(COLONNE_GUIDE));
+    int n = getNumeroGuide(listaG);
+    for (int i = 0; i < n && !uscitaInterrotta(u.uscita); i++) {
+        const Guida* g = getGuidaAtIndex(listaG, i);
+        inizioRecord(&u);
+        campoIntero(&u, "id_allievo", getGuidaIDAllievo(g));
+        scriviCampiGuida(&u, g);
+        fineRecord(&u);
+    }
+    return chiudiEsportazione(&u, filename);
+}
+
+bool esportaVistaAllievi(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                         const ListaEsami* listaE, const ListaGuide* listaG,
+                         const char* filename, FormatoEsportazione formato) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL ||
+        filename == NULL) return false;
+
+    Esportazione u;
+    if (!apriEsportazione(&u, filename, formato)) return false;
+
+    scriviIntestazioneCSV(&u, COLONNE_VISTA, NUM_COLONNE(COLONNE_VISTA));
+    int n = getNumeroAllievi(listaA);
+    for (int i = 0; i < n && !uscitaInterrotta(u.uscita); i++) {
+        const Allievo* a = getAllievoAtIndex(listaA, i);
+        int id = getAllievoID(a);
+
+        inizioRecord(&u);
+        scriviRecordAllievo(&u, a);
+        scriviCampiPagamento(&u, cercaPagamentoPerID(listaP, id));
+
+        const Esame* e = cercaEsamePerID(listaE, id);
+        if (e != NULL) {
+            campoIntero(&u, "tentativi_teorico", getTentativiTeorico(e));
+            campoBooleano(&u, "teorico_superato", isTeoricoSuperato(e));
+            campoIntero(&u, "tentativi_pratico", getTentativiPratico(e));
+            campoBooleano(&u, "pratico_superato", isPraticoSuperato(e));
+        } else {
+            campoNullo(&u, "tentativi_teorico");
+            campoNullo(&u, "teorico_superato");
+            campoNullo(&u, "tentativi_pratico");
+            campoNullo(&u, "pratico_superato");
+        }
+
+        scriviCampiGuida(&u, cercaGuidaPerID(listaG, id));
+        fineRecord(&u);
+    }
+    return chiudiEsportazione(&u, filename);
+}
+
+bool esportaTutto(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                  const ListaEsami* listaE, const ListaGuide* listaG,
+                  const char* prefisso, FormatoEsportazione formato) {
+    if (prefisso == NULL) prefisso = PREFISSO_ESPORTAZIONE_PREDEFINITO;
+    const char* estensione = (formato == ESPORTA_JSONL) ? "jsonl" : "csv";
+    char nome[512];
+    bool ok = true;
+
+    snprintf(nome, sizeof(nome), "%s_allievi.%s", prefisso, estensione);
+    ok = esportaAllievi(listaA, nome, formato) && ok;
+    snprintf(nome, sizeof(nome), "%s_pagamenti.%s", prefisso, estensione);
+    ok = esportaPagamenti(listaP, nome, formato) && ok;
+    snprintf(nome, sizeof(nome), "%s_esami.%s", prefisso, estensione);
+    ok = esportaEsami(listaE, nome, formato) && ok;
+    snprintf(nome, sizeof(nome), "%s_guide.%s", prefisso, estensione);
+    ok = esportaGuide(listaG, nome, formato) && ok;
+    snprintf(nome, sizeof(nome), "%s_vista.%s", prefisso, estensione);
+    ok = esportaVistaAllievi(listaA, listaP, listaE, listaG, nome, formato) && ok;
+
+    return ok;
+}
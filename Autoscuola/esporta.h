@@ -0,0 +1,115 @@
+/**
+ * @file esporta.h
+ * @brief Esportazione dei dati in formati leggibili da programmi (CSV e JSON Lines).
+ *
+ * A differenza del resoconto testuale (esportaResocontoCompleto), questi
+ * file sono pensati per strumenti esterni: un record per riga, campi con
+ * nome stabile, importi con due decimali e date nel formato aaaa-mm-gg.
+ *
+ * I record vengono formattati a mano in un'uscita su file (vedi uscita.h),
+ * scritta a blocchi di `DIM_BLOCCO_USCITA` byte: nessuna fprintf per campo,
+ * nessuna copia intera della tabella in memoria.
+ *
+ * In CSV la prima riga contiene i nomi delle colonne e i testi vengono
+ * racchiusi tra virgolette solo se necessario; in JSON Lines ogni riga e' un
+ * oggetto e i campi assenti (es. date di tentativi non sostenuti) valgono null.
+ */
+#ifndef ESPORTA_H
+#define ESPORTA_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define PREFISSO_ESPORTAZIONE_PREDEFINITO "esportazione"
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Formato dei file esportati.
+ */
+typedef enum {
+    ESPORTA_CSV = 0,   /**< Valori separati da virgola, con intestazione */
+    ESPORTA_JSONL = 1  /**< Un oggetto JSON per riga */
+} FormatoEsportazione;
+
+/**
+ * @brief Esporta la tabella degli allievi.
+ * @param listaA Lista degli allievi.
+ * @param filename File di destinazione (sovrascritto).
+ * @param formato Formato del file.
+ * @return true se successo, false in caso di errore di I/O.
+ */
+bool esportaAllievi(const ListaAllievi* listaA, const char* filename,
+                    FormatoEsportazione formato);
+
+/**
+ * @brief Esporta la tabella dei pagamenti.
+ * @param listaP Lista dei pagamenti.
+ * @param filename File di destinazione (sovrascritto).
+ * @param formato Formato del file.
+ * @return true se successo, false in caso di errore di I/O.
+ */
+bool esportaPagamenti(const ListaPagamenti* listaP, const char* filename,
+                      FormatoEsportazione formato);
+
+/**
+ * @brief Esporta la tabella degli esami, con le date dei tentativi.
+ * @param listaE Lista degli esami.
+ * @param filename File di destinazione (sovrascritto).
+ * @param formato Formato del file.
+ * @return true se successo, false in caso di errore di I/O.
+ */
+bool esportaEsami(const ListaEsami* listaE, const char* filename,
+                  FormatoEsportazione formato);
+
+/**
+ * @brief Esporta la tabella delle guide.
+ * @param listaG Lista delle guide.
+ * @param filename File di destinazione (sovrascritto).
+ * @param formato Formato del file.
+ * @return true se successo, false in caso di errore di I/O.
+ */
+bool esportaGuide(const ListaGuide* listaG, const char* filename,
+                  FormatoEsportazione formato);
+
+/**
+ * @brief Esporta una riga per allievo con pagamenti, esami e guide collegati per ID.
+ *
+ * I campi di una tabella in cui l'allievo non compare restano vuoti (CSV)
+ * o null (JSON Lines).
+ *
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param filename File di destinazione (sovrascritto).
+ * @param formato Formato del file.
+ * @return true se successo, false in caso di errore di I/O.
+ */
+bool esportaVistaAllievi(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                         const ListaEsami* listaE, const ListaGuide* listaG,
+                         const char* filename, FormatoEsportazione formato);
+
+/**
+ * @brief Esporta tutte le tabelle e la vista per allievo.
+ *
+ * Crea `<prefisso>_allievi`, `<prefisso>_pagamenti`, `<prefisso>_esami`,
+ * `<prefisso>_guide` e `<prefisso>_vista`, con estensione `.csv` o `.jsonl`.
+ *
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param prefisso Prefisso dei nomi dei file.
+ * @param formato Formato dei file.
+ * @return true se tutti i file sono stati scritti.
+ */
+bool esportaTutto(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                  const ListaEsami* listaE, const ListaGuide* listaG,
+                  const char* prefisso, FormatoEsportazione formato);
+
+#endif // ESPORTA_H
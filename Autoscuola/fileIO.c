@@ -9,11 +9,433 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
 #include "fileio.h"
 #include "allievi.h"
 #include "pagamenti.h"
 #include "esami.h"
 #include "guida.h"
+#include "archivio.h"
+#include "istantanea.h"
+#include "resoconto.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/locking.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#endif
+
+//STATO DEL MODULO
+static FormatoArchivio formato_corrente = FORMATO_FILE_SEPARATI;
+static uint64_t generazione_archivio = 0;
+/** File di dati presente ma non letto (istantanea o archivio): salvare lo sostituirebbe. */
+static const char* file_illeggibile = NULL;
+/** L'archivio su disco e' gia' nelle liste o superato dall'istantanea: si puo' rimuovere. */
+static bool archivio_superato = false;
+static bool messaggi_avanzamento = true;
+static int descrittore_blocco = -1;
+
+//FUNZIONI DI CONFIGURAZIONE
+
+void impostaFormatoArchivio(FormatoArchivio formato) {
+    formato_corrente = formato;
+}
+
+FormatoArchivio getFormatoArchivio(void) {
+    return formato_corrente;
+}
+
+void impostaMessaggiAvanzamento(bool attivi) {
+    messaggi_avanzamento = attivi;
+}
+
+bool acquisisciBloccoDati(void) {
+    if (descrittore_blocco >= 0) return true;
+
+#ifdef _WIN32
+    int fd = _open(BLOCCO_DATI_FILE, _O_CREAT | _O_RDWR, _S_IREAD | _S_IWRITE);
+    bool bloccato = fd >= 0 && _locking(fd, _LK_NBLCK, 1) == 0;
+    if (!bloccato && fd >= 0) _close(fd);
+#else
+    int fd = open(BLOCCO_DATI_FILE, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    bool bloccato = fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) == 0;
+    if (!bloccato && fd >= 0) close(fd);
+#endif
+
+    if (fd < 0) {
+        printf("Errore: impossibile creare il file %s.\n", BLOCCO_DATI_FILE);
+        return false;
+    }
+    if (!bloccato) {
+        printf("Errore: i dati sono gia' in uso (menu, servizio o comando in corso).\n");
+        return false;
+    }
+    descrittore_blocco = fd;
+    return true;
+}
+
+void rilasciaBloccoDati(void) {
+    if (descrittore_blocco < 0) return;
+
+    // Il file resta: rimuoverlo permetterebbe a due istanze di bloccare file diversi
+#ifdef _WIN32
+    _close(descrittore_blocco);
+#else
+    close(descrittore_blocco);
+#endif
+    descrittore_blocco = -1;
+}
+
+//LAVORI PER TABELLA (ESEGUITI IN PARALLELO)
+
+/**
+ * @brief Operazione da svolgere su una singola tabella.
+ */
+typedef enum {
+    LAVORO_SALVA_FILE,      /**< salvaX() sul file `.dat` della tabella */
+    LAVORO_CARICA_FILE,     /**< caricaX() dal file `.dat` della tabella */
+    LAVORO_SERIALIZZA,      /**< serializzaX() nel buffer della sezione */
+    LAVORO_DESERIALIZZA,    /**< deserializzaXConIndice() dalla sezione dell'archivio */
+    LAVORO_SERIALIZZA_INDICE /**< serializzaIndiceX() nel buffer della sezione */
+} TipoLavoro;
+
+/**
+ * @struct LavoroTabella
+ * @brief Descrive il lavoro assegnato a un thread: una tabella, un'operazione.
+ *
+ * Le liste sono passate senza `const` per usare un'unica struttura;
+ * i lavori di salvataggio e serializzazione le accedono in sola lettura.
+ */
+typedef struct {
+    TipoLavoro tipo;
+    TipoSezione tabella;
+    ListaAllievi* listaA;
+    ListaPagamenti* listaP;
+    ListaEsami* listaE;
+    ListaGuide* listaG;
+    Buffer* buffer;            /**< Destinazione di LAVORO_SERIALIZZA */
+    const VistaSezione* vista; /**< Sorgente di LAVORO_DESERIALIZZA */
+    const VistaSezione* indice; /**< Indice salvato da adottare (dati NULL = ricostruisci) */
+    bool esito;
+} LavoroTabella;
+
+/** Nome del file `.dat` di ogni tabella, nell'ordine di TipoSezione. */
+static const char* const FILE_TABELLE[NUM_SEZIONI] = {
+    "allievi.dat", "pagamenti.dat", "esami.dat", "guide.dat"
+};
+
+/**
+ * @brief Esegue il lavoro sulla tabella indicata.
+ *
+ * Nel caricamento l'indice per ID di ogni lista viene adottato da
+ * `autoscuola.idx` o ricostruito dalla funzione di deserializzazione,
+ * quindi sullo stesso thread.
+ */
+static bool eseguiLavoro(const LavoroTabella* l) {
+    const char* file = FILE_TABELLE[l->tabella];
+
+    switch (l->tipo) {
+        case LAVORO_SALVA_FILE:
+            switch (l->tabella) {
+                case SEZIONE_ALLIEVI:   return salvaAllievi(l->listaA, file);
+                case SEZIONE_PAGAMENTI: return salvaPagamenti(l->listaP, file);
+                case SEZIONE_ESAMI:     return salvaEsami(l->listaE, file);
+                case SEZIONE_GUIDE:     return salvaGuide(l->listaG, file);
+                default:                return false;
+            }
+        case LAVORO_CARICA_FILE:
+            switch (l->tabella) {
+                case SEZIONE_ALLIEVI:   return caricaAllievi(l->listaA, file);
+                case SEZIONE_PAGAMENTI: return caricaPagamenti(l->listaP, file);
+                case SEZIONE_ESAMI:     return caricaEsami(l->listaE, file);
+                case SEZIONE_GUIDE:     return caricaGuide(l->listaG, file);
+                default:                return false;
+            }
+        case LAVORO_SERIALIZZA:
+            switch (l->tabella) {
+                case SEZIONE_ALLIEVI:   return serializzaAllievi(l->listaA, l->buffer);
+                case SEZIONE_PAGAMENTI: return serializzaPagamenti(l->listaP, l->buffer);
+                case SEZIONE_ESAMI:     return serializzaEsami(l->listaE, l->buffer);
+                case SEZIONE_GUIDE:     return serializzaGuide(l->listaG, l->buffer);
+                default:                return false;
+            }
+        case LAVORO_DESERIALIZZA: {
+            const unsigned char* ind = (l->indice != NULL) ? l->indice->dati : NULL;
+            size_t n_ind = (l->indice != NULL) ? l->indice->lunghezza : 0;
+            switch (l->tabella) {
+                case SEZIONE_ALLIEVI:   return deserializzaAllieviConIndice(l->listaA, l->vista->dati, l->vista->lunghezza, ind, n_ind);
+                case SEZIONE_PAGAMENTI: return deserializzaPagamentiConIndice(l->listaP, l->vista->dati, l->vista->lunghezza, ind, n_ind);
+                case SEZIONE_ESAMI:     return deserializzaEsamiConIndice(l->listaE, l->vista->dati, l->vista->lunghezza, ind, n_ind);
+                case SEZIONE_GUIDE:     return deserializzaGuideConIndice(l->listaG, l->vista->dati, l->vista->lunghezza, ind, n_ind);
+                default:                return false;
+            }
+        }
+        case LAVORO_SERIALIZZA_INDICE:
+            switch (l->tabella) {
+                case SEZIONE_ALLIEVI:   return serializzaIndiceAllievi(l->listaA, l->buffer);
+                case SEZIONE_PAGAMENTI: return serializzaIndicePagamenti(l->listaP, l->buffer);
+                case SEZIONE_ESAMI:     return serializzaIndiceEsami(l->listaE, l->buffer);
+                case SEZIONE_GUIDE:     return serializzaIndiceGuide(l->listaG, l->buffer);
+                default:                return false;
+            }
+    }
+    return false;
+}
+
+/**
+ * @brief Punto di ingresso dei thread di lavoro.
+ */
+static void* threadLavoro(void* arg) {
+    LavoroTabella* l = (LavoroTabella*)arg;
+    l->esito = eseguiLavoro(l);
+    return NULL;
+}
+
+/**
+ * @brief Esegue lo stesso tipo di lavoro sulle quattro tabelle, un thread per tabella.
+ *
+ * Le tabelle sono indipendenti finche' non viene chiamata aggiornaID(),
+ * quindi possono essere elaborate contemporaneamente. Se un thread non puo'
+ * essere creato, il lavoro corrispondente viene eseguito sul thread chiamante.
+ *
+ * @return true se tutti i lavori sono riusciti.
+ */
+static bool eseguiSuTutteLeTabelle(TipoLavoro tipo,
+                                   ListaAllievi* listaA, ListaPagamenti* listaP,
+                                   ListaEsami* listaE, ListaGuide* listaG,
+                                   Buffer buffer[NUM_SEZIONI],
+                                   const VistaSezione viste[NUM_SEZIONI],
+                                   const VistaSezione indici[NUM_SEZIONI],
+                                   bool esiti[NUM_SEZIONI]) {
+    LavoroTabella lavori[NUM_SEZIONI];
+    pthread_t thread[NUM_SEZIONI];
+    bool avviato[NUM_SEZIONI];
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        lavori[i].tipo = tipo;
+        lavori[i].tabella = (TipoSezione)i;
+        lavori[i].listaA = listaA;
+        lavori[i].listaP = listaP;
+        lavori[i].listaE = listaE;
+        lavori[i].listaG = listaG;
+        lavori[i].buffer = (buffer != NULL) ? &buffer[i] : NULL;
+        lavori[i].vista = (viste != NULL) ? &viste[i] : NULL;
+        lavori[i].indice = (indici != NULL && indici[i].dati != NULL) ? &indici[i] : NULL;
+        lavori[i].esito = false;
+
+        avviato[i] = (pthread_create(&thread[i], NULL, threadLavoro, &lavori[i]) == 0);
+        if (!avviato[i]) {
+            lavori[i].esito = eseguiLavoro(&lavori[i]);
+        }
+    }
+
+    bool tutti = true;
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        if (avviato[i]) {
+            pthread_join(thread[i], NULL);
+        }
+        if (esiti != NULL) {
+            esiti[i] = lavori[i].esito;
+        }
+        tutti &= lavori[i].esito;
+    }
+    return tutti;
+}
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @struct TimbroIndice
+ * @brief Intestazione di ogni sezione di `autoscuola.idx`.
+ *
+ * Lega l'indice salvato alla sezione dati da cui e' stato costruito: se
+ * generazione, checksum o lunghezza non coincidono con l'archivio letto,
+ * l'indice e' obsoleto e viene ricostruito.
+ */
+typedef struct {
+    uint64_t generazione;   /**< Generazione dell'archivio dati */
+    uint32_t checksum_dati; /**< Checksum della sezione dati corrispondente */
+    uint32_t lunghezza_dati; /**< Lunghezza della sezione dati corrispondente */
+} TimbroIndice;
+
+/**
+ * @brief Scrive gli indici per ID delle quattro liste in `autoscuola.idx`.
+ *
+ * Il file usa lo stesso formato dell'archivio: ogni sezione contiene un
+ * TimbroIndice seguito dall'immagine dell'IndiceID, allineata come i dati
+ * e quindi riutilizzabile senza conversioni. Un errore non compromette il
+ * salvataggio dei dati: al prossimo avvio gli indici verranno ricostruiti.
+ */
+static void salvaIndici(const ListaAllievi* listaA,
+                        const ListaPagamenti* listaP,
+                        const ListaEsami* listaE,
+                        const ListaGuide* listaG,
+                        const Buffer dati[NUM_SEZIONI]) {
+    Buffer sezioni[NUM_SEZIONI];
+    bool ok = true;
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        inizializzaBuffer(&sezioni[i]);
+
+        TimbroIndice timbro;
+        memset(&timbro, 0, sizeof(timbro));
+        timbro.generazione = generazione_archivio;
+        timbro.checksum_dati = checksumArchivio(dati[i].dati, dati[i].lunghezza);
+        timbro.lunghezza_dati = (uint32_t)dati[i].lunghezza;
+        ok &= scriviBuffer(&sezioni[i], &timbro, sizeof(timbro));
+    }
+
+    ok = ok && eseguiSuTutteLeTabelle(LAVORO_SERIALIZZA_INDICE,
+                                      (ListaAllievi*)listaA, (ListaPagamenti*)listaP,
+                                      (ListaEsami*)listaE, (ListaGuide*)listaG,
+                                      sezioni, NULL, NULL, NULL);
+
+    if (!ok || !scriviArchivio(INDICI_FILE_PREDEFINITO, sezioni, generazione_archivio)) {
+        remove(INDICI_FILE_PREDEFINITO);
+    }
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        liberaBuffer(&sezioni[i]);
+    }
+}
+
+/**
+ * @brief Legge `autoscuola.idx` e seleziona gli indici coerenti con i dati letti.
+ *
+ * Per ogni tabella `indici[i]` punta all'immagine dell'indice se il timbro
+ * corrisponde alla sezione dati, altrimenti ha `dati` NULL (da ricostruire).
+ *
+ * @param contenuto Buffer che riceve il file (da liberare dal chiamante).
+ * @return Numero di indici adottabili.
+ */
+static int leggiIndici(Buffer* contenuto, const VistaSezione dati[NUM_SEZIONI],
+                       uint64_t generazione, VistaSezione indici[NUM_SEZIONI]) {
+    VistaSezione sezioni[NUM_SEZIONI];
+    uint64_t generazione_indici = 0;
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        indici[i].dati = NULL;
+        indici[i].lunghezza = 0;
+        indici[i].checksum = 0;
+    }
+
+    if (!leggiArchivio(INDICI_FILE_PREDEFINITO, contenuto, sezioni, &generazione_indici) ||
+        generazione_indici != generazione) {
+        return 0;
+    }
+
+    int validi = 0;
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        if (sezioni[i].lunghezza < sizeof(TimbroIndice)) continue;
+
+        TimbroIndice timbro;
+        memcpy(&timbro, sezioni[i].dati, sizeof(timbro));
+        if (timbro.generazione != generazione ||
+            timbro.checksum_dati != dati[i].checksum ||
+            timbro.lunghezza_dati != dati[i].lunghezza) {
+            continue;
+        }
+
+        indici[i].dati = sezioni[i].dati + sizeof(TimbroIndice);
+        indici[i].lunghezza = sezioni[i].lunghezza - sizeof(TimbroIndice);
+        validi++;
+    }
+    return validi;
+}
+
+/**
+ * @brief Serializza le quattro tabelle in parallelo e le scrive nell'archivio unico.
+ *
+ * Dopo i dati vengono salvati anche gli indici per ID, timbrati con la
+ * nuova generazione.
+ */
+static bool salvaArchivioUnico(const ListaAllievi* listaA,
+                               const ListaPagamenti* listaP,
+                               const ListaEsami* listaE,
+                               const ListaGuide* listaG) {
+    Buffer sezioni[NUM_SEZIONI];
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        inizializzaBuffer(&sezioni[i]);
+    }
+
+    bool ok = eseguiSuTutteLeTabelle(LAVORO_SERIALIZZA,
+                                     (ListaAllievi*)listaA, (ListaPagamenti*)listaP,
+                                     (ListaEsami*)listaE, (ListaGuide*)listaG,
+                                     sezioni, NULL, NULL, NULL);
+
+    ok = ok && scriviArchivio(ARCHIVIO_FILE_PREDEFINITO, sezioni, generazione_archivio + 1);
+    if (ok) {
+        generazione_archivio++;
+        archivio_superato = true;
+        salvaIndici(listaA, listaP, listaE, listaG, sezioni);
+    }
+
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        liberaBuffer(&sezioni[i]);
+    }
+    return ok;
+}
+
+/**
+ * @brief Carica le quattro tabelle da un file in formato archivio.
+ *
+ * Il file viene letto una sola volta; le sezioni vengono poi deserializzate
+ * in parallelo. Per l'archivio predefinito gli indici per ID vengono
+ * adottati da `autoscuola.idx` quando sono aggiornati. Se una sola sezione
+ * non e' valida nessuna tabella viene adottata: le liste vengono riportate
+ * allo stato vuoto.
+ */
+static bool caricaArchivioUnico(const char* filename,
+                                ListaAllievi* listaA,
+                                ListaPagamenti* listaP,
+                                ListaEsami* listaE,
+                                ListaGuide* listaG) {
+    Buffer contenuto, contenuto_indici;
+    inizializzaBuffer(&contenuto);
+    inizializzaBuffer(&contenuto_indici);
+
+    VistaSezione sezioni[NUM_SEZIONI];
+    VistaSezione indici[NUM_SEZIONI];
+    uint64_t generazione = 0;
+    bool ok = leggiArchivio(filename, &contenuto, sezioni, &generazione);
+    bool predefinito = (strcmp(filename, ARCHIVIO_FILE_PREDEFINITO) == 0);
+
+    if (ok && predefinito) {
+        leggiIndici(&contenuto_indici, sezioni, generazione, indici);
+    }
+
+    ok = ok && eseguiSuTutteLeTabelle(LAVORO_DESERIALIZZA, listaA, listaP, listaE, listaG,
+                                      NULL, sezioni, predefinito ? indici : NULL, NULL);
+
+    if (ok) {
+        if (predefinito) {
+            generazione_archivio = generazione;
+            archivio_superato = true;
+        }
+    } else {
+        inizializzaLista(listaA);
+        inizializzaListaPagamenti(listaP);
+        inizializzaListaEsami(listaE);
+        inizializzaListaGuide(listaG);
+    }
+
+    liberaBuffer(&contenuto_indici);
+    liberaBuffer(&contenuto);
+    return ok;
+}
+
+/**
+ * @brief Segnala un file di dati non leggibile e disattiva il salvataggio.
+ */
+static void segnalaFileIlleggibile(const char* filename) {
+    printf("Errore: %s non leggibile. Il file e' stato conservato e\n", filename);
+    printf("i dati non verranno salvati finche' non viene ripristinato o rimosso.\n");
+    file_illeggibile = filename;
+}
 
 //FUNZIONI DI COORDINAMENTO I/O
 
@@ -23,15 +445,38 @@ bool salvaTuttiDati(const ListaAllievi* listaA,
                     const ListaGuide* listaG) {
     bool ok = true;
 
-    printf("Salvataggio dati in corso...\n");
+    if (messaggi_avanzamento) printf("Salvataggio dati in corso...\n");
+
+    if (file_illeggibile != NULL) {
+        printf("Errore: salvataggio disattivato, il file %s non e' stato letto.\n",
+               file_illeggibile);
+        return false;
+    }
 
-    ok &= salvaAllievi(listaA, "allievi.dat");
-    ok &= salvaPagamenti(listaP, "pagamenti.dat");
-    ok &= salvaEsami(listaE, "esami.dat");
-    ok &= salvaGuide(listaG, "guide.dat");
+    if (formato_corrente == FORMATO_ISTANTANEA) {
+        ok = salvaIstantanea(listaA, listaP, listaE, listaG);
+    } else if (formato_corrente == FORMATO_FILE_UNICO) {
+        ok = salvaArchivioUnico(listaA, listaP, listaE, listaG);
+    } else {
+        ok = eseguiSuTutteLeTabelle(LAVORO_SALVA_FILE,
+                                    (ListaAllievi*)listaA, (ListaPagamenti*)listaP,
+                                    (ListaEsami*)listaE, (ListaGuide*)listaG,
+                                    NULL, NULL, NULL, NULL);
+    }
+
+    // Un'istantanea o un archivio non aggiornati non devono prevalere al prossimo avvio
+    if (ok && formato_corrente != FORMATO_ISTANTANEA && esisteIstantanea()) {
+        rimuoviIstantanea();
+    }
+    if (ok && formato_corrente == FORMATO_FILE_SEPARATI && archivio_superato) {
+        remove(ARCHIVIO_FILE_PREDEFINITO);
+        remove(INDICI_FILE_PREDEFINITO);
+        generazione_archivio = 0;
+        archivio_superato = false;
+    }
 
     if (ok) {
-        printf("Tutti i dati salvati con successo.\n");
+        if (messaggi_avanzamento) printf("Tutti i dati salvati con successo.\n");
     } else {
         printf("Alcuni dati non sono stati salvati correttamente.\n");
     }
@@ -45,24 +490,98 @@ bool caricaTuttiDati(ListaAllievi* listaA,
                      ListaGuide* listaG) {
     bool almeno_uno = false;
 
-    printf("Caricamento dati in corso...\n");
+    if (messaggi_avanzamento) printf("Caricamento dati in corso...\n");
+
+    // L'istantanea e l'archivio sono piu' recenti dei file separati: se non
+    // si leggono non si ripiega su dati piu' vecchi, che al salvataggio li
+    // sostituirebbero
+    file_illeggibile = NULL;
+    archivio_superato = false;
+    if (esisteIstantanea()) {
+        if (!caricaIstantanea(listaA, listaP, listaE, listaG)) {
+            segnalaFileIlleggibile(ISTANTANEA_FILE_PREDEFINITO);
+            return false;
+        }
+        formato_corrente = FORMATO_ISTANTANEA;
+        archivio_superato = esisteArchivio(ARCHIVIO_FILE_PREDEFINITO);
+        almeno_uno = true;
+    }
 
-    almeno_uno |= caricaAllievi(listaA, "allievi.dat");
-    almeno_uno |= caricaPagamenti(listaP, "pagamenti.dat");
-    almeno_uno |= caricaEsami(listaE, "esami.dat");
-    almeno_uno |= caricaGuide(listaG, "guide.dat");
+    if (!almeno_uno && esisteArchivio(ARCHIVIO_FILE_PREDEFINITO)) {
+        if (!caricaArchivioUnico(ARCHIVIO_FILE_PREDEFINITO, listaA, listaP, listaE, listaG)) {
+            segnalaFileIlleggibile(ARCHIVIO_FILE_PREDEFINITO);
+            return false;
+        }
+        formato_corrente = FORMATO_FILE_UNICO;
+        almeno_uno = true;
+    }
+
+    if (!almeno_uno) {
+        bool esiti[NUM_SEZIONI];
+        eseguiSuTutteLeTabelle(LAVORO_CARICA_FILE, listaA, listaP, listaE, listaG,
+                               NULL, NULL, NULL, esiti);
+        for (int i = 0; i < NUM_SEZIONI; i++) {
+            almeno_uno |= esiti[i];
+        }
+    }
 
     if (almeno_uno) {
-        printf("Dati caricati con successo.\n");
+        if (messaggi_avanzamento) printf("Dati caricati con successo.\n");
         // Aggiorna l'ID corrente dopo il caricamento
         aggiornaID(listaA);
-    } else {
+    } else if (messaggi_avanzamento) {
         printf("Nessun dato precedente trovato. Inizializzazione nuova sessione.\n");
     }
 
     return almeno_uno;
 }
 
+bool datiIlleggibili(void) {
+    return file_illeggibile != NULL;
+}
+
+uint64_t improntaDatiSalvati(void) {
+    const char* file[NUM_SEZIONI + 2];
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        file[i] = FILE_TABELLE[i];
+    }
+    file[NUM_SEZIONI] = ARCHIVIO_FILE_PREDEFINITO;
+    file[NUM_SEZIONI + 1] = ISTANTANEA_FILE_PREDEFINITO;
+
+    Buffer contenuto;
+    inizializzaBuffer(&contenuto);
+    uint64_t impronta = 0;
+    for (int i = 0; i < NUM_SEZIONI + 2; i++) {
+        uint64_t voce = 0;  // File mancante
+        if (leggiFileInBuffer(file[i], &contenuto)) {
+            voce = ((uint64_t)checksumArchivio(contenuto.dati, contenuto.lunghezza) << 32) ^
+                   (uint64_t)contenuto.lunghezza ^ 1u;
+        }
+        impronta = ((impronta << 7) | (impronta >> 57)) ^ voce;
+    }
+    liberaBuffer(&contenuto);
+    return impronta;
+}
+
+bool ripristinaDaArchivio(const char* filename,
+                          ListaAllievi* listaA,
+                          ListaPagamenti* listaP,
+                          ListaEsami* listaE,
+                          ListaGuide* listaG) {
+    if (filename == NULL || listaA == NULL || listaP == NULL ||
+        listaE == NULL || listaG == NULL) {
+        return false;
+    }
+
+    if (!caricaArchivioUnico(filename, listaA, listaP, listaE, listaG)) {
+        printf("Errore: il file %s non e' un archivio valido.\n", filename);
+        return false;
+    }
+
+    aggiornaID(listaA);
+    return true;
+}
+
 bool esportaResocontoCompleto(const ListaAllievi* listaA,
                               const ListaPagamenti* listaP,
                               const ListaEsami* listaE,
@@ -72,170 +591,11 @@ bool esportaResocontoCompleto(const ListaAllievi* listaA,
         return false;
     }
 
-    FILE* f = fopen("resoconto_allievi.txt", "w");
-    if (!f) {
-        printf("Errore: impossibile creare il file resoconto_allievi.txt\n");
+    if (!aggiornaResoconto(RESOCONTO_FILE_PREDEFINITO, listaA, listaP, listaE, listaG, NULL)) {
         return false;
     }
 
-    int n_allievi = getNumeroAllievi(listaA);
-
-    fprintf(f, "______________________________________________________________\n");
-    fprintf(f, "|     RESOCONTO COMPLETO ALLIEVI AUTOSCUOLA                  |\n");
-    fprintf(f, "______________________________________________________________\n\n");
-    fprintf(f, "Totale allievi: %d\n\n", n_allievi);
-
-    // Nota: Per ordinare alfabeticamente servirebbe una funzione nell'ADT
-    // Per ora iteriamo in ordine di inserimento
-
-    for (int i = 0; i < n_allievi; i++) {
-        const Allievo* a = getAllievoAtIndex(listaA, i);
-        if (a == NULL) continue;
-
-        int id = getAllievoID(a);
-        const char* nome = getAllievoNome(a);
-        const char* cognome = getAllievoCognome(a);
-        const char* cf = getAllievoCodiceFiscale(a);
-        const char* patente = getAllievoCategoriaPatente(a);
-        const char* stato = getAllievoStato(a);
-
-        fprintf(f, "___________________________________________________________\n");
-        fprintf(f, "| ID: %d\n", id);
-        fprintf(f, "| Nome: %s %s\n", nome, cognome);
-        fprintf(f, "| Codice Fiscale: %s\n", cf);
-        fprintf(f, "| Patente: %s\n", patente);
-        fprintf(f, "| Stato: %s\n", stato);
-        fprintf(f, "___________________________________________________________\n");
-
-        // --- PAGAMENTI ---
-        fprintf(f, "\n[PAGAMENTI]\n");
-        Pagamento* p = cercaPagamentoPerID(listaP, id);
-        if (p != NULL) {
-            float prima = getPrimaRata(p);
-            float seconda = getSecondaRata(p);
-            float terza = getTerzaRata(p);
-            float extra_base = getExtra(p);
-            float totale_rate = prima + seconda + terza;
-
-            // Calcola costo ore extra
-            float costo_ore_extra = 0.0;
-            int ore_extra = 0;
-            if (listaG != NULL) {
-                Guida* g = cercaGuidaPerID(listaG, id);
-                if (g != NULL) {
-                    ore_extra = getOreExtra(g);
-                    costo_ore_extra = calcolaCostoOreExtra(g, 15.0);
-                }
-            }
-
-            float totale_complessivo = totale_rate + extra_base + costo_ore_extra;
-
-            fprintf(f, "  Prima rata:      %.2f €\n", prima);
-            fprintf(f, "  Seconda rata:    %.2f €\n", seconda);
-            fprintf(f, "  Terza rata:      %.2f €\n", terza);
-            fprintf(f, "  Extra generici:  %.2f €\n", extra_base);
-            fprintf(f, "  Extra guide (%d ore x 15€): %.2f €\n", ore_extra, costo_ore_extra);
-            fprintf(f, "  ─────────────────────────\n");
-            fprintf(f, "  TOTALE PAGATO:   %.2f €\n", totale_complessivo);
-
-            if (totale_rate >= 750.0) {
-                fprintf(f, "  Rate principali complete\n");
-            } else {
-                fprintf(f, "  Mancano %.2f € sulle rate\n", 750.0 - totale_rate);
-            }
-        } else {
-            fprintf(f, "  Nessun pagamento registrato.\n");
-        }
-
-        // --- ESAMI ---
-        fprintf(f, "\n[ESAMI]\n");
-        Esame* e = cercaEsamePerID(listaE, id);
-        if (e != NULL) {
-            int tent_teorico = getTentativiTeorico(e);
-            int tent_pratico = getTentativiPratico(e);
-            bool superato_teorico = isTeoricoSuperato(e);
-            bool superato_pratico = isPraticoSuperato(e);
-
-            fprintf(f, "  Teorico: %d tentativi - %s\n",
-                    tent_teorico, superato_teorico ? "Superato" : "Non superato");
-
-            for (int t = 0; t < tent_teorico; t++) {
-                Data d;
-                if (getDataTeorico(e, t, &d) && d.giorno != 0) {
-                    fprintf(f, "    - Tentativo %d: %02d/%02d/%04d\n",
-                            t + 1, d.giorno, d.mese, d.anno);
-                }
-            }
-
-            fprintf(f, "  Pratico: %d tentativi - %s\n",
-                    tent_pratico, superato_pratico ? "Superato" : "Non superato");
-
-            for (int t = 0; t < tent_pratico; t++) {
-                Data d;
-                if (getDataPratico(e, t, &d) && d.giorno != 0) {
-                    fprintf(f, "    - Tentativo %d: %02d/%02d/%04d\n",
-                            t + 1, d.giorno, d.mese, d.anno);
-                }
-            }
-        } else {
-            fprintf(f, "  Nessun esame registrato.\n");
-        }
-
-        // --- GUIDE ---
-        fprintf(f, "\n[GUIDE]\n");
-        Guida* g = cercaGuidaPerID(listaG, id);
-        if (g != NULL) {
-            int ore_svolte = getOreSvolte(g);
-            int ore_extra = getOreExtra(g);
-
-            fprintf(f, "  Ore svolte:      %d\n", ore_svolte);
-            fprintf(f, "  Ore extra:       %d\n", ore_extra);
-
-            if (haCompletateOreObbligatorie(g)) {
-                fprintf(f, "  Ore obbligatorie completate\n");
-            } else {
-                fprintf(f, "  Mancano %d ore obbligatorie\n", 6 - ore_svolte);
-            }
-        } else {
-            fprintf(f, "  Nessuna guida registrata.\n");
-        }
-
-        // --- IDONEITÀ FINALE ---
-        fprintf(f, "\n[ESITO FINALE]\n");
-
-        bool teorico_ok = false;
-        bool pratico_ok = false;
-        bool pagamenti_ok = false;
-        bool guide_ok = false;
-
-        if (e != NULL) {
-            teorico_ok = isTeoricoSuperato(e);
-            pratico_ok = isPraticoSuperato(e);
-        }
-
-        if (p != NULL) {
-            float totale_rate = getPrimaRata(p) + getSecondaRata(p) + getTerzaRata(p);
-            pagamenti_ok = (totale_rate >= 750.0);
-        }
-
-        if (g != NULL) {
-            guide_ok = haCompletateOreObbligatorie(g);
-        }
-
-        bool idoneo = teorico_ok && pratico_ok && pagamenti_ok && guide_ok;
-
-        fprintf(f, "  Esame teorico:   %s\n", teorico_ok ? "Superato" : "Non superato");
-        fprintf(f, "  Esame pratico:   %s\n", pratico_ok ? "Superato" : "Non superatO");
-        fprintf(f, "  Pagamenti:       %s\n", pagamenti_ok ? "Completo" : "Non completo");
-        fprintf(f, "  Guide (6+ ore):  %s\n", guide_ok ? "Completo" : "Non completo");
-        fprintf(f, "  ─────────────────────────\n");
-        fprintf(f, "  -> %s\n", idoneo ? "IDONEO " : "NON IDONEO");
-
-        fprintf(f, "\n___________________________________________________________\n\n");
-    }
-
-    fclose(f);
-    printf("Resoconto esportato in 'resoconto_allievi.txt'\n");
+    printf("Resoconto esportato in '%s'\n", RESOCONTO_FILE_PREDEFINITO);
     return true;
 }
 
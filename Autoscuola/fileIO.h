@@ -11,12 +11,21 @@
  * - `pagamenti.dat` (gestito da pagamenti.c)
  * - `esami.dat` (gestito da esami.c)
  * - `guide.dat` (gestito da guida.c)
+ * - `autoscuola.db` (archivio unico opzionale, gestito da archivio.c)
+ * - `autoscuola.idx` (indici per ID dell'archivio unico, ricostruibili)
+ * - `autoscuola.snap` (istantanea differenziale opzionale, gestita da istantanea.c)
+ * - `autosalvataggio.db` (istantanea periodica, gestita da autosalvataggio.c)
+ * - `autoscuola.lock` (blocco esclusivo dell'istanza che usa i dati)
  * - `resoconto_allievi.txt` (report testuale generato da questo modulo)
  */
 #ifndef FILEIO_H
 #define FILEIO_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+//COSTANTI PUBBLICHE
+#define BLOCCO_DATI_FILE "autoscuola.lock"
 
 //FORWARD DECLARATIONS (tipi opachi)
 typedef struct ListaAllievi ListaAllievi;
@@ -24,16 +33,80 @@ typedef struct ListaPagamenti ListaPagamenti;
 typedef struct ListaEsami ListaEsami;
 typedef struct ListaGuide ListaGuide;
 
+/**
+ * @brief Formato usato per la persistenza dei dati.
+ */
+typedef enum {
+    FORMATO_FILE_SEPARATI = 0, /**< Un file `.dat` per ogni tabella */
+    FORMATO_FILE_UNICO = 1,    /**< Tutte le tabelle in `autoscuola.db` */
+    FORMATO_ISTANTANEA = 2     /**< Record fissi in `autoscuola.snap`, salvataggio differenziale */
+} FormatoArchivio;
+
+//FUNZIONI DI CONFIGURAZIONE
+
+/**
+ * @brief Imposta il formato usato dai salvataggi successivi.
+ * @param formato Formato desiderato.
+ */
+void impostaFormatoArchivio(FormatoArchivio formato);
+
+/**
+ * @brief Restituisce il formato di salvataggio corrente.
+ *
+ * Dopo un caricamento riuscito da `autoscuola.db` o `autoscuola.snap` il
+ * formato diventa automaticamente FORMATO_FILE_UNICO o FORMATO_ISTANTANEA.
+ *
+ * @return Formato corrente.
+ */
+FormatoArchivio getFormatoArchivio(void);
+
+/**
+ * @brief Attiva o disattiva i messaggi di avanzamento di caricamento e salvataggio.
+ *
+ * I comandi non interattivi li disattivano perche' l'output contenga solo
+ * il risultato; gli errori vengono comunque segnalati.
+ *
+ * @param attivi true per mostrarli (predefinito).
+ */
+void impostaMessaggiAvanzamento(bool attivi);
+
+/**
+ * @brief Acquisisce il blocco esclusivo sui dati (`autoscuola.lock`).
+ *
+ * Menu, servizio e comandi non interattivi lo acquisiscono prima di
+ * caricare i dati: una sola istanza alla volta puo' usarli. Il blocco viene
+ * rilasciato dal sistema anche se il processo termina in modo anomalo.
+ *
+ * @return true se acquisito, false se un'altra istanza usa i dati o il file
+ *         non puo' essere creato.
+ */
+bool acquisisciBloccoDati(void);
+
+/**
+ * @brief Rilascia il blocco acquisito con acquisisciBloccoDati().
+ */
+void rilasciaBloccoDati(void);
+
 //FUNZIONI DI COORDINAMENTO I/O
 
 /**
  * @brief Salva tutti i dati su file binari.
  *
- * Chiama le funzioni di salvataggio di ogni ADT:
+ * Con FORMATO_FILE_SEPARATI chiama le funzioni di salvataggio di ogni ADT:
  * - salvaAllievi() in allievi.dat
  * - salvaPagamenti() in pagamenti.dat
  * - salvaEsami() in esami.dat
  * - salvaGuide() in guide.dat
+ * e rimuove `autoscuola.db` e `autoscuola.idx`, che altrimenti verrebbero
+ * caricati al posto dei file appena scritti, se l'archivio era stato
+ * caricato, scritto o superato dall'istantanea in questa sessione.
+ *
+ * Con FORMATO_FILE_UNICO serializza le quattro tabelle e le scrive
+ * atomicamente in `autoscuola.db`.
+ *
+ * Con FORMATO_ISTANTANEA riscrive in `autoscuola.snap` solo i blocchi di
+ * record modificati dall'ultimo salvataggio. Negli altri formati
+ * l'istantanea, ormai superata, viene rimossa.
  *
  * @param listaA Puntatore alla lista degli allievi.
  * @param listaP Puntatore alla lista dei pagamenti.
@@ -49,7 +122,12 @@ bool salvaTuttiDati(const ListaAllievi* listaA,
 /**
  * @brief Carica tutti i dati dai file binari.
  *
- * Chiama le funzioni di caricamento di ogni ADT:
+ * Se esiste un'istantanea `autoscuola.snap`, o in alternativa un archivio
+ * `autoscuola.db`, le quattro tabelle vengono lette da li'. Un'istantanea o
+ * un archivio che non si riescono a leggere non vengono sostituiti da fonti
+ * piu' vecchie: il file viene conservato, le liste restano vuote e
+ * salvaTuttiDati() rifiuta di salvare.
+ * Altrimenti chiama le funzioni di caricamento di ogni ADT:
  * - caricaAllievi() da allievi.dat
  * - caricaPagamenti() da pagamenti.dat
  * - caricaEsami() da esami.dat
@@ -68,6 +146,48 @@ bool caricaTuttiDati(ListaAllievi* listaA,
                      ListaEsami* listaE,
                      ListaGuide* listaG);
 
+/**
+ * @brief Indica se l'ultimo caricamento ha trovato un file di dati non leggibile.
+ *
+ * Distingue un'istantanea o un archivio danneggiati, conservati senza
+ * caricarli, dall'assenza di dati di una nuova installazione: in entrambi
+ * i casi caricaTuttiDati() restituisce false.
+ *
+ * @return true se l'istantanea o l'archivio non sono stati letti.
+ */
+bool datiIlleggibili(void);
+
+/**
+ * @brief Calcola un'impronta dei file di dati presenti su disco.
+ *
+ * Considera i file `.dat`, `autoscuola.db` e `autoscuola.snap` (non gli
+ * indici, ricostruibili): ogni salvataggio che cambia i dati cambia
+ * l'impronta. Il giornale del servizio la registra alla creazione per
+ * riconoscere, dopo un'interruzione, se i dati sono gia' stati salvati.
+ *
+ * @return Impronta dei file (0 se non ce n'e' nessuno).
+ */
+uint64_t improntaDatiSalvati(void);
+
+/**
+ * @brief Sostituisce i dati in memoria con quelli di un file in formato archivio.
+ *
+ * Usato per il ripristino da `autosalvataggio.db` dopo una sessione
+ * interrotta. Se il file non e' integro le liste restano vuote.
+ *
+ * @param filename Nome del file archivio.
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ * @return true se il ripristino riesce, false altrimenti.
+ */
+bool ripristinaDaArchivio(const char* filename,
+                          ListaAllievi* listaA,
+                          ListaPagamenti* listaP,
+                          ListaEsami* listaE,
+                          ListaGuide* listaG);
+
 /**
  * @brief Esporta un resoconto completo in formato testo leggibile.
  *
@@ -78,6 +198,8 @@ bool caricaTuttiDati(ListaAllievi* listaA,
  * - Ore di guida svolte ed extra
  *
  * Usa le interfacce pubbliche degli ADT (getter) per ottenere i dati.
+ * La formattazione e' divisa tra piu' thread e, dopo la prima esportazione,
+ * vengono riformattati solo gli allievi modificati (vedi resoconto.h).
  *
  * @param listaA Puntatore alla lista degli allievi.
  * @param listaP Puntatore alla lista dei pagamenti.
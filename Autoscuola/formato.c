@@ -0,0 +1,166 @@
+/**
+ * @file formato.c
+ * @brief Implementazione della formattazione rapida di interi, importi e date.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "formato.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+
+/** Le cento coppie di cifre "00".."99", una dopo l'altra. */
+static const char COPPIE_CIFRE[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Scrive le cifre di un valore senza segno, almeno `cifre` cifre.
+ * @return Caratteri scritti (senza terminatore).
+ */
+static size_t scriviCifre(char* dest, unsigned long long v, int cifre) {
+    char tmp[FORMATO_MAX_INTERO];
+    int n = 0;
+
+    // Due cifre per iterazione dalla tabella
+    while (v >= 100) {
+        const char* coppia = &COPPIE_CIFRE[(v % 100) * 2];
+        tmp[n++] = coppia[1];
+        tmp[n++] = coppia[0];
+        v /= 100;
+    }
+    if (v >= 10) {
+        tmp[n++] = COPPIE_CIFRE[v * 2 + 1];
+        tmp[n++] = COPPIE_CIFRE[v * 2];
+    } else {
+        tmp[n++] = (char)('0' + v);
+    }
+    while (n < cifre && n < FORMATO_MAX_INTERO - 2) tmp[n++] = '0';
+
+    for (int i = 0; i < n; i++) dest[i] = tmp[n - 1 - i];
+    return (size_t)n;
+}
+
+/**
+ * @brief Come formattaInteroConZeri(), senza terminatore.
+ */
+static size_t scriviIntero(char* dest, long long valore, int cifre) {
+    size_t len = 0;
+    unsigned long long v = (unsigned long long)valore;
+    if (valore < 0) {
+        dest[len++] = '-';
+        v = 0ULL - v;
+    }
+    return len + scriviCifre(dest + len, v, cifre - (int)len);
+}
+
+/**
+ * @brief Scrive un campo di data a due cifre (come `%02d`).
+ */
+static size_t scriviDueCifre(char* dest, int valore) {
+    if (valore >= 0 && valore <= 99) {
+        dest[0] = COPPIE_CIFRE[valore * 2];
+        dest[1] = COPPIE_CIFRE[valore * 2 + 1];
+        return 2;
+    }
+    return scriviIntero(dest, valore, 2);
+}
+
+//FUNZIONI PUBBLICHE
+
+size_t formattaIntero(char* dest, long long valore) {
+    size_t len = scriviIntero(dest, valore, 1);
+    dest[len] = '\0';
+    return len;
+}
+
+size_t formattaInteroConZeri(char* dest, long long valore, int cifre) {
+    size_t len = scriviIntero(dest, valore, cifre);
+    dest[len] = '\0';
+    return len;
+}
+
+size_t formattaImporto(char* dest, double importo) {
+    bool negativo = importo < 0 || (importo == 0 && 1.0 / importo < 0);
+    double valore = negativo ? -importo : importo;
+
+    if (!(valore < 9.0e13)) {
+        // Oltre 2^53 / 100 i centesimi non sono piu' esatti in un double (o infinito/NaN): lo fa printf
+        int n = snprintf(dest, FORMATO_MAX_IMPORTO, "%.2f", importo);
+        return (n < 0) ? 0 : (n < FORMATO_MAX_IMPORTO ? (size_t)n : FORMATO_MAX_IMPORTO - 1);
+    }
+
+    // Prodotto esatto valore * 100 = scalato + errore (Dekker, 100 non va diviso)
+    double scalato = valore * 100.0;
+    double spezza = 134217729.0 * valore;
+    double alto = spezza - (spezza - valore);
+    double basso = valore - alto;
+    double errore = (alto * 100.0 - scalato) + basso * 100.0;
+
+    unsigned long long centesimi = (unsigned long long)scalato;
+    double resto = scalato - (double)centesimi;
+    if (resto > 0.5 || (resto == 0.5 && (errore > 0 || (errore == 0 && (centesimi & 1))))) {
+        centesimi++;
+    }
+
+    size_t len = 0;
+    if (negativo) dest[len++] = '-';
+    len += scriviCifre(dest + len, centesimi / 100, 1);
+    dest[len++] = '.';
+    dest[len++] = COPPIE_CIFRE[(centesimi % 100) * 2];
+    dest[len++] = COPPIE_CIFRE[(centesimi % 100) * 2 + 1];
+    dest[len] = '\0';
+    return len;
+}
+
+size_t formattaData(char* dest, const Data* data) {
+    size_t len = scriviDueCifre(dest, data->giorno);
+    dest[len++] = '/';
+    len += scriviDueCifre(dest + len, data->mese);
+    dest[len++] = '/';
+    len += scriviIntero(dest + len, data->anno, 4);
+    dest[len] = '\0';
+    return len;
+}
+
+size_t formattaDataISO(char* dest, const Data* data) {
+    size_t len = scriviIntero(dest, data->anno, 4);
+    dest[len++] = '-';
+    len += scriviDueCifre(dest + len, data->mese);
+    dest[len++] = '-';
+    len += scriviDueCifre(dest + len, data->giorno);
+    dest[len] = '\0';
+    return len;
+}
+
+size_t formattaTesto(char* dest, const char* testo) {
+    size_t n = strlen(testo);
+    memcpy(dest, testo, n + 1);
+    return n;
+}
+
+size_t allineaColonna(char* dest, const char* testo, int larghezza, bool a_destra) {
+    size_t n = strlen(testo);
+    size_t spazi = (larghezza > 0 && (size_t)larghezza > n) ? (size_t)larghezza - n : 0;
+
+    if (a_destra) {
+        memset(dest, ' ', spazi);
+        memcpy(dest + spazi, testo, n);
+    } else {
+        memcpy(dest, testo, n);
+        memset(dest + n, ' ', spazi);
+    }
+    dest[n + spazi] = '\0';
+    return n + spazi;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file formato.h
+ * @brief Formattazione rapida di interi, importi e date in buffer del chiamante.
+ *
+ * Sostituisce `printf("%.2f")`, `%02d/%02d/%04d` e le larghezze di colonna
+ * (`%-16s`) nei punti in cui si stampano molte righe: niente analisi della
+ * stringa di formato, le coppie di cifre vengono copiate da una tabella
+ * precalcolata e gli importi sono resi in virgola fissa.
+ *
+ * Il risultato e' identico a quello di printf per gli stessi valori. Tutte
+ * le funzioni scrivono in `dest`, aggiungono il terminatore e restituiscono
+ * il numero di caratteri scritti (terminatore escluso); `dest` deve avere
+ * almeno la dimensione indicata dalla costante corrispondente. Una riga si
+ * compone facendo avanzare un cursore:
+ *
+ *     char riga[128];
+ *     char* r = riga;
+ *     r += formattaTesto(r, "Totale: ");
+ *     r += formattaImporto(r, totale);
+ *     fwrite(riga, 1, r - riga, stdout);
+ */
+#ifndef FORMATO_H
+#define FORMATO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "data.h"
+
+//COSTANTI PUBBLICHE
+#define FORMATO_MAX_INTERO 24   /**< Byte per un long long con segno e terminatore */
+#define FORMATO_MAX_IMPORTO 48  /**< Byte per un importo float con due decimali */
+#define FORMATO_MAX_DATA 40     /**< Byte per una data (anche con campi fuori intervallo) */
+
+/**
+ * @brief Intero in base 10 (come `%lld`).
+ * @param dest Almeno FORMATO_MAX_INTERO byte.
+ * @param valore Valore da scrivere.
+ * @return Caratteri scritti.
+ */
+size_t formattaIntero(char* dest, long long valore);
+
+/**
+ * @brief Intero con zeri iniziali fino a `cifre` cifre (come `%0*d`).
+ * @param dest Almeno FORMATO_MAX_INTERO byte.
+ * @param valore Valore da scrivere.
+ * @param cifre Numero minimo di cifre (al massimo FORMATO_MAX_INTERO - 2).
+ * @return Caratteri scritti.
+ */
+size_t formattaInteroConZeri(char* dest, long long valore, int cifre);
+
+/**
+ * @brief Importo con due decimali (come `%.2f`).
+ *
+ * Il prodotto per 100 viene calcolato esattamente (risultato in doppia
+ * precisione piu' errore di arrotondamento) e arrotondato al centesimo con
+ * la stessa regola di printf, meta' al pari; i centesimi vengono poi scritti
+ * come intero. Accetta sia i float delle liste sia differenze in double.
+ *
+ * @param dest Almeno FORMATO_MAX_IMPORTO byte.
+ * @param importo Importo da scrivere.
+ * @return Caratteri scritti.
+ */
+size_t formattaImporto(char* dest, double importo);
+
+/**
+ * @brief Data come gg/mm/aaaa (come `%02d/%02d/%04d`).
+ * @param dest Almeno FORMATO_MAX_DATA byte.
+ * @param data Data da scrivere.
+ * @return Caratteri scritti.
+ */
+size_t formattaData(char* dest, const Data* data);
+
+/**
+ * @brief Data come aaaa-mm-gg (formato per le esportazioni).
+ * @param dest Almeno FORMATO_MAX_DATA byte.
+ * @param data Data da scrivere.
+ * @return Caratteri scritti.
+ */
+size_t formattaDataISO(char* dest, const Data* data);
+
+/**
+ * @brief Copia un testo (per comporre una riga con le altre funzioni).
+ * @param dest Almeno strlen(testo) + 1 byte.
+ * @param testo Testo da copiare.
+ * @return Caratteri scritti.
+ */
+size_t formattaTesto(char* dest, const char* testo);
+
+/**
+ * @brief Testo allineato in una colonna (come `%-*s` o `%*s`).
+ *
+ * Se il testo e' piu' lungo della colonna viene copiato per intero.
+ *
+ * @param dest Almeno max(strlen(testo), larghezza) + 1 byte.
+ * @param testo Testo da copiare.
+ * @param larghezza Larghezza minima della colonna.
+ * @param a_destra true per allineare a destra, false a sinistra.
+ * @return Caratteri scritti.
+ */
+size_t allineaColonna(char* dest, const char* testo, int larghezza, bool a_destra);
+
+#endif // FORMATO_H
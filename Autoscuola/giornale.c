@@ -0,0 +1,169 @@
+/**
+ * @file giornale.c
+ * @brief Implementazione del giornale delle scritture del servizio.
+ *
+ * Dopo una scrittura non riuscita il file potrebbe contenere una voce
+ * parziale, oltre la quale la lettura si fermerebbe: il giornale viene
+ * quindi segnato come guasto e rifiuta le voci successive.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "giornale.h"
+#include "archivio.h"
+#include "buffer.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define MAGIC_GIORNALE "AUTOGIOR"
+#define VERSIONE_GIORNALE 2
+
+/**
+ * @struct IntestazioneGiornale
+ * @brief Intestazione fissa posta all'inizio del file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t versione;
+    uint32_t riservato;
+    uint64_t impronta_dati;     /**< Impronta dei file di dati all'apertura */
+} IntestazioneGiornale;
+
+/**
+ * @struct IntestazioneVoce
+ * @brief Intestazione di una voce.
+ */
+typedef struct {
+    uint32_t lunghezza;         /**< Byte del contenuto */
+    uint32_t checksum;          /**< Checksum del contenuto */
+} IntestazioneVoce;
+
+//STATO DEL MODULO
+static FILE* file_giornale = NULL;
+static bool guasto = false;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Svuota i buffer della libreria e forza i dati sul disco.
+ */
+static bool forzaSuDisco(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+//FUNZIONI PUBBLICHE
+
+bool apriGiornale(uint64_t impronta_dati) {
+    pthread_mutex_lock(&mutex);
+    if (file_giornale != NULL) fclose(file_giornale);
+
+    IntestazioneGiornale intestazione;
+    memset(&intestazione, 0, sizeof(intestazione));
+    memcpy(intestazione.magic, MAGIC_GIORNALE, sizeof(intestazione.magic));
+    intestazione.versione = VERSIONE_GIORNALE;
+    intestazione.impronta_dati = impronta_dati;
+
+    file_giornale = fopen(GIORNALE_FILE, "wb");
+    bool ok = file_giornale != NULL &&
+              fwrite(&intestazione, sizeof(intestazione), 1, file_giornale) == 1 &&
+              forzaSuDisco(file_giornale);
+    if (!ok) {
+        printf("Errore: impossibile creare il giornale %s.\n", GIORNALE_FILE);
+        if (file_giornale != NULL) fclose(file_giornale);
+        file_giornale = NULL;
+    }
+    guasto = false;
+    pthread_mutex_unlock(&mutex);
+    return ok;
+}
+
+bool accodaGiornale(const void* dati, size_t n) {
+    if (n > UINT32_MAX) return false;
+
+    pthread_mutex_lock(&mutex);
+    bool ok = true;
+    if (file_giornale != NULL) {
+        IntestazioneVoce voce = { (uint32_t)n, checksumArchivio(dati, n) };
+        ok = !guasto &&
+             fwrite(&voce, sizeof(voce), 1, file_giornale) == 1 &&
+             fwrite(dati, 1, n, file_giornale) == n &&
+             forzaSuDisco(file_giornale);
+        if (!ok && !guasto) {
+            printf("Errore: scrittura del giornale %s non riuscita.\n", GIORNALE_FILE);
+            guasto = true;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return ok;
+}
+
+void chiudiGiornale(bool rimuovi_file) {
+    pthread_mutex_lock(&mutex);
+    if (file_giornale != NULL) {
+        fclose(file_giornale);
+        file_giornale = NULL;
+    }
+    guasto = false;
+    pthread_mutex_unlock(&mutex);
+
+    if (rimuovi_file) remove(GIORNALE_FILE);
+}
+
+bool esisteGiornale(void) {
+    FILE* file = fopen(GIORNALE_FILE, "rb");
+    if (file == NULL) return false;
+    fclose(file);
+    return true;
+}
+
+int leggiGiornale(uint64_t impronta_dati, VoceGiornale voce, void* contesto) {
+    if (voce == NULL) return -1;
+
+    FILE* file = fopen(GIORNALE_FILE, "rb");
+    if (file == NULL) return -1;
+
+    IntestazioneGiornale intestazione;
+    if (fread(&intestazione, sizeof(intestazione), 1, file) != 1 ||
+        memcmp(intestazione.magic, MAGIC_GIORNALE, sizeof(intestazione.magic)) != 0 ||
+        intestazione.versione != VERSIONE_GIORNALE) {
+        printf("Errore: %s non e' un giornale valido.\n", GIORNALE_FILE);
+        fclose(file);
+        return -1;
+    }
+    if (intestazione.impronta_dati != impronta_dati) {
+        // Il salvataggio e' avvenuto, la rimozione del giornale no
+        fclose(file);
+        return 0;
+    }
+
+    Buffer contenuto;
+    inizializzaBuffer(&contenuto);
+    int lette = 0;
+    IntestazioneVoce iv;
+    while (fread(&iv, sizeof(iv), 1, file) == 1) {
+        if (!riservaBuffer(&contenuto, iv.lunghezza) ||
+            fread(contenuto.dati, 1, iv.lunghezza, file) != iv.lunghezza ||
+            checksumArchivio(contenuto.dati, iv.lunghezza) != iv.checksum) {
+            break;  // Voce interrotta: le successive non sono state confermate
+        }
+        voce(contenuto.dati, iv.lunghezza, contesto);
+        lette++;
+    }
+
+    liberaBuffer(&contenuto);
+    fclose(file);
+    return lette;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file giornale.h
+ * @brief Giornale delle scritture della modalita' servizio.
+ *
+ * In modalita' servizio i dati vengono salvati solo all'arresto. Per non
+ * perdere le operazioni confermate ai client se il processo si interrompe,
+ * ogni gruppo di scritture viene prima accodato al giornale e forzato su
+ * disco, poi applicato alle liste: un gruppo (ad esempio un lotto del
+ * protocollo) costa una sola scrittura e una sola sincronizzazione.
+ *
+ * Il giornale contiene le operazioni successive all'ultimo salvataggio: al
+ * successivo avvio, se e' ancora presente, le operazioni vengono riapplicate
+ * ai dati caricati (vedi riapplicaGiornale() in servizio.h). Dopo un
+ * salvataggio completo il giornale non serve piu' e viene rimosso.
+ *
+ * L'intestazione registra l'impronta dei file di dati su cui il giornale e'
+ * stato aperto (improntaDatiSalvati() in fileio.h). Se il processo si ferma
+ * tra il salvataggio e la rimozione del giornale, i dati su disco hanno
+ * un'impronta diversa: le operazioni vi sono gia' comprese e non vengono
+ * riapplicate una seconda volta.
+ *
+ * Formato: intestazione fissa, poi una voce per gruppo formata da lunghezza
+ * e checksum (4 byte ciascuno) seguiti dal contenuto. Una voce incompleta o
+ * con checksum errato (scrittura interrotta) termina la lettura.
+ */
+#ifndef GIORNALE_H
+#define GIORNALE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//COSTANTI PUBBLICHE
+#define GIORNALE_FILE "autoscuola.giornale"
+
+/**
+ * @brief Funzione chiamata per ogni voce letta dal giornale.
+ * @param dati Contenuto della voce.
+ * @param n Byte del contenuto.
+ * @param contesto Puntatore passato a leggiGiornale().
+ */
+typedef void (*VoceGiornale)(const unsigned char* dati, size_t n, void* contesto);
+
+/**
+ * @brief Crea un giornale vuoto (sostituisce quello eventualmente presente).
+ * @param impronta_dati Impronta dei file di dati su cui si applicheranno le voci.
+ * @return true se il giornale e' pronto per le scritture.
+ */
+bool apriGiornale(uint64_t impronta_dati);
+
+/**
+ * @brief Accoda una voce e la forza su disco.
+ *
+ * Thread-safe. Se il giornale non e' aperto non fa nulla e restituisce true.
+ *
+ * @param dati Contenuto della voce.
+ * @param n Byte del contenuto.
+ * @return true se la voce e' su disco, false in caso di errore.
+ */
+bool accodaGiornale(const void* dati, size_t n);
+
+/**
+ * @brief Chiude il giornale.
+ * @param rimuovi_file true per cancellare il file (i dati sono stati salvati).
+ */
+void chiudiGiornale(bool rimuovi_file);
+
+/**
+ * @brief Verifica se e' presente un giornale lasciato da un servizio interrotto.
+ * @return true se il file del giornale esiste.
+ */
+bool esisteGiornale(void);
+
+/**
+ * @brief Legge le voci integre del giornale, nell'ordine di scrittura.
+ *
+ * Le voci vengono lette solo se il giornale e' stato aperto su dati con
+ * l'impronta indicata; altrimenti sono gia' comprese nei dati salvati.
+ *
+ * @param impronta_dati Impronta dei file di dati caricati.
+ * @param voce Funzione chiamata per ogni voce.
+ * @param contesto Puntatore passato a `voce`.
+ * @return Numero di voci lette (0 se gia' salvate), -1 se il file manca o
+ *         non e' un giornale.
+ */
+int leggiGiornale(uint64_t impronta_dati, VoceGiornale voce, void* contesto);
+
+#endif // GIORNALE_H
@@ -9,12 +9,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "guida.h"
 #include "allievi.h"  // Per trovaIDAllievo, getAllievoNome, getAllievoCognome
 #include "util.h"
+#include "indice.h"
+#include "modifiche.h"
+#include "codifica.h"
+#include "formato.h"
 
 //DEFINIZIONI STRUTTURE (PRIVATE)
 #define MAX_GUIDE 100
+#define TABELLA_GUIDE 'G' /**< Identificativo della tabella nel formato codificato */
+#define MAX_GUIDA_CODIFICATO (sizeof(Guida) + CODIFICA_MAX_VARINT)
+#define DIM_RIGA_GUIDA (3 * FORMATO_MAX_INTERO + 64) /**< Riga di stampaGuida */
+#define DIM_RIGA_GUIDA_ALLIEVO (2 * 30 + 4 * FORMATO_MAX_INTERO + 128) /**< Riga di stampaGuide */
 
 /**
  * @struct Guida
@@ -33,20 +42,162 @@ struct Guida {
 struct ListaGuide {
     Guida elenco_guide[MAX_GUIDE];
     int n_guide;
+    IndiceID indice_id; /**< Posizione dei record per ID allievo */
+    RegistroModifiche modifiche; /**< Generazioni di modifica per record e blocco */
 };
 
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Ricalcola le ore extra (oltre le obbligatorie) dalle ore svolte.
+ */
+static void aggiornaOreExtra(Guida* g) {
+    g->ore_extra = (g->ore_svolte > ORE_GUIDA_OBBLIGATORIE) ?
+                   (g->ore_svolte - ORE_GUIDA_OBBLIGATORIE) : 0;
+}
+
+/**
+ * @brief Aggiunge in coda la guida di un nuovo allievo (capacita' gia' verificata).
+ */
+static void accodaGuida(ListaGuide* lista, int id_allievo, int ore) {
+    Guida* nuova = &lista->elenco_guide[lista->n_guide];
+    nuova->id_allievo = id_allievo;
+    nuova->ore_svolte = ore;
+    aggiornaOreExtra(nuova);
+
+    inserisciInIndice(&lista->indice_id, id_allievo, lista->n_guide);
+    segnaModifica(&lista->modifiche, lista->n_guide);
+    lista->n_guide++;
+}
+
+/**
+ * @struct LezioneOrdinata
+ * @brief Copia di una lezione con la sua posizione nell'array del chiamante.
+ */
+typedef struct {
+    int id_allievo;
+    int ore;
+    int posizione;
+} LezioneOrdinata;
+
+/**
+ * @brief Ordina le lezioni per ID allievo e, a parita' di ID, per posizione.
+ */
+static int confrontaLezioni(const void* a, const void* b) {
+    const LezioneOrdinata* la = (const LezioneOrdinata*)a;
+    const LezioneOrdinata* lb = (const LezioneOrdinata*)b;
+    if (la->id_allievo != lb->id_allievo) return (la->id_allievo > lb->id_allievo) - (la->id_allievo < lb->id_allievo);
+    return (la->posizione > lb->posizione) - (la->posizione < lb->posizione);
+}
+
+/**
+ * @brief Ricostruisce l'indice per ID a partire dall'elenco corrente.
+ */
+static void ricostruisciIndiceGuide(ListaGuide* lista) {
+    svuotaIndice(&lista->indice_id);
+    for (int i = 0; i < lista->n_guide; i++) {
+        inserisciInIndice(&lista->indice_id, lista->elenco_guide[i].id_allievo, i);
+    }
+}
+
+/**
+ * @brief Codifica una guida: ID come differenza dal precedente, ore come interi zigzag.
+ */
+static bool codificaGuida(const Guida* g, int id_precedente, Buffer* buf) {
+    return scriviVarintConSegno(buf, (int64_t)g->id_allievo - id_precedente) &&
+           scriviVarintConSegno(buf, g->ore_svolte) &&
+           scriviVarintConSegno(buf, g->ore_extra);
+}
+
+/**
+ * @brief Decodifica una guida scritta da codificaGuida().
+ */
+static bool decodificaGuida(Lettore* lettore, Guida* g, int* id) {
+    *id += (int)leggiVarintConSegno(lettore);
+    g->id_allievo = *id;
+    g->ore_svolte = (int)leggiVarintConSegno(lettore);
+    g->ore_extra = (int)leggiVarintConSegno(lettore);
+    return !lettore->errore;
+}
+
+/**
+ * @brief Legge una tabella nel formato codificato.
+ * @return Numero di guide letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaCodificata(ListaGuide* lista, const unsigned char* dati, size_t lunghezza) {
+    Lettore lettore;
+    inizializzaLettore(&lettore, dati, lunghezza);
+    if (!leggiIntestazioneCodifica(&lettore, TABELLA_GUIDE)) return -1;
+
+    uint64_t n = leggiVarint(&lettore);
+    if (lettore.errore || n > MAX_GUIDE) return -1;
+
+    int id = 0;
+    for (int i = 0; i < (int)n; i++) {
+        if (!decodificaGuida(&lettore, &lista->elenco_guide[i], &id)) {
+            lista->n_guide = 0;
+            return -1;
+        }
+    }
+
+    lista->n_guide = (int)n;
+    return (int)n;
+}
+
+/**
+ * @brief Legge una tabella nel formato precedente (array di struct grezze).
+ * @return Numero di guide letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaGrezza(ListaGuide* lista, const unsigned char* dati, size_t lunghezza) {
+    const size_t intestazione = sizeof(int);
+    if (lunghezza < intestazione) return -1;
+
+    int n;
+    memcpy(&n, dati, sizeof(int));
+
+    if (n < 0 || n > MAX_GUIDE) return -1;
+    if (lunghezza < intestazione + sizeof(Guida) * n) return -1;
+
+    memcpy(lista->elenco_guide, dati + intestazione, sizeof(Guida) * n);
+    lista->n_guide = n;
+    return n;
+}
+
+/**
+ * @brief Compone la riga di stampaGuida() in `riga` (DIM_RIGA_GUIDA byte).
+ * @return Lunghezza della riga, '\n' compreso.
+ */
+static size_t formattaRigaGuida(char* riga, const Guida* guida) {
+    char* r = riga;
+    r += formattaTesto(r, "ID Allievo: ");
+    r += formattaIntero(r, guida->id_allievo);
+    r += formattaTesto(r, " | Ore totali: ");
+    r += formattaIntero(r, guida->ore_svolte);
+    r += formattaTesto(r, " | Ore extra: ");
+    r += formattaIntero(r, guida->ore_extra);
+    *r++ = '\n';
+    return (size_t)(r - riga);
+}
+
 //FUNZIONI DI CREAZIONE/DISTRUZIONE
 
 ListaGuide* creaListaGuide(void) {
     ListaGuide* lista = (ListaGuide*)malloc(sizeof(ListaGuide));
     if (lista != NULL) {
         lista->n_guide = 0;
+        svuotaIndice(&lista->indice_id);
+        if (!inizializzaRegistroModifiche(&lista->modifiche, lista->elenco_guide,
+                                          sizeof(Guida), MAX_GUIDE)) {
+            free(lista);
+            return NULL;
+        }
     }
     return lista;
 }
 
 void distruggiListaGuide(ListaGuide** lista) {
     if (lista != NULL && *lista != NULL) {
+        liberaRegistroModifiche(&(*lista)->modifiche);
         free(*lista);
         *lista = NULL;
     }
@@ -55,6 +206,8 @@ void distruggiListaGuide(ListaGuide** lista) {
 void inizializzaListaGuide(ListaGuide* lista) {
     if (lista == NULL) return;
     lista->n_guide = 0;
+    svuotaIndice(&lista->indice_id);
+    segnaModificaStruttura(&lista->modifiche);
 }
 
 //FUNZIONI DI ACCESSO (GETTER)
@@ -66,12 +219,8 @@ int getNumeroGuide(const ListaGuide* lista) {
 Guida* cercaGuidaPerID(const ListaGuide* lista, int id_allievo) {
     if (lista == NULL || id_allievo <= 0) return NULL;
 
-    for (int i = 0; i < lista->n_guide; i++) {
-        if (lista->elenco_guide[i].id_allievo == id_allievo) {
-            return &lista->elenco_guide[i];
-        }
-    }
-    return NULL;
+    int pos = cercaInIndice(&lista->indice_id, id_allievo);
+    return (pos >= 0) ? &lista->elenco_guide[pos] : NULL;
 }
 
 const Guida* getGuidaAtIndex(const ListaGuide* lista, int index) {
@@ -117,10 +266,50 @@ bool inizializzaGuida(ListaGuide* lista, int id_allievo) {
     nuova.ore_svolte = 0;
     nuova.ore_extra = 0;
 
+    inserisciInIndice(&lista->indice_id, nuova.id_allievo, lista->n_guide);
+    segnaModifica(&lista->modifiche, lista->n_guide);
     lista->elenco_guide[lista->n_guide++] = nuova;
     return true;
 }
 
+int rimuoviGuidePerID(ListaGuide* lista, const int id_allievi[], int n) {
+    if (lista == NULL || id_allievi == NULL || n <= 0) return 0;
+
+    // ID da rimuovere in un indice temporaneo: una sola passata sull'elenco,
+    // anche con piu' record per lo stesso allievo
+    IndiceID da_rimuovere;
+    svuotaIndice(&da_rimuovere);
+    bool non_validi = false;   // L'indice non accetta ID <= 0: quei record si riconoscono a parte
+    for (int i = 0; i < n; i++) {
+        if (id_allievi[i] > 0) {
+            inserisciInIndice(&da_rimuovere, id_allievi[i], i);
+        } else {
+            non_validi = true;
+        }
+    }
+
+    int scritti = 0;
+    int primo_spostato = -1;
+    for (int i = 0; i < lista->n_guide; i++) {
+        int id = lista->elenco_guide[i].id_allievo;
+        if ((id <= 0) ? non_validi : cercaInIndice(&da_rimuovere, id) >= 0) {
+            if (primo_spostato < 0) primo_spostato = i;
+            continue;
+        }
+        if (scritti != i) lista->elenco_guide[scritti] = lista->elenco_guide[i];
+        scritti++;
+    }
+
+    int rimossi = lista->n_guide - scritti;
+    if (rimossi == 0) return 0;
+
+    lista->n_guide = scritti;
+    for (int i = primo_spostato; i < scritti; i++) segnaModifica(&lista->modifiche, i);
+    segnaModificaStruttura(&lista->modifiche);
+    ricostruisciIndiceGuide(lista);
+    return rimossi;
+}
+
 bool registraOreGuida(ListaGuide* lista, int id_allievo, int ore_da_aggiungere) {
     if (lista == NULL || id_allievo <= 0 || ore_da_aggiungere <= 0) return false;
 
@@ -131,25 +320,77 @@ bool registraOreGuida(ListaGuide* lista, int id_allievo, int ore_da_aggiungere)
             printf("Errore: numero massimo di guide raggiunto.\n");
             return false;
         }
-
-        Guida nuova;
-        nuova.id_allievo = id_allievo;
-        nuova.ore_svolte = ore_da_aggiungere;
-        nuova.ore_extra = (ore_da_aggiungere > ORE_GUIDA_OBBLIGATORIE) ?
-                          (ore_da_aggiungere - ORE_GUIDA_OBBLIGATORIE) : 0;
-
-        lista->elenco_guide[lista->n_guide++] = nuova;
+        accodaGuida(lista, id_allievo, ore_da_aggiungere);
         return true;
     }
 
     // Aggiorna ore esistenti
+    if (g->ore_svolte > INT_MAX - ore_da_aggiungere) return false;
     g->ore_svolte += ore_da_aggiungere;
-    g->ore_extra = (g->ore_svolte > ORE_GUIDA_OBBLIGATORIE) ?
-                   (g->ore_svolte - ORE_GUIDA_OBBLIGATORIE) : 0;
+    aggiornaOreExtra(g);
+    segnaModificaRecord(g);
 
     return true;
 }
 
+int registraOreGuidaInBlocco(ListaGuide* lista, const LezioneGuida* lezioni, int n, bool* registrate) {
+    if (lista == NULL || lezioni == NULL || n <= 0) return 0;
+    if (registrate != NULL) memset(registrate, 0, sizeof(bool) * (size_t)n);
+
+    // Raggruppa le lezioni dello stesso allievo su una copia: l'array del chiamante resta com'e'
+    LezioneOrdinata* ordinate = (LezioneOrdinata*)malloc(sizeof(LezioneOrdinata) * (size_t)n);
+    if (ordinate == NULL) {
+        printf("Errore: memoria insufficiente per registrare le lezioni.\n");
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        ordinate[i].id_allievo = lezioni[i].id_allievo;
+        ordinate[i].ore = lezioni[i].ore;
+        ordinate[i].posizione = i;
+    }
+    qsort(ordinate, (size_t)n, sizeof(LezioneOrdinata), confrontaLezioni);
+
+    int applicate = 0;
+    int i = 0;
+    while (i < n) {
+        int id = ordinate[i].id_allievo;
+        int inizio = i;
+        long long ore = 0;
+        for (; i < n && ordinate[i].id_allievo == id; i++) {
+            if (ordinate[i].ore > 0) ore += ordinate[i].ore;
+        }
+        if (id <= 0 || ore <= 0) continue;
+
+        // Una ricerca e un ricalcolo delle ore extra per allievo
+        Guida* g = cercaGuidaPerID(lista, id);
+        if ((g != NULL ? g->ore_svolte : 0) > INT_MAX - ore) {
+            continue;  // Il totale non entra in un int: nessuna lezione dell'allievo
+        }
+        if (g != NULL) {
+            g->ore_svolte += (int)ore;
+            aggiornaOreExtra(g);
+            segnaModificaRecord(g);
+        } else if (lista->n_guide < MAX_GUIDE) {
+            accodaGuida(lista, id, (int)ore);
+        } else {
+            continue;
+        }
+
+        for (int k = inizio; k < i; k++) {
+            if (ordinate[k].ore <= 0) continue;
+            if (registrate != NULL) registrate[ordinate[k].posizione] = true;
+            applicate++;
+        }
+    }
+    free(ordinate);
+
+    if (registrate == NULL && applicate < n) {
+        printf("Attenzione: %d lezioni non registrate (dati non validi o lista piena).\n",
+               n - applicate);
+    }
+    return applicate;
+}
+
 void registraGuida(ListaGuide* listaG, const void* listaA) {
     if (listaG == NULL || listaA == NULL) {
         printf("Errore: liste non valide.\n");
@@ -193,23 +434,31 @@ void stampaGuida(const Guida* guida) {
         return;
     }
 
-    printf("ID Allievo: %d | Ore totali: %d | Ore extra: %d\n",
-           guida->id_allievo, guida->ore_svolte, guida->ore_extra);
+    char riga[DIM_RIGA_GUIDA];
+    fwrite(riga, 1, formattaRigaGuida(riga, guida), stdout);
 }
 
-void stampaTutteGuide(const ListaGuide* lista) {
+void stampaTutteGuide(const ListaGuide* lista, Uscita* uscita) {
     if (lista == NULL) {
         printf("Lista non valida.\n");
         return;
     }
 
-    printf("\n--- Elenco Guide ---\n");
-    for (int i = 0; i < lista->n_guide; i++) {
-        stampaGuida(&lista->elenco_guide[i]);
+    Uscita* terminale = NULL;
+    if (uscita == NULL) uscita = terminale = creaUscitaStandard();
+    if (uscita == NULL) return;
+
+    scriviTestoUscita(uscita, "\n--- Elenco Guide ---\n");
+    for (int i = 0; i < lista->n_guide && !uscitaInterrotta(uscita); i++) {
+        char* riga = riservaUscita(uscita, DIM_RIGA_GUIDA);
+        if (riga == NULL) break;
+        avanzaUscita(uscita, formattaRigaGuida(riga, &lista->elenco_guide[i]));
     }
+
+    if (terminale != NULL) chiudiUscita(&terminale);
 }
 
-void stampaGuide(const ListaGuide* listaG, const void* listaA) {
+void stampaGuide(const ListaGuide* listaG, const void* listaA, Uscita* uscita) {
     if (listaG == NULL || listaA == NULL) {
         printf("Errore: liste non valide.\n");
         return;
@@ -217,14 +466,17 @@ void stampaGuide(const ListaGuide* listaG, const void* listaA) {
 
     const ListaAllievi* allievi = (const ListaAllievi*)listaA;
 
-    printf("\n--- GUIDE REGISTRATE ---\n");
+    Uscita* terminale = NULL;
+    if (uscita == NULL) uscita = terminale = creaUscitaStandard();
+    if (uscita == NULL) return;
+
+    scriviTestoUscita(uscita, "\n--- GUIDE REGISTRATE ---\n");
 
     if (listaG->n_guide == 0) {
-        printf("Nessuna guida registrata.\n");
-        return;
+        scriviTestoUscita(uscita, "Nessuna guida registrata.\n");
     }
 
-    for (int i = 0; i < listaG->n_guide; i++) {
+    for (int i = 0; i < listaG->n_guide && !uscitaInterrotta(uscita); i++) {
         const Guida* g = &listaG->elenco_guide[i];
 
         // Cerca l'allievo usando interfaccia pubblica
@@ -238,54 +490,125 @@ void stampaGuide(const ListaGuide* listaG, const void* listaA) {
             cognome = getAllievoCognome(allievo);
         }
 
-        printf("ID: %d | Nome: %s | Cognome: %s | Ore totali: %d | Ore extra: %d",
-               g->id_allievo, nome, cognome, g->ore_svolte, g->ore_extra);
+        char* riga = riservaUscita(uscita, DIM_RIGA_GUIDA_ALLIEVO);
+        if (riga == NULL) break;
+
+        char* r = riga;
+        r += formattaTesto(r, "ID: ");
+        r += formattaIntero(r, g->id_allievo);
+        r += formattaTesto(r, " | Nome: ");
+        r += formattaTesto(r, nome);
+        r += formattaTesto(r, " | Cognome: ");
+        r += formattaTesto(r, cognome);
+        r += formattaTesto(r, " | Ore totali: ");
+        r += formattaIntero(r, g->ore_svolte);
+        r += formattaTesto(r, " | Ore extra: ");
+        r += formattaIntero(r, g->ore_extra);
 
         if (g->ore_svolte >= ORE_GUIDA_OBBLIGATORIE) {
-            printf(" Obbligatorie completate");
+            r += formattaTesto(r, " Obbligatorie completate");
         } else {
-            printf(" (Mancano %d ore)", ORE_GUIDA_OBBLIGATORIE - g->ore_svolte);
+            r += formattaTesto(r, " (Mancano ");
+            r += formattaIntero(r, ORE_GUIDA_OBBLIGATORIE - g->ore_svolte);
+            r += formattaTesto(r, " ore)");
         }
 
-        printf("\n");
+        *r++ = '\n';
+        avanzaUscita(uscita, (size_t)(r - riga));
     }
+
+    if (terminale != NULL) chiudiUscita(&terminale);
 }
 
 //FUNZIONI I/O FILE
 
-bool salvaGuide(const ListaGuide* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+int copiaModificheGuide(ListaGuide* copia, const ListaGuide* originale, unsigned long generazione) {
+    if (copia == NULL || originale == NULL) return -1;
 
-    FILE* file = fopen(filename, "wb");
-    if (file == NULL) {
-        printf("Errore: impossibile aprire il file %s per la scrittura.\n", filename);
-        return false;
+    int copiati = copiaBlocchiModificati(&originale->modifiche, &copia->modifiche,
+                                         copia->elenco_guide, originale->n_guide, generazione);
+    copia->n_guide = originale->n_guide;
+    if (originale->modifiche.generazione > generazione) {
+        copia->indice_id = originale->indice_id;
     }
+    return copiati;
+}
 
-    // Salva numero guide
-    fwrite(&lista->n_guide, sizeof(int), 1, file);
+const RegistroModifiche* getRegistroModificheGuide(const ListaGuide* lista) {
+    return (lista != NULL) ? &lista->modifiche : NULL;
+}
 
-    // Salva array guide
-    fwrite(lista->elenco_guide, sizeof(Guida), lista->n_guide, file);
+bool serializzaIntestazioneGrezzaGuide(const ListaGuide* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    fclose(file);
-    return true;
+    bool ok = scriviBuffer(buf, &lista->n_guide, sizeof(int));
+    return ok;
 }
 
-bool caricaGuide(ListaGuide* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+bool serializzaGuide(const ListaGuide* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+
+    // Stima per eccesso: una sola riallocazione per l'intera tabella
+    riservaBuffer(buf, buf->lunghezza + CODIFICA_DIM_INTESTAZIONE + CODIFICA_MAX_VARINT +
+                       (size_t)lista->n_guide * MAX_GUIDA_CODIFICATO);
 
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        return false; // File non esiste, non è un errore
+    // Intestazione: numero guide
+    bool ok = scriviIntestazioneCodifica(buf, TABELLA_GUIDE);
+    ok &= scriviVarint(buf, (uint64_t)lista->n_guide);
+
+    // Record codificati
+    int id_precedente = 0;
+    for (int i = 0; i < lista->n_guide && ok; i++) {
+        ok = codificaGuida(&lista->elenco_guide[i], id_precedente, buf);
+        id_precedente = lista->elenco_guide[i].id_allievo;
     }
+    return ok;
+}
 
-    // Carica numero guide
-    fread(&lista->n_guide, sizeof(int), 1, file);
+bool serializzaIndiceGuide(const ListaGuide* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+    return scriviBuffer(buf, &lista->indice_id, sizeof(IndiceID));
+}
 
-    // Carica array guide
-    fread(lista->elenco_guide, sizeof(Guida), lista->n_guide, file);
+bool deserializzaGuide(ListaGuide* lista, const unsigned char* dati, size_t lunghezza) {
+    return deserializzaGuideConIndice(lista, dati, lunghezza, NULL, 0);
+}
+
+bool deserializzaGuideConIndice(ListaGuide* lista, const unsigned char* dati, size_t lunghezza,
+                                const unsigned char* indice, size_t lunghezza_indice) {
+    if (lista == NULL || dati == NULL) return false;
 
-    fclose(file);
+    int n = isTabellaCodificata(dati, lunghezza) ?
+            leggiTabellaCodificata(lista, dati, lunghezza) :
+            leggiTabellaGrezza(lista, dati, lunghezza);
+    if (n < 0) return false;
+
+    segnaModificaTotale(&lista->modifiche, n);
+    // L'indice salvato viene adottato se compatibile, altrimenti viene
+    // ricostruito dallo stesso thread che carica la tabella
+    if (indice == NULL || !adottaIndice(&lista->indice_id, indice, lunghezza_indice, n)) {
+        ricostruisciIndiceGuide(lista);
+    }
     return true;
 }
+
+bool salvaGuide(const ListaGuide* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = serializzaGuide(lista, &buf) && scriviBufferSuFile(&buf, filename);
+    liberaBuffer(&buf);
+    return ok;
+}
+
+bool caricaGuide(ListaGuide* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = leggiFileInBuffer(filename, &buf) && // File mancante: non e' un errore
+              deserializzaGuide(lista, buf.dati, buf.lunghezza);
+    liberaBuffer(&buf);
+    return ok;
+}
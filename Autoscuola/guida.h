@@ -14,6 +14,9 @@
 #define GUIDA_H
 
 #include <stdbool.h>
+#include "buffer.h"
+#include "modifiche.h"
+#include "uscita.h"
 
 //COSTANTI PUBBLICHE
 #define ORE_GUIDA_OBBLIGATORIE 6
@@ -31,6 +34,16 @@ typedef struct Guida Guida;
  */
 typedef struct ListaGuide ListaGuide;
 
+//TIPI PUBBLICI
+/**
+ * @struct LezioneGuida
+ * @brief Ore di guida di un allievo da registrare con registraOreGuidaInBlocco().
+ */
+typedef struct {
+    int id_allievo; /**< ID dell'allievo */
+    int ore;        /**< Ore svolte (> 0) */
+} LezioneGuida;
+
 //FUNZIONI DI CREAZIONE/DISTRUZIONE
 /**
  * @brief Crea e inizializza una nuova lista di guide.
@@ -118,6 +131,20 @@ float calcolaCostoOreExtra(const Guida* guida, float costo_orario);
  * @return true se creata con successo, false altrimenti.
  */
 bool inizializzaGuida(ListaGuide* lista, int id_allievo);
+/**
+ * @brief Rimuove le guide degli allievi indicati (es. record orfani).
+ *
+ * L'elenco viene compattato in una sola passata mantenendo l'ordine; i
+ * record spostati risultano modificati per il salvataggio differenziale.
+ *
+ * @param lista Puntatore alla lista.
+ * @param id_allievi ID degli allievi i cui record vanno rimossi (un ID <= 0
+ *                   rimuove tutti i record con ID non valido).
+ * @param n Numero di ID.
+ * @return Numero di record rimossi.
+ */
+int rimuoviGuidePerID(ListaGuide* lista, const int id_allievi[], int n);
+
 
 /**
  * @brief Registra ore di guida per un allievo.
@@ -132,6 +159,26 @@ bool inizializzaGuida(ListaGuide* lista, int id_allievo);
  */
 bool registraOreGuida(ListaGuide* lista, int id_allievo, int ore_da_aggiungere);
 
+/**
+ * @brief Registra in una sola passata le ore di guida di molte lezioni.
+ *
+ * Le lezioni vengono raggruppate per ID allievo (su una copia: l'array del
+ * chiamante non viene modificato) e quelle dello stesso allievo sommate:
+ * ogni allievo richiede una sola ricerca e un solo ricalcolo delle ore
+ * extra, qualunque sia il numero delle sue lezioni. Come registraOreGuida(),
+ * crea la guida degli allievi che non ne hanno ancora una. Le lezioni con ID
+ * o ore non validi vengono ignorate; se il totale di un allievo supererebbe
+ * INT_MAX nessuna delle sue lezioni viene registrata.
+ *
+ * @param lista Puntatore alla lista delle guide.
+ * @param lezioni Lezioni da registrare.
+ * @param n Numero di lezioni.
+ * @param registrate Se non NULL, riceve per ogni lezione true se e' stata
+ *                   registrata; se NULL, le lezioni scartate vengono segnalate a video.
+ * @return Numero di lezioni registrate.
+ */
+int registraOreGuidaInBlocco(ListaGuide* lista, const LezioneGuida* lezioni, int n, bool* registrate);
+
 /**
  * @brief Registra una nuova sessione di guida per un allievo.
  *
@@ -153,8 +200,9 @@ void stampaGuida(const Guida* guida);
 /**
  * @brief Stampa tutte le guide registrate.
  * @param lista Lista delle guide.
+ * @param uscita Destinazione dell'elenco (NULL per il terminale).
  */
-void stampaTutteGuide(const ListaGuide* lista);
+void stampaTutteGuide(const ListaGuide* lista, Uscita* uscita);
 
 /**
  * @brief Stampa l'elenco delle guide svolte per ciascun allievo.
@@ -163,10 +211,100 @@ void stampaTutteGuide(const ListaGuide* lista);
  *
  * @param lista Puntatore alla lista delle guide.
  * @param listaA Puntatore opaco alla lista degli allievi (per associare nomi agli ID).
+ * @param uscita Destinazione dell'elenco (NULL per il terminale).
  */
-void stampaGuide(const ListaGuide* lista, const void* listaA);
+void stampaGuide(const ListaGuide* lista, const void* listaA, Uscita* uscita);
 
 //FUNZIONI I/O FILE
+/**
+ * @brief Aggiorna una copia della lista con i soli blocchi modificati dopo una generazione.
+ *
+ * Usata dall'autosalvataggio e dalle viste di condivisi.h per mantenere
+ * un'istantanea coerente senza ricopiare l'intera lista a ogni ciclo. Se la
+ * lista e' cambiata viene copiato anche l'indice per ID, cosi' le ricerche
+ * funzionano anche sulla copia; i record copiati conservano la loro
+ * generazione (getGenerazioneRecord()).
+ *
+ * @param copia Lista di destinazione (creata con creaListaGuide()).
+ * @param originale Lista da cui copiare.
+ * @param generazione Generazione dell'ultima copia (0 = copia completa).
+ * @return Numero di blocchi copiati, -1 se i parametri non sono validi.
+ */
+int copiaModificheGuide(ListaGuide* copia, const ListaGuide* originale, unsigned long generazione);
+
+/**
+ * @brief Restituisce il registro delle modifiche della lista delle guide.
+ *
+ * Il registro descrive anche l'array dei record (indirizzo, dimensione,
+ * capacita'): l'istantanea differenziale lo usa per riscrivere solo i
+ * blocchi modificati.
+ *
+ * @param lista Lista delle guide.
+ * @return Puntatore al registro (read-only), NULL se lista e' NULL.
+ */
+const RegistroModifiche* getRegistroModificheGuide(const ListaGuide* lista);
+
+/**
+ * @brief Serializza l'intestazione del formato a record fissi (contatori senza record).
+ *
+ * Seguita da `n` record grezzi forma un'area leggibile da deserializzaGuide().
+ *
+ * @param lista Lista delle guide.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIntestazioneGrezzaGuide(const ListaGuide* lista, Buffer* buf);
+
+/**
+ * @brief Serializza la lista delle guide in un buffer in memoria.
+ *
+ * Il formato e' lo stesso del file `guide.dat` e viene usato sia per i file
+ * separati sia per le sezioni dell'archivio unico. I record sono codificati
+ * in forma compatta (vedi codifica.h).
+ *
+ * @param lista Lista da serializzare.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaGuide(const ListaGuide* lista, Buffer* buf);
+
+/**
+ * @brief Ricostruisce la lista delle guide da un'area di memoria serializzata.
+ *
+ * Riconosce anche il formato precedente a struct grezze.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaGuide().
+ * @param lunghezza Numero di byte disponibili.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaGuide(ListaGuide* lista, const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Come deserializzaGuide(), adottando un indice per ID salvato in precedenza.
+ *
+ * L'indice viene adottato solo se ha la dimensione attesa e punta a
+ * posizioni esistenti; altrimenti viene ricostruito. Il chiamante deve
+ * garantire che l'indice sia stato prodotto per gli stessi dati.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaGuide().
+ * @param lunghezza Numero di byte disponibili.
+ * @param indice Byte prodotti da serializzaIndiceGuide() (NULL = ricostruisci).
+ * @param lunghezza_indice Numero di byte dell'indice.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaGuideConIndice(ListaGuide* lista, const unsigned char* dati, size_t lunghezza,
+                                const unsigned char* indice, size_t lunghezza_indice);
+
+/**
+ * @brief Serializza l'indice per ID della lista delle guide (immagine della tabella hash).
+ * @param lista Lista di cui salvare l'indice.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIndiceGuide(const ListaGuide* lista, Buffer* buf);
+
 /**
  * @brief Salva la lista delle guide su file binario.
  * @param lista Lista da salvare.
@@ -0,0 +1,820 @@
+/**
+ * @file importa.c
+ * @brief Implementazione dell'importazione in blocco da file CSV.
+ *
+ * Struttura:
+ * - LettoreCSV: lettura a blocchi e suddivisione in righe e campi
+ * - InsiemeCF: tabella hash codice fiscale -> ID allievo
+ * - Lotti: validazione dell'intero lotto, poi inserimento
+ * - Esiti d'esame: join hash sul codice fiscale, poi registrazione in ordine
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "importa.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "difensiva.h"
+#include "util.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define MAX_CAMPI_CSV 16
+#define DIM_CF 17
+
+/**
+ * @struct LettoreCSV
+ * @brief Lettura di un file a blocchi di dimensione fissa, una riga alla volta.
+ */
+typedef struct {
+    FILE* file;
+    char* blocco;       /**< DIM_BLOCCO_IMPORTAZIONE byte */
+    size_t lunghezza;   /**< Byte validi nel blocco */
+    size_t pos;         /**< Prossimo byte da esaminare */
+    bool fine_file;
+    bool errore;
+    long numero_riga;   /**< Numero dell'ultima riga letta (da 1) */
+    char separatore;    /**< ',' o ';', determinato dalla prima riga */
+} LettoreCSV;
+
+/**
+ * @struct InsiemeCF
+ * @brief Codici fiscali con l'ID dell'allievo associato (indirizzamento aperto, capacita' potenza di due).
+ */
+typedef struct {
+    char (*chiavi)[DIM_CF];
+    int* id;            /**< ID associato a ogni chiave (0 se non noto) */
+    size_t capacita;
+    size_t n;
+} InsiemeCF;
+
+/**
+ * @struct RigaAllievo
+ * @brief Riga del file allievi in attesa di validazione e inserimento.
+ */
+typedef struct {
+    char originale[DIM_MAX_RIGA_CSV];
+    char nome[30];
+    char cognome[30];
+    char codice_fiscale[DIM_CF];
+    char categoria[5];
+    const char* motivo; /**< NULL se la riga e' (finora) valida */
+} RigaAllievo;
+
+/**
+ * @struct RigaEsito
+ * @brief Riga del file degli esiti in attesa del join e della registrazione.
+ */
+typedef struct {
+    char originale[DIM_MAX_RIGA_CSV];
+    char codice_fiscale[DIM_CF];
+    TipoEsame tipo;
+    EsitoEsame esito;
+    Data data;
+    int id_allievo;     /**< Risultato del join, 0 se non ancora risolto */
+    const char* motivo; /**< NULL se la riga e' (finora) valida */
+} RigaEsito;
+
+//LETTURA CSV (PRIVATE)
+
+static bool apriLettoreCSV(LettoreCSV* lettore, const char* filename) {
+    memset(lettore, 0, sizeof(*lettore));
+    lettore->file = fopen(filename, "rb");
+    if (lettore->file == NULL) return false;
+
+    lettore->blocco = (char*)malloc(DIM_BLOCCO_IMPORTAZIONE);
+    if (lettore->blocco == NULL) {
+        fclose(lettore->file);
+        return false;
+    }
+    return true;
+}
+
+static void chiudiLettoreCSV(LettoreCSV* lettore) {
+    if (lettore->file != NULL) fclose(lettore->file);
+    free(lettore->blocco);
+    lettore->file = NULL;
+    lettore->blocco = NULL;
+}
+
+/**
+ * @brief Legge il prossimo blocco del file.
+ * @return false a fine file o in caso di errore.
+ */
+static bool riempiBlocco(LettoreCSV* lettore) {
+    if (lettore->fine_file) return false;
+
+    lettore->lunghezza = fread(lettore->blocco, 1, DIM_BLOCCO_IMPORTAZIONE, lettore->file);
+    lettore->pos = 0;
+    if (lettore->lunghezza == 0) {
+        lettore->fine_file = true;
+        lettore->errore = ferror(lettore->file) != 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Estrae la prossima riga (senza terminatore di riga).
+ *
+ * Le righe piu' lunghe di DIM_MAX_RIGA_CSV - 1 byte vengono consumate e
+ * troncate nella copia restituita.
+ *
+ * @return 1 riga letta, -1 riga troppo lunga, 0 fine del file.
+ */
+static int leggiRigaCSV(LettoreCSV* lettore, char riga[DIM_MAX_RIGA_CSV]) {
+    size_t usati = 0;
+    bool troncata = false;
+    bool letto_qualcosa = false;
+
+    while (true) {
+        if (lettore->pos >= lettore->lunghezza && !riempiBlocco(lettore)) {
+            if (!letto_qualcosa) return 0;
+            break; // Ultima riga senza '\n'
+        }
+        letto_qualcosa = true;
+
+        const char* inizio = lettore->blocco + lettore->pos;
+        size_t disponibili = lettore->lunghezza - lettore->pos;
+        const char* a_capo = (const char*)memchr(inizio, '\n', disponibili);
+        size_t n = (a_capo != NULL) ? (size_t)(a_capo - inizio) : disponibili;
+
+        size_t da_copiare = n;
+        if (usati + da_copiare > DIM_MAX_RIGA_CSV - 1) {
+            da_copiare = DIM_MAX_RIGA_CSV - 1 - usati;
+            troncata = true;
+        }
+        memcpy(riga + usati, inizio, da_copiare);
+        usati += da_copiare;
+
+        lettore->pos += n + (a_capo != NULL ? 1 : 0);
+        if (a_capo != NULL) break;
+    }
+
+    if (usati > 0 && riga[usati - 1] == '\r') usati--;
+    riga[usati] = '\0';
+    lettore->numero_riga++;
+    return troncata ? -1 : 1;
+}
+
+/**
+ * @brief Rimuove gli spazi iniziali e finali (in place).
+ */
+static char* rimuoviSpazi(char* testo) {
+    while (isspace((unsigned char)*testo)) testo++;
+    char* fine = testo + strlen(testo);
+    while (fine > testo && isspace((unsigned char)fine[-1])) fine--;
+    *fine = '\0';
+    return testo;
+}
+
+/**
+ * @brief Suddivide una riga nei suoi campi (in place).
+ *
+ * I campi possono essere racchiusi tra virgolette; `""` all'interno di un
+ * campo tra virgolette indica una virgoletta.
+ *
+ * @return Numero di campi trovati (al massimo `max_campi`).
+ */
+static int dividiCampiCSV(char* riga, char separatore, char* campi[], int max_campi) {
+    int n = 0;
+    char* p = riga;
+
+    while (n < max_campi) {
+        while (*p == ' ' || *p == '\t') p++;
+
+        if (*p == '"') {
+            // Campo tra virgolette: copia compattando le virgolette doppie
+            char* dest = ++p;
+            campi[n++] = dest;
+            while (*p != '\0') {
+                if (*p == '"' && p[1] == '"') {
+                    *dest++ = '"';
+                    p += 2;
+                } else if (*p == '"') {
+                    p++;
+                    break;
+                } else {
+                    *dest++ = *p++;
+                }
+            }
+            while (*p != '\0' && *p != separatore) p++;
+            char fine = *p;
+            *dest = '\0';
+            if (fine == '\0') break;
+            p++;
+        } else {
+            campi[n++] = p;
+            char* sep = strchr(p, separatore);
+            if (sep == NULL) {
+                campi[n - 1] = rimuoviSpazi(p);
+                break;
+            }
+            *sep = '\0';
+            campi[n - 1] = rimuoviSpazi(p);
+            p = sep + 1;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Sceglie il separatore guardando la prima riga del file.
+ */
+static char scegliSeparatore(const char* riga) {
+    int virgole = 0, punti_e_virgola = 0;
+    for (const char* p = riga; *p; p++) {
+        if (*p == ',') virgole++;
+        else if (*p == ';') punti_e_virgola++;
+    }
+    return (punti_e_virgola > virgole) ? ';' : ',';
+}
+
+//INSIEME CODICI FISCALI (PRIVATE)
+
+/**
+ * @brief Porta in maiuscolo un codice fiscale (in place).
+ */
+static void normalizzaCF(char* cf) {
+    for (int i = 0; cf[i] != '\0'; i++) {
+        cf[i] = (char)toupper((unsigned char)cf[i]);
+    }
+}
+
+static unsigned long hashCF(const char* cf) {
+    unsigned long h = 2166136261u;
+    for (int i = 0; cf[i] != '\0'; i++) {
+        h = (h ^ (unsigned char)cf[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void liberaInsiemeCF(InsiemeCF* insieme) {
+    free(insieme->chiavi);
+    free(insieme->id);
+    insieme->chiavi = NULL;
+    insieme->id = NULL;
+    insieme->capacita = 0;
+    insieme->n = 0;
+}
+
+static bool inserisciSenzaCrescere(InsiemeCF* insieme, const char* cf, int id) {
+    size_t cella = hashCF(cf) & (insieme->capacita - 1);
+    while (insieme->chiavi[cella][0] != '\0') {
+        if (strcmp(insieme->chiavi[cella], cf) == 0) return false;
+        cella = (cella + 1) & (insieme->capacita - 1);
+    }
+    strcpy(insieme->chiavi[cella], cf);
+    insieme->id[cella] = id;
+    insieme->n++;
+    return true;
+}
+
+/**
+ * @brief Inserisce un codice fiscale (gia' normalizzato in maiuscolo) con il suo ID.
+ * @return 1 se inserito, 0 se gia' presente, -1 in caso di errore di allocazione.
+ */
+static int inserisciCF(InsiemeCF* insieme, const char* cf, int id) {
+    // Mantiene il fattore di carico sotto 1/2
+    if ((insieme->n + 1) * 2 > insieme->capacita) {
+        InsiemeCF nuovo;
+        nuovo.capacita = (insieme->capacita > 0) ? insieme->capacita * 2 : 256;
+        nuovo.n = 0;
+        nuovo.chiavi = calloc(nuovo.capacita, DIM_CF);
+        nuovo.id = calloc(nuovo.capacita, sizeof(int));
+        if (nuovo.chiavi == NULL || nuovo.id == NULL) {
+            free(nuovo.chiavi);
+            free(nuovo.id);
+            return -1;
+        }
+
+        for (size_t i = 0; i < insieme->capacita; i++) {
+            if (insieme->chiavi[i][0] != '\0') {
+                inserisciSenzaCrescere(&nuovo, insieme->chiavi[i], insieme->id[i]);
+            }
+        }
+        liberaInsiemeCF(insieme);
+        *insieme = nuovo;
+    }
+    return inserisciSenzaCrescere(insieme, cf, id) ? 1 : 0;
+}
+
+/**
+ * @brief Cerca un codice fiscale (gia' normalizzato in maiuscolo).
+ * @return ID associato, 0 se assente.
+ */
+static int cercaCF(const InsiemeCF* insieme, const char* cf) {
+    if (insieme->capacita == 0) return 0;
+
+    size_t cella = hashCF(cf) & (insieme->capacita - 1);
+    while (insieme->chiavi[cella][0] != '\0') {
+        if (strcmp(insieme->chiavi[cella], cf) == 0) return insieme->id[cella];
+        cella = (cella + 1) & (insieme->capacita - 1);
+    }
+    return 0;
+}
+
+/**
+ * @brief Costruisce la tabella dei codici fiscali gia' registrati.
+ * @return false in caso di errore di allocazione.
+ */
+static bool caricaCFAllievi(InsiemeCF* insieme, const ListaAllievi* listaA) {
+    for (int i = 0; i < getNumeroAllievi(listaA); i++) {
+        const Allievo* a = getAllievoAtIndex(listaA, i);
+        char cf[DIM_CF];
+        snprintf(cf, sizeof(cf), "%s", getAllievoCodiceFiscale(a));
+        normalizzaCF(cf);
+        if (inserisciCF(insieme, cf, getAllievoID(a)) < 0) return false;
+    }
+    return true;
+}
+
+//FILE DEGLI SCARTI (PRIVATE)
+
+/**
+ * @brief Accoda una riga scartata, con il motivo come ultimo campo.
+ *
+ * Il file viene creato alla prima riga scartata.
+ */
+static void scriviScarto(FILE** scarti, const char* filename, char separatore,
+                         const char* riga, const char* motivo) {
+    if (*scarti == NULL) {
+        char nome[512];
+        snprintf(nome, sizeof(nome), "%s%s", filename, SUFFISSO_FILE_SCARTI);
+        *scarti = fopen(nome, "w");
+        if (*scarti == NULL) {
+            printf("Errore: impossibile creare il file %s\n", nome);
+            return;
+        }
+        setvbuf(*scarti, NULL, _IOFBF, DIM_BLOCCO_IMPORTAZIONE);
+    }
+    fprintf(*scarti, "%s%c%s\n", riga, separatore, motivo);
+}
+
+//LOTTI DI ALLIEVI (PRIVATE)
+
+/**
+ * @brief Copia un campo nella riga del lotto.
+ * @return false se il campo e' vuoto o troppo lungo.
+ */
+static bool copiaCampoCSV(char* dest, size_t dimensione, const char* valore) {
+    size_t lunghezza = strlen(valore);
+    if (lunghezza == 0 || lunghezza >= dimensione) return false;
+    memcpy(dest, valore, lunghezza + 1);
+    return true;
+}
+
+/**
+ * @brief Controlli formali su una riga gia' suddivisa in campi.
+ */
+static void preparaRigaAllievo(RigaAllievo* r, char* campi[], int n_campi) {
+    r->motivo = NULL;
+    memset(r->codice_fiscale, 0, sizeof(r->codice_fiscale));   // letto per intero dal controllo in blocco
+    if (n_campi < 4) {
+        r->motivo = "campi mancanti";
+    } else if (!copiaCampoCSV(r->nome, sizeof(r->nome), campi[0])) {
+        r->motivo = "nome mancante o troppo lungo";
+    } else if (!copiaCampoCSV(r->cognome, sizeof(r->cognome), campi[1])) {
+        r->motivo = "cognome mancante o troppo lungo";
+    } else if (!copiaCampoCSV(r->codice_fiscale, sizeof(r->codice_fiscale), campi[2])) {
+        r->motivo = "codice fiscale non valido";
+    } else if (!copiaCampoCSV(r->categoria, sizeof(r->categoria), campi[3])) {
+        r->motivo = "categoria patente non valida";
+    }
+}
+
+/**
+ * @brief Bit della riga `i` nella bitmap di validaCodiciFiscaliInBlocco().
+ */
+static bool codiceValidoNelLotto(const uint64_t cf_validi[], int i) {
+    return (cf_validi[i / 64] >> (i % 64)) & 1u;
+}
+
+/**
+ * @brief Valida l'intero lotto con le regole di difensiva.c e l'unicita' del codice fiscale.
+ * @return false in caso di errore di allocazione.
+ */
+static bool validaLottoAllievi(RigaAllievo lotto[], int n, InsiemeCF* presenti) {
+    uint64_t cf_validi[PAROLE_BITMAP_CF(DIM_LOTTO_IMPORTAZIONE)];
+    for (int i = 0; i < n; i++) {
+        if (lotto[i].motivo == NULL) normalizzaCF(lotto[i].codice_fiscale);
+    }
+    validaCodiciFiscaliInBlocco(lotto[0].codice_fiscale, (size_t)n, sizeof(RigaAllievo), cf_validi);
+
+    for (int i = 0; i < n; i++) {
+        RigaAllievo* r = &lotto[i];
+        if (r->motivo != NULL) continue;
+
+        if (!codiceValidoNelLotto(cf_validi, i)) {
+            r->motivo = "codice fiscale non valido";
+        } else if (!verificaDataCodiceFiscale(r->codice_fiscale)) {
+            r->motivo = "data del codice fiscale errata";
+        } else if (!verificaControlloCodiceFiscale(r->codice_fiscale)) {
+            r->motivo = "carattere di controllo del codice fiscale errato";
+        } else if (!validaCategoria(r->categoria)) {
+            r->motivo = "categoria patente non valida";
+        } else {
+            int esito = inserisciCF(presenti, r->codice_fiscale, 0);
+            if (esito < 0) return false;
+            if (esito == 0) r->motivo = "codice fiscale gia' presente";
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Inserisce le righe valide del lotto e scarta le altre.
+ */
+static void applicaLottoAllievi(RigaAllievo lotto[], int n, ListaAllievi* listaA,
+                                ListaPagamenti* listaP, ListaEsami* listaE,
+                                FILE** scarti, const char* filename, char separatore,
+                                EsitoImportazione* esito) {
+    for (int i = 0; i < n; i++) {
+        RigaAllievo* r = &lotto[i];
+        if (r->motivo == NULL) {
+            int id = aggiungiAllievo(listaA, r->nome, r->cognome, r->codice_fiscale, r->categoria);
+            if (id > 0) {
+                inizializzaPagamento(listaP, id);
+                inizializzaEsame(listaE, id);
+                esito->importati++;
+                continue;
+            }
+            r->motivo = "capacita' della lista esaurita";
+        }
+        scriviScarto(scarti, filename, separatore, r->originale, r->motivo);
+        esito->scartati++;
+    }
+}
+
+//LOTTI DI ESITI D'ESAME (PRIVATE)
+
+/**
+ * @brief Interpreta il tipo d'esame ("teorico"/"T" oppure "pratico"/"P").
+ */
+static bool leggiTipoEsame(const char* campo, TipoEsame* tipo) {
+    if (equalsIgnoreCase(campo, "teorico") || equalsIgnoreCase(campo, "t")) {
+        *tipo = ESAME_TEORICO;
+    } else if (equalsIgnoreCase(campo, "pratico") || equalsIgnoreCase(campo, "p")) {
+        *tipo = ESAME_PRATICO;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta l'esito ("1"/"superato" oppure "0"/"non superato").
+ */
+static bool leggiEsitoEsame(const char* campo, EsitoEsame* esito) {
+    if (strcmp(campo, "1") == 0 || equalsIgnoreCase(campo, "superato")) {
+        *esito = ESITO_SUPERATO;
+    } else if (strcmp(campo, "0") == 0 || equalsIgnoreCase(campo, "non superato") ||
+               equalsIgnoreCase(campo, "bocciato")) {
+        *esito = ESITO_NON_SUPERATO;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta una data gg/mm/aaaa, gg-mm-aaaa oppure aaaa-mm-gg.
+ */
+static bool leggiDataCSV(const char* campo, Data* data) {
+    int a, b, c, letti = 0;
+    if (sscanf(campo, "%d/%d/%d%n", &a, &b, &c, &letti) != 3 &&
+        sscanf(campo, "%d-%d-%d%n", &a, &b, &c, &letti) != 3) {
+        return false;
+    }
+    if (campo[letti] != '\0') return false;
+
+    if (a > 31) {
+        data->anno = a; data->mese = b; data->giorno = c;
+    } else {
+        data->giorno = a; data->mese = b; data->anno = c;
+    }
+    return validaData(data->giorno, data->mese, data->anno);
+}
+
+/**
+ * @brief Controlli formali su una riga gia' suddivisa in campi.
+ */
+static void preparaRigaEsito(RigaEsito* r, char* campi[], int n_campi) {
+    r->motivo = NULL;
+    r->id_allievo = 0;
+    memset(r->codice_fiscale, 0, sizeof(r->codice_fiscale));   // letto per intero dal controllo in blocco
+    if (n_campi < 4) {
+        r->motivo = "campi mancanti";
+    } else if (!copiaCampoCSV(r->codice_fiscale, sizeof(r->codice_fiscale), campi[0])) {
+        r->motivo = "codice fiscale non valido";
+    } else if (!leggiTipoEsame(campi[1], &r->tipo)) {
+        r->motivo = "tipo d'esame non valido";
+    } else if (!leggiEsitoEsame(campi[2], &r->esito)) {
+        r->motivo = "esito non valido";
+    } else if (!leggiDataCSV(campi[3], &r->data)) {
+        r->motivo = "data non valida";
+    }
+}
+
+/**
+ * @brief Risolve l'intero lotto contro la tabella dei codici fiscali (hash join).
+ */
+static void risolviLottoEsiti(RigaEsito lotto[], int n, const InsiemeCF* allievi,
+                              EsitoImportazioneEsami* esito) {
+    uint64_t cf_validi[PAROLE_BITMAP_CF(DIM_LOTTO_IMPORTAZIONE)];
+    for (int i = 0; i < n; i++) {
+        if (lotto[i].motivo == NULL) normalizzaCF(lotto[i].codice_fiscale);
+    }
+    validaCodiciFiscaliInBlocco(lotto[0].codice_fiscale, (size_t)n, sizeof(RigaEsito), cf_validi);
+
+    for (int i = 0; i < n; i++) {
+        RigaEsito* r = &lotto[i];
+        if (r->motivo != NULL) {
+            esito->righe_non_valide++;
+            continue;
+        }
+
+        if (!codiceValidoNelLotto(cf_validi, i)) {
+            r->motivo = "codice fiscale non valido";
+            esito->righe_non_valide++;
+        } else if ((r->id_allievo = cercaCF(allievi, r->codice_fiscale)) == 0) {
+            // Un carattere di controllo errato indica un errore di battitura nel file
+            r->motivo = verificaControlloCodiceFiscale(r->codice_fiscale)
+                            ? "codice fiscale sconosciuto"
+                            : "codice fiscale sconosciuto (carattere di controllo errato)";
+            esito->cf_sconosciuti++;
+        }
+    }
+}
+
+/**
+ * @brief Registra in ordine di file gli esiti risolti e scarta gli altri.
+ *
+ * L'ordine conta: il secondo tentativo di un allievo deve seguire il primo.
+ */
+static void applicaLottoEsiti(RigaEsito lotto[], int n, ListaAllievi* listaA,
+                              ListaPagamenti* listaP, ListaEsami* listaE,
+                              const ListaGuide* listaG, FILE** scarti,
+                              const char* filename, char separatore,
+                              EsitoImportazioneEsami* esito) {
+    for (int i = 0; i < n; i++) {
+        RigaEsito* r = &lotto[i];
+        if (r->motivo == NULL) {
+            bool penalita = false;
+            CodiceEsame codice;
+            if (r->tipo == ESAME_TEORICO) {
+                codice = registraEsitoTeorico(listaE, r->id_allievo, r->esito, r->data,
+                                              listaA, listaP, &penalita);
+            } else {
+                const Guida* g = cercaGuidaPerID(listaG, r->id_allievo);
+                int ore = (g != NULL) ? getOreSvolte(g) : 0;
+                codice = registraEsitoPratico(listaE, r->id_allievo, r->esito, r->data,
+                                              ore, listaP, &penalita);
+            }
+
+            if (codice <= 0 && codice >= ESAME_GIA_SUPERATO) {
+                esito->codici[-codice]++;
+            }
+            if (codice == ESAME_OK || penalita) {
+                esito->registrati++;
+                if (penalita) esito->penalita++;
+                continue;
+            }
+            r->motivo = descriviCodiceEsame(codice);
+        }
+        scriviScarto(scarti, filename, separatore, r->originale, r->motivo);
+        esito->scartati++;
+    }
+}
+
+//FUNZIONI PUBBLICHE
+
+bool importaAllieviCSV(const char* filename, ListaAllievi* listaA,
+                       ListaPagamenti* listaP, ListaEsami* listaE,
+                       EsitoImportazione* esito) {
+    EsitoImportazione locale = {0, 0, 0};
+    if (esito == NULL) esito = &locale;
+    *esito = locale;
+
+    if (filename == NULL || listaA == NULL || listaP == NULL || listaE == NULL) return false;
+
+    LettoreCSV lettore;
+    if (!apriLettoreCSV(&lettore, filename)) {
+        printf("Errore: impossibile aprire il file %s\n", filename);
+        return false;
+    }
+
+    RigaAllievo* lotto = (RigaAllievo*)malloc(sizeof(RigaAllievo) * DIM_LOTTO_IMPORTAZIONE);
+    if (lotto == NULL) {
+        printf("Errore: memoria insufficiente per l'importazione.\n");
+        chiudiLettoreCSV(&lettore);
+        return false;
+    }
+
+    // I codici fiscali gia' registrati contano come duplicati
+    InsiemeCF presenti = {NULL, NULL, 0, 0};
+    bool ok = caricaCFAllievi(&presenti, listaA);
+
+    FILE* scarti = NULL;
+    char riga[DIM_MAX_RIGA_CSV];
+    int n_lotto = 0;
+    int stato;
+
+    while (ok && (stato = leggiRigaCSV(&lettore, riga)) != 0) {
+        if (lettore.separatore == 0) {
+            lettore.separatore = scegliSeparatore(riga);
+        }
+
+        RigaAllievo* r = &lotto[n_lotto];
+        strcpy(r->originale, riga);
+
+        char* campi[MAX_CAMPI_CSV];
+        int n_campi = dividiCampiCSV(riga, lettore.separatore, campi, MAX_CAMPI_CSV);
+        if (n_campi == 0 || (n_campi == 1 && campi[0][0] == '\0')) continue; // Riga vuota
+
+        // Intestazione facoltativa sulla prima riga
+        if (lettore.numero_riga == 1 && n_campi >= 3 && equalsIgnoreCase(campi[2], "codice_fiscale")) {
+            continue;
+        }
+
+        esito->righe_lette++;
+        if (stato < 0) {
+            r->motivo = "riga troppo lunga";
+        } else {
+            preparaRigaAllievo(r, campi, n_campi);
+        }
+
+        if (++n_lotto == DIM_LOTTO_IMPORTAZIONE) {
+            ok = validaLottoAllievi(lotto, n_lotto, &presenti);
+            if (ok) {
+                applicaLottoAllievi(lotto, n_lotto, listaA, listaP, listaE,
+                                    &scarti, filename, lettore.separatore, esito);
+            }
+            n_lotto = 0;
+        }
+    }
+
+    if (ok && n_lotto > 0) {
+        ok = validaLottoAllievi(lotto, n_lotto, &presenti);
+        if (ok) {
+            applicaLottoAllievi(lotto, n_lotto, listaA, listaP, listaE,
+                                &scarti, filename, lettore.separatore, esito);
+        }
+    }
+
+    if (!ok) {
+        printf("Errore: memoria insufficiente per l'importazione.\n");
+    }
+    if (lettore.errore) {
+        printf("Errore: lettura del file %s interrotta.\n", filename);
+        ok = false;
+    }
+
+    // Un solo riordinamento per l'intera importazione
+    if (esito->importati > 0) {
+        ordinaAllieviAlfabetico(listaA);
+    }
+
+    if (scarti != NULL) fclose(scarti);
+    liberaInsiemeCF(&presenti);
+    free(lotto);
+    chiudiLettoreCSV(&lettore);
+    return ok;
+}
+
+void stampaEsitoImportazione(const EsitoImportazione* esito, const char* filename) {
+    if (esito == NULL) return;
+
+    printf("\n--- Esito importazione ---\n");
+    printf("Righe lette:  %d\n", esito->righe_lette);
+    printf("Importate:    %d\n", esito->importati);
+    printf("Scartate:     %d\n", esito->scartati);
+    if (esito->scartati > 0 && filename != NULL) {
+        printf("Righe scartate salvate in %s%s\n", filename, SUFFISSO_FILE_SCARTI);
+    }
+}
+
+const char* descriviCodiceEsame(CodiceEsame codice) {
+    switch (codice) {
+        case ESAME_OK:                      return "registrato";
+        case ESAME_TEORICO_NON_SUPERATO:    return "teorico non ancora superato";
+        case ESAME_ORE_GUIDA_INSUFFICIENTI: return "ore di guida insufficienti";
+        case ESAME_TENTATIVI_ESAURITI:      return "tentativi esauriti";
+        case ESAME_GIA_SUPERATO:            return "esame gia' superato";
+        default:                            return "scheda esami non trovata";
+    }
+}
+
+bool importaEsitiEsamiCSV(const char* filename, ListaAllievi* listaA,
+                          ListaPagamenti* listaP, ListaEsami* listaE,
+                          const ListaGuide* listaG, EsitoImportazioneEsami* esito) {
+    EsitoImportazioneEsami locale;
+    memset(&locale, 0, sizeof(locale));
+    if (esito == NULL) esito = &locale;
+    *esito = locale;
+
+    if (filename == NULL || listaA == NULL || listaP == NULL ||
+        listaE == NULL || listaG == NULL) return false;
+
+    LettoreCSV lettore;
+    if (!apriLettoreCSV(&lettore, filename)) {
+        printf("Errore: impossibile aprire il file %s\n", filename);
+        return false;
+    }
+
+    RigaEsito* lotto = (RigaEsito*)malloc(sizeof(RigaEsito) * DIM_LOTTO_IMPORTAZIONE);
+    if (lotto == NULL) {
+        printf("Errore: memoria insufficiente per l'importazione.\n");
+        chiudiLettoreCSV(&lettore);
+        return false;
+    }
+
+    // Lato "build" del join: una sola passata sugli allievi
+    InsiemeCF allievi = {NULL, NULL, 0, 0};
+    bool ok = caricaCFAllievi(&allievi, listaA);
+
+    FILE* scarti = NULL;
+    char riga[DIM_MAX_RIGA_CSV];
+    int n_lotto = 0;
+    int stato;
+
+    while (ok && (stato = leggiRigaCSV(&lettore, riga)) != 0) {
+        if (lettore.separatore == 0) {
+            lettore.separatore = scegliSeparatore(riga);
+        }
+
+        RigaEsito* r = &lotto[n_lotto];
+        strcpy(r->originale, riga);
+
+        char* campi[MAX_CAMPI_CSV];
+        int n_campi = dividiCampiCSV(riga, lettore.separatore, campi, MAX_CAMPI_CSV);
+        if (n_campi == 0 || (n_campi == 1 && campi[0][0] == '\0')) continue; // Riga vuota
+
+        // Intestazione facoltativa sulla prima riga
+        if (lettore.numero_riga == 1 && equalsIgnoreCase(campi[0], "codice_fiscale")) {
+            continue;
+        }
+
+        esito->righe_lette++;
+        if (stato < 0) {
+            r->motivo = "riga troppo lunga";
+        } else {
+            preparaRigaEsito(r, campi, n_campi);
+        }
+
+        if (++n_lotto == DIM_LOTTO_IMPORTAZIONE) {
+            risolviLottoEsiti(lotto, n_lotto, &allievi, esito);
+            applicaLottoEsiti(lotto, n_lotto, listaA, listaP, listaE, listaG,
+                              &scarti, filename, lettore.separatore, esito);
+            n_lotto = 0;
+        }
+    }
+
+    if (ok && n_lotto > 0) {
+        risolviLottoEsiti(lotto, n_lotto, &allievi, esito);
+        applicaLottoEsiti(lotto, n_lotto, listaA, listaP, listaE, listaG,
+                          &scarti, filename, lettore.separatore, esito);
+    }
+
+    if (!ok) {
+        printf("Errore: memoria insufficiente per l'importazione.\n");
+    }
+    if (lettore.errore) {
+        printf("Errore: lettura del file %s interrotta.\n", filename);
+        ok = false;
+    }
+
+    if (scarti != NULL) fclose(scarti);
+    liberaInsiemeCF(&allievi);
+    free(lotto);
+    chiudiLettoreCSV(&lettore);
+    return ok;
+}
+
+void stampaEsitoImportazioneEsami(const EsitoImportazioneEsami* esito, const char* filename) {
+    if (esito == NULL) return;
+
+    printf("\n--- Esito importazione esiti d'esame ---\n");
+    printf("Righe lette:                  %d\n", esito->righe_lette);
+    printf("Tentativi registrati:         %d\n", esito->registrati);
+    printf("  di cui con penalita':       %d\n", esito->penalita);
+    printf("Scartati:                     %d\n", esito->scartati);
+    printf("  righe non valide:           %d\n", esito->righe_non_valide);
+    printf("  codice fiscale sconosciuto: %d\n", esito->cf_sconosciuti);
+
+    printf("\nCodici di ritorno:\n");
+    static const CodiceEsame codici[] = {
+        ESAME_OK, ESAME_ERRORE_GENERICO, ESAME_TEORICO_NON_SUPERATO,
+        ESAME_ORE_GUIDA_INSUFFICIENTI, ESAME_TENTATIVI_ESAURITI, ESAME_GIA_SUPERATO
+    };
+    for (size_t i = 0; i < sizeof(codici) / sizeof(codici[0]); i++) {
+        printf("  %3d %-30s %d\n", (int)codici[i], descriviCodiceEsame(codici[i]),
+               esito->codici[-codici[i]]);
+    }
+    if (esito->scartati > 0 && filename != NULL) {
+        printf("Righe scartate salvate in %s%s\n", filename, SUFFISSO_FILE_SCARTI);
+    }
+}
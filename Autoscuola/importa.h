@@ -0,0 +1,129 @@
+/**
+ * @file importa.h
+ * @brief Importazione in blocco di dati da file CSV.
+ *
+ * Il file viene letto a blocchi di dimensione fissa e suddiviso in righe
+ * senza caricarlo per intero in memoria. Le righe vengono raccolte in lotti
+ * di `DIM_LOTTO_IMPORTAZIONE`: ogni lotto viene prima validato per intero con
+ * le regole di difensiva.c e poi inserito. Le righe non valide non
+ * interrompono l'importazione: vengono copiate, con il motivo dello scarto,
+ * nel file `<file>.scarti`.
+ *
+ * Formato atteso per gli allievi (separatore `,` oppure `;`, campi
+ * eventualmente tra virgolette, riga di intestazione facoltativa):
+ *
+ *     nome,cognome,codice_fiscale,categoria_patente
+ *
+ * Formato atteso per gli esiti d'esame (data gg/mm/aaaa, gg-mm-aaaa o
+ * aaaa-mm-gg):
+ *
+ *     codice_fiscale,tipo,esito,data
+ *     RSSMRA80A01H501U,teorico,superato,12/03/2025
+ *     RSSMRA80A01H501U,P,0,2025-04-02
+ */
+#ifndef IMPORTA_H
+#define IMPORTA_H
+
+#include <stdbool.h>
+#include "esami.h"
+
+//COSTANTI PUBBLICHE
+#define DIM_BLOCCO_IMPORTAZIONE (64 * 1024) /**< Byte letti dal file per ogni lettura */
+#define DIM_MAX_RIGA_CSV 512                /**< Lunghezza massima di una riga */
+#define DIM_LOTTO_IMPORTAZIONE 256          /**< Righe validate insieme */
+#define SUFFISSO_FILE_SCARTI ".scarti"
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @struct EsitoImportazione
+ * @brief Contatori di un'importazione.
+ */
+typedef struct {
+    int righe_lette;   /**< Righe di dati (intestazione e righe vuote escluse) */
+    int importati;     /**< Righe applicate */
+    int scartati;      /**< Righe copiate nel file degli scarti */
+} EsitoImportazione;
+
+/**
+ * @brief Importa allievi da un file CSV.
+ *
+ * Per ogni riga valida crea l'allievo e, come inserisciAllievo(), il suo
+ * pagamento e la sua scheda esami. Vengono scartate le righe con campi
+ * mancanti o troppo lunghi, codice fiscale non valido (formato, data o
+ * carattere di controllo) o gia' presente (anche nello stesso file),
+ * categoria non valida, e quelle che eccedono la capacita' delle liste. Al
+ * termine la lista viene ordinata una sola volta.
+ *
+ * @param filename File CSV da importare.
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param esito Se non NULL, riceve i contatori dell'importazione.
+ * @return true se il file e' stato letto fino in fondo, false se non e' apribile o in caso di errore di I/O.
+ */
+bool importaAllieviCSV(const char* filename, ListaAllievi* listaA,
+                       ListaPagamenti* listaP, ListaEsami* listaE,
+                       EsitoImportazione* esito);
+
+/**
+ * @brief Stampa il riepilogo di un'importazione.
+ * @param esito Contatori da stampare.
+ * @param filename File importato (per indicare il file degli scarti).
+ */
+void stampaEsitoImportazione(const EsitoImportazione* esito, const char* filename);
+
+/**
+ * @struct EsitoImportazioneEsami
+ * @brief Contatori di un'importazione di esiti d'esame.
+ */
+typedef struct {
+    int righe_lette;      /**< Righe di dati (intestazione e righe vuote escluse) */
+    int registrati;       /**< Tentativi registrati */
+    int penalita;         /**< Tentativi registrati che hanno applicato penalita' */
+    int scartati;         /**< Righe copiate nel file degli scarti */
+    int righe_non_valide; /**< Scarti per campi mancanti o non interpretabili */
+    int cf_sconosciuti;   /**< Scarti per codice fiscale non registrato */
+    int codici[6];        /**< Occorrenze di ogni CodiceEsame, indicizzate con -codice */
+} EsitoImportazioneEsami;
+
+/**
+ * @brief Importa gli esiti d'esame da un file esterno, collegandoli per codice fiscale.
+ *
+ * I codici fiscali degli allievi vengono caricati una sola volta in una
+ * tabella hash e ogni riga del file viene collegata all'allievo con una sola
+ * ricerca. I tentativi vengono registrati nell'ordine del file con le regole
+ * di registraEsitoTeorico() e registraEsitoPratico(), penalita' comprese; per
+ * il pratico contano le ore di guida gia' registrate. Le righe rifiutate
+ * finiscono nel file degli scarti con il motivo.
+ *
+ * @param filename File CSV da importare.
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti (penalita').
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide (ore svolte).
+ * @param esito Se non NULL, riceve i contatori dell'importazione.
+ * @return true se il file e' stato letto fino in fondo, false se non e' apribile o in caso di errore di I/O.
+ */
+bool importaEsitiEsamiCSV(const char* filename, ListaAllievi* listaA,
+                          ListaPagamenti* listaP, ListaEsami* listaE,
+                          const ListaGuide* listaG, EsitoImportazioneEsami* esito);
+
+/**
+ * @brief Stampa il riepilogo di un'importazione di esiti, con il conteggio dei codici di ritorno.
+ * @param esito Contatori da stampare.
+ * @param filename File importato (per indicare il file degli scarti).
+ */
+void stampaEsitoImportazioneEsami(const EsitoImportazioneEsami* esito, const char* filename);
+
+/**
+ * @brief Descrizione breve di un codice di ritorno degli esami.
+ * @param codice Codice da descrivere.
+ * @return Stringa costante.
+ */
+const char* descriviCodiceEsame(CodiceEsame codice);
+
+#endif // IMPORTA_H
@@ -0,0 +1,74 @@
+/**
+ * @file indice.c
+ * @brief Implementazione dell'indice hash ID -> posizione (indirizzamento aperto).
+ */
+
+#include <string.h>
+#include "indice.h"
+
+/**
+ * @brief Calcola la cella di partenza per una chiave (hash moltiplicativo).
+ */
+static unsigned int cellaIniziale(int chiave) {
+    return ((unsigned int)chiave * 2654435761u) & (CAPACITA_INDICE - 1);
+}
+
+void svuotaIndice(IndiceID* indice) {
+    if (indice == NULL) return;
+    memset(indice->chiavi, 0, sizeof(indice->chiavi));
+    indice->n_chiavi = 0;
+}
+
+bool inserisciInIndice(IndiceID* indice, int chiave, int posizione) {
+    if (indice == NULL || chiave <= 0) return false;
+
+    unsigned int cella = cellaIniziale(chiave);
+    for (int passi = 0; passi < CAPACITA_INDICE; passi++) {
+        if (indice->chiavi[cella] == chiave) {
+            return true; // Resta valida la prima occorrenza
+        }
+        if (indice->chiavi[cella] == 0) {
+            indice->chiavi[cella] = chiave;
+            indice->posizioni[cella] = posizione;
+            indice->n_chiavi++;
+            return true;
+        }
+        cella = (cella + 1) & (CAPACITA_INDICE - 1);
+    }
+    return false;
+}
+
+int cercaInIndice(const IndiceID* indice, int chiave) {
+    if (indice == NULL || chiave <= 0) return -1;
+
+    unsigned int cella = cellaIniziale(chiave);
+    for (int passi = 0; passi < CAPACITA_INDICE; passi++) {
+        if (indice->chiavi[cella] == chiave) {
+            return indice->posizioni[cella];
+        }
+        if (indice->chiavi[cella] == 0) {
+            return -1;
+        }
+        cella = (cella + 1) & (CAPACITA_INDICE - 1);
+    }
+    return -1;
+}
+
+bool adottaIndice(IndiceID* indice, const void* dati, size_t lunghezza, int n_record) {
+    if (indice == NULL || dati == NULL || lunghezza != sizeof(IndiceID)) return false;
+
+    const IndiceID* salvato = (const IndiceID*)dati;
+    int occupate = 0;
+    for (int i = 0; i < CAPACITA_INDICE; i++) {
+        if (salvato->chiavi[i] == 0) continue;
+        if (salvato->chiavi[i] < 0 ||
+            salvato->posizioni[i] < 0 || salvato->posizioni[i] >= n_record) {
+            return false;
+        }
+        occupate++;
+    }
+    if (occupate != salvato->n_chiavi || occupate > n_record) return false;
+
+    memcpy(indice, salvato, sizeof(IndiceID));
+    return true;
+}
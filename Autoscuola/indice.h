@@ -0,0 +1,79 @@
+/**
+ * @file indice.h
+ * @brief Indice hash per la ricerca per ID nelle liste degli ADT.
+ *
+ * L'indice associa un ID (allievo) alla posizione del record nella lista,
+ * evitando la scansione lineare di `cercaAllievoPerID`, `cercaPagamentoPerID`,
+ * `cercaEsamePerID` e `cercaGuidaPerID`.
+ *
+ * E' una tabella a indirizzamento aperto di dimensione fissa: non alloca
+ * memoria e puo' quindi essere incorporata direttamente nella struttura
+ * privata di ogni lista. Se la stessa chiave viene inserita piu' volte resta
+ * valida la prima posizione, come per la ricerca lineare.
+ */
+#ifndef INDICE_H
+#define INDICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//COSTANTI PUBBLICHE
+/**
+ * @brief Numero di celle dell'indice.
+ *
+ * Deve essere una potenza di due e almeno il doppio della capacita'
+ * massima delle liste (100 record), per mantenere brevi le catene di ricerca.
+ */
+#define CAPACITA_INDICE 256
+
+/**
+ * @struct IndiceID
+ * @brief Tabella hash ID -> posizione nella lista.
+ */
+typedef struct {
+    int chiavi[CAPACITA_INDICE];    /**< ID memorizzati (0 = cella libera) */
+    int posizioni[CAPACITA_INDICE]; /**< Posizione del record nella lista */
+    int n_chiavi;                   /**< Numero di celle occupate */
+} IndiceID;
+
+/**
+ * @brief Svuota l'indice.
+ * @param indice Indice da svuotare.
+ */
+void svuotaIndice(IndiceID* indice);
+
+/**
+ * @brief Inserisce una chiave nell'indice.
+ * @param indice Indice da aggiornare.
+ * @param chiave ID da indicizzare (> 0).
+ * @param posizione Posizione del record nella lista.
+ * @return true se la chiave e' indicizzata (anche se gia' presente), false se l'indice e' pieno o la chiave non e' valida.
+ */
+bool inserisciInIndice(IndiceID* indice, int chiave, int posizione);
+
+/**
+ * @brief Cerca la posizione associata a una chiave.
+ * @param indice Indice in cui cercare.
+ * @param chiave ID da cercare.
+ * @return Posizione del record, -1 se la chiave non e' presente.
+ */
+int cercaInIndice(const IndiceID* indice, int chiave);
+
+/**
+ * @brief Adotta l'immagine di un indice salvata su file.
+ *
+ * L'indice non contiene puntatori, quindi la sua immagine in memoria puo'
+ * essere scritta e riletta cosi' com'e'. Prima di adottarla vengono
+ * controllate la dimensione e la coerenza delle celle (chiavi positive,
+ * posizioni entro `n_record`, conteggio delle celle occupate); in caso di
+ * errore `indice` resta invariato.
+ *
+ * @param indice Indice di destinazione.
+ * @param dati Immagine dell'indice (sizeof(IndiceID) byte).
+ * @param lunghezza Numero di byte disponibili.
+ * @param n_record Numero di record della lista a cui l'indice si riferisce.
+ * @return true se l'immagine e' stata adottata, false se va ricostruito.
+ */
+bool adottaIndice(IndiceID* indice, const void* dati, size_t lunghezza, int n_record);
+
+#endif // INDICE_H
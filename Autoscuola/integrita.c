@@ -0,0 +1,466 @@
+/**
+ * @file integrita.c
+ * @brief Implementazione del controllo di integrita' a regole.
+ *
+ * Struttura:
+ * - Regole predefinite (funzioni di verifica su un record)
+ * - Registro delle regole, caricato con le predefinite al primo uso
+ * - Descrittori delle tabelle: come contare, leggere e identificare i record
+ * - Una passata per tabella, eseguite in parallelo e poi unite in ordine
+ * - Esiti dell'ultimo controllo (regole violate per posizione), riusati dal
+ *   controllo incrementale per i record non modificati (vedi modifiche.h)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "integrita.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "difensiva.h"
+#include "modifiche.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+
+/**
+ * @struct DescrittoreTabella
+ * @brief Accesso uniforme ai record di una tabella.
+ */
+typedef struct {
+    const char* titolo;      /**< Intestazione della sezione nella stampa */
+    const char* prefisso;    /**< Inizio di ogni riga di violazione */
+    int (*numero)(const ContestoIntegrita* contesto);
+    const void* (*record)(const ContestoIntegrita* contesto, int i);
+    int (*id_allievo)(const void* record);
+    const RegistroModifiche* (*registro)(const ContestoIntegrita* contesto);
+} DescrittoreTabella;
+
+/**
+ * @struct EsitiTabella
+ * @brief Regole violate da ogni record di una tabella all'ultimo controllo.
+ */
+typedef struct {
+    uint64_t* violate;   /**< Per posizione: bit r se la r-esima regola della tabella e' violata */
+    int n_record;
+    int capacita;
+} EsitiTabella;
+
+/**
+ * @struct PassataIntegrita
+ * @brief Lavoro di un thread: una tabella, le sue regole e le violazioni trovate.
+ */
+typedef struct {
+    TabellaIntegrita tabella;
+    const ContestoIntegrita* contesto;
+    const RegolaIntegrita* regole[MAX_REGOLE_INTEGRITA];
+    int n_regole;
+    ViolazioneIntegrita* violazioni;
+    int n_violazioni;
+    int capacita;
+    int n_record;
+    bool incrementale;          /**< Riusa gli esiti dei record non modificati */
+    unsigned long generazione;  /**< Generazione dell'ultimo controllo */
+    bool rifai_tra_moduli;      /**< Altre liste modificate: rivalutare le regole tra moduli */
+    EsitiTabella* esiti;
+    int n_ricontrollati;
+    bool errore;
+} PassataIntegrita;
+
+//REGOLE PREDEFINITE (PRIVATE)
+
+static bool nomePresente(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    return stringaNonVuota(getAllievoNome((const Allievo*)r));
+}
+
+static bool cognomePresente(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    return stringaNonVuota(getAllievoCognome((const Allievo*)r));
+}
+
+static bool codiceFiscaleValido(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    return validaCodiceFiscale(getAllievoCodiceFiscale((const Allievo*)r));
+}
+
+/*
+ * Le due regole seguenti valgono solo per un codice di formato valido:
+ * un formato errato e' gia' segnalato da codiceFiscaleValido.
+ */
+static bool dataCodiceFiscaleCoerente(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const char* cf = getAllievoCodiceFiscale((const Allievo*)r);
+    return !validaCodiceFiscale(cf) || verificaDataCodiceFiscale(cf);
+}
+
+static bool controlloCodiceFiscaleCorretto(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const char* cf = getAllievoCodiceFiscale((const Allievo*)r);
+    return !validaCodiceFiscale(cf) || verificaControlloCodiceFiscale(cf);
+}
+
+static bool statoValido(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    return validaStato(getAllievoStato((const Allievo*)r));
+}
+
+static bool importiNonNegativi(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Pagamento* p = (const Pagamento*)r;
+    return validaImporto(getPrimaRata(p)) && validaImporto(getSecondaRata(p)) &&
+           validaImporto(getTerzaRata(p));
+}
+
+static bool rateProgressive(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Pagamento* p = (const Pagamento*)r;
+    return verificaProgressioneRate(getPrimaRata(p), getSecondaRata(p), getTerzaRata(p));
+}
+
+static bool tentativiValidi(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Esame* e = (const Esame*)r;
+    return validaTentativi(getTentativiTeorico(e)) && validaTentativi(getTentativiPratico(e));
+}
+
+static bool teoricoCoerente(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Esame* e = (const Esame*)r;
+    return verificaCoerenzaEsame(getTentativiTeorico(e), isTeoricoSuperato(e) ? 1 : 0);
+}
+
+static bool praticoCoerente(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Esame* e = (const Esame*)r;
+    return verificaCoerenzaEsame(getTentativiPratico(e), isPraticoSuperato(e) ? 1 : 0);
+}
+
+static bool praticoDopoTeorico(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Esame* e = (const Esame*)r;
+    return !isPraticoSuperato(e) || isTeoricoSuperato(e);
+}
+
+static bool oreNonNegative(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Guida* g = (const Guida*)r;
+    return validaOre(getOreSvolte(g)) && validaOre(getOreExtra(g));
+}
+
+static bool oreExtraCoerenti(const void* r, const ContestoIntegrita* c) {
+    (void)c;
+    const Guida* g = (const Guida*)r;
+    return verificaCoerenzaOreExtra(getOreSvolte(g), getOreExtra(g), ORE_GUIDA_OBBLIGATORIE);
+}
+
+static const RegolaIntegrita REGOLE_PREDEFINITE[] = {
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "nome vuoto",                     nomePresente },
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "cognome vuoto",                  cognomePresente },
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "codice fiscale non valido",      codiceFiscaleValido },
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "data del codice fiscale errata", dataCodiceFiscaleCoerente },
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "carattere di controllo errato",  controlloCodiceFiscaleCorretto },
+    { INTEGRITA_ALLIEVI,   REGOLA_CAMPO,      "stato non valido",               statoValido },
+    { INTEGRITA_PAGAMENTI, REGOLA_CAMPO,      "importi negativi",               importiNonNegativi },
+    { INTEGRITA_PAGAMENTI, REGOLA_TRA_CAMPI,  "progressione rate non valida",   rateProgressive },
+    { INTEGRITA_ESAMI,     REGOLA_CAMPO,      "numero tentativi non valido",    tentativiValidi },
+    { INTEGRITA_ESAMI,     REGOLA_TRA_CAMPI,  "incoerenza teorico",             teoricoCoerente },
+    { INTEGRITA_ESAMI,     REGOLA_TRA_CAMPI,  "incoerenza pratico",             praticoCoerente },
+    { INTEGRITA_ESAMI,     REGOLA_TRA_CAMPI,  "pratico superato senza teorico", praticoDopoTeorico },
+    { INTEGRITA_GUIDE,     REGOLA_CAMPO,      "ore negative",                   oreNonNegative },
+    { INTEGRITA_GUIDE,     REGOLA_TRA_CAMPI,  "incoerenza ore extra",           oreExtraCoerenti }
+};
+
+//DESCRITTORI DELLE TABELLE (PRIVATE)
+
+static int numeroAllievi(const ContestoIntegrita* c) { return getNumeroAllievi(c->listaA); }
+static int numeroPagamenti(const ContestoIntegrita* c) { return getNumeroPagamenti(c->listaP); }
+static int numeroEsami(const ContestoIntegrita* c) { return getNumeroEsami(c->listaE); }
+static int numeroGuide(const ContestoIntegrita* c) { return getNumeroGuide(c->listaG); }
+
+static const void* allievoAt(const ContestoIntegrita* c, int i) { return getAllievoAtIndex(c->listaA, i); }
+static const void* pagamentoAt(const ContestoIntegrita* c, int i) { return getPagamentoAtIndex(c->listaP, i); }
+static const void* esameAt(const ContestoIntegrita* c, int i) { return getEsameAtIndex(c->listaE, i); }
+static const void* guidaAt(const ContestoIntegrita* c, int i) { return getGuidaAtIndex(c->listaG, i); }
+
+static int idAllievo(const void* r) { return getAllievoID((const Allievo*)r); }
+static int idPagamento(const void* r) { return getPagamentoIDAllievo((const Pagamento*)r); }
+static int idEsame(const void* r) { return getEsameIDAllievo((const Esame*)r); }
+static int idGuida(const void* r) { return getGuidaIDAllievo((const Guida*)r); }
+
+static const RegistroModifiche* registroAllievi(const ContestoIntegrita* c) { return getRegistroModificheAllievi(c->listaA); }
+static const RegistroModifiche* registroPagamenti(const ContestoIntegrita* c) { return getRegistroModifichePagamenti(c->listaP); }
+static const RegistroModifiche* registroEsami(const ContestoIntegrita* c) { return getRegistroModificheEsami(c->listaE); }
+static const RegistroModifiche* registroGuide(const ContestoIntegrita* c) { return getRegistroModificheGuide(c->listaG); }
+
+static const DescrittoreTabella TABELLE[NUM_TABELLE_INTEGRITA] = {
+    { "ALLIEVI",   "Allievo ID",           numeroAllievi,   allievoAt,   idAllievo,   registroAllievi },
+    { "PAGAMENTI", "Pagamento ID allievo", numeroPagamenti, pagamentoAt, idPagamento, registroPagamenti },
+    { "ESAMI",     "Esame ID allievo",     numeroEsami,     esameAt,     idEsame,     registroEsami },
+    { "GUIDE",     "Guida ID allievo",     numeroGuide,     guidaAt,     idGuida,     registroGuide }
+};
+
+//STATO DEL MODULO
+/** Regole registrate; le predefinite vengono copiate al primo uso. */
+static RegolaIntegrita registro[MAX_REGOLE_INTEGRITA];
+static int n_registro = 0;
+static bool registro_pronto = false;
+
+/** Esiti dell'ultimo controllo riuscito, validi per `liste_controllate` e `generazione_controllo`. */
+static EsitiTabella esiti_controllo[NUM_TABELLE_INTEGRITA];
+static ContestoIntegrita liste_controllate;
+static unsigned long generazione_controllo = 0;
+static bool esiti_validi = false;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+static void preparaRegistro(void) {
+    if (registro_pronto) return;
+    n_registro = (int)(sizeof(REGOLE_PREDEFINITE) / sizeof(REGOLE_PREDEFINITE[0]));
+    memcpy(registro, REGOLE_PREDEFINITE, sizeof(REGOLE_PREDEFINITE));
+    registro_pronto = true;
+}
+
+static void aggiungiViolazione(PassataIntegrita* p, int id_allievo, const RegolaIntegrita* regola) {
+    if (p->errore) return;
+    if (p->n_violazioni == p->capacita) {
+        int nuova = (p->capacita > 0) ? p->capacita * 2 : 16;
+        ViolazioneIntegrita* v = (ViolazioneIntegrita*)realloc(p->violazioni, sizeof(ViolazioneIntegrita) * nuova);
+        if (v == NULL) {
+            p->errore = true;
+            return;
+        }
+        p->violazioni = v;
+        p->capacita = nuova;
+    }
+    ViolazioneIntegrita* v = &p->violazioni[p->n_violazioni++];
+    v->tabella = p->tabella;
+    v->id_allievo = id_allievo;
+    v->regola = regola;
+}
+
+/**
+ * @brief Garantisce agli esiti della tabella almeno `n` posizioni.
+ */
+static bool riservaEsiti(EsitiTabella* esiti, int n) {
+    if (n <= esiti->capacita) return true;
+    uint64_t* v = (uint64_t*)realloc(esiti->violate, sizeof(uint64_t) * (size_t)n);
+    if (v == NULL) return false;
+    esiti->violate = v;
+    esiti->capacita = n;
+    return true;
+}
+
+/**
+ * @brief Una sola passata sulla tabella: ogni record contro tutte le sue regole.
+ *
+ * In modo incrementale i record non modificati dall'ultimo controllo
+ * riprendono le regole violate allora; solo le regole tra moduli vengono
+ * rivalutate se nel frattempo e' cambiata un'altra lista.
+ */
+static void eseguiPassata(PassataIntegrita* p) {
+    const DescrittoreTabella* t = &TABELLE[p->tabella];
+    const RegistroModifiche* modifiche = t->registro(p->contesto);
+    p->n_record = t->numero(p->contesto);
+    if (p->n_record < 0) p->n_record = 0;
+
+    if (!riservaEsiti(p->esiti, p->n_record)) {
+        p->errore = true;
+        return;
+    }
+
+    for (int i = 0; i < p->n_record; i++) {
+        const void* record = t->record(p->contesto, i);
+        uint64_t violate = 0;
+        if (record == NULL) {
+            p->esiti->violate[i] = 0;
+            continue;
+        }
+
+        bool riusa = p->incrementale && i < p->esiti->n_record &&
+                     !recordModificatoDopo(modifiche, i, p->generazione);
+        if (riusa) {
+            violate = p->esiti->violate[i];
+            for (int r = 0; r < p->n_regole && p->rifai_tra_moduli; r++) {
+                if (p->regole[r]->ambito != REGOLA_TRA_MODULI) continue;
+                violate &= ~((uint64_t)1 << r);
+                if (!p->regole[r]->verifica(record, p->contesto)) violate |= (uint64_t)1 << r;
+            }
+        } else {
+            for (int r = 0; r < p->n_regole; r++) {
+                if (!p->regole[r]->verifica(record, p->contesto)) violate |= (uint64_t)1 << r;
+            }
+            p->n_ricontrollati++;
+        }
+
+        p->esiti->violate[i] = violate;
+        for (int r = 0; violate != 0 && r < p->n_regole; r++) {
+            if (violate & ((uint64_t)1 << r)) aggiungiViolazione(p, t->id_allievo(record), p->regole[r]);
+        }
+    }
+    p->esiti->n_record = p->n_record;
+}
+
+static void* threadPassata(void* arg) {
+    eseguiPassata((PassataIntegrita*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Controllo completo o incrementale; salva gli esiti per il prossimo.
+ */
+static bool eseguiControllo(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                            const ListaEsami* listaE, const ListaGuide* listaG,
+                            RisultatoIntegrita* risultato, bool incrementale) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL ||
+        risultato == NULL) return false;
+
+    memset(risultato, 0, sizeof(*risultato));
+    preparaRegistro();
+
+    // Senza esiti precedenti per queste liste il controllo e' completo
+    incrementale = incrementale && integritaGiaControllata(listaA, listaP, listaE, listaG);
+    unsigned long generazione = getGenerazioneCorrente();
+
+    ContestoIntegrita contesto = { listaA, listaP, listaE, listaG };
+    PassataIntegrita passate[NUM_TABELLE_INTEGRITA];
+    memset(passate, 0, sizeof(passate));
+
+    // Regole raggruppate per tabella, nell'ordine di registrazione
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        passate[t].tabella = (TabellaIntegrita)t;
+        passate[t].contesto = &contesto;
+        passate[t].incrementale = incrementale;
+        passate[t].generazione = generazione_controllo;
+        passate[t].rifai_tra_moduli = generazione != generazione_controllo;
+        passate[t].esiti = &esiti_controllo[t];
+    }
+    for (int i = 0; i < n_registro; i++) {
+        PassataIntegrita* p = &passate[registro[i].tabella];
+        p->regole[p->n_regole++] = &registro[i];
+    }
+
+    // Una tabella per thread; la prima sul thread chiamante
+    pthread_t thread[NUM_TABELLE_INTEGRITA];
+    bool avviato[NUM_TABELLE_INTEGRITA];
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        avviato[t] = (t > 0) && (pthread_create(&thread[t], NULL, threadPassata, &passate[t]) == 0);
+    }
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        if (!avviato[t]) eseguiPassata(&passate[t]);
+    }
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        if (avviato[t]) pthread_join(thread[t], NULL);
+    }
+
+    // Unione nell'ordine delle tabelle
+    bool ok = true;
+    int totale = 0;
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        ok = ok && !passate[t].errore;
+        totale += passate[t].n_violazioni;
+    }
+    if (ok && totale > 0) {
+        risultato->violazioni = (ViolazioneIntegrita*)malloc(sizeof(ViolazioneIntegrita) * totale);
+        ok = (risultato->violazioni != NULL);
+    }
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        if (ok && passate[t].n_violazioni > 0) {
+            memcpy(risultato->violazioni + risultato->n_violazioni, passate[t].violazioni,
+                   sizeof(ViolazioneIntegrita) * passate[t].n_violazioni);
+            risultato->n_violazioni += passate[t].n_violazioni;
+        }
+        risultato->violazioni_tabella[t] = passate[t].n_violazioni;
+        risultato->record_tabella[t] = passate[t].n_record;
+        risultato->record_ricontrollati[t] = passate[t].n_ricontrollati;
+        free(passate[t].violazioni);
+    }
+    risultato->incrementale = incrementale;
+
+    // Esiti validi per il prossimo controllo incrementale solo se tutto e' andato a buon fine
+    esiti_validi = ok;
+    liste_controllate = contesto;
+    generazione_controllo = generazione;
+
+    if (!ok) {
+        printf("Errore: memoria insufficiente per il controllo di integrita'.\n");
+        liberaRisultatoIntegrita(risultato);
+        return false;
+    }
+    return true;
+}
+
+//FUNZIONI PUBBLICHE
+
+bool registraRegolaIntegrita(const RegolaIntegrita* regola) {
+    if (regola == NULL || regola->verifica == NULL || regola->messaggio == NULL ||
+        regola->tabella < 0 || regola->tabella >= NUM_TABELLE_INTEGRITA) {
+        return false;
+    }
+
+    preparaRegistro();
+    if (n_registro >= MAX_REGOLE_INTEGRITA) {
+        printf("Errore: registro delle regole pieno.\n");
+        return false;
+    }
+    registro[n_registro++] = *regola;
+    esiti_validi = false;   // Gli esiti salvati non considerano la nuova regola
+    return true;
+}
+
+int contaRegoleIntegrita(TabellaIntegrita tabella) {
+    preparaRegistro();
+    int n = 0;
+    for (int i = 0; i < n_registro; i++) {
+        if (registro[i].tabella == tabella) n++;
+    }
+    return n;
+}
+
+bool verificaIntegrita(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                       const ListaEsami* listaE, const ListaGuide* listaG,
+                       RisultatoIntegrita* risultato) {
+    return eseguiControllo(listaA, listaP, listaE, listaG, risultato, false);
+}
+
+bool verificaIntegritaIncrementale(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                                   const ListaEsami* listaE, const ListaGuide* listaG,
+                                   RisultatoIntegrita* risultato) {
+    return eseguiControllo(listaA, listaP, listaE, listaG, risultato, true);
+}
+
+bool integritaGiaControllata(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                             const ListaEsami* listaE, const ListaGuide* listaG) {
+    return esiti_validi && liste_controllate.listaA == listaA && liste_controllate.listaP == listaP &&
+           liste_controllate.listaE == listaE && liste_controllate.listaG == listaG;
+}
+
+void stampaRisultatoIntegrita(const RisultatoIntegrita* risultato) {
+    if (risultato == NULL) return;
+
+    int v = 0;
+    for (int t = 0; t < NUM_TABELLE_INTEGRITA; t++) {
+        printf("---- VALIDAZIONE %s ----\n", TABELLE[t].titolo);
+        for (; v < risultato->n_violazioni && risultato->violazioni[v].tabella == (TabellaIntegrita)t; v++) {
+            const ViolazioneIntegrita* x = &risultato->violazioni[v];
+            printf(" %s %d: %s\n", TABELLE[t].prefisso, x->id_allievo, x->regola->messaggio);
+        }
+        printf("Errori trovati: %d\n", risultato->violazioni_tabella[t]);
+        if (risultato->incrementale) {
+            printf("Record ricontrollati: %d su %d\n", risultato->record_ricontrollati[t],
+                   risultato->record_tabella[t]);
+        }
+        printf("\n");
+    }
+
+    stampaRiepilogoErrori(risultato->n_violazioni);
+}
+
+void liberaRisultatoIntegrita(RisultatoIntegrita* risultato) {
+    if (risultato == NULL) return;
+    free(risultato->violazioni);
+    memset(risultato, 0, sizeof(*risultato));
+}
@@ -0,0 +1,179 @@
+/**
+ * @file integrita.h
+ * @brief Controllo di integrita' dei dati a regole.
+ *
+ * Ogni controllo e' una regola registrata per una tabella: una funzione che
+ * riceve un record (e, per le regole tra moduli, le altre liste) e dice se il
+ * record la rispetta. Il controllo percorre ogni tabella una sola volta e
+ * applica a ogni record tutte le regole della tabella, quindi aggiungere una
+ * regola non aggiunge passate sui dati. Le quattro tabelle vengono percorse
+ * in parallelo, una per thread; le violazioni vengono raccolte in un elenco
+ * strutturato, nell'ordine delle tabelle e dei record.
+ *
+ * Ogni controllo ricorda le regole violate da ogni record. Il controllo
+ * incrementale rivaluta solo i record modificati da allora: i setter e le
+ * registrazioni (setRata, registraOreGuida, setAllievoStato, esiti d'esame,
+ * ...) segnano gia' i record modificati per il salvataggio differenziale
+ * (vedi modifiche.h) e il controllo usa le stesse generazioni. Il risultato
+ * e' identico a quello di un controllo completo.
+ *
+ * Le regole predefinite usano i validatori di difensiva.c; altre regole si
+ * aggiungono con registraRegolaIntegrita(). L'esistenza dell'allievo a cui
+ * si riferiscono pagamenti, esami e guide e' controllata da referenze.h.
+ */
+#ifndef INTEGRITA_H
+#define INTEGRITA_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define MAX_REGOLE_INTEGRITA 64 /**< Regole registrabili, predefinite comprese */
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Tabella a cui si applica una regola.
+ */
+typedef enum {
+    INTEGRITA_ALLIEVI = 0,
+    INTEGRITA_PAGAMENTI,
+    INTEGRITA_ESAMI,
+    INTEGRITA_GUIDE,
+    NUM_TABELLE_INTEGRITA
+} TabellaIntegrita;
+
+/**
+ * @brief Ambito di una regola (solo descrittivo).
+ */
+typedef enum {
+    REGOLA_CAMPO,        /**< Un solo campo del record */
+    REGOLA_TRA_CAMPI,    /**< Piu' campi dello stesso record */
+    REGOLA_TRA_MODULI    /**< Il record e le altre liste */
+} AmbitoRegola;
+
+/**
+ * @struct ContestoIntegrita
+ * @brief Liste controllate, passate alle regole tra moduli.
+ */
+typedef struct {
+    const ListaAllievi* listaA;
+    const ListaPagamenti* listaP;
+    const ListaEsami* listaE;
+    const ListaGuide* listaG;
+} ContestoIntegrita;
+
+/**
+ * @brief Verifica di una regola.
+ *
+ * Viene chiamata da piu' thread insieme: deve solo leggere.
+ *
+ * @param record Allievo, Pagamento, Esame o Guida, secondo la tabella della regola.
+ * @param contesto Liste controllate.
+ * @return true se il record rispetta la regola.
+ */
+typedef bool (*VerificaRegola)(const void* record, const ContestoIntegrita* contesto);
+
+/**
+ * @struct RegolaIntegrita
+ * @brief Regola registrata.
+ */
+typedef struct {
+    TabellaIntegrita tabella;
+    AmbitoRegola ambito;
+    const char* messaggio;    /**< Descrizione della violazione (es. "nome vuoto") */
+    VerificaRegola verifica;
+} RegolaIntegrita;
+
+/**
+ * @struct ViolazioneIntegrita
+ * @brief Record che non rispetta una regola.
+ */
+typedef struct {
+    TabellaIntegrita tabella;
+    int id_allievo;                  /**< ID dell'allievo a cui si riferisce il record */
+    const RegolaIntegrita* regola;   /**< Regola violata (nel registro del modulo) */
+} ViolazioneIntegrita;
+
+/**
+ * @struct RisultatoIntegrita
+ * @brief Esito di un controllo.
+ */
+typedef struct {
+    ViolazioneIntegrita* violazioni;                /**< Nell'ordine di tabelle e record */
+    int n_violazioni;
+    int violazioni_tabella[NUM_TABELLE_INTEGRITA];
+    int record_tabella[NUM_TABELLE_INTEGRITA];      /**< Record controllati */
+    int record_ricontrollati[NUM_TABELLE_INTEGRITA]; /**< Record su cui sono state eseguite le regole */
+    bool incrementale;                              /**< Esiti dei record non modificati ripresi dal controllo precedente */
+} RisultatoIntegrita;
+
+/**
+ * @brief Aggiunge una regola a quelle predefinite.
+ * @param regola Regola da copiare nel registro (`messaggio` deve restare valido).
+ * @return true se registrata, false se non valida o se il registro e' pieno.
+ */
+bool registraRegolaIntegrita(const RegolaIntegrita* regola);
+
+/**
+ * @brief Numero di regole registrate per una tabella.
+ * @param tabella Tabella.
+ * @return Numero di regole.
+ */
+int contaRegoleIntegrita(TabellaIntegrita tabella);
+
+/**
+ * @brief Controlla le quattro liste con tutte le regole registrate.
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param risultato Riceve le violazioni (da liberare con liberaRisultatoIntegrita()).
+ * @return true se il controllo e' stato completato, false per argomenti non validi o memoria insufficiente.
+ */
+bool verificaIntegrita(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                       const ListaEsami* listaE, const ListaGuide* listaG,
+                       RisultatoIntegrita* risultato);
+
+/**
+ * @brief Come verificaIntegrita(), ma esegue le regole solo sui record modificati dall'ultimo controllo.
+ *
+ * Per gli altri record vengono riprese le regole violate allora; le regole
+ * tra moduli vengono rivalutate su tutti i record se qualche lista e'
+ * cambiata. Senza un controllo precedente sulle stesse liste, o dopo la
+ * registrazione di una regola, il controllo e' completo.
+ *
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param risultato Riceve le violazioni (da liberare con liberaRisultatoIntegrita()).
+ * @return true se il controllo e' stato completato, false per argomenti non validi o memoria insufficiente.
+ */
+bool verificaIntegritaIncrementale(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                                   const ListaEsami* listaE, const ListaGuide* listaG,
+                                   RisultatoIntegrita* risultato);
+
+/**
+ * @brief Indica se esistono gli esiti di un controllo sulle liste indicate.
+ * @return true se verificaIntegritaIncrementale() puo' limitarsi ai record modificati.
+ */
+bool integritaGiaControllata(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                             const ListaEsami* listaE, const ListaGuide* listaG);
+
+/**
+ * @brief Stampa le violazioni tabella per tabella e il riepilogo finale.
+ * @param risultato Esito da stampare.
+ */
+void stampaRisultatoIntegrita(const RisultatoIntegrita* risultato);
+
+/**
+ * @brief Libera l'elenco delle violazioni.
+ * @param risultato Esito da liberare.
+ */
+void liberaRisultatoIntegrita(RisultatoIntegrita* risultato);
+
+#endif // INTEGRITA_H
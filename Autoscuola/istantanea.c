@@ -0,0 +1,586 @@
+/**
+ * @file istantanea.c
+ * @brief Implementazione dell'istantanea a record fissi con salvataggio differenziale.
+ *
+ * Layout del file:
+ * - Intestazione fissa (`IntestazioneIstantanea`) con la disposizione delle tabelle
+ * - Per ogni tabella, a partire da un offset allineato a ALLINEAMENTO_SEZIONI:
+ *   intestazione dell'ADT (contatori) seguita dall'array di `capacita` record
+ *
+ * L'area di ogni tabella, limitata ai record validi, ha lo stesso formato dei
+ * vecchi file `.dat` a struct grezze e viene quindi letta da deserializzaX().
+ *
+ * Area di ripristino (`autoscuola.snap.redo`): intestazione con checksum
+ * seguita da voci {offset, lunghezza, byte}. Contiene tutte le scritture di
+ * un salvataggio differenziale, intestazione finale compresa, e viene
+ * rimossa quando l'istantanea e' su disco.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "istantanea.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "archivio.h"
+#include "modifiche.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define MAGIC_ISTANTANEA "AUTOSNAP"
+#define VERSIONE_ISTANTANEA 1
+
+#define STATO_COMPLETA 0
+#define STATO_IN_SCRITTURA 1
+
+#define ISTANTANEA_FILE_TEMPORANEO ISTANTANEA_FILE_PREDEFINITO ".tmp"
+#define RIPRISTINO_FILE ISTANTANEA_FILE_PREDEFINITO ".redo"
+#define MAGIC_RIPRISTINO "AUTOREDO"
+
+/**
+ * @struct VoceTabella
+ * @brief Disposizione dell'area di una tabella nel file.
+ */
+typedef struct {
+    uint64_t offset;            /**< Inizio dell'area della tabella */
+    uint32_t dim_intestazione;  /**< Byte dell'intestazione dell'ADT */
+    uint32_t dim_record;        /**< Dimensione di un record */
+    uint32_t capacita;          /**< Record riservati */
+    uint32_t riservato;
+} VoceTabella;
+
+/**
+ * @struct IntestazioneIstantanea
+ * @brief Intestazione fissa posta all'inizio del file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t versione;
+    uint32_t stato;             /**< STATO_COMPLETA o STATO_IN_SCRITTURA */
+    uint64_t salvataggi;        /**< Numero progressivo del salvataggio */
+    VoceTabella tabelle[NUM_SEZIONI];
+    uint32_t checksum_intestazione; /**< Checksum dei campi precedenti */
+    uint32_t riservato;
+} IntestazioneIstantanea;
+
+/**
+ * @struct IntestazioneRipristino
+ * @brief Intestazione dell'area di ripristino.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t versione;
+    uint32_t riservato;
+    uint64_t salvataggi;        /**< Salvataggio prodotto dalle scritture */
+    uint64_t lunghezza;         /**< Byte delle voci che seguono */
+    uint32_t checksum;          /**< Checksum delle voci */
+    uint32_t checksum_intestazione; /**< Checksum dei campi precedenti */
+} IntestazioneRipristino;
+
+/**
+ * @struct VoceRipristino
+ * @brief Intestazione di una scrittura dell'area di ripristino, seguita dai suoi byte.
+ */
+typedef struct {
+    uint64_t offset;
+    uint64_t lunghezza;
+} VoceRipristino;
+
+/**
+ * @struct Destinazione
+ * @brief Dove vanno le scritture di un salvataggio.
+ */
+typedef struct {
+    FILE* file;                 /**< Scrittura diretta (immagine completa)... */
+    Buffer* ripristino;         /**< ...oppure voci accodate all'area di ripristino */
+} Destinazione;
+
+/**
+ * @struct DescrizioneTabella
+ * @brief Dati di una tabella in memoria necessari alla scrittura.
+ */
+typedef struct {
+    const RegistroModifiche* registro; /**< Array dei record e blocchi modificati */
+    Buffer intestazione;               /**< Contatori serializzati dall'ADT */
+    int n_record;                      /**< Record validi */
+} DescrizioneTabella;
+
+//STATO DEL MODULO
+/** Generazione delle liste in memoria gia' presente su disco (0 = nessuna). */
+static unsigned long generazione_salvata = 0;
+static uint64_t salvataggi = 0;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Arrotonda una posizione al multiplo successivo di ALLINEAMENTO_SEZIONI.
+ */
+static uint64_t allinea(uint64_t posizione) {
+    return (posizione + ALLINEAMENTO_SEZIONI - 1) / ALLINEAMENTO_SEZIONI * ALLINEAMENTO_SEZIONI;
+}
+
+/**
+ * @brief Forza sul disco i dati scritti finora.
+ */
+static bool forzaSuDisco(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+/**
+ * @brief Scrive `n` byte alla posizione indicata.
+ */
+static bool scriviInPosizione(FILE* file, uint64_t posizione, const void* dati, size_t n) {
+    if (n == 0) return true;
+    return fseek(file, (long)posizione, SEEK_SET) == 0 && fwrite(dati, 1, n, file) == n;
+}
+
+/**
+ * @brief Calcola la disposizione del file per le tabelle descritte.
+ */
+static void calcolaDisposizione(const DescrizioneTabella tabelle[NUM_SEZIONI],
+                                IntestazioneIstantanea* intestazione) {
+    memset(intestazione, 0, sizeof(*intestazione));
+    memcpy(intestazione->magic, MAGIC_ISTANTANEA, sizeof(intestazione->magic));
+    intestazione->versione = VERSIONE_ISTANTANEA;
+
+    uint64_t posizione = allinea(sizeof(IntestazioneIstantanea));
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        VoceTabella* voce = &intestazione->tabelle[i];
+        voce->offset = posizione;
+        voce->dim_intestazione = (uint32_t)tabelle[i].intestazione.lunghezza;
+        voce->dim_record = (uint32_t)tabelle[i].registro->dim_record;
+        voce->capacita = (uint32_t)tabelle[i].registro->capacita;
+        posizione = allinea(posizione + voce->dim_intestazione +
+                            (uint64_t)voce->dim_record * voce->capacita);
+    }
+}
+
+/**
+ * @brief Calcola il checksum dell'intestazione (campi precedenti al checksum).
+ */
+static uint32_t checksumIntestazione(const IntestazioneIstantanea* intestazione) {
+    return checksumArchivio(intestazione, offsetof(IntestazioneIstantanea, checksum_intestazione));
+}
+
+/**
+ * @brief Legge e valida l'intestazione di un file aperto.
+ */
+static bool leggiIntestazione(FILE* file, IntestazioneIstantanea* intestazione) {
+    if (fseek(file, 0, SEEK_SET) != 0 ||
+        fread(intestazione, sizeof(*intestazione), 1, file) != 1) {
+        return false;
+    }
+    return memcmp(intestazione->magic, MAGIC_ISTANTANEA, sizeof(intestazione->magic)) == 0 &&
+           intestazione->versione == VERSIONE_ISTANTANEA &&
+           intestazione->checksum_intestazione == checksumIntestazione(intestazione);
+}
+
+/**
+ * @brief Scrive l'intestazione del file con lo stato indicato e la forza su disco.
+ */
+static bool scriviIntestazione(FILE* file, IntestazioneIstantanea* intestazione, uint32_t stato) {
+    intestazione->stato = stato;
+    intestazione->checksum_intestazione = checksumIntestazione(intestazione);
+    return scriviInPosizione(file, 0, intestazione, sizeof(*intestazione)) && forzaSuDisco(file);
+}
+
+/**
+ * @brief Scrive `n` byte alla posizione indicata della destinazione.
+ */
+static bool scriviDestinazione(const Destinazione* d, uint64_t posizione, const void* dati, size_t n) {
+    if (d->file != NULL) return scriviInPosizione(d->file, posizione, dati, n);
+    if (n == 0) return true;
+
+    VoceRipristino voce = { posizione, n };
+    return scriviBuffer(d->ripristino, &voce, sizeof(voce)) &&
+           scriviBuffer(d->ripristino, dati, n);
+}
+
+/**
+ * @brief Esegue sul file le voci di un'area di ripristino.
+ * @param voci Voci (dopo l'intestazione dell'area).
+ * @param n Byte delle voci.
+ */
+static bool applicaRipristino(FILE* file, const unsigned char* voci, size_t n) {
+    size_t pos = 0;
+    while (pos < n) {
+        VoceRipristino voce;
+        if (n - pos < sizeof(voce)) return false;
+        memcpy(&voce, voci + pos, sizeof(voce));
+        pos += sizeof(voce);
+        if (voce.lunghezza > n - pos ||
+            !scriviInPosizione(file, voce.offset, voci + pos, (size_t)voce.lunghezza)) {
+            return false;
+        }
+        pos += (size_t)voce.lunghezza;
+    }
+    return forzaSuDisco(file);
+}
+
+/**
+ * @brief Calcola il checksum dell'intestazione dell'area di ripristino.
+ */
+static uint32_t checksumRipristino(const IntestazioneRipristino* intestazione) {
+    return checksumArchivio(intestazione, offsetof(IntestazioneRipristino, checksum_intestazione));
+}
+
+/**
+ * @brief Completa un salvataggio differenziale interrotto.
+ *
+ * Un'area di ripristino integra contiene tutte le scritture del salvataggio:
+ * vengono rieseguite (sono idempotenti) e l'area viene rimossa. Un'area non
+ * integra e' stata interrotta prima di toccare l'istantanea, che e' quindi
+ * ancora quella del salvataggio precedente.
+ *
+ * @return false se l'area integra non ha potuto essere applicata (viene conservata).
+ */
+static bool completaSalvataggioInterrotto(void) {
+    if (!esisteArchivio(RIPRISTINO_FILE)) return true;
+
+    Buffer contenuto;
+    inizializzaBuffer(&contenuto);
+    if (!leggiFileInBuffer(RIPRISTINO_FILE, &contenuto)) {
+        printf("Errore: impossibile leggere %s.\n", RIPRISTINO_FILE);
+        return false;
+    }
+
+    IntestazioneRipristino ir;
+    bool integra = contenuto.lunghezza >= sizeof(ir);
+    if (integra) {
+        memcpy(&ir, contenuto.dati, sizeof(ir));
+        integra = memcmp(ir.magic, MAGIC_RIPRISTINO, sizeof(ir.magic)) == 0 &&
+                  ir.versione == VERSIONE_ISTANTANEA &&
+                  ir.checksum_intestazione == checksumRipristino(&ir) &&
+                  ir.lunghezza == contenuto.lunghezza - sizeof(ir) &&
+                  ir.checksum == checksumArchivio(contenuto.dati + sizeof(ir), (size_t)ir.lunghezza);
+    }
+
+    // L'area vale solo per l'istantanea da cui e' partito il salvataggio
+    FILE* file = integra ? fopen(ISTANTANEA_FILE_PREDEFINITO, "r+b") : NULL;
+    IntestazioneIstantanea su_disco;
+    bool applica = file != NULL &&
+                   (!leggiIntestazione(file, &su_disco) ||
+                    su_disco.salvataggi == ir.salvataggi || su_disco.salvataggi + 1 == ir.salvataggi);
+
+    bool ok = true;
+    if (applica) {
+        ok = applicaRipristino(file, contenuto.dati + sizeof(ir), (size_t)ir.lunghezza);
+        if (ok) {
+            printf("Completato il salvataggio interrotto di %s.\n", ISTANTANEA_FILE_PREDEFINITO);
+        } else {
+            printf("Errore: impossibile completare il salvataggio interrotto di %s.\n",
+                   ISTANTANEA_FILE_PREDEFINITO);
+        }
+    }
+    if (file != NULL && fclose(file) != 0) ok = false;
+    if (ok) remove(RIPRISTINO_FILE);
+
+    liberaBuffer(&contenuto);
+    return ok;
+}
+
+/**
+ * @brief Rende definitivo il file temporaneo sostituendo l'istantanea precedente.
+ */
+static bool rendiDefinitivo(const char* temporaneo, const char* filename) {
+#ifdef _WIN32
+    // Su Windows rename() non sovrascrive un file esistente
+    remove(filename);
+#endif
+    return rename(temporaneo, filename) == 0;
+}
+
+/**
+ * @brief Scrive l'area di una tabella: intestazione dell'ADT e blocchi da aggiornare.
+ * @return Numero di blocchi scritti, -1 in caso di errore.
+ */
+static int scriviTabella(const Destinazione* d, const VoceTabella* voce,
+                         const DescrizioneTabella* tabella, bool completa) {
+    if (!scriviDestinazione(d, voce->offset, tabella->intestazione.dati,
+                            tabella->intestazione.lunghezza)) {
+        return -1;
+    }
+
+    const RegistroModifiche* registro = tabella->registro;
+    uint64_t inizio_record = voce->offset + voce->dim_intestazione;
+    int scritti = 0;
+
+    for (int primo = 0; primo < tabella->n_record; primo += DIM_BLOCCO_MODIFICHE) {
+        int blocco = primo / DIM_BLOCCO_MODIFICHE;
+        if (!completa && !bloccoModificatoDopo(registro, blocco, generazione_salvata)) continue;
+
+        int ultimo = primo + DIM_BLOCCO_MODIFICHE;
+        if (ultimo > tabella->n_record) ultimo = tabella->n_record;
+
+        size_t offset = registro->dim_record * (size_t)primo;
+        if (!scriviDestinazione(d, inizio_record + offset, registro->base + offset,
+                                registro->dim_record * (size_t)(ultimo - primo))) {
+            return -1;
+        }
+        scritti++;
+    }
+    return scritti;
+}
+
+/**
+ * @brief Raccoglie registri e intestazioni delle quattro liste.
+ */
+static bool descriviTabelle(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                            const ListaEsami* listaE, const ListaGuide* listaG,
+                            DescrizioneTabella tabelle[NUM_SEZIONI]) {
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        inizializzaBuffer(&tabelle[i].intestazione);
+    }
+
+    tabelle[SEZIONE_ALLIEVI].registro = getRegistroModificheAllievi(listaA);
+    tabelle[SEZIONE_ALLIEVI].n_record = getNumeroAllievi(listaA);
+    tabelle[SEZIONE_PAGAMENTI].registro = getRegistroModifichePagamenti(listaP);
+    tabelle[SEZIONE_PAGAMENTI].n_record = getNumeroPagamenti(listaP);
+    tabelle[SEZIONE_ESAMI].registro = getRegistroModificheEsami(listaE);
+    tabelle[SEZIONE_ESAMI].n_record = getNumeroEsami(listaE);
+    tabelle[SEZIONE_GUIDE].registro = getRegistroModificheGuide(listaG);
+    tabelle[SEZIONE_GUIDE].n_record = getNumeroGuide(listaG);
+
+    return serializzaIntestazioneGrezzaAllievi(listaA, &tabelle[SEZIONE_ALLIEVI].intestazione) &&
+           serializzaIntestazioneGrezzaPagamenti(listaP, &tabelle[SEZIONE_PAGAMENTI].intestazione) &&
+           serializzaIntestazioneGrezzaEsami(listaE, &tabelle[SEZIONE_ESAMI].intestazione) &&
+           serializzaIntestazioneGrezzaGuide(listaG, &tabelle[SEZIONE_GUIDE].intestazione);
+}
+
+/**
+ * @brief Libera le intestazioni raccolte da descriviTabelle().
+ */
+static void liberaDescrizioni(DescrizioneTabella tabelle[NUM_SEZIONI]) {
+    for (int i = 0; i < NUM_SEZIONI; i++) {
+        liberaBuffer(&tabelle[i].intestazione);
+    }
+}
+
+/**
+ * @brief Scrive l'immagine completa in un file temporaneo e la sostituisce all'istantanea.
+ *
+ * Fino al rename resta valida l'istantanea precedente.
+ */
+static bool salvaImmagineCompleta(IntestazioneIstantanea* intestazione,
+                                  const DescrizioneTabella tabelle[NUM_SEZIONI]) {
+    FILE* file = fopen(ISTANTANEA_FILE_TEMPORANEO, "w+b");
+    if (file == NULL) {
+        printf("Errore: impossibile aprire il file %s per la scrittura.\n", ISTANTANEA_FILE_TEMPORANEO);
+        return false;
+    }
+
+    Destinazione d = { file, NULL };
+    bool ok = true;
+    for (int i = 0; i < NUM_SEZIONI && ok; i++) {
+        ok = scriviTabella(&d, &intestazione->tabelle[i], &tabelle[i], true) >= 0;
+    }
+    ok = ok && forzaSuDisco(file);
+    ok = ok && scriviIntestazione(file, intestazione, STATO_COMPLETA);
+    if (fclose(file) != 0) ok = false;
+
+    if (!ok || !rendiDefinitivo(ISTANTANEA_FILE_TEMPORANEO, ISTANTANEA_FILE_PREDEFINITO)) {
+        remove(ISTANTANEA_FILE_TEMPORANEO);
+        return false;
+    }
+
+    // Un'area rimasta da un salvataggio non riuscito riguardava l'istantanea sostituita
+    remove(RIPRISTINO_FILE);
+    return true;
+}
+
+/**
+ * @brief Scrive i blocchi modificati passando dall'area di ripristino.
+ *
+ * Le scritture (intestazione finale compresa) vengono prima raccolte
+ * nell'area di ripristino e forzate su disco, poi eseguite sull'istantanea
+ * marcata "in scrittura". Un'interruzione in qualunque punto lascia
+ * l'istantanea precedente intatta oppure un'area integra da rieseguire.
+ */
+static bool salvaDifferenze(FILE* file, IntestazioneIstantanea* intestazione,
+                            const DescrizioneTabella tabelle[NUM_SEZIONI]) {
+    Buffer ripristino;
+    inizializzaBuffer(&ripristino);
+    Destinazione d = { NULL, &ripristino };
+
+    bool ok = riempiBuffer(&ripristino, sizeof(IntestazioneRipristino));
+    for (int i = 0; i < NUM_SEZIONI && ok; i++) {
+        ok = scriviTabella(&d, &intestazione->tabelle[i], &tabelle[i], false) >= 0;
+    }
+    intestazione->stato = STATO_COMPLETA;
+    intestazione->checksum_intestazione = checksumIntestazione(intestazione);
+    ok = ok && scriviDestinazione(&d, 0, intestazione, sizeof(*intestazione));
+
+    if (ok) {
+        IntestazioneRipristino ir;
+        memset(&ir, 0, sizeof(ir));
+        memcpy(ir.magic, MAGIC_RIPRISTINO, sizeof(ir.magic));
+        ir.versione = VERSIONE_ISTANTANEA;
+        ir.salvataggi = intestazione->salvataggi;
+        ir.lunghezza = ripristino.lunghezza - sizeof(ir);
+        ir.checksum = checksumArchivio(ripristino.dati + sizeof(ir), (size_t)ir.lunghezza);
+        ir.checksum_intestazione = checksumRipristino(&ir);
+        memcpy(ripristino.dati, &ir, sizeof(ir));
+
+        FILE* area = fopen(RIPRISTINO_FILE, "wb");
+        ok = area != NULL &&
+             fwrite(ripristino.dati, 1, ripristino.lunghezza, area) == ripristino.lunghezza &&
+             forzaSuDisco(area);
+        if (area != NULL && fclose(area) != 0) ok = false;
+    }
+
+    if (ok) {
+        IntestazioneIstantanea in_scrittura = *intestazione;
+        ok = scriviIntestazione(file, &in_scrittura, STATO_IN_SCRITTURA) &&
+             applicaRipristino(file, ripristino.dati + sizeof(IntestazioneRipristino),
+                               ripristino.lunghezza - sizeof(IntestazioneRipristino));
+        // Se l'istantanea non e' stata aggiornata, l'area resta per il prossimo caricamento
+        if (ok) remove(RIPRISTINO_FILE);
+    } else {
+        remove(RIPRISTINO_FILE);
+    }
+
+    liberaBuffer(&ripristino);
+    return ok;
+}
+
+//FUNZIONI PUBBLICHE
+
+bool salvaIstantanea(const ListaAllievi* listaA,
+                     const ListaPagamenti* listaP,
+                     const ListaEsami* listaE,
+                     const ListaGuide* listaG) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return false;
+
+    DescrizioneTabella tabelle[NUM_SEZIONI];
+    if (!descriviTabelle(listaA, listaP, listaE, listaG, tabelle)) {
+        liberaDescrizioni(tabelle);
+        return false;
+    }
+
+    IntestazioneIstantanea intestazione, su_disco;
+    calcolaDisposizione(tabelle, &intestazione);
+
+    // Scrittura differenziale solo su un file completo con la stessa disposizione
+    bool completa = (generazione_salvata == 0);
+    FILE* file = fopen(ISTANTANEA_FILE_PREDEFINITO, "r+b");
+    if (file == NULL || !leggiIntestazione(file, &su_disco) ||
+        su_disco.stato != STATO_COMPLETA ||
+        memcmp(su_disco.tabelle, intestazione.tabelle, sizeof(intestazione.tabelle)) != 0) {
+        completa = true;
+    }
+
+    // Le liste vengono modificate solo da questo thread: la generazione letta
+    // ora descrive esattamente cio' che viene scritto
+    // Il numero avanza anche se il salvataggio fallisce: un'area di ripristino
+    // rimasta non viene scambiata per quella del salvataggio successivo
+    unsigned long generazione = getGenerazioneCorrente();
+    intestazione.salvataggi = ++salvataggi;
+
+    bool ok;
+    if (completa) {
+        if (file != NULL) fclose(file);
+        ok = salvaImmagineCompleta(&intestazione, tabelle);
+    } else {
+        ok = salvaDifferenze(file, &intestazione, tabelle);
+        if (fclose(file) != 0) ok = false;
+    }
+    liberaDescrizioni(tabelle);
+
+    if (ok) {
+        generazione_salvata = generazione;
+    } else {
+        generazione_salvata = 0; // Il prossimo salvataggio riscrive tutto
+        printf("Errore: impossibile completare il salvataggio di %s.\n", ISTANTANEA_FILE_PREDEFINITO);
+    }
+    return ok;
+}
+
+bool caricaIstantanea(ListaAllievi* listaA,
+                      ListaPagamenti* listaP,
+                      ListaEsami* listaE,
+                      ListaGuide* listaG) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return false;
+
+    if (!completaSalvataggioInterrotto()) return false;
+
+    Buffer contenuto;
+    inizializzaBuffer(&contenuto);
+    if (!leggiFileInBuffer(ISTANTANEA_FILE_PREDEFINITO, &contenuto)) return false;
+
+    // La disposizione attesa dipende solo dal tipo delle liste, non dal contenuto
+    DescrizioneTabella tabelle[NUM_SEZIONI];
+    IntestazioneIstantanea attesa, intestazione;
+    bool ok = descriviTabelle(listaA, listaP, listaE, listaG, tabelle);
+    if (ok) {
+        calcolaDisposizione(tabelle, &attesa);
+    }
+    liberaDescrizioni(tabelle);
+
+    ok = ok && contenuto.lunghezza >= sizeof(intestazione);
+    if (ok) {
+        memcpy(&intestazione, contenuto.dati, sizeof(intestazione));
+        ok = memcmp(intestazione.magic, MAGIC_ISTANTANEA, sizeof(intestazione.magic)) == 0 &&
+             intestazione.versione == VERSIONE_ISTANTANEA &&
+             intestazione.checksum_intestazione == checksumIntestazione(&intestazione) &&
+             intestazione.stato == STATO_COMPLETA &&
+             memcmp(intestazione.tabelle, attesa.tabelle, sizeof(attesa.tabelle)) == 0;
+    }
+
+    for (int i = 0; i < NUM_SEZIONI && ok; i++) {
+        const VoceTabella* voce = &intestazione.tabelle[i];
+        if (voce->offset > contenuto.lunghezza) {
+            ok = false;
+            break;
+        }
+
+        // Area della tabella fino alla fine del file: deserializzaX() legge
+        // i contatori e verifica che i record validi siano presenti
+        const unsigned char* area = contenuto.dati + voce->offset;
+        size_t disponibili = contenuto.lunghezza - (size_t)voce->offset;
+        size_t massimo = voce->dim_intestazione + (size_t)voce->dim_record * voce->capacita;
+        if (disponibili > massimo) disponibili = massimo;
+
+        switch ((TipoSezione)i) {
+            case SEZIONE_ALLIEVI:   ok = deserializzaAllievi(listaA, area, disponibili); break;
+            case SEZIONE_PAGAMENTI: ok = deserializzaPagamenti(listaP, area, disponibili); break;
+            case SEZIONE_ESAMI:     ok = deserializzaEsami(listaE, area, disponibili); break;
+            case SEZIONE_GUIDE:     ok = deserializzaGuide(listaG, area, disponibili); break;
+            default:                ok = false; break;
+        }
+    }
+
+    if (ok) {
+        // Il contenuto in memoria coincide con il file
+        generazione_salvata = getGenerazioneCorrente();
+        salvataggi = intestazione.salvataggi;
+    } else {
+        inizializzaLista(listaA);
+        inizializzaListaPagamenti(listaP);
+        inizializzaListaEsami(listaE);
+        inizializzaListaGuide(listaG);
+    }
+
+    liberaBuffer(&contenuto);
+    return ok;
+}
+
+bool esisteIstantanea(void) {
+    return esisteArchivio(ISTANTANEA_FILE_PREDEFINITO);
+}
+
+void rimuoviIstantanea(void) {
+    remove(ISTANTANEA_FILE_PREDEFINITO);
+    generazione_salvata = 0;
+}
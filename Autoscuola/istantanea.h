@@ -0,0 +1,79 @@
+/**
+ * @file istantanea.h
+ * @brief Istantanea su disco a record fissi con salvataggio differenziale.
+ *
+ * A differenza dell'archivio unico (riscritto per intero a ogni salvataggio),
+ * l'istantanea riserva a ogni tabella un'area a dimensione fissa: intestazione
+ * dell'ADT seguita da `capacita` record grezzi, divisi in blocchi di
+ * `DIM_BLOCCO_MODIFICHE` record. Il salvataggio riscrive in posizione solo i
+ * blocchi modificati dall'ultimo salvataggio (vedi modifiche.h) e le
+ * intestazioni delle tabelle; il costo e' quindi proporzionale alle modifiche.
+ *
+ * Coerenza in caso di interruzione: un'immagine completa viene scritta in
+ * un file temporaneo e sostituita all'istantanea con un rename. I blocchi di
+ * un salvataggio differenziale vengono prima registrati, con l'intestazione
+ * finale, in un'area di ripristino forzata su disco e solo dopo scritti in
+ * posizione; se il salvataggio si interrompe, caricaIstantanea() riesegue
+ * l'area e completa l'istantanea. Un'istantanea che resta comunque
+ * illeggibile non viene mai sostituita dai dati di un altro formato.
+ */
+#ifndef ISTANTANEA_H
+#define ISTANTANEA_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define ISTANTANEA_FILE_PREDEFINITO "autoscuola.snap"
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Salva le quattro liste nell'istantanea, scrivendo solo i blocchi modificati.
+ *
+ * Se il file non esiste, non e' integro o ha una disposizione diversa da
+ * quella delle liste, viene riscritto per intero.
+ *
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ * @return true se successo, false altrimenti.
+ */
+bool salvaIstantanea(const ListaAllievi* listaA,
+                     const ListaPagamenti* listaP,
+                     const ListaEsami* listaE,
+                     const ListaGuide* listaG);
+
+/**
+ * @brief Carica le quattro liste dall'istantanea.
+ *
+ * Completa per prima cosa un salvataggio differenziale interrotto. In caso
+ * di errore le liste vengono riportate allo stato vuoto.
+ *
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ * @return true se l'istantanea esiste, e' completa ed e' stata caricata.
+ */
+bool caricaIstantanea(ListaAllievi* listaA,
+                      ListaPagamenti* listaP,
+                      ListaEsami* listaE,
+                      ListaGuide* listaG);
+
+/**
+ * @brief Verifica se esiste un file di istantanea.
+ * @return true se il file esiste.
+ */
+bool esisteIstantanea(void);
+
+/**
+ * @brief Rimuove l'istantanea (diventata obsoleta dopo un salvataggio in altro formato).
+ */
+void rimuoviIstantanea(void);
+
+#endif // ISTANTANEA_H
@@ -13,16 +13,33 @@
  * - Esami (teorico e pratico, con limite tentativi e vincoli)
  * - Guide (registrazione ore, calcolo ore extra)
  * - Salvataggio/caricamento automatico da file `.dat`
+ * - Autosalvataggio periodico in background con ripristino all'avvio
+ *
+ * Con `--servizio [socket] [lavoratori]` il programma non mostra il menu ma
+ * serve i dati ai client locali su un socket Unix (vedi servizio.h). Le
+ * scritture del servizio sono registrate nel giornale (giornale.h): se il
+ * servizio si interrompe, al successivo avvio vengono riapplicate ai dati.
+ *
+ * Con `<comando> [argomenti]` (es. `add-student`, `register-hours`,
+ * `export --csv`, `check`) il programma esegue una sola operazione senza
+ * menu ne' domande e termina (vedi comandi.h).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "allievi.h"
 #include "pagamenti.h"
 #include "esami.h"
 #include "guida.h"
 #include "fileio.h"
 #include "menu.h"
+#include "autosalvataggio.h"
+#include "resoconto.h"
+#include "util.h"
+#include "servizio.h"
+#include "giornale.h"
+#include "comandi.h"
 
 /**
  * @brief Funzione principale che avvia il gestionale autoscuola.
@@ -34,9 +51,20 @@
  * - Salva automaticamente i dati prima della chiusura.
  * - Libera la memoria allocata.
  *
- * @return 0 in caso di esecuzione corretta, 1 in caso di errore.
+ * @param argc Numero di argomenti.
+ * @param argv Argomenti (`--servizio [socket] [lavoratori]` per la modalita' servizio,
+ *             oppure un comando non interattivo).
+ * @return 0 in caso di esecuzione corretta, altrimenti un codice di errore.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    bool servizio = (argc > 1 && strcmp(argv[1], "--servizio") == 0);
+
+    //COMANDO NON INTERATTIVO (una sola operazione, senza menu)
+    if (argc > 1 && !servizio) {
+        return eseguiComando(argc - 1, argv + 1);
+    }
+
+
     printf("\n");
     printf("----------------------------------------------------------\n");
     printf("|                                                        |\n");
@@ -46,6 +74,12 @@ int main() {
     printf("\n");
     printf("Inizializzazione in corso...\n\n");
 
+    //BLOCCO DEI DATI (una sola istanza alla volta: menu, servizio o comando)
+    if (!acquisisciBloccoDati()) {
+        printf("Chiudere l'altra istanza e riprovare.\n");
+        return 1;
+    }
+
     //CREAZIONE STRUTTURE DATI
     ListaAllievi* listaAllievi = creaListaAllievi();
     ListaPagamenti* listaPagamenti = creaListaPagamenti();
@@ -78,6 +112,58 @@ int main() {
     printf("\nCaricamento dati salvati...\n");
     caricaDati(listaAllievi, listaPagamenti, listaEsami, listaGuide);
 
+    //RECUPERO DAL GIORNALE (servizio precedente interrotto)
+    if (esisteGiornale()) {
+        printf("\nIl servizio precedente non e' stato chiuso correttamente.\n");
+        int rieseguite = riapplicaGiornale(listaAllievi, listaPagamenti, listaEsami, listaGuide,
+                                           improntaDatiSalvati());
+        // Senza salvataggio il giornale e' l'unica copia delle operazioni
+        bool recuperate = rieseguite == 0 ||
+                          (rieseguite > 0 &&
+                           salvaTuttiDati(listaAllievi, listaPagamenti, listaEsami, listaGuide));
+        if (!recuperate) {
+            if (rieseguite < 0) {
+                printf("\nErrore: impossibile leggere il giornale %s, il file e' stato conservato.\n",
+                       GIORNALE_FILE);
+            } else {
+                printf("\nErrore: impossibile salvare le operazioni recuperate da %s.\n", GIORNALE_FILE);
+            }
+            distruggiListaAllievi(&listaAllievi);
+            distruggiListaPagamenti(&listaPagamenti);
+            distruggiListaEsami(&listaEsami);
+            distruggiListaGuide(&listaGuide);
+            return 1;
+        }
+        printf(" Recuperate %d operazioni dal giornale\n", rieseguite);
+
+        // Ogni scrittura del servizio e' nel giornale: l'autosalvataggio non aggiunge nulla
+        chiudiGiornale(true);
+        arrestaAutosalvataggio(true);
+    }
+
+    //RIPRISTINO DA AUTOSALVATAGGIO (sessione precedente interrotta)
+    if (servizio && esisteAutosalvataggio()) {
+        // Senza nessuno a cui chiedere, l'autosalvataggio andrebbe perso alla chiusura
+        printf("\nErrore: la sessione precedente non e' stata chiusa correttamente.\n");
+        printf("Avviare il programma senza argomenti per ripristinare i dati.\n");
+        distruggiListaAllievi(&listaAllievi);
+        distruggiListaPagamenti(&listaPagamenti);
+        distruggiListaEsami(&listaEsami);
+        distruggiListaGuide(&listaGuide);
+        return 1;
+    }
+    if (esisteAutosalvataggio()) {
+        printf("\nLa sessione precedente non e' stata chiusa correttamente.\n");
+        if (conferma("Ripristinare i dati dall'ultimo autosalvataggio?")) {
+            if (ripristinaDaArchivio(AUTOSALVATAGGIO_FILE, listaAllievi, listaPagamenti,
+                                     listaEsami, listaGuide)) {
+                printf(" Dati ripristinati da %s\n", AUTOSALVATAGGIO_FILE);
+            } else {
+                caricaDati(listaAllievi, listaPagamenti, listaEsami, listaGuide);
+            }
+        }
+    }
+
     //ORDINAMENTO E AGGIORNAMENTO ID
     ordinaAllieviAlfabetico(listaAllievi);
     aggiornaID(listaAllievi);
@@ -93,15 +179,27 @@ int main() {
     printf("     Esami in corso:      %d\n", n_esami);
     printf("     Guide registrate:    %d\n", n_guide);
     printf("\n Sistema pronto!\n");
-    printf("\nPremi INVIO per continuare...");
-    getchar();
 
-    //MENU PRINCIPALE
-    mostraMenuPrincipale(listaAllievi, listaPagamenti, listaEsami, listaGuide);
+    bool ok = true;
+    avviaAutosalvataggio(AUTOSALVATAGGIO_INTERVALLO_PREDEFINITO);
+    if (servizio) {
+        //MODALITA' SERVIZIO (fino a SIGINT o SIGTERM)
+        const char* percorso = (argc > 2) ? argv[2] : SERVIZIO_SOCKET_PREDEFINITO;
+        int lavoratori = (argc > 3) ? atoi(argv[3]) : 0;
+        ok = apriGiornale(improntaDatiSalvati()) &&
+             eseguiServizio(percorso, lavoratori, listaAllievi, listaPagamenti, listaEsami, listaGuide);
+    } else {
+        //MENU PRINCIPALE (con autosalvataggio in background)
+        printf("\nPremi INVIO per continuare...");
+        getchar();
+        mostraMenuPrincipale(listaAllievi, listaPagamenti, listaEsami, listaGuide);
+    }
 
     //SALVATAGGIO FINALE
     printf("\n Salvataggio finale dei dati...\n");
-    salvaDati(listaAllievi, listaPagamenti, listaEsami, listaGuide);
+    bool salvati = salvaTuttiDati(listaAllievi, listaPagamenti, listaEsami, listaGuide);
+    chiudiGiornale(salvati);  // Il giornale serve finche' i dati non sono su disco
+    arrestaAutosalvataggio(salvati);  // Senza salvataggio l'autosalvataggio resta per il ripristino
 
     //PULIZIA MEMORIA
     printf("Pulizia memoria...\n");
@@ -109,6 +207,8 @@ int main() {
     distruggiListaPagamenti(&listaPagamenti);
     distruggiListaEsami(&listaEsami);
     distruggiListaGuide(&listaGuide);
+    liberaCacheResoconto();
+    rilasciaBloccoDati();
 
     printf("\n");
     printf("----------------------------------------------------------\n");
@@ -121,5 +221,5 @@ int main() {
     printf("----------------------------------------------------------\n");
     printf("\n");
 
-    return 0;
+    return ok ? 0 : 1;
 }
@@ -13,8 +13,13 @@
 #include "esami.h"
 #include "guida.h"
 #include "fileio.h"
-#include "difensiva.h"
 #include "util.h"
+#include "autosalvataggio.h"
+#include "importa.h"
+#include "esporta.h"
+#include "uscita.h"
+#include "integrita.h"
+#include "referenze.h"
 
 /**
  * @brief Mostra il menu principale e gestisce la navigazione nei sottomenu.
@@ -24,9 +29,9 @@
  * - Gestire i pagamenti (rate ed extra)
  * - Registrare e visualizzare esami
  * - Registrare e visualizzare guide
- * - Eseguire controlli di integrità (difensiva)
+ * - Eseguire controlli di integrità (regole di integrita.h, riferimenti di referenze.h)
  * - Esportare un resoconto completo su file `.txt`
- * - Salvare tutti i dati in file `.dat`
+ * - Salvare tutti i dati in file `.dat` o nell'archivio unico
  *
  * @param listaA Puntatore alla lista degli allievi
  * @param listaP Puntatore alla lista dei pagamenti
@@ -36,6 +41,7 @@
 void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsami* listaE, ListaGuide* listaG) {
     int scelta;
     do {
+        puntoDiAutosalvataggio(listaA, listaP, listaE, listaG);
         pulisciSchermo();
         printf("\n_____________________________________\n");
         printf("|    MENU AUTOSCUOLA - GESTIONALE    |\n");
@@ -47,6 +53,8 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
         printf("\n5. Controllo integrita' dati");
         printf("\n6. Esporta resoconto completo");
         printf("\n7. Salva");
+        printf("\n8. Formato di salvataggio");
+        printf("\n9. Esporta dati (CSV / JSON Lines)");
         printf("\n0. Esci e salva\n");
         scelta = inputInt("\n Scelta: ");
 
@@ -63,6 +71,7 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                     printf("3. Cerca allievo\n");
                     printf("4. Filtra per patente\n");
                     printf("5. Filtra per stato\n");
+                    printf("6. Importa allievi da file CSV\n");
                     printf("0. Torna indietro\n");
                     sotto = inputInt("\n Scelta: ");
 
@@ -70,9 +79,12 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                         case 1:
                             inserisciAllievo(listaA, listaP, listaE);
                             break;
-                        case 2:
-                            stampaAllievi(listaA);
+                        case 2: {
+                            Uscita* pagine = creaUscitaPaginata(RIGHE_PAGINA_PREDEFINITE);
+                            stampaAllievi(listaA, pagine);
+                            chiudiUscita(&pagine);
                             break;
+                        }
                         case 3:
                             cercaAllievo(listaA, listaP, listaE);
                             break;
@@ -82,11 +94,22 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                         case 5:
                             filtraPerStato(listaA);
                             break;
+                        case 6: {
+                            char file[256];
+                            EsitoImportazione esito;
+                            printf("Nome del file CSV (nome,cognome,codice_fiscale,categoria): ");
+                            inputString(file, sizeof(file));
+                            if (importaAllieviCSV(file, listaA, listaP, listaE, &esito)) {
+                                stampaEsitoImportazione(&esito, file);
+                            }
+                            break;
+                        }
                         case 0:
                             break;
                         default:
                             printf(" Scelta non valida.\n");
                     }
+                    puntoDiAutosalvataggio(listaA, listaP, listaE, listaG);
                     if (sotto != 0) attendiInvio();
                 } while (sotto != 0);
                 break;
@@ -120,6 +143,7 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                         default:
                             printf(" Scelta non valida.\n");
                     }
+                    puntoDiAutosalvataggio(listaA, listaP, listaE, listaG);
                     if (sotto != 0) attendiInvio();
                 } while (sotto != 0);
                 break;
@@ -135,6 +159,7 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                     printf("\n1. Registra tentativo teorico\n");
                     printf("2. Registra tentativo pratico\n");
                     printf("3. Visualizza stato esami\n");
+                    printf("4. Importa esiti da file CSV\n");
                     printf("0. Torna indietro\n");
                     sotto = inputInt("\n Scelta: ");
 
@@ -176,11 +201,22 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                         case 3:
                             stampaEsame(listaE, listaA);
                             break;
+                        case 4: {
+                            char file[256];
+                            EsitoImportazioneEsami esito;
+                            printf("Nome del file CSV (codice_fiscale,tipo,esito,data): ");
+                            inputString(file, sizeof(file));
+                            if (importaEsitiEsamiCSV(file, listaA, listaP, listaE, listaG, &esito)) {
+                                stampaEsitoImportazioneEsami(&esito, file);
+                            }
+                            break;
+                        }
                         case 0:
                             break;
                         default:
                             printf(" Scelta non valida.\n");
                     }
+                    puntoDiAutosalvataggio(listaA, listaP, listaE, listaG);
                     if (sotto != 0) attendiInvio();
                 } while (sotto != 0);
                 break;
@@ -202,14 +238,18 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                         case 1:
                             registraGuida(listaG, listaA);
                             break;
-                        case 2:
-                            stampaGuide(listaG, listaA);
+                        case 2: {
+                            Uscita* pagine = creaUscitaPaginata(RIGHE_PAGINA_PREDEFINITE);
+                            stampaGuide(listaG, listaA, pagine);
+                            chiudiUscita(&pagine);
                             break;
+                        }
                         case 0:
                             break;
                         default:
                             printf(" Scelta non valida.\n");
                     }
+                    puntoDiAutosalvataggio(listaA, listaP, listaE, listaG);
                     if (sotto != 0) attendiInvio();
                 } while (sotto != 0);
                 break;
@@ -221,104 +261,32 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                 printf("      CONTROLLO INTEGRITA' DATI     \n");
                 printf("--------------------------------------\n\n");
 
-                printf("Esecuzione controlli di validazione...\n\n");
-
-                int errori_totali = 0;
-                int errori_modulo = 0;
-
-                // Validazione Allievi
-                printf("---- VALIDAZIONE ALLIEVI ----\n");
-                int n_allievi = getNumeroAllievi(listaA);
-                for (int i = 0; i < n_allievi; i++) {
-                    const Allievo* a = getAllievoAtIndex(listaA, i);
-                    if (a == NULL) continue;
-
-                    if (!stringaNonVuota(getAllievoNome(a))) {
-                        printf(" Allievo ID %d: nome vuoto\n", getAllievoID(a));
-                        errori_modulo++;
-                    }
-                    if (!validaCodiceFiscale(getAllievoCodiceFiscale(a))) {
-                        printf(" Allievo ID %d: codice fiscale non valido\n", getAllievoID(a));
-                        errori_modulo++;
-                    }
-                }
-                printf("Errori trovati: %d\n\n", errori_modulo);
-                errori_totali += errori_modulo;
-                errori_modulo = 0;
-
-                // Validazione Pagamenti
-                printf("---- VALIDAZIONE PAGAMENTI ----\n");
-                int n_pagamenti = getNumeroPagamenti(listaP);
-                for (int i = 0; i < n_pagamenti; i++) {
-                    const Pagamento* p = getPagamentoAtIndex(listaP, i);
-                    if (p == NULL) continue;
-
-                    if (!validaImporto(getPrimaRata(p)) ||
-                        !validaImporto(getSecondaRata(p)) ||
-                        !validaImporto(getTerzaRata(p))) {
-                        printf(" Pagamento ID allievo %d: importi negativi\n",
-                               getPagamentoIDAllievo(p));
-                        errori_modulo++;
-                    }
-
-                    if (!verificaProgressioneRate(getPrimaRata(p), getSecondaRata(p), getTerzaRata(p))) {
-                        printf("Pagamento ID allievo %d: progressione rate non valida\n",
-                               getPagamentoIDAllievo(p));
-                        errori_modulo++;
-                    }
-                }
-                printf("Errori trovati: %d\n\n", errori_modulo);
-                errori_totali += errori_modulo;
-                errori_modulo = 0;
-
-                // Validazione Esami
-                printf("---- VALIDAZIONE ESAMI ----\n");
-                int n_esami = getNumeroEsami(listaE);
-                for (int i = 0; i < n_esami; i++) {
-                    const Esame* e = getEsameAtIndex(listaE, i);
-                    if (e == NULL) continue;
+                // Dopo il primo controllo basta rivalutare i record modificati
+                bool solo_modificati = integritaGiaControllata(listaA, listaP, listaE, listaG) &&
+                    conferma("Controllare solo i record modificati dall'ultimo controllo?");
 
-                    if (!validaTentativi(getTentativiTeorico(e)) ||
-                        !validaTentativi(getTentativiPratico(e))) {
-                        printf(" Esame ID allievo %d: numero tentativi non valido\n",
-                               getEsameIDAllievo(e));
-                        errori_modulo++;
-                    }
+                printf("Esecuzione controlli di validazione...\n\n");
 
-                    if (!verificaCoerenzaEsame(getTentativiTeorico(e), isTeoricoSuperato(e) ? 1 : 0)) {
-                        printf(" Esame ID allievo %d: incoerenza teorico\n",
-                               getEsameIDAllievo(e));
-                        errori_modulo++;
-                    }
+                RisultatoIntegrita risultato;
+                bool eseguito = solo_modificati
+                    ? verificaIntegritaIncrementale(listaA, listaP, listaE, listaG, &risultato)
+                    : verificaIntegrita(listaA, listaP, listaE, listaG, &risultato);
+                if (eseguito) {
+                    stampaRisultatoIntegrita(&risultato);
+                    liberaRisultatoIntegrita(&risultato);
                 }
-                printf("Errori trovati: %d\n\n", errori_modulo);
-                errori_totali += errori_modulo;
-                errori_modulo = 0;
-
-                // Validazione Guide
-                printf("---- VALIDAZIONE GUIDE ----\n");
-                int n_guide = getNumeroGuide(listaG);
-                for (int i = 0; i < n_guide; i++) {
-                    const Guida* g = getGuidaAtIndex(listaG, i);
-                    if (g == NULL) continue;
 
-                    if (!validaOre(getOreSvolte(g)) || !validaOre(getOreExtra(g))) {
-                        printf(" Guida ID allievo %d: ore negative\n",
-                               getGuidaIDAllievo(g));
-                        errori_modulo++;
-                    }
-
-                    if (!verificaCoerenzaOreExtra(getOreSvolte(g), getOreExtra(g), 6)) {
-                        printf(" Guida ID allievo %d: incoerenza ore extra\n",
-                               getGuidaIDAllievo(g));
-                        errori_modulo++;
+                printf("\nControllo dei riferimenti tra le tabelle...\n\n");
+                RisultatoReferenze referenze;
+                if (verificaReferenze(listaA, listaP, listaE, listaG, &referenze)) {
+                    stampaRisultatoReferenze(&referenze);
+                    if (contaProblemiReferenze(&referenze) > 0 &&
+                        conferma("Rimuovere i record orfani e creare quelli mancanti?")) {
+                        int riparati = riparaReferenze(listaP, listaE, listaG, &referenze);
+                        printf("Record rimossi o creati: %d\n", riparati);
                     }
+                    liberaRisultatoReferenze(&referenze);
                 }
-                printf("Errori trovati: %d\n\n", errori_modulo);
-                errori_totali += errori_modulo;
-
-                // Riepilogo finale
-                stampaRiepilogoErrori(errori_totali);
 
                 attendiInvio();
                 break;
@@ -336,6 +304,39 @@ void mostraMenuPrincipale(ListaAllievi* listaA, ListaPagamenti* listaP, ListaEsa
                 attendiInvio();
                 break;
 
+            case 8: { // FORMATO DI SALVATAGGIO
+                const char* nomi[] = {
+                    "file separati (.dat)",
+                    "file unico (autoscuola.db)",
+                    "istantanea differenziale (autoscuola.snap)"
+                };
+                printf("\n Formato attuale: %s\n", nomi[getFormatoArchivio()]);
+                printf("\n1. %s\n2. %s\n3. %s\n0. Annulla\n", nomi[0], nomi[1], nomi[2]);
+                int formato = inputInt("\n Scelta: ");
+                if (formato >= 1 && formato <= 3) {
+                    impostaFormatoArchivio((FormatoArchivio)(formato - 1));
+                    printf(" Formato aggiornato: verra' usato dal prossimo salvataggio.\n");
+                }
+                attendiInvio();
+                break;
+            }
+
+            case 9: { // ESPORTA DATI
+                printf("\n1. CSV\n2. JSON Lines\n0. Annulla\n");
+                int formato = inputInt("\n Scelta: ");
+                if (formato == 1 || formato == 2) {
+                    if (esportaTutto(listaA, listaP, listaE, listaG,
+                                     PREFISSO_ESPORTAZIONE_PREDEFINITO,
+                                     (FormatoEsportazione)(formato - 1))) {
+                        printf(" Dati esportati nei file %s_*.%s\n",
+                               PREFISSO_ESPORTAZIONE_PREDEFINITO,
+                               formato == 1 ? "csv" : "jsonl");
+                    }
+                }
+                attendiInvio();
+                break;
+            }
+
             case 0: // ESCI
                 printf("\n Salvataggio finale...\n");
                 salvaDati(listaA, listaP, listaE, listaG);
@@ -0,0 +1,203 @@
+/**
+ * @file modifiche.c
+ * @brief Implementazione del tracciamento delle modifiche per record e per blocco.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "modifiche.h"
+
+//STATO DEL MODULO
+#define MAX_AREE_REGISTRATE 128 // Liste in uso, copie dell'autosalvataggio e delle viste
+
+/*
+ * Liste diverse possono essere modificate da thread diversi (es. caricamento
+ * in parallelo, dati condivisi): il contatore e' atomico e l'elenco delle
+ * aree, scritto solo alla creazione e distruzione delle liste, e' protetto
+ * da un lock lettori/scrittori.
+ */
+static atomic_ulong generazione_globale = 0;
+static RegistroModifiche* aree_registrate[MAX_AREE_REGISTRATE];
+static pthread_rwlock_t lock_aree = PTHREAD_RWLOCK_INITIALIZER;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Assegna la prossima generazione e la registra sulla lista.
+ */
+static unsigned long nuovaGenerazione(RegistroModifiche* registro) {
+    registro->generazione = atomic_fetch_add(&generazione_globale, 1) + 1;
+    return registro->generazione;
+}
+
+/**
+ * @brief Individua tra le aree registrate il registro che contiene un record.
+ * @param posizione Riceve l'indice del record nel suo array.
+ * @return Registro proprietario, NULL se il record non appartiene a nessuna lista.
+ */
+static RegistroModifiche* trovaRegistro(const void* record, int* posizione) {
+    if (record == NULL) return NULL;
+
+    const unsigned char* p = (const unsigned char*)record;
+    RegistroModifiche* trovato = NULL;
+    pthread_rwlock_rdlock(&lock_aree);
+    for (int i = 0; i < MAX_AREE_REGISTRATE && trovato == NULL; i++) {
+        RegistroModifiche* r = aree_registrate[i];
+        if (r == NULL) continue;
+
+        const unsigned char* fine = r->base + r->dim_record * (size_t)r->capacita;
+        if (p >= r->base && p < fine) {
+            *posizione = (int)((size_t)(p - r->base) / r->dim_record);
+            trovato = r;
+        }
+    }
+    pthread_rwlock_unlock(&lock_aree);
+    return trovato;
+}
+
+//FUNZIONI PUBBLICHE
+
+bool inizializzaRegistroModifiche(RegistroModifiche* registro, const void* base,
+                                  size_t dim_record, int capacita) {
+    if (registro == NULL || base == NULL || capacita <= 0) return false;
+
+    int n_blocchi = (capacita + DIM_BLOCCO_MODIFICHE - 1) / DIM_BLOCCO_MODIFICHE;
+    registro->gen_record = (unsigned long*)calloc((size_t)capacita, sizeof(unsigned long));
+    registro->gen_blocco = (unsigned long*)calloc((size_t)n_blocchi, sizeof(unsigned long));
+    if (registro->gen_record == NULL || registro->gen_blocco == NULL) {
+        free(registro->gen_record);
+        free(registro->gen_blocco);
+        registro->gen_record = NULL;
+        registro->gen_blocco = NULL;
+        return false;
+    }
+
+    registro->generazione = 0;
+    registro->capacita = capacita;
+    registro->base = (const unsigned char*)base;
+    registro->dim_record = dim_record;
+
+    // Un'area non registrata perderebbe in silenzio le modifiche fatte dai setter
+    bool registrato = false;
+    pthread_rwlock_wrlock(&lock_aree);
+    for (int i = 0; i < MAX_AREE_REGISTRATE && !registrato; i++) {
+        if (aree_registrate[i] == NULL) {
+            aree_registrate[i] = registro;
+            registrato = true;
+        }
+    }
+    pthread_rwlock_unlock(&lock_aree);
+
+    if (!registrato) {
+        free(registro->gen_record);
+        free(registro->gen_blocco);
+        registro->gen_record = NULL;
+        registro->gen_blocco = NULL;
+        registro->capacita = 0;
+    }
+    return registrato;
+}
+
+void liberaRegistroModifiche(RegistroModifiche* registro) {
+    if (registro == NULL) return;
+
+    pthread_rwlock_wrlock(&lock_aree);
+    for (int i = 0; i < MAX_AREE_REGISTRATE; i++) {
+        if (aree_registrate[i] == registro) {
+            aree_registrate[i] = NULL;
+        }
+    }
+    pthread_rwlock_unlock(&lock_aree);
+
+    free(registro->gen_record);
+    free(registro->gen_blocco);
+    registro->gen_record = NULL;
+    registro->gen_blocco = NULL;
+    registro->capacita = 0;
+}
+
+void segnaModifica(RegistroModifiche* registro, int posizione) {
+    if (registro == NULL || registro->gen_record == NULL) return;
+    if (posizione < 0 || posizione >= registro->capacita) return;
+
+    unsigned long gen = nuovaGenerazione(registro);
+    registro->gen_record[posizione] = gen;
+    registro->gen_blocco[posizione / DIM_BLOCCO_MODIFICHE] = gen;
+}
+
+void segnaModificaTotale(RegistroModifiche* registro, int n) {
+    if (registro == NULL || registro->gen_record == NULL) return;
+    if (n > registro->capacita) n = registro->capacita;
+
+    unsigned long gen = nuovaGenerazione(registro);
+    for (int i = 0; i < n; i++) {
+        registro->gen_record[i] = gen;
+    }
+    for (int b = 0; b * DIM_BLOCCO_MODIFICHE < n; b++) {
+        registro->gen_blocco[b] = gen;
+    }
+}
+
+void segnaModificaStruttura(RegistroModifiche* registro) {
+    if (registro == NULL) return;
+    nuovaGenerazione(registro);
+}
+
+void segnaModificaRecord(const void* record) {
+    int posizione;
+    RegistroModifiche* r = trovaRegistro(record, &posizione);
+    if (r != NULL) segnaModifica(r, posizione);
+}
+
+unsigned long getGenerazioneRecord(const void* record) {
+    int posizione;
+    const RegistroModifiche* r = trovaRegistro(record, &posizione);
+    return (r != NULL) ? r->gen_record[posizione] : 0;
+}
+
+unsigned long getGenerazioneCorrente(void) {
+    return atomic_load(&generazione_globale);
+}
+
+bool bloccoModificatoDopo(const RegistroModifiche* registro, int blocco, unsigned long generazione) {
+    if (registro == NULL || registro->gen_blocco == NULL || blocco < 0) return false;
+    if (blocco * DIM_BLOCCO_MODIFICHE >= registro->capacita) return false;
+    return registro->gen_blocco[blocco] > generazione;
+}
+
+bool recordModificatoDopo(const RegistroModifiche* registro, int posizione, unsigned long generazione) {
+    if (registro == NULL || registro->gen_record == NULL) return false;
+    if (posizione < 0 || posizione >= registro->capacita) return false;
+    return registro->gen_record[posizione] > generazione;
+}
+
+int copiaBlocchiModificati(const RegistroModifiche* registro, RegistroModifiche* copia,
+                           void* destinazione, int n, unsigned long generazione) {
+    if (registro == NULL || registro->gen_blocco == NULL || destinazione == NULL) return 0;
+    if (n > registro->capacita) n = registro->capacita;
+    bool generazioni = copia != NULL && copia->gen_record != NULL && copia->capacita >= n;
+
+    unsigned char* dest = (unsigned char*)destinazione;
+    int copiati = 0;
+    for (int inizio = 0; inizio < n; inizio += DIM_BLOCCO_MODIFICHE) {
+        int blocco = inizio / DIM_BLOCCO_MODIFICHE;
+        if (registro->gen_blocco[blocco] <= generazione) continue;
+
+        int fine = inizio + DIM_BLOCCO_MODIFICHE;
+        if (fine > n) fine = n;
+        size_t offset = registro->dim_record * (size_t)inizio;
+        memcpy(dest + offset, registro->base + offset, registro->dim_record * (size_t)(fine - inizio));
+
+        // Le generazioni seguono i record: la copia risponde a getGenerazioneRecord() come l'originale
+        if (generazioni) {
+            memcpy(copia->gen_record + inizio, registro->gen_record + inizio,
+                   sizeof(unsigned long) * (size_t)(fine - inizio));
+            copia->gen_blocco[blocco] = registro->gen_blocco[blocco];
+        }
+        copiati++;
+    }
+    if (generazioni) copia->generazione = registro->generazione;
+    return copiati;
+}
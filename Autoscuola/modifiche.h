@@ -0,0 +1,146 @@
+/**
+ * @file modifiche.h
+ * @brief Tracciamento delle modifiche ai record delle liste (per blocchi).
+ *
+ * Ogni lista incorpora un `RegistroModifiche`. A ogni modifica viene
+ * assegnato un numero di generazione crescente e globale, memorizzato sul
+ * record modificato e sul blocco di `DIM_BLOCCO_MODIFICHE` record che lo
+ * contiene. Chi deve reagire alle modifiche (autosalvataggio, ...) ricorda
+ * l'ultima generazione elaborata e visita solo i blocchi piu' recenti.
+ *
+ * I setter che ricevono solo il puntatore al record (es. `setAllievoStato`)
+ * usano segnaModificaRecord(): il registro proprietario viene individuato
+ * tra le aree registrate da ogni lista alla creazione.
+ *
+ * Una lista va modificata da un thread alla volta (il thread principale,
+ * oppure chi ne detiene la scrittura in condivisi.h); liste diverse possono
+ * essere modificate in parallelo. I lettori in background lavorano su copie
+ * o in una sezione di lettura.
+ */
+#ifndef MODIFICHE_H
+#define MODIFICHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//COSTANTI PUBBLICHE
+#define DIM_BLOCCO_MODIFICHE 16
+
+/**
+ * @struct RegistroModifiche
+ * @brief Generazioni di modifica per record e per blocco di una lista.
+ */
+typedef struct {
+    unsigned long* gen_record;  /**< Ultima modifica di ogni record (0 = mai) */
+    unsigned long* gen_blocco;  /**< Ultima modifica di ogni blocco */
+    unsigned long generazione;  /**< Ultima modifica della lista (record o struttura) */
+    int capacita;               /**< Numero massimo di record tracciati */
+    const unsigned char* base;  /**< Inizio dell'array di record (per segnaModificaRecord) */
+    size_t dim_record;          /**< Dimensione di un record */
+} RegistroModifiche;
+
+/**
+ * @brief Inizializza il registro per un array di record e lo rende visibile ai setter.
+ * @param registro Registro da inizializzare.
+ * @param base Indirizzo del primo record dell'array.
+ * @param dim_record Dimensione di un record (sizeof).
+ * @param capacita Numero massimo di record nell'array.
+ * @return true se successo, false in caso di errore di allocazione o se
+ *         se l'elenco delle liste registrate e' pieno.
+ */
+bool inizializzaRegistroModifiche(RegistroModifiche* registro, const void* base,
+                                  size_t dim_record, int capacita);
+
+/**
+ * @brief Libera il registro e lo rimuove dalle aree registrate.
+ * @param registro Registro da liberare.
+ */
+void liberaRegistroModifiche(RegistroModifiche* registro);
+
+/**
+ * @brief Segna come modificato il record in posizione `posizione`.
+ * @param registro Registro della lista.
+ * @param posizione Indice del record (0-based).
+ */
+void segnaModifica(RegistroModifiche* registro, int posizione);
+
+/**
+ * @brief Segna come modificati i record nell'intervallo [0, n).
+ *
+ * Usato quando l'intero contenuto viene sostituito (es. caricamento da file).
+ *
+ * @param registro Registro della lista.
+ * @param n Numero di record.
+ */
+void segnaModificaTotale(RegistroModifiche* registro, int n);
+
+/**
+ * @brief Segna una modifica di struttura (es. svuotamento) senza record coinvolti.
+ * @param registro Registro della lista.
+ */
+void segnaModificaStruttura(RegistroModifiche* registro);
+
+/**
+ * @brief Segna come modificato il record indicato, cercando il registro che lo contiene.
+ *
+ * Se il record non appartiene a nessuna lista registrata (es. una copia
+ * locale) la chiamata non ha effetto.
+ *
+ * @param record Puntatore al record modificato.
+ */
+void segnaModificaRecord(const void* record);
+
+/**
+ * @brief Restituisce la generazione dell'ultima modifica di un record.
+ *
+ * Come segnaModificaRecord(), individua la lista a partire dal puntatore.
+ *
+ * @param record Puntatore al record.
+ * @return Generazione dell'ultima modifica, 0 se mai modificato o non appartenente a una lista.
+ */
+unsigned long getGenerazioneRecord(const void* record);
+
+/**
+ * @brief Restituisce l'ultima generazione assegnata (globale a tutte le liste).
+ * @return Generazione corrente.
+ */
+unsigned long getGenerazioneCorrente(void);
+
+/**
+ * @brief Verifica se un blocco e' stato modificato dopo una certa generazione.
+ * @param registro Registro della lista.
+ * @param blocco Indice del blocco.
+ * @param generazione Generazione di riferimento.
+ * @return true se il blocco e' piu' recente.
+ */
+bool bloccoModificatoDopo(const RegistroModifiche* registro, int blocco, unsigned long generazione);
+
+/**
+ * @brief Verifica se un record e' stato modificato dopo una certa generazione.
+ * @param registro Registro della lista.
+ * @param posizione Indice del record.
+ * @param generazione Generazione di riferimento.
+ * @return true se il record e' piu' recente.
+ */
+bool recordModificatoDopo(const RegistroModifiche* registro, int posizione, unsigned long generazione);
+
+/**
+ * @brief Copia in `destinazione` i blocchi dei primi `n` record modificati dopo una generazione.
+ *
+ * `destinazione` deve avere la stessa disposizione dell'array tracciato
+ * (stesso tipo di record e stessa capacita'): i blocchi non modificati
+ * restano quelli della copia precedente. Con i record vengono copiate le
+ * loro generazioni nel registro della copia, cosi' chi confronta
+ * generazioni (es. aggiornaResoconto()) vede la copia come l'originale.
+ *
+ * @param registro Registro della lista originale.
+ * @param copia Registro della lista copia (NULL = solo i record).
+ * @param destinazione Array di record della copia.
+ * @param n Numero di record validi nella lista originale.
+ * @param generazione Generazione dell'ultima copia (0 = copia completa).
+ * @return Numero di blocchi copiati.
+ */
+int copiaBlocchiModificati(const RegistroModifiche* registro, RegistroModifiche* copia,
+                           void* destinazione, int n, unsigned long generazione);
+
+#endif // MODIFICHE_H
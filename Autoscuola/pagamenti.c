@@ -13,9 +13,16 @@
 #include "allievi.h"  // Per trovaIDAllievo, ordinaAllieviAlfabetico, getter
 #include "guida.h"    // Per getOreExtra, calcolaCostoOreExtra
 #include "util.h"
+#include "indice.h"
+#include "modifiche.h"
+#include "codifica.h"
+#include "formato.h"
 
 //DEFINIZIONI STRUTTURE (PRIVATE)
 #define MAX_PAGAMENTI 100
+#define TABELLA_PAGAMENTI 'P' /**< Identificativo della tabella nel formato codificato */
+#define MAX_PAGAMENTO_CODIFICATO (sizeof(Pagamento) + CODIFICA_MAX_VARINT)
+#define DIM_RIGA_PAGAMENTO (FORMATO_MAX_INTERO + 6 * (16 + FORMATO_MAX_IMPORTO)) /**< Riga di stampaPagamento */
 
 /**
  * @struct Pagamento
@@ -36,20 +43,146 @@ struct Pagamento {
 struct ListaPagamenti {
     Pagamento elenco_pagamenti[MAX_PAGAMENTI];
     int n_pagamenti;
+    IndiceID indice_id; /**< Posizione dei record per ID allievo */
+    RegistroModifiche modifiche; /**< Generazioni di modifica per record e blocco */
 };
 
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Ricostruisce l'indice per ID a partire dall'elenco corrente.
+ */
+static void ricostruisciIndicePagamenti(ListaPagamenti* lista) {
+    svuotaIndice(&lista->indice_id);
+    for (int i = 0; i < lista->n_pagamenti; i++) {
+        inserisciInIndice(&lista->indice_id, lista->elenco_pagamenti[i].id_allievo, i);
+    }
+}
+
+/**
+ * @brief Codifica un pagamento: ID come differenza dal precedente, poi maschera
+ * delle rate non nulle seguita solo da quelle (valori float invariati).
+ */
+static bool codificaPagamento(const Pagamento* p, int id_precedente, Buffer* buf) {
+    const float importi[4] = { p->prima_rata, p->seconda_rata, p->terza_rata, p->extra };
+    unsigned char maschera = 0;
+    for (int i = 0; i < 4; i++) {
+        if (importi[i] != 0.0f) maschera |= (unsigned char)(1u << i);
+    }
+
+    bool ok = scriviVarintConSegno(buf, (int64_t)p->id_allievo - id_precedente) &&
+              scriviByte(buf, maschera);
+    for (int i = 0; i < 4 && ok; i++) {
+        if (maschera & (1u << i)) ok = scriviBuffer(buf, &importi[i], sizeof(float));
+    }
+    return ok;
+}
+
+/**
+ * @brief Decodifica un pagamento scritto da codificaPagamento().
+ */
+static bool decodificaPagamento(Lettore* lettore, Pagamento* p, int* id) {
+    float importi[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    *id += (int)leggiVarintConSegno(lettore);
+    unsigned char maschera = leggiByte(lettore);
+    if (maschera > 0x0F) return false;
+    for (int i = 0; i < 4; i++) {
+        if (maschera & (1u << i)) leggiByteGrezzi(lettore, &importi[i], sizeof(float));
+    }
+
+    p->id_allievo = *id;
+    p->prima_rata = importi[0];
+    p->seconda_rata = importi[1];
+    p->terza_rata = importi[2];
+    p->extra = importi[3];
+    return !lettore->errore;
+}
+
+/**
+ * @brief Legge una tabella nel formato codificato.
+ * @return Numero di pagamenti letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaCodificata(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza) {
+    Lettore lettore;
+    inizializzaLettore(&lettore, dati, lunghezza);
+    if (!leggiIntestazioneCodifica(&lettore, TABELLA_PAGAMENTI)) return -1;
+
+    uint64_t n = leggiVarint(&lettore);
+    if (lettore.errore || n > MAX_PAGAMENTI) return -1;
+
+    int id = 0;
+    for (int i = 0; i < (int)n; i++) {
+        if (!decodificaPagamento(&lettore, &lista->elenco_pagamenti[i], &id)) {
+            lista->n_pagamenti = 0;
+            return -1;
+        }
+    }
+
+    lista->n_pagamenti = (int)n;
+    return (int)n;
+}
+
+/**
+ * @brief Compone la riga di stampaPagamento() in `riga` (DIM_RIGA_PAGAMENTO byte).
+ * @return Lunghezza della riga, '\n' compreso.
+ */
+static size_t formattaRigaPagamento(char* riga, const Pagamento* pagamento) {
+    char* r = riga;
+    r += formattaTesto(r, "ID Allievo: ");
+    r += formattaIntero(r, pagamento->id_allievo);
+    r += formattaTesto(r, " | Prima: ");
+    r += formattaImporto(r, pagamento->prima_rata);
+    r += formattaTesto(r, " | Seconda: ");
+    r += formattaImporto(r, pagamento->seconda_rata);
+    r += formattaTesto(r, " | Terza: ");
+    r += formattaImporto(r, pagamento->terza_rata);
+    r += formattaTesto(r, " | Extra: ");
+    r += formattaImporto(r, pagamento->extra);
+    r += formattaTesto(r, " | Totale: ");
+    r += formattaImporto(r, calcolaTotalePagato(pagamento));
+    *r++ = '\n';
+    return (size_t)(r - riga);
+}
+
+/**
+ * @brief Legge una tabella nel formato precedente (array di struct grezze).
+ * @return Numero di pagamenti letti, -1 se i dati non sono validi.
+ */
+static int leggiTabellaGrezza(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza) {
+    const size_t intestazione = sizeof(int);
+    if (lunghezza < intestazione) return -1;
+
+    int n;
+    memcpy(&n, dati, sizeof(int));
+
+    if (n < 0 || n > MAX_PAGAMENTI) return -1;
+    if (lunghezza < intestazione + sizeof(Pagamento) * n) return -1;
+
+    memcpy(lista->elenco_pagamenti, dati + intestazione, sizeof(Pagamento) * n);
+    lista->n_pagamenti = n;
+    return n;
+}
+
 //FUNZIONI DI CREAZIONE/DISTRUZIONE
 
 ListaPagamenti* creaListaPagamenti(void) {
     ListaPagamenti* lista = (ListaPagamenti*)malloc(sizeof(ListaPagamenti));
     if (lista != NULL) {
         lista->n_pagamenti = 0;
+        svuotaIndice(&lista->indice_id);
+        if (!inizializzaRegistroModifiche(&lista->modifiche, lista->elenco_pagamenti,
+                                          sizeof(Pagamento), MAX_PAGAMENTI)) {
+            free(lista);
+            return NULL;
+        }
     }
     return lista;
 }
 
 void distruggiListaPagamenti(ListaPagamenti** lista) {
     if (lista != NULL && *lista != NULL) {
+        liberaRegistroModifiche(&(*lista)->modifiche);
         free(*lista);
         *lista = NULL;
     }
@@ -58,6 +191,8 @@ void distruggiListaPagamenti(ListaPagamenti** lista) {
 void inizializzaListaPagamenti(ListaPagamenti* listaP) {
     if (listaP == NULL) return;
     listaP->n_pagamenti = 0;
+    svuotaIndice(&listaP->indice_id);
+    segnaModificaStruttura(&listaP->modifiche);
 }
 
 //FUNZIONI DI ACCESSO (GETTER)
@@ -69,12 +204,8 @@ int getNumeroPagamenti(const ListaPagamenti* lista) {
 Pagamento* cercaPagamentoPerID(const ListaPagamenti* lista, int id_allievo) {
     if (lista == NULL || id_allievo <= 0) return NULL;
 
-    for (int i = 0; i < lista->n_pagamenti; i++) {
-        if (lista->elenco_pagamenti[i].id_allievo == id_allievo) {
-            return &lista->elenco_pagamenti[i];
-        }
-    }
-    return NULL;
+    int pos = cercaInIndice(&lista->indice_id, id_allievo);
+    return (pos >= 0) ? &lista->elenco_pagamenti[pos] : NULL;
 }
 
 const Pagamento* getPagamentoAtIndex(const ListaPagamenti* lista, int index) {
@@ -119,6 +250,7 @@ bool azzeraPagamento(Pagamento* pagamento) {
     pagamento->seconda_rata = 0.0;
     pagamento->terza_rata = 0.0;
     pagamento->extra = 0.0;
+    segnaModificaRecord(pagamento);
     return true;
 }
 
@@ -128,19 +260,22 @@ bool setRata(Pagamento* pagamento, int tipo_rata, float importo) {
     switch (tipo_rata) {
         case 1:
             pagamento->prima_rata = importo;
-            return true;
+            break;
         case 2:
             pagamento->seconda_rata = importo;
-            return true;
+            break;
         case 3:
             pagamento->terza_rata = importo;
-            return true;
+            break;
         case 4:
             pagamento->extra = importo;
-            return true;
+            break;
         default:
             return false;
     }
+
+    segnaModificaRecord(pagamento);
+    return true;
 }
 
 //FUNZIONALIT DI DOMINIO
@@ -160,10 +295,50 @@ bool inizializzaPagamento(ListaPagamenti* listaP, int id_allievo) {
     nuovo.terza_rata = 0.0;
     nuovo.extra = 0.0;
 
+    inserisciInIndice(&listaP->indice_id, nuovo.id_allievo, listaP->n_pagamenti);
+    segnaModifica(&listaP->modifiche, listaP->n_pagamenti);
     listaP->elenco_pagamenti[listaP->n_pagamenti++] = nuovo;
     return true;
 }
 
+int rimuoviPagamentiPerID(ListaPagamenti* listaP, const int id_allievi[], int n) {
+    if (listaP == NULL || id_allievi == NULL || n <= 0) return 0;
+
+    // ID da rimuovere in un indice temporaneo: una sola passata sull'elenco,
+    // anche con piu' record per lo stesso allievo
+    IndiceID da_rimuovere;
+    svuotaIndice(&da_rimuovere);
+    bool non_validi = false;   // L'indice non accetta ID <= 0: quei record si riconoscono a parte
+    for (int i = 0; i < n; i++) {
+        if (id_allievi[i] > 0) {
+            inserisciInIndice(&da_rimuovere, id_allievi[i], i);
+        } else {
+            non_validi = true;
+        }
+    }
+
+    int scritti = 0;
+    int primo_spostato = -1;
+    for (int i = 0; i < listaP->n_pagamenti; i++) {
+        int id = listaP->elenco_pagamenti[i].id_allievo;
+        if ((id <= 0) ? non_validi : cercaInIndice(&da_rimuovere, id) >= 0) {
+            if (primo_spostato < 0) primo_spostato = i;
+            continue;
+        }
+        if (scritti != i) listaP->elenco_pagamenti[scritti] = listaP->elenco_pagamenti[i];
+        scritti++;
+    }
+
+    int rimossi = listaP->n_pagamenti - scritti;
+    if (rimossi == 0) return 0;
+
+    listaP->n_pagamenti = scritti;
+    for (int i = primo_spostato; i < scritti; i++) segnaModifica(&listaP->modifiche, i);
+    segnaModificaStruttura(&listaP->modifiche);
+    ricostruisciIndicePagamenti(listaP);
+    return rimossi;
+}
+
 bool aggiungiRata(ListaPagamenti* lista, int id_allievo, int tipo_rata, float importo) {
     if (lista == NULL || id_allievo <= 0 || importo < 0) return false;
 
@@ -250,16 +425,29 @@ void stampaStatoPagamento(const ListaPagamenti* listaP, const void* listaA) {
     float complessivo = totale + p->extra;
 
     printf("\n--- PAGAMENTI DI %s %s ---\n", nome, cognome);
-    printf("Prima rata:   %.2f\n", p->prima_rata);
-    printf("Seconda rata: %.2f\n", p->seconda_rata);
-    printf("Terza rata:   %.2f\n", p->terza_rata);
-    printf("Extra:        %.2f\n", p->extra);
-    printf("Totale pagato: %.2f \n", complessivo);
 
-    if (totale >= 750.0)
-        printf("Pagamento completo.\n");
-    else
-        printf("Mancano %.2f  sulle rate principali.\n", 750.0 - totale);
+    char riga[6 * (32 + FORMATO_MAX_IMPORTO)];
+    char* r = riga;
+    r += formattaTesto(r, "Prima rata:   ");
+    r += formattaImporto(r, p->prima_rata);
+    r += formattaTesto(r, "\nSeconda rata: ");
+    r += formattaImporto(r, p->seconda_rata);
+    r += formattaTesto(r, "\nTerza rata:   ");
+    r += formattaImporto(r, p->terza_rata);
+    r += formattaTesto(r, "\nExtra:        ");
+    r += formattaImporto(r, p->extra);
+    r += formattaTesto(r, "\nTotale pagato: ");
+    r += formattaImporto(r, complessivo);
+    r += formattaTesto(r, " \n");
+
+    if (totale >= 750.0) {
+        r += formattaTesto(r, "Pagamento completo.\n");
+    } else {
+        r += formattaTesto(r, "Mancano ");
+        r += formattaImporto(r, 750.0 - totale);
+        r += formattaTesto(r, "  sulle rate principali.\n");
+    }
+    fwrite(riga, 1, (size_t)(r - riga), stdout);
 }
 
 void stampaPagamento(const Pagamento* pagamento) {
@@ -268,22 +456,28 @@ void stampaPagamento(const Pagamento* pagamento) {
         return;
     }
 
-    float totale = calcolaTotalePagato(pagamento);
-    printf("ID Allievo: %d | Prima: %.2f | Seconda: %.2f | Terza: %.2f | Extra: %.2f | Totale: %.2f\n",
-           pagamento->id_allievo, pagamento->prima_rata, pagamento->seconda_rata,
-           pagamento->terza_rata, pagamento->extra, totale);
+    char riga[DIM_RIGA_PAGAMENTO];
+    fwrite(riga, 1, formattaRigaPagamento(riga, pagamento), stdout);
 }
 
-void stampaTuttiPagamenti(const ListaPagamenti* lista) {
+void stampaTuttiPagamenti(const ListaPagamenti* lista, Uscita* uscita) {
     if (lista == NULL) {
         printf("Lista non valida.\n");
         return;
     }
 
-    printf("\n--- Elenco Pagamenti ---\n");
-    for (int i = 0; i < lista->n_pagamenti; i++) {
-        stampaPagamento(&lista->elenco_pagamenti[i]);
+    Uscita* terminale = NULL;
+    if (uscita == NULL) uscita = terminale = creaUscitaStandard();
+    if (uscita == NULL) return;
+
+    scriviTestoUscita(uscita, "\n--- Elenco Pagamenti ---\n");
+    for (int i = 0; i < lista->n_pagamenti && !uscitaInterrotta(uscita); i++) {
+        char* riga = riservaUscita(uscita, DIM_RIGA_PAGAMENTO);
+        if (riga == NULL) break;
+        avanzaUscita(uscita, formattaRigaPagamento(riga, &lista->elenco_pagamenti[i]));
     }
+
+    if (terminale != NULL) chiudiUscita(&terminale);
 }
 
 void riepilogoPagamenti(const ListaPagamenti* listaP, const void* listaA, const void* listaG) {
@@ -333,9 +527,27 @@ void riepilogoPagamenti(const ListaPagamenti* listaP, const void* listaA, const
 
         float totale = rate + extra_base + costo_ore_extra;
 
-        printf("%-4d| %-16s| %-16s| %-11.2f| %-7.2f| %-14.2f| %s\n",
-               id, nome, cognome, rate, extra_base + costo_ore_extra, totale,
-               (totale >= 750.0) ? "Completo" : "Incompleto");
+        // Colonne come "%-4d| %-16s| %-16s| %-11.2f| %-7.2f| %-14.2f| %s"
+        char riga[256];
+        char campo[FORMATO_MAX_IMPORTO];
+        char* r = riga;
+        formattaIntero(campo, id);
+        r += allineaColonna(r, campo, 4, false);
+        r += formattaTesto(r, "| ");
+        r += allineaColonna(r, nome, 16, false);
+        r += formattaTesto(r, "| ");
+        r += allineaColonna(r, cognome, 16, false);
+        r += formattaTesto(r, "| ");
+        formattaImporto(campo, rate);
+        r += allineaColonna(r, campo, 11, false);
+        r += formattaTesto(r, "| ");
+        formattaImporto(campo, extra_base + costo_ore_extra);
+        r += allineaColonna(r, campo, 7, false);
+        r += formattaTesto(r, "| ");
+        formattaImporto(campo, totale);
+        r += allineaColonna(r, campo, 14, false);
+        r += formattaTesto(r, (totale >= 750.0) ? "| Completo\n" : "| Incompleto\n");
+        fwrite(riga, 1, (size_t)(r - riga), stdout);
     }
 
     distruggiListaAllievi(&ordinata);
@@ -343,39 +555,93 @@ void riepilogoPagamenti(const ListaPagamenti* listaP, const void* listaA, const
 
 //FUNZIONI I/O FILE
 
-bool salvaPagamenti(const ListaPagamenti* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+int copiaModifichePagamenti(ListaPagamenti* copia, const ListaPagamenti* originale, unsigned long generazione) {
+    if (copia == NULL || originale == NULL) return -1;
 
-    FILE* file = fopen(filename, "wb");
-    if (file == NULL) {
-        printf("Errore: impossibile aprire il file %s per la scrittura.\n", filename);
-        return false;
+    int copiati = copiaBlocchiModificati(&originale->modifiche, &copia->modifiche,
+                                         copia->elenco_pagamenti, originale->n_pagamenti, generazione);
+    copia->n_pagamenti = originale->n_pagamenti;
+    if (originale->modifiche.generazione > generazione) {
+        copia->indice_id = originale->indice_id;
     }
+    return copiati;
+}
 
-    // Salva numero pagamenti
-    fwrite(&lista->n_pagamenti, sizeof(int), 1, file);
+const RegistroModifiche* getRegistroModifichePagamenti(const ListaPagamenti* lista) {
+    return (lista != NULL) ? &lista->modifiche : NULL;
+}
 
-    // Salva array pagamenti
-    fwrite(lista->elenco_pagamenti, sizeof(Pagamento), lista->n_pagamenti, file);
+bool serializzaIntestazioneGrezzaPagamenti(const ListaPagamenti* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    fclose(file);
-    return true;
+    bool ok = scriviBuffer(buf, &lista->n_pagamenti, sizeof(int));
+    return ok;
 }
 
-bool caricaPagamenti(ListaPagamenti* lista, const char* filename) {
-    if (lista == NULL || filename == NULL) return false;
+bool serializzaPagamenti(const ListaPagamenti* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
 
-    FILE* file = fopen(filename, "rb");
-    if (file == NULL) {
-        return false; // File non esiste, non  un errore
+    // Stima per eccesso: una sola riallocazione per l'intera tabella
+    riservaBuffer(buf, buf->lunghezza + CODIFICA_DIM_INTESTAZIONE + CODIFICA_MAX_VARINT +
+                       (size_t)lista->n_pagamenti * MAX_PAGAMENTO_CODIFICATO);
+
+    // Intestazione: numero pagamenti
+    bool ok = scriviIntestazioneCodifica(buf, TABELLA_PAGAMENTI);
+    ok &= scriviVarint(buf, (uint64_t)lista->n_pagamenti);
+
+    // Record codificati
+    int id_precedente = 0;
+    for (int i = 0; i < lista->n_pagamenti && ok; i++) {
+        ok = codificaPagamento(&lista->elenco_pagamenti[i], id_precedente, buf);
+        id_precedente = lista->elenco_pagamenti[i].id_allievo;
     }
+    return ok;
+}
 
-    // Carica numero pagamenti
-    fread(&lista->n_pagamenti, sizeof(int), 1, file);
+bool serializzaIndicePagamenti(const ListaPagamenti* lista, Buffer* buf) {
+    if (lista == NULL || buf == NULL) return false;
+    return scriviBuffer(buf, &lista->indice_id, sizeof(IndiceID));
+}
+
+bool deserializzaPagamenti(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza) {
+    return deserializzaPagamentiConIndice(lista, dati, lunghezza, NULL, 0);
+}
 
-    // Carica array pagamenti
-    fread(lista->elenco_pagamenti, sizeof(Pagamento), lista->n_pagamenti, file);
+bool deserializzaPagamentiConIndice(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza,
+                                    const unsigned char* indice, size_t lunghezza_indice) {
+    if (lista == NULL || dati == NULL) return false;
 
-    fclose(file);
+    int n = isTabellaCodificata(dati, lunghezza) ?
+            leggiTabellaCodificata(lista, dati, lunghezza) :
+            leggiTabellaGrezza(lista, dati, lunghezza);
+    if (n < 0) return false;
+
+    segnaModificaTotale(&lista->modifiche, n);
+    // L'indice salvato viene adottato se compatibile, altrimenti viene
+    // ricostruito dallo stesso thread che carica la tabella
+    if (indice == NULL || !adottaIndice(&lista->indice_id, indice, lunghezza_indice, n)) {
+        ricostruisciIndicePagamenti(lista);
+    }
     return true;
 }
+
+bool salvaPagamenti(const ListaPagamenti* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = serializzaPagamenti(lista, &buf) && scriviBufferSuFile(&buf, filename);
+    liberaBuffer(&buf);
+    return ok;
+}
+
+bool caricaPagamenti(ListaPagamenti* lista, const char* filename) {
+    if (lista == NULL || filename == NULL) return false;
+
+    Buffer buf;
+    inizializzaBuffer(&buf);
+    bool ok = leggiFileInBuffer(filename, &buf) && // File mancante: non e' un errore
+              deserializzaPagamenti(lista, buf.dati, buf.lunghezza);
+    liberaBuffer(&buf);
+    return ok;
+}
@@ -15,6 +15,9 @@
 #define PAGAMENTI_H
 
 #include <stdbool.h>
+#include "buffer.h"
+#include "modifiche.h"
+#include "uscita.h"
 
 //TIPI OPACHI
 /**
@@ -139,6 +142,20 @@ bool setRata(Pagamento* pagamento, int tipo_rata, float importo);
  * @return true se il pagamento  stato creato, false altrimenti.
  */
 bool inizializzaPagamento(ListaPagamenti* listaP, int id_allievo);
+/**
+ * @brief Rimuove i pagamenti degli allievi indicati (es. record orfani).
+ *
+ * L'elenco viene compattato in una sola passata mantenendo l'ordine; i
+ * record spostati risultano modificati per il salvataggio differenziale.
+ *
+ * @param listaP Puntatore alla lista.
+ * @param id_allievi ID degli allievi i cui record vanno rimossi (un ID <= 0
+ *                   rimuove tutti i record con ID non valido).
+ * @param n Numero di ID.
+ * @return Numero di record rimossi.
+ */
+int rimuoviPagamentiPerID(ListaPagamenti* listaP, const int id_allievi[], int n);
+
 
 /**
  * @brief Aggiunge un importo a una specifica rata di un allievo.
@@ -174,8 +191,9 @@ void stampaPagamento(const Pagamento* pagamento);
 /**
  * @brief Stampa tutti i pagamenti registrati.
  * @param lista Lista dei pagamenti.
+ * @param uscita Destinazione dell'elenco (NULL per il terminale).
  */
-void stampaTuttiPagamenti(const ListaPagamenti* lista);
+void stampaTuttiPagamenti(const ListaPagamenti* lista, Uscita* uscita);
 
 /**
  * @brief Stampa il riepilogo di tutti i pagamenti degli allievi, includendo i costi extra per ore guida aggiuntive.
@@ -186,6 +204,95 @@ void stampaTuttiPagamenti(const ListaPagamenti* lista);
 void riepilogoPagamenti(const ListaPagamenti* listaP, const void* listaA, const void* listaG);
 
 //FUNZIONI I/O FILE
+/**
+ * @brief Aggiorna una copia della lista con i soli blocchi modificati dopo una generazione.
+ *
+ * Usata dall'autosalvataggio e dalle viste di condivisi.h per mantenere
+ * un'istantanea coerente senza ricopiare l'intera lista a ogni ciclo. Se la
+ * lista e' cambiata viene copiato anche l'indice per ID, cosi' le ricerche
+ * funzionano anche sulla copia; i record copiati conservano la loro
+ * generazione (getGenerazioneRecord()).
+ *
+ * @param copia Lista di destinazione (creata con creaListaPagamenti()).
+ * @param originale Lista da cui copiare.
+ * @param generazione Generazione dell'ultima copia (0 = copia completa).
+ * @return Numero di blocchi copiati, -1 se i parametri non sono validi.
+ */
+int copiaModifichePagamenti(ListaPagamenti* copia, const ListaPagamenti* originale, unsigned long generazione);
+
+/**
+ * @brief Restituisce il registro delle modifiche della lista dei pagamenti.
+ *
+ * Il registro descrive anche l'array dei record (indirizzo, dimensione,
+ * capacita'): l'istantanea differenziale lo usa per riscrivere solo i
+ * blocchi modificati.
+ *
+ * @param lista Lista dei pagamenti.
+ * @return Puntatore al registro (read-only), NULL se lista e' NULL.
+ */
+const RegistroModifiche* getRegistroModifichePagamenti(const ListaPagamenti* lista);
+
+/**
+ * @brief Serializza l'intestazione del formato a record fissi (contatori senza record).
+ *
+ * Seguita da `n` record grezzi forma un'area leggibile da deserializzaPagamenti().
+ *
+ * @param lista Lista dei pagamenti.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIntestazioneGrezzaPagamenti(const ListaPagamenti* lista, Buffer* buf);
+
+/**
+ * @brief Serializza la lista dei pagamenti in un buffer in memoria.
+ *
+ * Il formato e' lo stesso del file `pagamenti.dat` e viene usato sia per i file
+ * separati sia per le sezioni dell'archivio unico. I record sono codificati
+ * in forma compatta (vedi codifica.h).
+ *
+ * @param lista Lista da serializzare.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaPagamenti(const ListaPagamenti* lista, Buffer* buf);
+
+/**
+ * @brief Ricostruisce la lista dei pagamenti da un'area di memoria serializzata.
+ *
+ * Riconosce anche il formato precedente a struct grezze.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaPagamenti().
+ * @param lunghezza Numero di byte disponibili.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaPagamenti(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza);
+
+/**
+ * @brief Come deserializzaPagamenti(), adottando un indice per ID salvato in precedenza.
+ *
+ * L'indice viene adottato solo se ha la dimensione attesa e punta a
+ * posizioni esistenti; altrimenti viene ricostruito. Il chiamante deve
+ * garantire che l'indice sia stato prodotto per gli stessi dati.
+ *
+ * @param lista Lista in cui caricare (deve essere gia' inizializzata).
+ * @param dati Byte prodotti da serializzaPagamenti().
+ * @param lunghezza Numero di byte disponibili.
+ * @param indice Byte prodotti da serializzaIndicePagamenti() (NULL = ricostruisci).
+ * @param lunghezza_indice Numero di byte dell'indice.
+ * @return true se successo, false se i dati sono troncati o non validi.
+ */
+bool deserializzaPagamentiConIndice(ListaPagamenti* lista, const unsigned char* dati, size_t lunghezza,
+                                    const unsigned char* indice, size_t lunghezza_indice);
+
+/**
+ * @brief Serializza l'indice per ID della lista dei pagamenti (immagine della tabella hash).
+ * @param lista Lista di cui salvare l'indice.
+ * @param buf Buffer di destinazione (i byte vengono accodati).
+ * @return true se successo, false altrimenti.
+ */
+bool serializzaIndicePagamenti(const ListaPagamenti* lista, Buffer* buf);
+
 /**
  * @brief Salva la lista dei pagamenti su file binario.
  * @param lista Lista da salvare.
@@ -0,0 +1,68 @@
+/**
+ * @file protocollo.c
+ * @brief Composizione e misura dei messaggi del protocollo del servizio.
+ */
+
+#include <stdint.h>
+#include "protocollo.h"
+#include "codifica.h"
+#include "esami.h"
+
+//FUNZIONI DI COMPOSIZIONE
+
+size_t iniziaMessaggio(Buffer* buf, unsigned char operazione) {
+    size_t inizio = buf->lunghezza;
+    riempiBuffer(buf, PROTOCOLLO_DIM_LUNGHEZZA);
+    scriviByte(buf, operazione);
+    return inizio;
+}
+
+bool chiudiMessaggio(Buffer* buf, size_t inizio) {
+    if (buf->dati == NULL || buf->lunghezza < inizio + PROTOCOLLO_DIM_LUNGHEZZA + 1) return false;
+
+    size_t corpo = buf->lunghezza - inizio - PROTOCOLLO_DIM_LUNGHEZZA;
+    if (corpo > PROTOCOLLO_MAX_CORPO) {
+        buf->lunghezza = inizio;
+        return false;
+    }
+    for (int i = 0; i < PROTOCOLLO_DIM_LUNGHEZZA; i++) {
+        buf->dati[inizio + (size_t)i] = (unsigned char)(corpo >> (8 * i));
+    }
+    return true;
+}
+
+//FUNZIONI DI LETTURA
+
+size_t misuraMessaggio(const unsigned char* dati, size_t n, bool* non_valido) {
+    *non_valido = false;
+    if (n < PROTOCOLLO_DIM_LUNGHEZZA) return 0;
+
+    uint32_t corpo = 0;
+    for (int i = 0; i < PROTOCOLLO_DIM_LUNGHEZZA; i++) {
+        corpo |= (uint32_t)dati[i] << (8 * i);
+    }
+    if (corpo == 0 || corpo > PROTOCOLLO_MAX_CORPO) {
+        *non_valido = true;
+        return 0;
+    }
+
+    size_t totale = PROTOCOLLO_DIM_LUNGHEZZA + (size_t)corpo;
+    return (n >= totale) ? totale : 0;
+}
+
+const char* descriviEsitoProtocollo(int esito) {
+    switch (esito) {
+        case PROTOCOLLO_OK: return "operazione eseguita";
+        case ESAME_ERRORE_GENERICO: return "esame non registrabile";
+        case ESAME_TEORICO_NON_SUPERATO: return "teorico non ancora superato";
+        case ESAME_ORE_GUIDA_INSUFFICIENTI: return "ore di guida insufficienti";
+        case ESAME_TENTATIVI_ESAURITI: return "tentativi esauriti";
+        case ESAME_GIA_SUPERATO: return "esame gia' superato";
+        case PROTOCOLLO_NON_TROVATO: return "allievo non trovato";
+        case PROTOCOLLO_RICHIESTA_NON_VALIDA: return "richiesta non valida";
+        case PROTOCOLLO_OPERAZIONE_FALLITA: return "operazione rifiutata";
+        case PROTOCOLLO_OPERAZIONE_SCONOSCIUTA: return "operazione sconosciuta";
+        case PROTOCOLLO_GIORNALE_NON_SCRITTO: return "giornale non scritto, operazione non eseguita";
+        default: return "esito sconosciuto";
+    }
+}
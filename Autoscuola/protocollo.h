@@ -0,0 +1,125 @@
+/**
+ * @file protocollo.h
+ * @brief Protocollo binario del servizio su socket Unix (vedi servizio.h).
+ *
+ * Ogni messaggio e' formato da 4 byte con la lunghezza del corpo (little
+ * endian) seguiti dal corpo. Il corpo inizia con il codice dell'operazione
+ * (1 byte); i campi seguono con le primitive di codifica.h: interi come
+ * varint con segno, stringhe precedute dalla lunghezza, importi come float
+ * grezzi (come nei file dei pagamenti). La risposta ripete il codice
+ * dell'operazione, seguito dall'esito (varint con segno) e, se l'esito e'
+ * PROTOCOLLO_OK, dai dati.
+ *
+ * Campi delle richieste:
+ * - OP_CERCA_ALLIEVO: id
+ * - OP_REGISTRA_ORE: id, ore
+ * - OP_REGISTRA_ESAME: id, tipo (TipoEsame), esito (EsitoEsame), giorno, mese, anno
+ * - OP_AGGIUNGI_RATA: id, rata (1-3, 4 = extra), importo
+ * - OP_RESOCONTO: elenco (ElencoResoconto)
+ * - OP_LOTTO: numero di voci, poi le voci: messaggi completi (prefisso di
+ *   lunghezza compreso) di OP_REGISTRA_ORE, OP_REGISTRA_ESAME o OP_AGGIUNGI_RATA
+ *
+ * Dati delle risposte:
+ * - OP_CERCA_ALLIEVO: id, nome, cognome, codice fiscale, patente, stato,
+ *   le quattro rate, tentativi teorico e pratico, esami superati (bit 0
+ *   teorico, bit 1 pratico), ore di guida svolte
+ * - OP_REGISTRA_ESAME: l'esito e' un CodiceEsame; se l'esame e' stato
+ *   valutato (esito da 0 a -5) segue il flag delle penalita' applicate (0/1),
+ *   anche quando l'esito non e' ESAME_OK
+ * - OP_RESOCONTO: testo dell'elenco
+ * - OP_LOTTO: numero di voci, poi per ogni voce il suo esito (e, per gli
+ *   esami valutati, il flag delle penalita')
+ * - le altre operazioni: nessun dato
+ *
+ * Un client puo' inviare piu' richieste senza attendere le risposte: le
+ * richieste di una connessione sono eseguite e ricevono risposta nell'ordine
+ * di invio. Le scritture consecutive ricevute insieme, come le voci di un
+ * OP_LOTTO, vengono applicate in una sola sezione di scrittura e registrate
+ * con una sola voce del giornale (giornale.h). Ogni voce ha il proprio
+ * esito: una voce rifiutata non annulla le altre.
+ */
+#ifndef PROTOCOLLO_H
+#define PROTOCOLLO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "buffer.h"
+
+//COSTANTI PUBBLICHE
+#define PROTOCOLLO_DIM_LUNGHEZZA 4               /**< Byte del prefisso di lunghezza */
+#define PROTOCOLLO_MAX_CORPO (1024 * 1024)       /**< Corpo massimo di un messaggio */
+
+/**
+ * @brief Operazioni del protocollo.
+ */
+typedef enum {
+    OP_CERCA_ALLIEVO = 1,
+    OP_REGISTRA_ORE = 2,
+    OP_REGISTRA_ESAME = 3,
+    OP_AGGIUNGI_RATA = 4,
+    OP_RESOCONTO = 5,
+    OP_LOTTO = 6
+} OperazioneProtocollo;
+
+/**
+ * @brief Elenchi restituiti da OP_RESOCONTO.
+ */
+typedef enum {
+    ELENCO_ALLIEVI = 0,
+    ELENCO_PAGAMENTI = 1,
+    ELENCO_ESAMI = 2,
+    ELENCO_GUIDE = 3
+} ElencoResoconto;
+
+/**
+ * @brief Esiti delle risposte.
+ *
+ * OP_REGISTRA_ESAME restituisce i valori di CodiceEsame (da 0 a -5); gli
+ * esiti del protocollo partono da -20 per non sovrapporsi.
+ */
+typedef enum {
+    PROTOCOLLO_OK = 0,
+    PROTOCOLLO_NON_TROVATO = -20,            /**< Allievo o record inesistente */
+    PROTOCOLLO_RICHIESTA_NON_VALIDA = -21,   /**< Campi mancanti, in eccesso o fuori intervallo */
+    PROTOCOLLO_OPERAZIONE_FALLITA = -22,     /**< La funzione di dominio ha rifiutato l'operazione */
+    PROTOCOLLO_OPERAZIONE_SCONOSCIUTA = -23,
+    PROTOCOLLO_GIORNALE_NON_SCRITTO = -24    /**< Scrittura non registrata nel giornale: non applicata */
+} EsitoProtocollo;
+
+//FUNZIONI DI COMPOSIZIONE
+
+/**
+ * @brief Inizia un messaggio in coda al buffer: lunghezza provvisoria e operazione.
+ * @param buf Buffer di destinazione.
+ * @param operazione Codice dell'operazione.
+ * @return Posizione del messaggio nel buffer, da passare a chiudiMessaggio().
+ */
+size_t iniziaMessaggio(Buffer* buf, unsigned char operazione);
+
+/**
+ * @brief Completa un messaggio scrivendone la lunghezza.
+ * @param buf Buffer con il messaggio.
+ * @param inizio Valore restituito da iniziaMessaggio().
+ * @return true se il messaggio e' completo, false se supera PROTOCOLLO_MAX_CORPO o manca memoria.
+ */
+bool chiudiMessaggio(Buffer* buf, size_t inizio);
+
+//FUNZIONI DI LETTURA
+
+/**
+ * @brief Misura il primo messaggio presente in un'area ricevuta.
+ * @param dati Byte ricevuti.
+ * @param n Numero di byte.
+ * @param non_valido Riceve true se il messaggio e' vuoto o supera PROTOCOLLO_MAX_CORPO.
+ * @return Byte del messaggio (prefisso compreso) se e' arrivato per intero, altrimenti 0.
+ */
+size_t misuraMessaggio(const unsigned char* dati, size_t n, bool* non_valido);
+
+/**
+ * @brief Descrizione testuale di un esito (del protocollo o CodiceEsame).
+ * @param esito Esito di una risposta.
+ * @return Stringa costante.
+ */
+const char* descriviEsitoProtocollo(int esito);
+
+#endif // PROTOCOLLO_H
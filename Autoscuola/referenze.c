@@ -0,0 +1,284 @@
+/**
+ * @file referenze.c
+ * @brief Implementazione del controllo di integrita' referenziale.
+ *
+ * Struttura:
+ * - InsiemeID: mappa di bit indicizzata dall'ID dell'allievo
+ * - Descrittori delle tabelle: come contare i record e leggerne l'ID allievo
+ * - Una passata per tabella, eseguite in parallelo: ogni record viene
+ *   cercato fra gli allievi e il suo ID segnato fra quelli visti, poi gli
+ *   allievi non visti sono i record mancanti
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "referenze.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+
+/**
+ * @struct InsiemeID
+ * @brief Insieme di ID in [1, max_id], un bit per ID.
+ */
+typedef struct {
+    uint64_t* parole;
+    int max_id;
+} InsiemeID;
+
+/**
+ * @struct DescrittoreReferenze
+ * @brief Accesso uniforme a una tabella che si riferisce agli allievi.
+ */
+typedef struct {
+    const char* titolo;        /**< Intestazione della sezione nella stampa */
+    const char* prefisso;      /**< Inizio della riga di un record orfano */
+    const char* mancante;      /**< Descrizione di un allievo senza record */
+    bool obbligatoria;         /**< Ogni allievo deve avere un record */
+    int (*numero)(const void* lista);
+    int (*id_allievo)(const void* lista, int i);
+} DescrittoreReferenze;
+
+/**
+ * @struct PassataReferenze
+ * @brief Lavoro di un thread: una tabella contro l'insieme degli allievi.
+ */
+typedef struct {
+    TabellaReferenze tabella;
+    const void* lista;
+    const InsiemeID* allievi;
+    const int* id_allievi;     /**< ID degli allievi nell'ordine della lista */
+    int n_allievi;
+    int* orfani;
+    int n_orfani;
+    int* mancanti;
+    int n_mancanti;
+    bool errore;
+} PassataReferenze;
+
+//DESCRITTORI DELLE TABELLE (PRIVATE)
+
+static int numeroPagamenti(const void* l) { return getNumeroPagamenti((const ListaPagamenti*)l); }
+static int numeroEsami(const void* l) { return getNumeroEsami((const ListaEsami*)l); }
+static int numeroGuide(const void* l) { return getNumeroGuide((const ListaGuide*)l); }
+
+static int idPagamento(const void* l, int i) {
+    return getPagamentoIDAllievo(getPagamentoAtIndex((const ListaPagamenti*)l, i));
+}
+static int idEsame(const void* l, int i) {
+    return getEsameIDAllievo(getEsameAtIndex((const ListaEsami*)l, i));
+}
+static int idGuida(const void* l, int i) {
+    return getGuidaIDAllievo(getGuidaAtIndex((const ListaGuide*)l, i));
+}
+
+static const DescrittoreReferenze TABELLE[NUM_TABELLE_REFERENZE] = {
+    { "PAGAMENTI", "Pagamento ID allievo", "senza pagamento",    true,  numeroPagamenti, idPagamento },
+    { "ESAMI",     "Esame ID allievo",     "senza scheda esami", true,  numeroEsami,     idEsame },
+    { "GUIDE",     "Guida ID allievo",     "senza guide",        false, numeroGuide,     idGuida }
+};
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+static bool creaInsiemeID(InsiemeID* insieme, int max_id) {
+    insieme->max_id = (max_id > 0) ? max_id : 0;
+    insieme->parole = (uint64_t*)calloc((size_t)insieme->max_id / 64 + 1, sizeof(uint64_t));
+    return insieme->parole != NULL;
+}
+
+static void liberaInsiemeID(InsiemeID* insieme) {
+    free(insieme->parole);
+    insieme->parole = NULL;
+}
+
+/** @pre 1 <= id <= max_id */
+static void aggiungiID(InsiemeID* insieme, int id) {
+    insieme->parole[id / 64] |= (uint64_t)1 << (id % 64);
+}
+
+static bool contieneID(const InsiemeID* insieme, int id) {
+    if (id <= 0 || id > insieme->max_id) return false;
+    return (insieme->parole[id / 64] >> (id % 64)) & 1u;
+}
+
+/**
+ * @brief Una passata sulla tabella, poi una sugli allievi per i record mancanti.
+ */
+static void eseguiPassata(PassataReferenze* p) {
+    const DescrittoreReferenze* t = &TABELLE[p->tabella];
+    int n = t->numero(p->lista);
+    if (n < 0) n = 0;
+
+    InsiemeID visti;
+    p->orfani = (int*)malloc(sizeof(int) * (size_t)(n + 1));
+    p->mancanti = (int*)malloc(sizeof(int) * (size_t)(p->n_allievi + 1));
+    if (p->orfani == NULL || p->mancanti == NULL || !creaInsiemeID(&visti, p->allievi->max_id)) {
+        p->errore = true;
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        int id = t->id_allievo(p->lista, i);
+        if (contieneID(p->allievi, id)) {
+            aggiungiID(&visti, id);
+        } else {
+            p->orfani[p->n_orfani++] = id;
+        }
+    }
+
+    if (t->obbligatoria) {
+        for (int i = 0; i < p->n_allievi; i++) {
+            if (!contieneID(&visti, p->id_allievi[i])) p->mancanti[p->n_mancanti++] = p->id_allievi[i];
+        }
+    }
+    liberaInsiemeID(&visti);
+}
+
+static void* threadPassata(void* arg) {
+    eseguiPassata((PassataReferenze*)arg);
+    return NULL;
+}
+
+//FUNZIONI PUBBLICHE
+
+bool verificaReferenze(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                       const ListaEsami* listaE, const ListaGuide* listaG,
+                       RisultatoReferenze* risultato) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL ||
+        risultato == NULL) return false;
+
+    memset(risultato, 0, sizeof(*risultato));
+
+    // ID degli allievi e mappa di bit, costruite una volta per tutte le tabelle
+    int n_allievi = getNumeroAllievi(listaA);
+    if (n_allievi < 0) n_allievi = 0;
+    int* id_allievi = (int*)malloc(sizeof(int) * (size_t)(n_allievi + 1));
+    if (id_allievi == NULL) {
+        printf("Errore: memoria insufficiente per il controllo dei riferimenti.\n");
+        return false;
+    }
+    int max_id = 0;
+    for (int i = 0; i < n_allievi; i++) {
+        id_allievi[i] = getAllievoID(getAllievoAtIndex(listaA, i));
+        if (id_allievi[i] > max_id) max_id = id_allievi[i];
+    }
+
+    InsiemeID allievi;
+    if (!creaInsiemeID(&allievi, max_id)) {
+        printf("Errore: memoria insufficiente per il controllo dei riferimenti.\n");
+        free(id_allievi);
+        return false;
+    }
+    for (int i = 0; i < n_allievi; i++) {
+        if (id_allievi[i] > 0) aggiungiID(&allievi, id_allievi[i]);
+    }
+
+    PassataReferenze passate[NUM_TABELLE_REFERENZE];
+    const void* liste[NUM_TABELLE_REFERENZE] = { listaP, listaE, listaG };
+    memset(passate, 0, sizeof(passate));
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        passate[t].tabella = (TabellaReferenze)t;
+        passate[t].lista = liste[t];
+        passate[t].allievi = &allievi;
+        passate[t].id_allievi = id_allievi;
+        passate[t].n_allievi = n_allievi;
+    }
+
+    // Una tabella per thread; la prima sul thread chiamante
+    pthread_t thread[NUM_TABELLE_REFERENZE];
+    bool avviato[NUM_TABELLE_REFERENZE];
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        avviato[t] = (t > 0) && (pthread_create(&thread[t], NULL, threadPassata, &passate[t]) == 0);
+    }
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        if (!avviato[t]) eseguiPassata(&passate[t]);
+    }
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        if (avviato[t]) pthread_join(thread[t], NULL);
+    }
+
+    bool ok = true;
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        ok = ok && !passate[t].errore;
+        risultato->orfani[t] = passate[t].orfani;
+        risultato->n_orfani[t] = passate[t].n_orfani;
+        risultato->mancanti[t] = passate[t].mancanti;
+        risultato->n_mancanti[t] = passate[t].n_mancanti;
+    }
+    liberaInsiemeID(&allievi);
+    free(id_allievi);
+
+    if (!ok) {
+        printf("Errore: memoria insufficiente per il controllo dei riferimenti.\n");
+        liberaRisultatoReferenze(risultato);
+        return false;
+    }
+    return true;
+}
+
+int contaProblemiReferenze(const RisultatoReferenze* risultato) {
+    if (risultato == NULL) return 0;
+    int n = 0;
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        n += risultato->n_orfani[t] + risultato->n_mancanti[t];
+    }
+    return n;
+}
+
+void stampaRisultatoReferenze(const RisultatoReferenze* risultato) {
+    if (risultato == NULL) return;
+
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        printf("---- RIFERIMENTI %s ----\n", TABELLE[t].titolo);
+        for (int i = 0; i < risultato->n_orfani[t]; i++) {
+            printf(" %s %d: allievo inesistente\n", TABELLE[t].prefisso, risultato->orfani[t][i]);
+        }
+        for (int i = 0; i < risultato->n_mancanti[t]; i++) {
+            printf(" Allievo ID %d: %s\n", risultato->mancanti[t][i], TABELLE[t].mancante);
+        }
+        printf("Orfani: %d, mancanti: %d\n\n", risultato->n_orfani[t], risultato->n_mancanti[t]);
+    }
+
+    int n = contaProblemiReferenze(risultato);
+    if (n == 0) {
+        printf("Riferimenti tra le tabelle: NESSUN PROBLEMA\n");
+    } else {
+        printf("Riferimenti tra le tabelle: %d PROBLEMI trovati\n", n);
+    }
+}
+
+int riparaReferenze(ListaPagamenti* listaP, ListaEsami* listaE, ListaGuide* listaG,
+                    const RisultatoReferenze* risultato) {
+    if (listaP == NULL || listaE == NULL || listaG == NULL || risultato == NULL) return 0;
+
+    int riparati = 0;
+    riparati += rimuoviPagamentiPerID(listaP, risultato->orfani[REFERENZE_PAGAMENTI],
+                                      risultato->n_orfani[REFERENZE_PAGAMENTI]);
+    riparati += rimuoviEsamiPerID(listaE, risultato->orfani[REFERENZE_ESAMI],
+                                  risultato->n_orfani[REFERENZE_ESAMI]);
+    riparati += rimuoviGuidePerID(listaG, risultato->orfani[REFERENZE_GUIDE],
+                                  risultato->n_orfani[REFERENZE_GUIDE]);
+
+    for (int i = 0; i < risultato->n_mancanti[REFERENZE_PAGAMENTI]; i++) {
+        if (inizializzaPagamento(listaP, risultato->mancanti[REFERENZE_PAGAMENTI][i])) riparati++;
+    }
+    for (int i = 0; i < risultato->n_mancanti[REFERENZE_ESAMI]; i++) {
+        if (inizializzaEsame(listaE, risultato->mancanti[REFERENZE_ESAMI][i])) riparati++;
+    }
+    return riparati;
+}
+
+void liberaRisultatoReferenze(RisultatoReferenze* risultato) {
+    if (risultato == NULL) return;
+    for (int t = 0; t < NUM_TABELLE_REFERENZE; t++) {
+        free(risultato->orfani[t]);
+        free(risultato->mancanti[t]);
+    }
+    memset(risultato, 0, sizeof(*risultato));
+}
@@ -0,0 +1,95 @@
+/**
+ * @file referenze.h
+ * @brief Integrita' referenziale tra gli allievi e le altre tabelle.
+ *
+ * Pagamenti, esami e guide si riferiscono a un allievo tramite `id_allievo`.
+ * Il controllo costruisce una volta la mappa di bit degli ID degli allievi e
+ * la consulta per ogni record delle altre tre tabelle, una tabella per
+ * thread: il costo e' lineare nel numero di record. Trova:
+ * - record orfani: pagamenti, esami o guide di un allievo inesistente
+ * - record mancanti: allievi senza pagamento o senza scheda esami (la
+ *   scheda delle guide nasce con la prima lezione e non e' obbligatoria)
+ *
+ * riparaReferenze() rimuove gli orfani e crea i record mancanti.
+ */
+#ifndef REFERENZE_H
+#define REFERENZE_H
+
+#include <stdbool.h>
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Tabella che si riferisce agli allievi.
+ */
+typedef enum {
+    REFERENZE_PAGAMENTI = 0,
+    REFERENZE_ESAMI,
+    REFERENZE_GUIDE,
+    NUM_TABELLE_REFERENZE
+} TabellaReferenze;
+
+/**
+ * @struct RisultatoReferenze
+ * @brief Esito di un controllo: ID allievo dei record orfani e degli allievi senza record.
+ */
+typedef struct {
+    int* orfani[NUM_TABELLE_REFERENZE];      /**< ID dei record orfani, nell'ordine della tabella */
+    int n_orfani[NUM_TABELLE_REFERENZE];
+    int* mancanti[NUM_TABELLE_REFERENZE];    /**< ID degli allievi senza record, nell'ordine degli allievi */
+    int n_mancanti[NUM_TABELLE_REFERENZE];
+} RisultatoReferenze;
+
+/**
+ * @brief Cerca record orfani e record mancanti.
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param risultato Riceve l'esito (da liberare con liberaRisultatoReferenze()).
+ * @return true se il controllo e' stato completato, false per argomenti non validi o memoria insufficiente.
+ */
+bool verificaReferenze(const ListaAllievi* listaA, const ListaPagamenti* listaP,
+                       const ListaEsami* listaE, const ListaGuide* listaG,
+                       RisultatoReferenze* risultato);
+
+/**
+ * @brief Numero totale di problemi trovati.
+ * @param risultato Esito di verificaReferenze().
+ * @return Orfani piu' record mancanti.
+ */
+int contaProblemiReferenze(const RisultatoReferenze* risultato);
+
+/**
+ * @brief Stampa orfani e record mancanti tabella per tabella.
+ * @param risultato Esito da stampare.
+ */
+void stampaRisultatoReferenze(const RisultatoReferenze* risultato);
+
+/**
+ * @brief Ripara i problemi trovati da verificaReferenze().
+ *
+ * Rimuove i record orfani e crea pagamento e scheda esami iniziali per gli
+ * allievi che ne sono privi. Le liste non devono essere cambiate dopo il
+ * controllo.
+ *
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param risultato Esito di verificaReferenze() sulle stesse liste.
+ * @return Numero di record rimossi o creati.
+ */
+int riparaReferenze(ListaPagamenti* listaP, ListaEsami* listaE, ListaGuide* listaG,
+                    const RisultatoReferenze* risultato);
+
+/**
+ * @brief Libera gli elenchi di un esito.
+ * @param risultato Esito da liberare.
+ */
+void liberaRisultatoReferenze(RisultatoReferenze* risultato);
+
+#endif // REFERENZE_H
@@ -0,0 +1,760 @@
+/**
+ * @file resoconto.c
+ * @brief Generazione parallela del resoconto testuale degli allievi.
+ *
+ * Gli allievi vengono divisi in fasce contigue; ogni thread formatta la
+ * propria fascia in un buffer in memoria e il thread chiamante scrive poi i
+ * buffer nell'ordine delle fasce, con una sola scrittura per buffer. Ogni
+ * sezione dipende solo dal proprio allievo, quindi il file e' identico a
+ * quello prodotto da un solo thread.
+ *
+ * Per l'aggiornamento incrementale le sezioni restano in memoria, una per
+ * allievo, con la generazione di modifica (vedi modifiche.h) a cui sono
+ * state formattate. Vengono riformattate solo le sezioni i cui record sono
+ * cambiati; nel file si riscrivono in posizione le sezioni di lunghezza
+ * invariata e, dalla prima sezione spostata in poi, la coda del file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "resoconto.h"
+#include "buffer.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "indice.h"
+#include "modifiche.h"
+#include "formato.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define DIM_INIZIALE_SEZIONE 1024 /**< Stima dei byte per allievo */
+
+/**
+ * @struct TestoResoconto
+ * @brief Testo formattato in memoria; dopo un errore di allocazione le scritture vengono ignorate.
+ */
+typedef struct {
+    Buffer buf;
+    bool errore;
+} TestoResoconto;
+
+/**
+ * @struct LavoroResoconto
+ * @brief Fascia [inizio, fine) assegnata a un thread.
+ *
+ * Senza `allievi` la fascia indica posizioni nella lista e viene formattata
+ * in `testo`; con `allievi` indica posizioni in quell'elenco e ogni allievo
+ * viene formattato nella propria sezione `sezioni[i]`.
+ */
+typedef struct {
+    const ListaAllievi* listaA;
+    const ListaPagamenti* listaP;
+    const ListaEsami* listaE;
+    const ListaGuide* listaG;
+    int inizio;
+    int fine;
+    const Allievo* const* allievi;
+    TestoResoconto** sezioni;
+    TestoResoconto testo;
+} LavoroResoconto;
+
+/**
+ * @struct SezioneResoconto
+ * @brief Sezione di un allievo conservata tra due aggiornamenti.
+ */
+typedef struct {
+    int id;                     /**< ID dell'allievo */
+    unsigned long generazione;  /**< Generazione dei record da cui e' stata formattata */
+    TestoResoconto testo;
+    long offset;                /**< Posizione nel file all'ultimo aggiornamento */
+} SezioneResoconto;
+
+#define MAX_SEZIONI_RESOCONTO (CAPACITA_INDICE / 2)
+
+//STATO DEL MODULO
+/**
+ * Sezioni formattate dall'ultimo aggiornamento e disposizione del file
+ * scritto. Usato solo dal thread principale.
+ */
+static struct {
+    char filename[256];
+    IndiceID indice;                                /**< ID allievo -> sezione */
+    SezioneResoconto sezioni[MAX_SEZIONI_RESOCONTO];
+    int n_sezioni;
+    int ordine[MAX_SEZIONI_RESOCONTO];              /**< Sezioni nell'ordine del file */
+    int n_ordine;
+    TestoResoconto intestazione;
+    long dimensione_file;
+    bool valida;
+} cache;
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+/**
+ * @brief Garantisce `n` byte liberi in coda al testo.
+ * @return Primo byte libero, NULL dopo un errore di allocazione.
+ */
+static char* riservaTesto(TestoResoconto* testo, size_t n) {
+    if (testo->errore) return NULL;
+    if (!riservaBuffer(&testo->buf, testo->buf.lunghezza + n)) {
+        testo->errore = true;
+        return NULL;
+    }
+    return (char*)testo->buf.dati + testo->buf.lunghezza;
+}
+
+/**
+ * @brief Accoda una stringa costante.
+ *
+ * Il file viene scritto in binario (le sezioni si riscrivono sul posto a
+ * offset noti): su Windows gli a capo diventano "\r\n" come in modo testo.
+ */
+static void accodaStringa(TestoResoconto* testo, const char* s) {
+    size_t n = strlen(s);
+#ifdef _WIN32
+    for (const char* p = s; *p != '\0'; p++) {
+        if (*p == '\n') n++;
+    }
+#endif
+    char* dest = riservaTesto(testo, n);
+    if (dest == NULL) return;
+#ifdef _WIN32
+    for (char* d = dest; *s != '\0'; s++) {
+        if (*s == '\n') *d++ = '\r';
+        *d++ = *s;
+    }
+#else
+    memcpy(dest, s, n);
+#endif
+    testo->buf.lunghezza += n;
+}
+
+static void accodaIntero(TestoResoconto* testo, long long valore) {
+    char* dest = riservaTesto(testo, FORMATO_MAX_INTERO);
+    if (dest != NULL) testo->buf.lunghezza += formattaIntero(dest, valore);
+}
+
+static void accodaImporto(TestoResoconto* testo, double importo) {
+    char* dest = riservaTesto(testo, FORMATO_MAX_IMPORTO);
+    if (dest != NULL) testo->buf.lunghezza += formattaImporto(dest, importo);
+}
+
+static void accodaData(TestoResoconto* testo, const Data* data) {
+    char* dest = riservaTesto(testo, FORMATO_MAX_DATA);
+    if (dest != NULL) testo->buf.lunghezza += formattaData(dest, data);
+}
+
+/**
+ * @brief Formatta la sezione di un allievo: anagrafica, pagamenti, esami, guide, esito.
+ *
+ * Tutta la sezione e' composta con formato.h, senza stringhe di formato.
+ */
+static void scriviSezioneAllievo(TestoResoconto* testo, const Allievo* a,
+                                 const ListaPagamenti* listaP,
+                                 const ListaEsami* listaE,
+                                 const ListaGuide* listaG) {
+    int id = getAllievoID(a);
+    const char* nome = getAllievoNome(a);
+    const char* cognome = getAllievoCognome(a);
+    const char* cf = getAllievoCodiceFiscale(a);
+    const char* patente = getAllievoCategoriaPatente(a);
+    const char* stato = getAllievoStato(a);
+
+    accodaStringa(testo, "___________________________________________________________\n| ID: ");
+    accodaIntero(testo, id);
+    accodaStringa(testo, "\n| Nome: ");
+    accodaStringa(testo, nome);
+    accodaStringa(testo, " ");
+    accodaStringa(testo, cognome);
+    accodaStringa(testo, "\n| Codice Fiscale: ");
+    accodaStringa(testo, cf);
+    accodaStringa(testo, "\n| Patente: ");
+    accodaStringa(testo, patente);
+    accodaStringa(testo, "\n| Stato: ");
+    accodaStringa(testo, stato);
+    accodaStringa(testo, "\n___________________________________________________________\n");
+
+    // --- PAGAMENTI ---
+    accodaStringa(testo, "\n[PAGAMENTI]\n");
+    Pagamento* p = cercaPagamentoPerID(listaP, id);
+    if (p != NULL) {
+        float prima = getPrimaRata(p);
+        float seconda = getSecondaRata(p);
+        float terza = getTerzaRata(p);
+        float extra_base = getExtra(p);
+        float totale_rate = prima + seconda + terza;
+
+        // Calcola costo ore extra
+        float costo_ore_extra = 0.0;
+        int ore_extra = 0;
+        if (listaG != NULL) {
+            Guida* g = cercaGuidaPerID(listaG, id);
+            if (g != NULL) {
+                ore_extra = getOreExtra(g);
+                costo_ore_extra = calcolaCostoOreExtra(g, 15.0);
+            }
+        }
+
+        float totale_complessivo = totale_rate + extra_base + costo_ore_extra;
+
+        accodaStringa(testo, "  Prima rata:      ");
+        accodaImporto(testo, prima);
+        accodaStringa(testo, " €\n  Seconda rata:    ");
+        accodaImporto(testo, seconda);
+        accodaStringa(testo, " €\n  Terza rata:      ");
+        accodaImporto(testo, terza);
+        accodaStringa(testo, " €\n  Extra generici:  ");
+        accodaImporto(testo, extra_base);
+        accodaStringa(testo, " €\n  Extra guide (");
+        accodaIntero(testo, ore_extra);
+        accodaStringa(testo, " ore x 15€): ");
+        accodaImporto(testo, costo_ore_extra);
+        accodaStringa(testo, " €\n  ─────────────────────────\n  TOTALE PAGATO:   ");
+        accodaImporto(testo, totale_complessivo);
+        accodaStringa(testo, " €\n");
+
+        if (totale_rate >= 750.0) {
+            accodaStringa(testo, "  Rate principali complete\n");
+        } else {
+            accodaStringa(testo, "  Mancano ");
+            accodaImporto(testo, 750.0 - totale_rate);
+            accodaStringa(testo, " € sulle rate\n");
+        }
+    } else {
+        accodaStringa(testo, "  Nessun pagamento registrato.\n");
+    }
+
+    // --- ESAMI ---
+    accodaStringa(testo, "\n[ESAMI]\n");
+    Esame* e = cercaEsamePerID(listaE, id);
+    if (e != NULL) {
+        int tent_teorico = getTentativiTeorico(e);
+        int tent_pratico = getTentativiPratico(e);
+        bool superato_teorico = isTeoricoSuperato(e);
+        bool superato_pratico = isPraticoSuperato(e);
+
+        accodaStringa(testo, "  Teorico: ");
+        accodaIntero(testo, tent_teorico);
+        accodaStringa(testo, superato_teorico ? " tentativi - Superato\n" : " tentativi - Non superato\n");
+
+        for (int t = 0; t < tent_teorico; t++) {
+            Data d;
+            if (getDataTeorico(e, t, &d) && d.giorno != 0) {
+                accodaStringa(testo, "    - Tentativo ");
+                accodaIntero(testo, t + 1);
+                accodaStringa(testo, ": ");
+                accodaData(testo, &d);
+                accodaStringa(testo, "\n");
+            }
+        }
+
+        accodaStringa(testo, "  Pratico: ");
+        accodaIntero(testo, tent_pratico);
+        accodaStringa(testo, superato_pratico ? " tentativi - Superato\n" : " tentativi - Non superato\n");
+
+        for (int t = 0; t < tent_pratico; t++) {
+            Data d;
+            if (getDataPratico(e, t, &d) && d.giorno != 0) {
+                accodaStringa(testo, "    - Tentativo ");
+                accodaIntero(testo, t + 1);
+                accodaStringa(testo, ": ");
+                accodaData(testo, &d);
+                accodaStringa(testo, "\n");
+            }
+        }
+    } else {
+        accodaStringa(testo, "  Nessun esame registrato.\n");
+    }
+
+    // --- GUIDE ---
+    accodaStringa(testo, "\n[GUIDE]\n");
+    Guida* g = cercaGuidaPerID(listaG, id);
+    if (g != NULL) {
+        int ore_svolte = getOreSvolte(g);
+        int ore_extra = getOreExtra(g);
+
+        accodaStringa(testo, "  Ore svolte:      ");
+        accodaIntero(testo, ore_svolte);
+        accodaStringa(testo, "\n  Ore extra:       ");
+        accodaIntero(testo, ore_extra);
+        accodaStringa(testo, "\n");
+
+        if (haCompletateOreObbligatorie(g)) {
+            accodaStringa(testo, "  Ore obbligatorie completate\n");
+        } else {
+            accodaStringa(testo, "  Mancano ");
+            accodaIntero(testo, 6 - ore_svolte);
+            accodaStringa(testo, " ore obbligatorie\n");
+        }
+    } else {
+        accodaStringa(testo, "  Nessuna guida registrata.\n");
+    }
+
+    // --- IDONEITÀ FINALE ---
+    accodaStringa(testo, "\n[ESITO FINALE]\n");
+
+    bool teorico_ok = false;
+    bool pratico_ok = false;
+    bool pagamenti_ok = false;
+    bool guide_ok = false;
+
+    if (e != NULL) {
+        teorico_ok = isTeoricoSuperato(e);
+        pratico_ok = isPraticoSuperato(e);
+    }
+
+    if (p != NULL) {
+        float totale_rate = getPrimaRata(p) + getSecondaRata(p) + getTerzaRata(p);
+        pagamenti_ok = (totale_rate >= 750.0);
+    }
+
+    if (g != NULL) {
+        guide_ok = haCompletateOreObbligatorie(g);
+    }
+
+    bool idoneo = teorico_ok && pratico_ok && pagamenti_ok && guide_ok;
+
+    accodaStringa(testo, teorico_ok ? "  Esame teorico:   Superato\n" : "  Esame teorico:   Non superato\n");
+    accodaStringa(testo, pratico_ok ? "  Esame pratico:   Superato\n" : "  Esame pratico:   Non superatO\n");
+    accodaStringa(testo, pagamenti_ok ? "  Pagamenti:       Completo\n" : "  Pagamenti:       Non completo\n");
+    accodaStringa(testo, guide_ok ? "  Guide (6+ ore):  Completo\n" : "  Guide (6+ ore):  Non completo\n");
+    accodaStringa(testo, "  ─────────────────────────\n");
+    accodaStringa(testo, idoneo ? "  -> IDONEO \n" : "  -> NON IDONEO\n");
+
+    accodaStringa(testo, "\n___________________________________________________________\n\n");
+}
+
+/**
+ * @brief Formatta la fascia di allievi assegnata al lavoro.
+ */
+static void formattaFascia(LavoroResoconto* l) {
+    if (l->allievi != NULL) {
+        for (int i = l->inizio; i < l->fine; i++) {
+            TestoResoconto* t = l->sezioni[i];
+            svuotaBuffer(&t->buf);
+            t->errore = false;
+            scriviSezioneAllievo(t, l->allievi[i], l->listaP, l->listaE, l->listaG);
+        }
+        return;
+    }
+
+    inizializzaBuffer(&l->testo.buf);
+    l->testo.errore = false;
+
+    size_t stima = (size_t)(l->fine - l->inizio) * DIM_INIZIALE_SEZIONE;
+    if (stima > 0 && !riservaBuffer(&l->testo.buf, stima)) {
+        l->testo.errore = true;
+        return;
+    }
+
+    for (int i = l->inizio; i < l->fine && !l->testo.errore; i++) {
+        const Allievo* a = getAllievoAtIndex(l->listaA, i);
+        if (a == NULL) continue;
+        scriviSezioneAllievo(&l->testo, a, l->listaP, l->listaE, l->listaG);
+    }
+}
+
+/**
+ * @brief Punto di ingresso dei thread di formattazione.
+ */
+static void* threadResoconto(void* arg) {
+    formattaFascia((LavoroResoconto*)arg);
+    return NULL;
+}
+
+/**
+ * @brief Numero di processori disponibili (almeno 1).
+ */
+static int numeroProcessori(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long n = (long)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (n > 0) ? (int)n : 1;
+}
+
+/**
+ * @brief Sceglie quante fasce formattare in parallelo.
+ *
+ * Per pochi allievi il costo di creare un thread supera quello della
+ * formattazione, quindi ogni fascia ha almeno RESOCONTO_MIN_ALLIEVI_PER_THREAD allievi.
+ */
+static int numeroFasce(int n_allievi) {
+    int fasce = n_allievi / RESOCONTO_MIN_ALLIEVI_PER_THREAD;
+    int processori = numeroProcessori();
+    if (fasce > processori) fasce = processori;
+    if (fasce > RESOCONTO_MAX_THREAD) fasce = RESOCONTO_MAX_THREAD;
+    return (fasce > 0) ? fasce : 1;
+}
+
+/**
+ * @brief Divide `n` elementi in fasce contigue e le formatta in parallelo.
+ *
+ * La prima fascia resta al thread chiamante, come quelle per cui non e'
+ * stato possibile creare un thread. Al ritorno tutte le fasce sono complete.
+ *
+ * @param modello Liste ed eventuale elenco di allievi/sezioni, copiati in ogni lavoro.
+ * @return Numero di fasce usate.
+ */
+static int formattaInParallelo(const LavoroResoconto* modello, int n,
+                               LavoroResoconto lavori[RESOCONTO_MAX_THREAD]) {
+    int n_fasce = numeroFasce(n);
+    pthread_t thread[RESOCONTO_MAX_THREAD];
+    bool avviato[RESOCONTO_MAX_THREAD];
+
+    // Fasce contigue di dimensione quasi uguale
+    for (int i = 0; i < n_fasce; i++) {
+        lavori[i] = *modello;
+        lavori[i].inizio = (int)((long)n * i / n_fasce);
+        lavori[i].fine = (int)((long)n * (i + 1) / n_fasce);
+
+        avviato[i] = (i > 0) &&
+                     (pthread_create(&thread[i], NULL, threadResoconto, &lavori[i]) == 0);
+    }
+    for (int i = 0; i < n_fasce; i++) {
+        if (!avviato[i]) formattaFascia(&lavori[i]);
+    }
+    for (int i = 0; i < n_fasce; i++) {
+        if (avviato[i]) pthread_join(thread[i], NULL);
+    }
+    return n_fasce;
+}
+
+/**
+ * @brief Formatta l'intestazione del resoconto.
+ */
+static void scriviIntestazione(TestoResoconto* testo, int n_allievi) {
+    accodaStringa(testo, "______________________________________________________________\n");
+    accodaStringa(testo, "|     RESOCONTO COMPLETO ALLIEVI AUTOSCUOLA                  |\n");
+    accodaStringa(testo, "______________________________________________________________\n\n");
+    accodaStringa(testo, "Totale allievi: ");
+    accodaIntero(testo, n_allievi);
+    accodaStringa(testo, "\n\n");
+}
+
+//AGGIORNAMENTO INCREMENTALE (PRIVATE)
+
+/**
+ * @brief Generazione piu' recente tra i record di un allievo nelle quattro liste.
+ */
+static unsigned long generazioneAllievo(const Allievo* a, const ListaPagamenti* listaP,
+                                        const ListaEsami* listaE, const ListaGuide* listaG) {
+    int id = getAllievoID(a);
+    unsigned long record[4] = {
+        getGenerazioneRecord(a),
+        (listaP != NULL) ? getGenerazioneRecord(cercaPagamentoPerID(listaP, id)) : 0,
+        (listaE != NULL) ? getGenerazioneRecord(cercaEsamePerID(listaE, id)) : 0,
+        (listaG != NULL) ? getGenerazioneRecord(cercaGuidaPerID(listaG, id)) : 0
+    };
+
+    unsigned long massima = 0;
+    for (int i = 0; i < 4; i++) {
+        if (record[i] > massima) massima = record[i];
+    }
+    return massima;
+}
+
+/**
+ * @brief Svuota la cache delle sezioni (libera la memoria, azzera la disposizione).
+ */
+static void svuotaCache(void) {
+    for (int i = 0; i < cache.n_sezioni; i++) {
+        liberaBuffer(&cache.sezioni[i].testo.buf);
+    }
+    liberaBuffer(&cache.intestazione.buf);
+    memset(&cache, 0, sizeof(cache));
+}
+
+/**
+ * @brief Sezione di un allievo nella cache, creata vuota se assente.
+ * @return Indice della sezione, -1 se la cache e' piena.
+ */
+static int sezionePerID(int id) {
+    int pos = cercaInIndice(&cache.indice, id);
+    if (pos >= 0) return pos;
+    if (cache.n_sezioni >= MAX_SEZIONI_RESOCONTO) return -1;
+
+    pos = cache.n_sezioni++;
+    SezioneResoconto* s = &cache.sezioni[pos];
+    s->id = id;
+    s->generazione = 0;
+    s->offset = -1;
+    inizializzaBuffer(&s->testo.buf);
+    s->testo.errore = false;
+    inserisciInIndice(&cache.indice, id, pos);
+    return pos;
+}
+
+/**
+ * @brief Dimensione attuale di un file aperto, -1 in caso di errore.
+ */
+static long dimensioneFile(FILE* f) {
+    if (fseek(f, 0, SEEK_END) != 0) return -1;
+    return ftell(f);
+}
+
+/**
+ * @brief Tronca un file aperto alla lunghezza indicata.
+ */
+static bool troncaFile(FILE* f, long lunghezza) {
+    fflush(f);
+#ifdef _WIN32
+    return _chsize(_fileno(f), lunghezza) == 0;
+#else
+    return ftruncate(fileno(f), (off_t)lunghezza) == 0;
+#endif
+}
+
+/**
+ * @brief Scrive sul file le sezioni nella nuova disposizione.
+ *
+ * Le sezioni precedenti la prima differenza di disposizione (ordine o
+ * lunghezza) restano dove sono: si riscrivono solo quelle riformattate.
+ * Dalla prima differenza in poi il file viene riscritto e troncato.
+ *
+ * @param riformattata Per ogni sezione della cache, true se appena riformattata.
+ */
+static bool scriviModifiche(FILE* f, const int ordine[], int n_ordine,
+                            const TestoResoconto* intestazione,
+                            const bool riformattata[], bool completo) {
+    const Buffer* testa = &intestazione->buf;
+    long offset = (long)testa->lunghezza;
+    int primo_spostato = 0;
+
+    // L'intestazione cambia con il numero di allievi; di solito non di lunghezza
+    bool stessa_testa = !completo && testa->lunghezza == cache.intestazione.buf.lunghezza;
+    if (!stessa_testa || memcmp(testa->dati, cache.intestazione.buf.dati, testa->lunghezza) != 0) {
+        if (fseek(f, 0, SEEK_SET) != 0 ||
+            fwrite(testa->dati, 1, testa->lunghezza, f) != testa->lunghezza) {
+            return false;
+        }
+    }
+
+    // Sezioni rimaste nella stessa posizione con la stessa lunghezza
+    for (; stessa_testa && primo_spostato < n_ordine; primo_spostato++) {
+        int pos = ordine[primo_spostato];
+        const SezioneResoconto* s = &cache.sezioni[pos];
+        if (primo_spostato >= cache.n_ordine || cache.ordine[primo_spostato] != pos ||
+            s->offset != offset) break;
+
+        long fine = (primo_spostato + 1 < cache.n_ordine)
+                    ? cache.sezioni[cache.ordine[primo_spostato + 1]].offset
+                    : cache.dimensione_file;
+        if (fine - offset != (long)s->testo.buf.lunghezza) break;
+
+        if (riformattata[pos]) {
+            if (fseek(f, offset, SEEK_SET) != 0 ||
+                fwrite(s->testo.buf.dati, 1, s->testo.buf.lunghezza, f) != s->testo.buf.lunghezza) {
+                return false;
+            }
+        }
+        offset += (long)s->testo.buf.lunghezza;
+    }
+    if (stessa_testa && primo_spostato == n_ordine && n_ordine == cache.n_ordine) {
+        return true; // Nessuna coda da riscrivere
+    }
+
+    // Coda: dalla prima sezione spostata fino alla fine
+    if (fseek(f, offset, SEEK_SET) != 0) return false;
+    for (int k = primo_spostato; k < n_ordine; k++) {
+        const SezioneResoconto* s = &cache.sezioni[ordine[k]];
+        if (fwrite(s->testo.buf.dati, 1, s->testo.buf.lunghezza, f) != s->testo.buf.lunghezza) {
+            return false;
+        }
+        offset += (long)s->testo.buf.lunghezza;
+    }
+    return troncaFile(f, offset);
+}
+
+//FUNZIONI PUBBLICHE
+
+bool scriviResoconto(const char* filename,
+                     const ListaAllievi* listaA,
+                     const ListaPagamenti* listaP,
+                     const ListaEsami* listaE,
+                     const ListaGuide* listaG) {
+    if (filename == NULL || listaA == NULL) return false;
+
+    int n_allievi = getNumeroAllievi(listaA);
+
+    LavoroResoconto modello;
+    memset(&modello, 0, sizeof(modello));
+    modello.listaA = listaA;
+    modello.listaP = listaP;
+    modello.listaE = listaE;
+    modello.listaG = listaG;
+
+    LavoroResoconto lavori[RESOCONTO_MAX_THREAD];
+    int n_fasce = formattaInParallelo(&modello, n_allievi, lavori);
+
+    TestoResoconto intestazione;
+    inizializzaBuffer(&intestazione.buf);
+    intestazione.errore = false;
+    scriviIntestazione(&intestazione, n_allievi);
+
+    bool ok = !intestazione.errore;
+    for (int i = 0; i < n_fasce; i++) {
+        ok = ok && !lavori[i].testo.errore;
+    }
+
+    if (!ok) {
+        printf("Errore: memoria insufficiente per il resoconto.\n");
+    } else {
+        FILE* f = fopen(filename, "wb");
+        if (f == NULL) {
+            printf("Errore: impossibile creare il file %s\n", filename);
+            ok = false;
+        } else {
+            // Una scrittura per buffer, nell'ordine delle fasce
+            ok = fwrite(intestazione.buf.dati, 1, intestazione.buf.lunghezza, f) ==
+                 intestazione.buf.lunghezza;
+            for (int i = 0; i < n_fasce && ok; i++) {
+                const Buffer* b = &lavori[i].testo.buf;
+                ok = fwrite(b->dati, 1, b->lunghezza, f) == b->lunghezza;
+            }
+            if (fclose(f) != 0) ok = false;
+            if (!ok) printf("Errore: scrittura del file %s non riuscita.\n", filename);
+        }
+    }
+
+    liberaBuffer(&intestazione.buf);
+    for (int i = 0; i < n_fasce; i++) {
+        liberaBuffer(&lavori[i].testo.buf);
+    }
+    return ok;
+}
+
+bool aggiornaResoconto(const char* filename,
+                       const ListaAllievi* listaA,
+                       const ListaPagamenti* listaP,
+                       const ListaEsami* listaE,
+                       const ListaGuide* listaG,
+                       int* riformattate) {
+    if (riformattate != NULL) *riformattate = 0;
+    if (filename == NULL || listaA == NULL) return false;
+
+    if (cache.valida && strcmp(cache.filename, filename) != 0) {
+        svuotaCache();
+    }
+
+    int n_allievi = getNumeroAllievi(listaA);
+    if (n_allievi > MAX_SEZIONI_RESOCONTO) {
+        return scriviResoconto(filename, listaA, listaP, listaE, listaG);
+    }
+
+    // Nuova disposizione e sezioni da riformattare
+    int ordine[MAX_SEZIONI_RESOCONTO];
+    bool riformattata[MAX_SEZIONI_RESOCONTO] = {false};
+    const Allievo* da_formattare[MAX_SEZIONI_RESOCONTO];
+    TestoResoconto* destinazioni[MAX_SEZIONI_RESOCONTO];
+    int n_da_formattare = 0;
+
+    for (int i = 0; i < n_allievi; i++) {
+        const Allievo* a = getAllievoAtIndex(listaA, i);
+        int pos = sezionePerID(getAllievoID(a));
+        if (pos < 0) {
+            // Cache piena di allievi non piu' presenti: si riparte da zero
+            svuotaCache();
+            return aggiornaResoconto(filename, listaA, listaP, listaE, listaG, riformattate);
+        }
+        ordine[i] = pos;
+
+        SezioneResoconto* s = &cache.sezioni[pos];
+        unsigned long generazione = generazioneAllievo(a, listaP, listaE, listaG);
+        // Diversa, non solo maggiore: una vista puo' essere piu' vecchia delle liste gia' esportate
+        if (!cache.valida || s->offset < 0 || s->testo.errore || generazione != s->generazione) {
+            s->generazione = generazione;
+            da_formattare[n_da_formattare] = a;
+            destinazioni[n_da_formattare] = &s->testo;
+            riformattata[pos] = true;
+            n_da_formattare++;
+        }
+    }
+
+    LavoroResoconto modello;
+    memset(&modello, 0, sizeof(modello));
+    modello.listaA = listaA;
+    modello.listaP = listaP;
+    modello.listaE = listaE;
+    modello.listaG = listaG;
+    modello.allievi = da_formattare;
+    modello.sezioni = destinazioni;
+
+    LavoroResoconto lavori[RESOCONTO_MAX_THREAD];
+    formattaInParallelo(&modello, n_da_formattare, lavori);
+
+    TestoResoconto intestazione;
+    inizializzaBuffer(&intestazione.buf);
+    intestazione.errore = false;
+    scriviIntestazione(&intestazione, n_allievi);
+
+    bool ok = !intestazione.errore;
+    for (int i = 0; i < n_da_formattare; i++) {
+        ok = ok && !destinazioni[i]->errore;
+    }
+    if (!ok) {
+        printf("Errore: memoria insufficiente per il resoconto.\n");
+        liberaBuffer(&intestazione.buf);
+        cache.valida = false;
+        return false;
+    }
+
+    // Il file deve essere ancora quello scritto l'ultima volta
+    FILE* f = cache.valida ? fopen(filename, "r+b") : NULL;
+    bool completo = (f == NULL) || dimensioneFile(f) != cache.dimensione_file;
+    if (f == NULL) f = fopen(filename, "wb");
+    if (f == NULL) {
+        printf("Errore: impossibile creare il file %s\n", filename);
+        liberaBuffer(&intestazione.buf);
+        cache.valida = false;
+        return false;
+    }
+    if (completo) {
+        // Disposizione sul disco sconosciuta: tutte le sezioni vanno riscritte
+        for (int k = 0; k < n_allievi; k++) riformattata[ordine[k]] = true;
+    }
+
+    ok = scriviModifiche(f, ordine, n_allievi, &intestazione, riformattata, completo);
+    if (fclose(f) != 0) ok = false;
+    if (!ok) {
+        printf("Errore: scrittura del file %s non riuscita.\n", filename);
+        liberaBuffer(&intestazione.buf);
+        cache.valida = false;
+        return false;
+    }
+
+    // Registra la nuova disposizione
+    long offset = (long)intestazione.buf.lunghezza;
+    for (int k = 0; k < n_allievi; k++) {
+        SezioneResoconto* s = &cache.sezioni[ordine[k]];
+        s->offset = offset;
+        offset += (long)s->testo.buf.lunghezza;
+        cache.ordine[k] = ordine[k];
+    }
+    cache.n_ordine = n_allievi;
+    cache.dimensione_file = offset;
+    liberaBuffer(&cache.intestazione.buf);
+    cache.intestazione = intestazione;
+    snprintf(cache.filename, sizeof(cache.filename), "%s", filename);
+    cache.valida = true;
+
+    if (riformattate != NULL) *riformattate = n_da_formattare;
+    return true;
+}
+
+void liberaCacheResoconto(void) {
+    svuotaCache();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file resoconto.h
+ * @brief Resoconto testuale completo degli allievi, formattato in parallelo.
+ *
+ * Il resoconto contiene, per ogni allievo, anagrafica, pagamenti, esami con
+ * date dei tentativi, ore di guida ed esito finale. Le sezioni vengono
+ * formattate in memoria da piu' thread e scritte su file nell'ordine della
+ * lista, quindi il contenuto non dipende dal numero di thread usati.
+ *
+ * aggiornaResoconto() conserva in memoria la sezione di ogni allievo e, alle
+ * chiamate successive, riformatta solo gli allievi con record modificati
+ * (allievo, pagamento, esame o guida) e li sostituisce nel file: il costo di
+ * un aggiornamento dipende dalle modifiche, non dal numero di allievi.
+ */
+#ifndef RESOCONTO_H
+#define RESOCONTO_H
+
+#include <stdbool.h>
+
+//COSTANTI PUBBLICHE
+#define RESOCONTO_FILE_PREDEFINITO "resoconto_allievi.txt"
+#define RESOCONTO_MAX_THREAD 16              /**< Thread di formattazione al massimo */
+#define RESOCONTO_MIN_ALLIEVI_PER_THREAD 16  /**< Sotto questa soglia non conviene un thread in piu' */
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Scrive il resoconto completo su file.
+ *
+ * Gli allievi vengono divisi in fasce contigue, una per processore (al
+ * massimo RESOCONTO_MAX_THREAD); ogni fascia viene formattata in un proprio
+ * buffer e i buffer vengono scritti in ordine, una scrittura ciascuno.
+ *
+ * @param filename File di destinazione (sovrascritto).
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ * @return true se il file e' stato scritto per intero.
+ */
+bool scriviResoconto(const char* filename,
+                     const ListaAllievi* listaA,
+                     const ListaPagamenti* listaP,
+                     const ListaEsami* listaE,
+                     const ListaGuide* listaG);
+
+/**
+ * @brief Aggiorna il resoconto riformattando solo gli allievi modificati.
+ *
+ * La prima chiamata (o dopo un cambio di file) formatta tutti gli allievi.
+ * Le successive riformattano le sezioni degli allievi i cui record sono
+ * cambiati dall'ultimo aggiornamento (vedi getGenerazioneRecord()) e nel
+ * file riscrivono in posizione le sezioni di lunghezza invariata; dalla
+ * prima sezione che cambia lunghezza o posizione viene riscritta la coda.
+ * Se il file e' stato modificato o rimosso nel frattempo viene riscritto per
+ * intero dalle sezioni in memoria. Il contenuto e' identico a quello di
+ * scriviResoconto().
+ *
+ * @param filename File di destinazione.
+ * @param listaA Puntatore alla lista degli allievi.
+ * @param listaP Puntatore alla lista dei pagamenti.
+ * @param listaE Puntatore alla lista degli esami.
+ * @param listaG Puntatore alla lista delle guide.
+ * @param riformattate Se non NULL, riceve il numero di sezioni riformattate.
+ * @return true se il file e' aggiornato.
+ */
+bool aggiornaResoconto(const char* filename,
+                       const ListaAllievi* listaA,
+                       const ListaPagamenti* listaP,
+                       const ListaEsami* listaE,
+                       const ListaGuide* listaG,
+                       int* riformattate);
+
+/**
+ * @brief Libera le sezioni conservate da aggiornaResoconto().
+ */
+void liberaCacheResoconto(void);
+
+#endif // RESOCONTO_H
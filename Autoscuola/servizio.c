@@ -0,0 +1,1142 @@
+/**
+ * @file servizio.c
+ * @brief Implementazione del servizio su socket Unix (ciclo epoll e lavoratori).
+ *
+ * Proprieta' di una connessione:
+ * - il ciclo la crea, ne legge i byte e la chiude; e' l'unico a usare
+ *   epoll_ctl() e close() sul descrittore
+ * - quando arrivano messaggi completi e nessun lavoratore la sta servendo,
+ *   il ciclo la segna `in_lavorazione` e la accoda; il lavoratore esegue
+ *   tutti i messaggi completi, poi tenta di inviare le risposte
+ * - se restano byte da inviare o la connessione va chiusa, il lavoratore la
+ *   segnala al ciclo tramite l'eventfd; una connessione non viene chiusa
+ *   finche' e' in lavorazione o segnalata
+ *
+ * Le scritture vengono accodate al giornale (giornale.h) dentro la sezione
+ * di scrittura, prima di essere applicate: l'ordine delle voci e' quindi
+ * quello in cui le scritture sono state applicate alle liste.
+ *
+ * Ordine dei lock: mutex della connessione, poi mutex della coda.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE   // accept4
+#endif
+
+#include <stdio.h>
+#include "servizio.h"
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include "protocollo.h"
+#include "codifica.h"
+#include "condivisi.h"
+#include "allievi.h"
+#include "pagamenti.h"
+#include "esami.h"
+#include "guida.h"
+#include "uscita.h"
+#include "difensiva.h"
+#include "autosalvataggio.h"
+#include "giornale.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+#define MAX_EVENTI 64
+#define DIM_LETTURA (64 * 1024)                         /**< Byte letti per evento */
+#define MAX_INGRESSO (2 * (PROTOCOLLO_MAX_CORPO + PROTOCOLLO_DIM_LUNGHEZZA)) /**< Oltre, si smette di leggere */
+#define INTERVALLO_CICLO_MS 1000                        /**< Attesa massima tra due punti di autosalvataggio */
+
+/**
+ * @struct Connessione
+ * @brief Stato di un client.
+ */
+typedef struct Connessione {
+    int fd;
+    pthread_mutex_t mutex;
+    Buffer ingresso;             /**< Byte ricevuti */
+    size_t consumati;            /**< Byte di `ingresso` gia' eseguiti */
+    Buffer uscita;               /**< Risposte da inviare */
+    size_t inviati;              /**< Byte di `uscita` gia' inviati */
+    bool in_lavorazione;         /**< In coda o affidata a un lavoratore */
+    bool fine_ingresso;          /**< Il client ha chiuso il proprio lato */
+    bool errore;                 /**< Da chiudere senza altre risposte */
+    uint32_t interessi;          /**< Eventi epoll registrati (solo ciclo) */
+    struct Connessione* successiva_coda;
+    struct Connessione* successiva_segnalata;
+    bool segnalata;              /**< Nell'elenco delle segnalazioni (protetto dal mutex della coda) */
+    struct Connessione* precedente;  /**< Elenco di tutte le connessioni (solo ciclo) */
+    struct Connessione* successiva;
+} Connessione;
+
+/**
+ * @struct Servizio
+ * @brief Stato condiviso da ciclo e lavoratori.
+ */
+typedef struct {
+    DatiCondivisi* dati;
+    int epoll;
+    int ascolto;
+    int segnalazioni;            /**< eventfd: connessioni da aggiornare */
+    int segnali;                 /**< signalfd: SIGINT e SIGTERM */
+
+    pthread_mutex_t mutex_coda;
+    pthread_cond_t lavoro;
+    Connessione* prima;          /**< Connessioni da servire */
+    Connessione* ultima;
+    Connessione* segnalate;
+    bool arresto;
+
+    Connessione* connessioni;
+} Servizio;
+
+/**
+ * @struct Richiesta
+ * @brief Campi decodificati di una richiesta e risposta in composizione.
+ */
+typedef struct {
+    Lettore lettore;
+    Buffer* risposta;
+    const unsigned char* messaggio;  /**< Messaggio completo (prefisso compreso), per il giornale */
+    size_t dim_messaggio;
+    unsigned char operazione;
+    int id;
+    int valori[5];
+    float importo;
+    bool penalita;               /**< Esami: penalita' applicate */
+    int esito;
+} Richiesta;
+
+/**
+ * @struct GruppoScritture
+ * @brief Scritture applicate in una sola sezione e registrate con una sola voce del giornale.
+ */
+typedef struct {
+    Richiesta* voci;
+    int n;
+    const Buffer* giornale;      /**< Messaggi delle voci da applicare, in ordine */
+} GruppoScritture;
+
+/**
+ * @struct AreaLavoro
+ * @brief Buffer di un lavoratore, riusati da una richiesta all'altra.
+ */
+typedef struct {
+    Buffer messaggi;             /**< Copia dei messaggi da eseguire */
+    Buffer voci;                 /**< Richieste del gruppo in corso (array di Richiesta) */
+    Buffer giornale;             /**< Voce del giornale del gruppo in corso */
+    Buffer risposte;
+} AreaLavoro;
+
+/**
+ * @struct RipristinoGiornale
+ * @brief Contesto di riapplicaGiornale().
+ */
+typedef struct {
+    ListeCondivise liste;
+    Buffer voci;                 /**< Richieste della voce in corso (array di Richiesta) */
+    int applicate;
+} RipristinoGiornale;
+
+//ESECUZIONE DELLE RICHIESTE (PRIVATE)
+
+/**
+ * @brief Vero se la richiesta e' stata letta per intero e senza byte in piu'.
+ */
+static bool richiestaCompleta(const Richiesta* r) {
+    return !r->lettore.errore && r->lettore.pos == r->lettore.fine;
+}
+
+/**
+ * @brief Sezioni da acquisire per una scrittura; 0 se l'operazione non e' una scrittura.
+ */
+static unsigned int accessoScrittura(unsigned char operazione) {
+    switch (operazione) {
+        case OP_REGISTRA_ORE: return ACCESSO_ALLIEVI | ACCESSO_GUIDE;
+        case OP_REGISTRA_ESAME: return ACCESSO_TUTTE;
+        case OP_AGGIUNGI_RATA: return ACCESSO_ALLIEVI | ACCESSO_PAGAMENTI;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Esegue una lettura su una vista; se non ce ne sono di libere, in una sezione di lettura.
+ */
+static void leggi(DatiCondivisi* dati, OperazioneCondivisa operazione, void* contesto) {
+    if (!leggiVista(dati, operazione, contesto)) {
+        leggiCondivisi(dati, ACCESSO_TUTTE, operazione, contesto);
+    }
+}
+
+/**
+ * @brief Completa una risposta; se supera la dimensione massima resta solo l'esito di errore.
+ */
+static void chiudiRisposta(Buffer* risposta, size_t inizio, unsigned char operazione) {
+    if (!chiudiMessaggio(risposta, inizio)) {
+        inizio = iniziaMessaggio(risposta, operazione);
+        scriviVarintConSegno(risposta, PROTOCOLLO_OPERAZIONE_FALLITA);
+        chiudiMessaggio(risposta, inizio);
+    }
+}
+
+static void cercaAllievoServizio(const ListeCondivise* l, void* contesto) {
+    Richiesta* r = (Richiesta*)contesto;
+    const Allievo* a = cercaAllievoPerID(l->listaA, r->id);
+    if (a == NULL) {
+        r->esito = PROTOCOLLO_NON_TROVATO;
+        return;
+    }
+
+    const Pagamento* p = cercaPagamentoPerID(l->listaP, r->id);
+    const Esame* e = cercaEsamePerID(l->listaE, r->id);
+    const Guida* g = cercaGuidaPerID(l->listaG, r->id);
+    float rate[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    if (p != NULL) {
+        rate[0] = getPrimaRata(p);
+        rate[1] = getSecondaRata(p);
+        rate[2] = getTerzaRata(p);
+        rate[3] = getExtra(p);
+    }
+
+    Buffer* b = r->risposta;
+    bool ok = scriviVarintConSegno(b, PROTOCOLLO_OK) &&
+              scriviVarintConSegno(b, getAllievoID(a)) &&
+              scriviStringa(b, getAllievoNome(a), 30) &&
+              scriviStringa(b, getAllievoCognome(a), 30) &&
+              scriviStringa(b, getAllievoCodiceFiscale(a), 17) &&
+              scriviStringa(b, getAllievoCategoriaPatente(a), 5) &&
+              scriviStringa(b, getAllievoStato(a), 20) &&
+              scriviBuffer(b, rate, sizeof(rate)) &&
+              scriviVarintConSegno(b, (e != NULL) ? getTentativiTeorico(e) : 0) &&
+              scriviVarintConSegno(b, (e != NULL) ? getTentativiPratico(e) : 0) &&
+              scriviByte(b, (unsigned char)((isTeoricoSuperato(e) ? 1u : 0u) |
+                                            (isPraticoSuperato(e) ? 2u : 0u))) &&
+              scriviVarintConSegno(b, (g != NULL) ? getOreSvolte(g) : 0);
+    r->esito = ok ? PROTOCOLLO_OK : PROTOCOLLO_OPERAZIONE_FALLITA;
+}
+
+static void elencoServizio(const ListeCondivise* l, void* contesto) {
+    Richiesta* r = (Richiesta*)contesto;
+    Uscita* u = creaUscitaMemoria();
+    if (u == NULL) {
+        r->esito = PROTOCOLLO_OPERAZIONE_FALLITA;
+        return;
+    }
+
+    switch (r->valori[0]) {
+        case ELENCO_ALLIEVI: stampaAllievi(l->listaA, u); break;
+        case ELENCO_PAGAMENTI: stampaTuttiPagamenti(l->listaP, u); break;
+        case ELENCO_ESAMI: stampaTuttiEsami(l->listaE, u); break;
+        default: stampaTutteGuide(l->listaG, u); break;
+    }
+
+    size_t lunghezza = 0;
+    const char* testo = getTestoUscita(u, &lunghezza);
+    bool ok = testo != NULL &&
+              scriviVarintConSegno(r->risposta, PROTOCOLLO_OK) &&
+              scriviStringa(r->risposta, testo, lunghezza + 1);
+    chiudiUscita(&u);
+    r->esito = ok ? PROTOCOLLO_OK : PROTOCOLLO_OPERAZIONE_FALLITA;
+}
+
+static void registraOreServizio(const ListeCondivise* l, Richiesta* r) {
+    if (cercaAllievoPerID(l->listaA, r->id) == NULL) {
+        r->esito = PROTOCOLLO_NON_TROVATO;
+    } else {
+        r->esito = registraOreGuida(l->listaG, r->id, r->valori[0]) ? PROTOCOLLO_OK
+                                                                    : PROTOCOLLO_OPERAZIONE_FALLITA;
+    }
+}
+
+static void registraEsameServizio(const ListeCondivise* l, Richiesta* r) {
+    if (cercaAllievoPerID(l->listaA, r->id) == NULL) {
+        r->esito = PROTOCOLLO_NON_TROVATO;
+        return;
+    }
+
+    Data data = { r->valori[2], r->valori[3], r->valori[4] };
+    EsitoEsame esito = (r->valori[1] != 0) ? ESITO_SUPERATO : ESITO_NON_SUPERATO;
+    if (r->valori[0] == ESAME_TEORICO) {
+        r->esito = registraEsitoTeorico(l->listaE, r->id, esito, data,
+                                        l->listaA, l->listaP, &r->penalita);
+    } else {
+        const Guida* g = cercaGuidaPerID(l->listaG, r->id);
+        r->esito = registraEsitoPratico(l->listaE, r->id, esito, data,
+                                        (g != NULL) ? getOreSvolte(g) : 0, l->listaP, &r->penalita);
+    }
+}
+
+static void aggiungiRataServizio(const ListeCondivise* l, Richiesta* r) {
+    if (cercaAllievoPerID(l->listaA, r->id) == NULL) {
+        r->esito = PROTOCOLLO_NON_TROVATO;
+    } else {
+        r->esito = aggiungiRata(l->listaP, r->id, r->valori[0], r->importo) ? PROTOCOLLO_OK
+                                                                            : PROTOCOLLO_OPERAZIONE_FALLITA;
+    }
+}
+
+/**
+ * @brief Decodifica una scrittura e ne verifica i campi.
+ *
+ * L'esito resta PROTOCOLLO_OK se la scrittura e' da applicare.
+ *
+ * @param messaggio Messaggio completo, prefisso di lunghezza compreso.
+ * @param n Byte del messaggio.
+ */
+static void decodificaScrittura(Richiesta* r, const unsigned char* messaggio, size_t n) {
+    memset(r, 0, sizeof(*r));
+    r->messaggio = messaggio;
+    r->dim_messaggio = n;
+    inizializzaLettore(&r->lettore, messaggio + PROTOCOLLO_DIM_LUNGHEZZA, n - PROTOCOLLO_DIM_LUNGHEZZA);
+    r->operazione = leggiByte(&r->lettore);
+    r->id = (int)leggiVarintConSegno(&r->lettore);
+
+    bool valida = false;
+    switch (r->operazione) {
+        case OP_REGISTRA_ORE:
+            r->valori[0] = (int)leggiVarintConSegno(&r->lettore);
+            valida = richiestaCompleta(r) && r->valori[0] > 0;
+            break;
+
+        case OP_REGISTRA_ESAME:
+            for (int i = 0; i < 5; i++) {
+                r->valori[i] = (int)leggiVarintConSegno(&r->lettore);
+            }
+            valida = richiestaCompleta(r) &&
+                     (r->valori[0] == ESAME_TEORICO || r->valori[0] == ESAME_PRATICO) &&
+                     (r->valori[1] == ESITO_SUPERATO || r->valori[1] == ESITO_NON_SUPERATO) &&
+                     validaData(r->valori[2], r->valori[3], r->valori[4]);
+            break;
+
+        case OP_AGGIUNGI_RATA:
+            r->valori[0] = (int)leggiVarintConSegno(&r->lettore);
+            leggiByteGrezzi(&r->lettore, &r->importo, sizeof(float));
+            valida = richiestaCompleta(r) && r->valori[0] >= 1 && r->valori[0] <= 4 &&
+                     r->importo >= 0.0f && r->importo <= 1.0e7f;
+            break;
+
+        default:
+            r->esito = PROTOCOLLO_OPERAZIONE_SCONOSCIUTA;
+            return;
+    }
+    r->esito = valida ? PROTOCOLLO_OK : PROTOCOLLO_RICHIESTA_NON_VALIDA;
+}
+
+/**
+ * @brief Applica una scrittura decodificata.
+ * @pre Sezione di scrittura acquisita con accessoScrittura() dell'operazione.
+ */
+static void applicaScrittura(const ListeCondivise* l, Richiesta* r) {
+    switch (r->operazione) {
+        case OP_REGISTRA_ORE: registraOreServizio(l, r); break;
+        case OP_REGISTRA_ESAME: registraEsameServizio(l, r); break;
+        default: aggiungiRataServizio(l, r); break;
+    }
+}
+
+/**
+ * @brief Applica una sequenza di ore di guida con una sola registraOreGuidaInBlocco().
+ *
+ * Le richieste di allievi inesistenti vengono escluse prima del blocco; se
+ * manca memoria per il blocco le ore vengono registrate una per volta.
+ *
+ * @pre Sezione di scrittura acquisita, voci con esito PROTOCOLLO_OK.
+ */
+static void applicaOreInBlocco(const ListeCondivise* l, Richiesta* voci, int n) {
+    LezioneGuida* lezioni = (LezioneGuida*)malloc(sizeof(LezioneGuida) * (size_t)n);
+    Richiesta** richieste = (Richiesta**)malloc(sizeof(Richiesta*) * (size_t)n);
+    bool* registrate = (bool*)malloc(sizeof(bool) * (size_t)n);
+    if (lezioni == NULL || richieste == NULL || registrate == NULL) {
+        for (int i = 0; i < n; i++) {
+            registraOreServizio(l, &voci[i]);
+        }
+    } else {
+        int k = 0;
+        for (int i = 0; i < n; i++) {
+            if (cercaAllievoPerID(l->listaA, voci[i].id) == NULL) {
+                voci[i].esito = PROTOCOLLO_NON_TROVATO;
+                continue;
+            }
+            lezioni[k].id_allievo = voci[i].id;
+            lezioni[k].ore = voci[i].valori[0];
+            richieste[k++] = &voci[i];
+        }
+        registraOreGuidaInBlocco(l->listaG, lezioni, k, registrate);
+        for (int i = 0; i < k; i++) {
+            richieste[i]->esito = registrate[i] ? PROTOCOLLO_OK : PROTOCOLLO_OPERAZIONE_FALLITA;
+        }
+    }
+    free(lezioni);
+    free(richieste);
+    free(registrate);
+}
+
+/**
+ * @brief Applica, nell'ordine, le scritture valide di un gruppo.
+ *
+ * Le ore di guida consecutive vengono registrate in blocco: una ricerca e un
+ * ricalcolo delle ore extra per allievo invece che per lezione.
+ *
+ * @pre Sezione di scrittura acquisita con accessoScrittura() di tutte le voci.
+ */
+static void applicaScritture(const ListeCondivise* l, Richiesta* voci, int n) {
+    int i = 0;
+    while (i < n) {
+        if (voci[i].esito != PROTOCOLLO_OK) {
+            i++;
+            continue;
+        }
+        int fine = i + 1;
+        if (voci[i].operazione == OP_REGISTRA_ORE) {
+            while (fine < n && voci[fine].esito == PROTOCOLLO_OK &&
+                   voci[fine].operazione == OP_REGISTRA_ORE) {
+                fine++;
+            }
+        }
+        if (fine - i > 1) {
+            applicaOreInBlocco(l, voci + i, fine - i);
+        } else {
+            applicaScrittura(l, &voci[i]);
+        }
+        i = fine;
+    }
+}
+
+/**
+ * @brief Registra il gruppo nel giornale e, solo se la voce e' su disco, lo applica.
+ */
+static void applicaGruppo(const ListeCondivise* l, void* contesto) {
+    GruppoScritture* g = (GruppoScritture*)contesto;
+    if (accodaGiornale(g->giornale->dati, g->giornale->lunghezza)) {
+        applicaScritture(l, g->voci, g->n);
+        return;
+    }
+
+    for (int i = 0; i < g->n; i++) {
+        if (g->voci[i].esito == PROTOCOLLO_OK) g->voci[i].esito = PROTOCOLLO_GIORNALE_NON_SCRITTO;
+    }
+}
+
+/**
+ * @brief Esegue le scritture decodificate di un gruppo con una sola sezione di scrittura.
+ * @param giornale Buffer in cui comporre la voce del giornale.
+ */
+static void eseguiGruppo(DatiCondivisi* dati, Richiesta* voci, int n, Buffer* giornale) {
+    unsigned int accesso = 0;
+    bool ok = true;
+    svuotaBuffer(giornale);
+    for (int i = 0; i < n && ok; i++) {
+        if (voci[i].esito != PROTOCOLLO_OK) continue;
+        accesso |= accessoScrittura(voci[i].operazione);
+        ok = scriviBuffer(giornale, voci[i].messaggio, voci[i].dim_messaggio);
+    }
+
+    if (!ok) {
+        for (int i = 0; i < n; i++) {
+            if (voci[i].esito == PROTOCOLLO_OK) voci[i].esito = PROTOCOLLO_OPERAZIONE_FALLITA;
+        }
+        return;
+    }
+    if (accesso == 0) return;
+
+    GruppoScritture g = { voci, n, giornale };
+    scriviInLotto(dati, accesso, applicaGruppo, &g);
+}
+
+/**
+ * @brief Scrive l'esito di una scrittura e, per un esame valutato, il flag delle penalita'.
+ */
+static void scriviEsitoScrittura(Buffer* risposta, const Richiesta* r) {
+    scriviVarintConSegno(risposta, r->esito);
+    if (r->operazione == OP_REGISTRA_ESAME &&
+        r->esito <= ESAME_OK && r->esito >= ESAME_GIA_SUPERATO) {
+        scriviByte(risposta, r->penalita ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Posto per la k-esima richiesta del gruppo in corso.
+ * @return Puntatore al posto, NULL se manca memoria.
+ */
+static Richiesta* postoRichiesta(AreaLavoro* area, int k) {
+    if (!riservaBuffer(&area->voci, (size_t)(k + 1) * sizeof(Richiesta))) return NULL;
+    return (Richiesta*)area->voci.dati + k;
+}
+
+/**
+ * @brief Esegue una richiesta di lettura (o sconosciuta), accodando la risposta.
+ * @param corpo Corpo del messaggio (senza prefisso di lunghezza).
+ */
+static void eseguiLettura(DatiCondivisi* dati, const unsigned char* corpo, size_t n, Buffer* risposta) {
+    Richiesta r;
+    memset(&r, 0, sizeof(r));
+    inizializzaLettore(&r.lettore, corpo, n);
+    r.risposta = risposta;
+    r.esito = PROTOCOLLO_RICHIESTA_NON_VALIDA;
+
+    unsigned char operazione = leggiByte(&r.lettore);
+    size_t inizio = iniziaMessaggio(risposta, operazione);
+    size_t dati_risposta = risposta->lunghezza;
+    r.id = (int)leggiVarintConSegno(&r.lettore);
+
+    switch (operazione) {
+        case OP_CERCA_ALLIEVO:
+            if (richiestaCompleta(&r)) leggi(dati, cercaAllievoServizio, &r);
+            break;
+
+        case OP_RESOCONTO:
+            // L'elenco non ha ID: il campo letto e' il tipo di elenco
+            r.valori[0] = r.id;
+            if (richiestaCompleta(&r) && r.valori[0] >= ELENCO_ALLIEVI && r.valori[0] <= ELENCO_GUIDE) {
+                leggi(dati, elencoServizio, &r);
+            }
+            break;
+
+        default:
+            r.esito = PROTOCOLLO_OPERAZIONE_SCONOSCIUTA;
+            break;
+    }
+
+    // Chi ha scritto dati ha scritto anche l'esito; altrimenti solo l'esito
+    if (risposta->lunghezza == dati_risposta || r.esito != PROTOCOLLO_OK) {
+        risposta->lunghezza = dati_risposta;
+        scriviVarintConSegno(risposta, r.esito);
+    }
+    chiudiRisposta(risposta, inizio, operazione);
+}
+
+/**
+ * @brief Esegue un OP_LOTTO: le voci formano un solo gruppo, con un esito per voce.
+ * @param corpo Corpo del messaggio (senza prefisso di lunghezza).
+ */
+static void eseguiLotto(DatiCondivisi* dati, AreaLavoro* area, const unsigned char* corpo, size_t n) {
+    Lettore lettore;
+    inizializzaLettore(&lettore, corpo, n);
+    leggiByte(&lettore);
+    int64_t numero = leggiVarintConSegno(&lettore);
+
+    int k = 0;
+    int esito = (!lettore.errore && numero >= 0) ? PROTOCOLLO_OK : PROTOCOLLO_RICHIESTA_NON_VALIDA;
+    while (esito == PROTOCOLLO_OK && k < numero) {
+        bool non_valido = false;
+        size_t dim = misuraMessaggio(lettore.pos, (size_t)(lettore.fine - lettore.pos), &non_valido);
+        Richiesta* r = (dim > 0) ? postoRichiesta(area, k) : NULL;
+        if (r == NULL) {
+            esito = (dim > 0) ? PROTOCOLLO_OPERAZIONE_FALLITA : PROTOCOLLO_RICHIESTA_NON_VALIDA;
+            break;
+        }
+        decodificaScrittura(r, lettore.pos, dim);
+        lettore.pos += dim;
+        k++;
+    }
+    if (esito == PROTOCOLLO_OK && lettore.pos != lettore.fine) esito = PROTOCOLLO_RICHIESTA_NON_VALIDA;
+
+    Buffer* risposta = &area->risposte;
+    size_t inizio = iniziaMessaggio(risposta, OP_LOTTO);
+    scriviVarintConSegno(risposta, esito);
+    if (esito == PROTOCOLLO_OK) {
+        Richiesta* voci = (Richiesta*)area->voci.dati;
+        eseguiGruppo(dati, voci, k, &area->giornale);
+        scriviVarintConSegno(risposta, k);
+        for (int i = 0; i < k; i++) {
+            scriviEsitoScrittura(risposta, &voci[i]);
+        }
+    }
+    chiudiRisposta(risposta, inizio, OP_LOTTO);
+}
+
+/**
+ * @brief Esegue i messaggi completi copiati in `area->messaggi`, accodando le risposte.
+ *
+ * Le scritture consecutive formano un solo gruppo (eseguiGruppo()): chi
+ * invia molte scritture senza attendere le risposte paga una sola sezione di
+ * scrittura e una sola voce del giornale per ogni blocco ricevuto.
+ */
+static void eseguiMessaggi(DatiCondivisi* dati, AreaLavoro* area) {
+    const unsigned char* messaggi = area->messaggi.dati;
+    size_t totale = area->messaggi.lunghezza;
+    size_t pos = 0;
+
+    while (pos < totale) {
+        bool non_valido = false;
+        size_t n = misuraMessaggio(messaggi + pos, totale - pos, &non_valido);
+        unsigned char operazione = messaggi[pos + PROTOCOLLO_DIM_LUNGHEZZA];
+
+        if (accessoScrittura(operazione) == 0) {
+            if (operazione == OP_LOTTO) {
+                eseguiLotto(dati, area, messaggi + pos + PROTOCOLLO_DIM_LUNGHEZZA,
+                            n - PROTOCOLLO_DIM_LUNGHEZZA);
+            } else {
+                eseguiLettura(dati, messaggi + pos + PROTOCOLLO_DIM_LUNGHEZZA,
+                              n - PROTOCOLLO_DIM_LUNGHEZZA, &area->risposte);
+            }
+            pos += n;
+            continue;
+        }
+
+        int k = 0;
+        Richiesta* r;
+        while (pos < totale && (r = postoRichiesta(area, k)) != NULL) {
+            n = misuraMessaggio(messaggi + pos, totale - pos, &non_valido);
+            if (accessoScrittura(messaggi[pos + PROTOCOLLO_DIM_LUNGHEZZA]) == 0) break;
+            decodificaScrittura(r, messaggi + pos, n);
+            pos += n;
+            k++;
+        }
+        if (k == 0) {
+            // Memoria esaurita: la scrittura viene rifiutata senza eseguirla
+            size_t inizio = iniziaMessaggio(&area->risposte, operazione);
+            scriviVarintConSegno(&area->risposte, PROTOCOLLO_OPERAZIONE_FALLITA);
+            chiudiRisposta(&area->risposte, inizio, operazione);
+            pos += n;
+            continue;
+        }
+
+        Richiesta* voci = (Richiesta*)area->voci.dati;
+        eseguiGruppo(dati, voci, k, &area->giornale);
+        for (int i = 0; i < k; i++) {
+            size_t inizio = iniziaMessaggio(&area->risposte, voci[i].operazione);
+            scriviEsitoScrittura(&area->risposte, &voci[i]);
+            chiudiRisposta(&area->risposte, inizio, voci[i].operazione);
+        }
+    }
+}
+
+/**
+ * @brief Riapplica alle liste le scritture di una voce del giornale.
+ *
+ * La voce e' un gruppo: viene applicata come in applicaGruppo(), cosi' gli
+ * esiti coincidono con quelli dati ai client.
+ */
+static void riapplicaVoce(const unsigned char* dati, size_t n, void* contesto) {
+    RipristinoGiornale* rg = (RipristinoGiornale*)contesto;
+    size_t pos = 0;
+    bool non_valido = false;
+    size_t dim;
+    int k = 0;
+    while (pos < n && (dim = misuraMessaggio(dati + pos, n - pos, &non_valido)) > 0) {
+        if (!riservaBuffer(&rg->voci, (size_t)(k + 1) * sizeof(Richiesta))) break;
+        Richiesta* r = (Richiesta*)rg->voci.dati + k;
+        decodificaScrittura(r, dati + pos, dim);
+        pos += dim;
+        k++;
+    }
+
+    Richiesta* voci = (Richiesta*)rg->voci.dati;
+    applicaScritture(&rg->liste, voci, k);
+    for (int i = 0; i < k; i++) {
+        if (voci[i].esito == PROTOCOLLO_OK) rg->applicate++;
+    }
+}
+
+
+//CONNESSIONI (PRIVATE)
+
+/**
+ * @brief Invia quanto possibile delle risposte accumulate, senza bloccare.
+ * @pre Mutex della connessione acquisito.
+ */
+static void inviaUscita(Connessione* c) {
+    while (!c->errore && c->inviati < c->uscita.lunghezza) {
+        ssize_t n = send(c->fd, c->uscita.dati + c->inviati, c->uscita.lunghezza - c->inviati, MSG_NOSIGNAL);
+        if (n > 0) {
+            c->inviati += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) c->errore = true;
+            break;
+        }
+    }
+    if (c->errore || c->inviati == c->uscita.lunghezza) {
+        svuotaBuffer(&c->uscita);
+        c->inviati = 0;
+    }
+}
+
+/**
+ * @brief Misura il prossimo messaggio da eseguire; un messaggio non valido segna l'errore.
+ * @pre Mutex della connessione acquisito.
+ * @return Byte del messaggio, 0 se non e' ancora arrivato per intero o la connessione e' in errore.
+ */
+static size_t messaggioPronto(Connessione* c) {
+    bool non_valido = false;
+    size_t n = misuraMessaggio(c->ingresso.dati + c->consumati,
+                               c->ingresso.lunghezza - c->consumati, &non_valido);
+    if (non_valido) c->errore = true;
+    return c->errore ? 0 : n;
+}
+
+/**
+ * @brief Eventi epoll che la connessione deve ricevere.
+ * @pre Mutex della connessione acquisito.
+ */
+static uint32_t interessiConnessione(const Connessione* c) {
+    uint32_t eventi = 0;
+    if (!c->fine_ingresso && !c->errore &&
+        c->ingresso.lunghezza - c->consumati < MAX_INGRESSO) eventi |= EPOLLIN;
+    if (!c->errore && c->inviati < c->uscita.lunghezza) eventi |= EPOLLOUT;
+    return eventi;
+}
+
+static void liberaConnessione(Servizio* s, Connessione* c) {
+    if (c->precedente != NULL) {
+        c->precedente->successiva = c->successiva;
+    } else {
+        s->connessioni = c->successiva;
+    }
+    if (c->successiva != NULL) c->successiva->precedente = c->precedente;
+
+    epoll_ctl(s->epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    pthread_mutex_destroy(&c->mutex);
+    liberaBuffer(&c->ingresso);
+    liberaBuffer(&c->uscita);
+    free(c);
+}
+
+/**
+ * @brief Accoda una connessione per i lavoratori.
+ * @pre Mutex della connessione acquisito.
+ */
+static void accodaConnessione(Servizio* s, Connessione* c) {
+    c->in_lavorazione = true;
+    c->successiva_coda = NULL;
+    pthread_mutex_lock(&s->mutex_coda);
+    if (s->ultima != NULL) {
+        s->ultima->successiva_coda = c;
+    } else {
+        s->prima = c;
+    }
+    s->ultima = c;
+    pthread_cond_signal(&s->lavoro);
+    pthread_mutex_unlock(&s->mutex_coda);
+}
+
+/**
+ * @brief Segnala al ciclo una connessione da aggiornare.
+ * @pre Mutex della connessione acquisito.
+ */
+static void segnalaConnessione(Servizio* s, Connessione* c) {
+    pthread_mutex_lock(&s->mutex_coda);
+    if (!c->segnalata) {
+        c->segnalata = true;
+        c->successiva_segnalata = s->segnalate;
+        s->segnalate = c;
+    }
+    pthread_mutex_unlock(&s->mutex_coda);
+
+    uint64_t uno = 1;
+    ssize_t scritti = write(s->segnalazioni, &uno, sizeof(uno));
+    (void)scritti;  // Se il contatore e' gia' alto il ciclo e' comunque sveglio
+}
+
+/**
+ * @brief Invia, aggiorna gli eventi registrati o chiude la connessione (solo ciclo).
+ */
+static void aggiornaConnessione(Servizio* s, Connessione* c) {
+    pthread_mutex_lock(&c->mutex);
+    if (!c->in_lavorazione) inviaUscita(c);
+
+    pthread_mutex_lock(&s->mutex_coda);
+    bool segnalata = c->segnalata;
+    pthread_mutex_unlock(&s->mutex_coda);
+
+    bool da_chiudere = !c->in_lavorazione && !segnalata &&
+                       (c->errore || (c->fine_ingresso && c->uscita.lunghezza == 0));
+    if (!da_chiudere) {
+        uint32_t interessi = interessiConnessione(c);
+        if (interessi != c->interessi) {
+            struct epoll_event ev = { .events = interessi, .data.ptr = c };
+            epoll_ctl(s->epoll, EPOLL_CTL_MOD, c->fd, &ev);
+            c->interessi = interessi;
+        }
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    if (da_chiudere) liberaConnessione(s, c);
+}
+
+/**
+ * @brief Legge i byte disponibili e, se c'e' un messaggio completo, accoda la connessione.
+ */
+static void riceviConnessione(Servizio* s, Connessione* c) {
+    pthread_mutex_lock(&c->mutex);
+    if (riservaBuffer(&c->ingresso, c->ingresso.lunghezza + DIM_LETTURA)) {
+        ssize_t n = recv(c->fd, c->ingresso.dati + c->ingresso.lunghezza, DIM_LETTURA, 0);
+        if (n > 0) {
+            c->ingresso.lunghezza += (size_t)n;
+        } else if (n == 0) {
+            c->fine_ingresso = true;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            c->errore = true;
+        }
+    } else {
+        c->errore = true;
+    }
+
+    if (!c->in_lavorazione && messaggioPronto(c) > 0) accodaConnessione(s, c);
+    pthread_mutex_unlock(&c->mutex);
+
+    aggiornaConnessione(s, c);
+}
+
+/**
+ * @brief Esegue tutti i messaggi completi di una connessione (lavoratore).
+ */
+static void serviConnessione(Servizio* s, Connessione* c, AreaLavoro* area) {
+    pthread_mutex_lock(&c->mutex);
+    while (true) {
+        size_t inizio = c->consumati;
+        size_t n;
+        while ((n = messaggioPronto(c)) > 0) {
+            c->consumati += n;
+        }
+        if (c->consumati == inizio) break;
+
+        // Il ciclo puo' riallocare l'ingresso mentre le richieste vengono eseguite
+        svuotaBuffer(&area->messaggi);
+        if (!scriviBuffer(&area->messaggi, c->ingresso.dati + inizio, c->consumati - inizio)) {
+            c->errore = true;
+            break;
+        }
+        pthread_mutex_unlock(&c->mutex);
+
+        svuotaBuffer(&area->risposte);
+        eseguiMessaggi(s->dati, area);
+
+        pthread_mutex_lock(&c->mutex);
+        if (!scriviBuffer(&c->uscita, area->risposte.dati, area->risposte.lunghezza)) c->errore = true;
+    }
+
+    // Compatta l'ingresso gia' eseguito
+    if (c->consumati > 0) {
+        size_t resto = c->ingresso.lunghezza - c->consumati;
+        if (resto > 0) memmove(c->ingresso.dati, c->ingresso.dati + c->consumati, resto);
+        c->ingresso.lunghezza = resto;
+        c->consumati = 0;
+    }
+
+    inviaUscita(c);
+    c->in_lavorazione = false;
+    if (c->errore || c->fine_ingresso || c->uscita.lunghezza > 0 ||
+        interessiConnessione(c) != c->interessi) {
+        segnalaConnessione(s, c);
+    }
+    pthread_mutex_unlock(&c->mutex);
+}
+
+static void* threadLavoratore(void* arg) {
+    Servizio* s = (Servizio*)arg;
+    AreaLavoro area;
+    inizializzaBuffer(&area.messaggi);
+    inizializzaBuffer(&area.voci);
+    inizializzaBuffer(&area.giornale);
+    inizializzaBuffer(&area.risposte);
+
+    pthread_mutex_lock(&s->mutex_coda);
+    while (true) {
+        while (!s->arresto && s->prima == NULL) {
+            pthread_cond_wait(&s->lavoro, &s->mutex_coda);
+        }
+        if (s->arresto) break;
+
+        Connessione* c = s->prima;
+        s->prima = c->successiva_coda;
+        if (s->prima == NULL) s->ultima = NULL;
+        pthread_mutex_unlock(&s->mutex_coda);
+
+        serviConnessione(s, c, &area);
+
+        pthread_mutex_lock(&s->mutex_coda);
+    }
+    pthread_mutex_unlock(&s->mutex_coda);
+
+    liberaBuffer(&area.messaggi);
+    liberaBuffer(&area.voci);
+    liberaBuffer(&area.giornale);
+    liberaBuffer(&area.risposte);
+    return NULL;
+}
+
+//CICLO DEGLI EVENTI (PRIVATE)
+
+static void accettaConnessioni(Servizio* s) {
+    while (true) {
+        int fd = accept4(s->ascolto, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return;
+        }
+
+        Connessione* c = (Connessione*)calloc(1, sizeof(Connessione));
+        if (c == NULL) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->interessi = EPOLLIN;
+        pthread_mutex_init(&c->mutex, NULL);
+        inizializzaBuffer(&c->ingresso);
+        inizializzaBuffer(&c->uscita);
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = c };
+        if (epoll_ctl(s->epoll, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            pthread_mutex_destroy(&c->mutex);
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->successiva = s->connessioni;
+        if (s->connessioni != NULL) s->connessioni->precedente = c;
+        s->connessioni = c;
+    }
+}
+
+/**
+ * @brief Aggiorna le connessioni segnalate dai lavoratori.
+ */
+static void gestisciSegnalazioni(Servizio* s) {
+    uint64_t contatore;
+    ssize_t letti = read(s->segnalazioni, &contatore, sizeof(contatore));
+    (void)letti;
+
+    pthread_mutex_lock(&s->mutex_coda);
+    Connessione* c = s->segnalate;
+    s->segnalate = NULL;
+    pthread_mutex_unlock(&s->mutex_coda);
+
+    // Finche' e' segnalata una connessione non puo' essere riaccodata qui,
+    // quindi il collegamento alla successiva resta valido fino all'azzeramento
+    while (c != NULL) {
+        pthread_mutex_lock(&s->mutex_coda);
+        Connessione* successiva = c->successiva_segnalata;
+        c->segnalata = false;
+        pthread_mutex_unlock(&s->mutex_coda);
+
+        aggiornaConnessione(s, c);
+        c = successiva;
+    }
+}
+
+/**
+ * @brief Crea il socket di ascolto; rifiuta un percorso gia' servito da un altro processo.
+ */
+static int apriSocketAscolto(const char* percorso) {
+    struct sockaddr_un indirizzo;
+    memset(&indirizzo, 0, sizeof(indirizzo));
+    indirizzo.sun_family = AF_UNIX;
+    if (strlen(percorso) >= sizeof(indirizzo.sun_path)) {
+        printf("Errore: percorso del socket troppo lungo.\n");
+        return -1;
+    }
+    strcpy(indirizzo.sun_path, percorso);
+
+    // Un socket rimasto da un servizio terminato male si puo' rimuovere
+    int prova = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (prova >= 0) {
+        bool attivo = connect(prova, (struct sockaddr*)&indirizzo, sizeof(indirizzo)) == 0;
+        close(prova);
+        if (attivo) {
+            printf("Errore: un servizio e' gia' attivo su %s.\n", percorso);
+            return -1;
+        }
+    }
+    unlink(percorso);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 ||
+        bind(fd, (struct sockaddr*)&indirizzo, sizeof(indirizzo)) != 0 ||
+        chmod(percorso, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        printf("Errore: impossibile aprire il socket %s (%s).\n", percorso, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool registraDescrittore(int epoll, int fd, void* dato) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = dato };
+    return epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/**
+ * @brief Ciclo degli eventi, fino a SIGINT o SIGTERM.
+ */
+static void cicloEventi(Servizio* s) {
+    struct epoll_event eventi[MAX_EVENTI];
+    bool fine = false;
+    time_t ultimo_punto = time(NULL);
+
+    while (!fine) {
+        int n = epoll_wait(s->epoll, eventi, MAX_EVENTI, INTERVALLO_CICLO_MS);
+        if (n < 0 && errno != EINTR) {
+            printf("Errore: attesa degli eventi fallita (%s).\n", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            void* dato = eventi[i].data.ptr;
+            if (dato == &s->ascolto) {
+                accettaConnessioni(s);
+            } else if (dato == &s->segnalazioni) {
+                gestisciSegnalazioni(s);
+            } else if (dato == &s->segnali) {
+                // Letto qui, il segnale non resta pendente quando la maschera viene ripristinata
+                struct signalfd_siginfo info;
+                ssize_t letti = read(s->segnali, &info, sizeof(info));
+                (void)letti;
+                fine = true;
+            } else {
+                Connessione* c = (Connessione*)dato;
+                if (eventi[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    riceviConnessione(s, c);
+                } else {
+                    aggiornaConnessione(s, c);
+                }
+            }
+        }
+
+        // Le liste si leggono solo in una sezione: l'autosalvataggio copia i blocchi modificati
+        time_t adesso = time(NULL);
+        if (adesso != ultimo_punto) {
+            iniziaLettura(s->dati, ACCESSO_TUTTE);
+            const ListeCondivise* l = getListeCondivise(s->dati);
+            puntoDiAutosalvataggio(l->listaA, l->listaP, l->listaE, l->listaG);
+            terminaLettura(s->dati, ACCESSO_TUTTE);
+            ultimo_punto = adesso;
+        }
+    }
+}
+
+/**
+ * @brief Numero di processori disponibili (almeno 1).
+ */
+static int numeroProcessori(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+//FUNZIONI PUBBLICHE
+
+int riapplicaGiornale(ListaAllievi* listaA, ListaPagamenti* listaP,
+                      ListaEsami* listaE, ListaGuide* listaG, uint64_t impronta_dati) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return -1;
+
+    RipristinoGiornale rg;
+    rg.liste = (ListeCondivise){ listaA, listaP, listaE, listaG };
+    rg.applicate = 0;
+    inizializzaBuffer(&rg.voci);
+
+    int lette = leggiGiornale(impronta_dati, riapplicaVoce, &rg);
+    liberaBuffer(&rg.voci);
+    return (lette >= 0) ? rg.applicate : -1;
+}
+
+bool eseguiServizio(const char* percorso, int n_lavoratori,
+                    ListaAllievi* listaA, ListaPagamenti* listaP,
+                    ListaEsami* listaE, ListaGuide* listaG) {
+    if (listaA == NULL || listaP == NULL || listaE == NULL || listaG == NULL) return false;
+    if (percorso == NULL) percorso = SERVIZIO_SOCKET_PREDEFINITO;
+    if (n_lavoratori <= 0) n_lavoratori = numeroProcessori();
+    if (n_lavoratori > SERVIZIO_MAX_LAVORATORI) n_lavoratori = SERVIZIO_MAX_LAVORATORI;
+
+    Servizio s;
+    memset(&s, 0, sizeof(s));
+    s.epoll = s.ascolto = s.segnalazioni = s.segnali = -1;
+    pthread_mutex_init(&s.mutex_coda, NULL);
+    pthread_cond_init(&s.lavoro, NULL);
+
+    // I segnali di arresto arrivano solo dal signalfd, in tutti i thread
+    sigset_t arresto, precedenti;
+    sigemptyset(&arresto);
+    sigaddset(&arresto, SIGINT);
+    sigaddset(&arresto, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &arresto, &precedenti);
+
+    s.dati = creaDatiCondivisi(listaA, listaP, listaE, listaG);
+    bool ok = s.dati != NULL && attivaVisteCondivise(s.dati);
+    if (ok) {
+        s.ascolto = apriSocketAscolto(percorso);
+        s.epoll = epoll_create1(EPOLL_CLOEXEC);
+        s.segnalazioni = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        s.segnali = signalfd(-1, &arresto, SFD_NONBLOCK | SFD_CLOEXEC);
+        ok = s.ascolto >= 0 && s.epoll >= 0 && s.segnalazioni >= 0 && s.segnali >= 0 &&
+             registraDescrittore(s.epoll, s.ascolto, &s.ascolto) &&
+             registraDescrittore(s.epoll, s.segnalazioni, &s.segnalazioni) &&
+             registraDescrittore(s.epoll, s.segnali, &s.segnali);
+        if (!ok && s.ascolto >= 0) printf("Errore: impossibile avviare il ciclo degli eventi.\n");
+    }
+
+    pthread_t lavoratori[SERVIZIO_MAX_LAVORATORI];
+    int avviati = 0;
+    while (ok && avviati < n_lavoratori &&
+           pthread_create(&lavoratori[avviati], NULL, threadLavoratore, &s) == 0) {
+        avviati++;
+    }
+    ok = ok && avviati > 0;
+
+    if (ok) {
+        printf("Servizio attivo su %s con %d lavoratori (Ctrl+C per terminare).\n", percorso, avviati);
+        fflush(stdout);
+        cicloEventi(&s);
+        printf("Arresto del servizio...\n");
+    }
+
+    // Arresto: i lavoratori terminano la connessione in corso, le altre vengono chiuse
+    pthread_mutex_lock(&s.mutex_coda);
+    s.arresto = true;
+    pthread_cond_broadcast(&s.lavoro);
+    pthread_mutex_unlock(&s.mutex_coda);
+    for (int i = 0; i < avviati; i++) {
+        pthread_join(lavoratori[i], NULL);
+    }
+    while (s.connessioni != NULL) {
+        liberaConnessione(&s, s.connessioni);
+    }
+
+    if (s.ascolto >= 0) {
+        close(s.ascolto);
+        unlink(percorso);
+    }
+    if (s.epoll >= 0) close(s.epoll);
+    if (s.segnalazioni >= 0) close(s.segnalazioni);
+    if (s.segnali >= 0) close(s.segnali);
+    distruggiDatiCondivisi(&s.dati);
+    pthread_mutex_destroy(&s.mutex_coda);
+    pthread_cond_destroy(&s.lavoro);
+    pthread_sigmask(SIG_SETMASK, &precedenti, NULL);
+    return ok;
+}
+
+#else
+
+int riapplicaGiornale(ListaAllievi* listaA, ListaPagamenti* listaP,
+                      ListaEsami* listaE, ListaGuide* listaG, uint64_t impronta_dati) {
+    (void)listaA; (void)listaP; (void)listaE; (void)listaG; (void)impronta_dati;
+    return -1;
+}
+
+bool eseguiServizio(const char* percorso, int n_lavoratori,
+                    ListaAllievi* listaA, ListaPagamenti* listaP,
+                    ListaEsami* listaE, ListaGuide* listaG) {
+    (void)percorso; (void)n_lavoratori;
+    (void)listaA; (void)listaP; (void)listaE; (void)listaG;
+    printf("Errore: la modalita' servizio e' disponibile solo su Linux.\n");
+    return false;
+}
+
+#endif
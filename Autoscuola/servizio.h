@@ -0,0 +1,81 @@
+/**
+ * @file servizio.h
+ * @brief Modalita' servizio: le liste in memoria servite a piu' client locali.
+ *
+ * Il programma interattivo possiede i dati, quindi una sola postazione alla
+ * volta puo' lavorare. In modalita' servizio il processo tiene in memoria le
+ * quattro liste e risponde, su un socket Unix, alle richieste del protocollo
+ * binario di protocollo.h (ricerca, ore di guida, esami, rate, elenchi).
+ *
+ * Struttura:
+ * - un thread con un ciclo epoll accetta le connessioni e ne legge i byte
+ * - un gruppo di thread lavoratori esegue le richieste: una connessione con
+ *   messaggi completi viene affidata a un lavoratore, che ne esegue le
+ *   richieste in ordine e invia le risposte
+ * - le scritture passano da scriviInLotto() (le scritture concorrenti delle
+ *   varie postazioni vengono raggruppate), le letture da una vista coerente
+ *   (condivisi.h) e non attendono mai gli scrittori
+ * - le scritture consecutive di una connessione e i lotti (OP_LOTTO) sono
+ *   applicati con una sola sezione di scrittura e una sola voce del giornale
+ *
+ * Il servizio termina con SIGINT o SIGTERM; il chiamante salva poi i dati.
+ * Se il giornale e' aperto (apriGiornale()) ogni scrittura vi viene
+ * registrata prima di essere applicata; dopo un'interruzione,
+ * riapplicaGiornale() recupera le scritture successive all'ultimo salvataggio.
+ * Disponibile solo su Linux.
+ */
+#ifndef SERVIZIO_H
+#define SERVIZIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//COSTANTI PUBBLICHE
+#define SERVIZIO_SOCKET_PREDEFINITO "autoscuola.sock"
+#define SERVIZIO_MAX_LAVORATORI 64
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct ListaAllievi ListaAllievi;
+typedef struct ListaPagamenti ListaPagamenti;
+typedef struct ListaEsami ListaEsami;
+typedef struct ListaGuide ListaGuide;
+
+/**
+ * @brief Serve le liste sul socket indicato fino a SIGINT o SIGTERM.
+ *
+ * Durante il servizio le liste vanno usate solo dai thread del servizio.
+ * Ogni secondo viene offerto un punto di autosalvataggio (se attivo).
+ *
+ * @param percorso Percorso del socket (NULL = SERVIZIO_SOCKET_PREDEFINITO).
+ * @param n_lavoratori Thread lavoratori (<= 0: uno per processore, al massimo SERVIZIO_MAX_LAVORATORI).
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @return true se il servizio e' stato avviato e fermato regolarmente.
+ */
+bool eseguiServizio(const char* percorso, int n_lavoratori,
+                    ListaAllievi* listaA, ListaPagamenti* listaP,
+                    ListaEsami* listaE, ListaGuide* listaG);
+
+/**
+ * @brief Riapplica alle liste le scritture registrate nel giornale.
+ *
+ * Da chiamare all'avvio sui dati caricati dall'ultimo salvataggio, prima di
+ * riaprire il giornale. Le scritture vengono rieseguite nell'ordine
+ * originale e producono gli stessi esiti. Se i file di dati non sono piu'
+ * quelli su cui il giornale e' stato aperto, le scritture sono gia' salvate
+ * e non vengono rieseguite.
+ *
+ * @param listaA Lista degli allievi.
+ * @param listaP Lista dei pagamenti.
+ * @param listaE Lista degli esami.
+ * @param listaG Lista delle guide.
+ * @param impronta_dati improntaDatiSalvati() dei file da cui sono state caricate le liste.
+ * @return Numero di scritture rieseguite con successo, -1 se il giornale
+ *         manca o non e' valido.
+ */
+int riapplicaGiornale(ListaAllievi* listaA, ListaPagamenti* listaP,
+                      ListaEsami* listaE, ListaGuide* listaG, uint64_t impronta_dati);
+
+#endif // SERVIZIO_H
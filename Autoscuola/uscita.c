@@ -0,0 +1,247 @@
+/**
+ * @file uscita.c
+ * @brief Implementazione delle uscite a blocchi (terminale, file, memoria, pagine).
+ *
+ * Tutte le uscite accumulano il testo in un Buffer:
+ * - terminale e file: il blocco viene scritto quando supererebbe DIM_BLOCCO_USCITA
+ * - memoria: il blocco cresce e non viene mai scritto
+ * - pagine: il blocco viene scritto ogni `righe_pagina` righe, chiedendo
+ *   conferma prima di mostrare la pagina successiva
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uscita.h"
+#include "buffer.h"
+
+//DEFINIZIONI STRUTTURE (PRIVATE)
+
+/**
+ * @brief Tipo di destinazione.
+ */
+typedef enum {
+    USCITA_STANDARD,
+    USCITA_FILE,
+    USCITA_MEMORIA,
+    USCITA_PAGINATA
+} TipoUscita;
+
+/**
+ * @struct Uscita
+ * @brief Destinazione con il blocco in corso di riempimento.
+ */
+struct Uscita {
+    TipoUscita tipo;
+    FILE* file;          /**< stdout o file aperto (NULL in memoria) */
+    Buffer blocco;       /**< Testo non ancora scritto */
+    int righe_pagina;
+    int righe;           /**< Righe complete nella pagina in corso */
+    bool pagina_piena;   /**< Pagina mostrata: chiedere conferma prima di proseguire */
+    bool interrotta;     /**< L'utente ha chiesto di smettere */
+    bool errore;         /**< Scrittura o allocazione fallita */
+};
+
+//FUNZIONI DI SUPPORTO (PRIVATE)
+
+static Uscita* creaUscita(TipoUscita tipo, FILE* file, size_t capacita) {
+    Uscita* u = (Uscita*)calloc(1, sizeof(Uscita));
+    if (u == NULL) return NULL;
+
+    u->tipo = tipo;
+    u->file = file;
+    inizializzaBuffer(&u->blocco);
+    if (!riservaBuffer(&u->blocco, capacita)) {
+        free(u);
+        return NULL;
+    }
+    return u;
+}
+
+static void scriviSuFile(Uscita* u, const void* dati, size_t n) {
+    if (n > 0 && !u->errore && fwrite(dati, 1, n, u->file) != n) u->errore = true;
+}
+
+/**
+ * @brief Chiede se mostrare la pagina successiva.
+ * @return false se l'utente risponde `q` o l'input e' terminato.
+ */
+static bool chiediPaginaSuccessiva(void) {
+    char risposta[16];
+    printf("-- Invio: pagina successiva, q: fine --");
+    fflush(stdout);
+    if (fgets(risposta, sizeof(risposta), stdin) == NULL) return false;
+    if (strchr(risposta, '\n') == NULL) {
+        int c;
+        while ((c = getchar()) != '\n' && c != EOF);
+    }
+    return risposta[0] != 'q' && risposta[0] != 'Q';
+}
+
+/**
+ * @brief Conta le righe aggiunte da `inizio` in poi e mostra ogni pagina completa.
+ */
+static void impagina(Uscita* u, size_t inizio) {
+    size_t pos = inizio;
+    while (pos < u->blocco.lunghezza) {
+        if (u->pagina_piena) {
+            // C'e' altro testo dopo una pagina gia' mostrata
+            if (!chiediPaginaSuccessiva()) {
+                u->interrotta = true;
+                u->blocco.lunghezza = 0;
+                return;
+            }
+            u->pagina_piena = false;
+        }
+
+        unsigned char* a_capo = memchr(u->blocco.dati + pos, '\n', u->blocco.lunghezza - pos);
+        if (a_capo == NULL) return;
+        pos = (size_t)(a_capo - u->blocco.dati) + 1;
+
+        if (++u->righe == u->righe_pagina) {
+            scriviSuFile(u, u->blocco.dati, pos);
+            fflush(u->file);
+            memmove(u->blocco.dati, u->blocco.dati + pos, u->blocco.lunghezza - pos);
+            u->blocco.lunghezza -= pos;
+            pos = 0;
+            u->righe = 0;
+            u->pagina_piena = true;
+        }
+    }
+}
+
+//FUNZIONI DI CREAZIONE/DISTRUZIONE
+
+Uscita* creaUscitaStandard(void) {
+    return creaUscita(USCITA_STANDARD, stdout, DIM_BLOCCO_USCITA);
+}
+
+Uscita* creaUscitaFile(const char* filename) {
+    if (filename == NULL) return NULL;
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("Errore: impossibile creare il file %s\n", filename);
+        return NULL;
+    }
+    Uscita* u = creaUscita(USCITA_FILE, file, DIM_BLOCCO_USCITA);
+    if (u == NULL) {
+        printf("Errore: memoria insufficiente.\n");
+        fclose(file);
+    }
+    return u;
+}
+
+Uscita* creaUscitaMemoria(void) {
+    Uscita* u = creaUscita(USCITA_MEMORIA, NULL, 1);
+    if (u != NULL) u->blocco.dati[0] = '\0';
+    return u;
+}
+
+Uscita* creaUscitaPaginata(int righe_per_pagina) {
+    Uscita* u = creaUscita(USCITA_PAGINATA, stdout, 1);
+    if (u != NULL) {
+        u->righe_pagina = (righe_per_pagina > 0) ? righe_per_pagina : RIGHE_PAGINA_PREDEFINITE;
+    }
+    return u;
+}
+
+bool chiudiUscita(Uscita** uscita) {
+    if (uscita == NULL || *uscita == NULL) return false;
+
+    Uscita* u = *uscita;
+    svuotaUscita(u);
+    if (u->tipo == USCITA_FILE) {
+        if (fclose(u->file) != 0) u->errore = true;
+    } else if (u->file != NULL) {
+        if (fflush(u->file) != 0) u->errore = true;
+    }
+
+    bool ok = !u->errore;
+    liberaBuffer(&u->blocco);
+    free(u);
+    *uscita = NULL;
+    return ok;
+}
+
+//FUNZIONI DI SCRITTURA
+
+char* riservaUscita(Uscita* uscita, size_t n) {
+    if (uscita == NULL) return NULL;
+
+    Uscita* u = uscita;
+    if (u->interrotta || u->errore) {
+        // Il testo verra' scartato: basta un'area valida
+        u->blocco.lunghezza = 0;
+    } else if ((u->tipo == USCITA_STANDARD || u->tipo == USCITA_FILE)
+               && u->blocco.lunghezza + n > DIM_BLOCCO_USCITA) {
+        svuotaUscita(u);
+    }
+
+    // In memoria resta sempre spazio per il terminatore
+    size_t extra = (u->tipo == USCITA_MEMORIA) ? 1 : 0;
+    if (!riservaBuffer(&u->blocco, u->blocco.lunghezza + n + extra)) {
+        u->errore = true;
+        return NULL;
+    }
+    return (char*)u->blocco.dati + u->blocco.lunghezza;
+}
+
+void avanzaUscita(Uscita* uscita, size_t n) {
+    if (uscita == NULL || uscita->interrotta || uscita->errore) return;
+
+    size_t inizio = uscita->blocco.lunghezza;
+    uscita->blocco.lunghezza += n;
+    if (uscita->tipo == USCITA_MEMORIA) {
+        uscita->blocco.dati[uscita->blocco.lunghezza] = '\0';
+    } else if (uscita->tipo == USCITA_PAGINATA) {
+        impagina(uscita, inizio);
+    }
+}
+
+void scriviUscita(Uscita* uscita, const char* dati, size_t n) {
+    if (uscita == NULL || uscita->interrotta || uscita->errore || n == 0) return;
+
+    if ((uscita->tipo == USCITA_STANDARD || uscita->tipo == USCITA_FILE) && n > DIM_BLOCCO_USCITA) {
+        // Piu' grande di un blocco: direttamente sul file
+        svuotaUscita(uscita);
+        scriviSuFile(uscita, dati, n);
+        return;
+    }
+
+    char* dest = riservaUscita(uscita, n);
+    if (dest == NULL) return;
+    memcpy(dest, dati, n);
+    avanzaUscita(uscita, n);
+}
+
+void scriviTestoUscita(Uscita* uscita, const char* testo) {
+    if (testo != NULL) scriviUscita(uscita, testo, strlen(testo));
+}
+
+void scriviCarattereUscita(Uscita* uscita, char c) {
+    char* dest = riservaUscita(uscita, 1);
+    if (dest == NULL) return;
+    *dest = c;
+    avanzaUscita(uscita, 1);
+}
+
+void svuotaUscita(Uscita* uscita) {
+    if (uscita == NULL || uscita->tipo == USCITA_MEMORIA) return;
+
+    if (!uscita->interrotta) scriviSuFile(uscita, uscita->blocco.dati, uscita->blocco.lunghezza);
+    uscita->blocco.lunghezza = 0;
+    uscita->righe = 0;
+}
+
+//FUNZIONI DI ACCESSO (GETTER)
+
+bool uscitaInterrotta(const Uscita* uscita) {
+    return uscita == NULL || uscita->interrotta || uscita->errore;
+}
+
+const char* getTestoUscita(const Uscita* uscita, size_t* lunghezza) {
+    if (uscita == NULL || uscita->tipo != USCITA_MEMORIA) return NULL;
+    if (lunghezza != NULL) *lunghezza = uscita->blocco.lunghezza;
+    return (const char*)uscita->blocco.dati;
+}
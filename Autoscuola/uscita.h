@@ -0,0 +1,135 @@
+/**
+ * @file uscita.h
+ * @brief Destinazione a blocchi per gli elenchi: terminale, file, memoria o pagine.
+ *
+ * Le funzioni di elenco (stampaAllievi, stampaTuttiPagamenti, ...) non
+ * chiamano printf per ogni riga: compongono il testo in un blocco di memoria
+ * che viene scritto con una sola operazione quando e' pieno. Cambiando
+ * l'uscita lo stesso elenco finisce sul terminale, in un file, in memoria
+ * (es. per un'altra elaborazione) oppure sul terminale una pagina alla volta.
+ *
+ * Con l'uscita paginata, dopo ogni pagina si attende Invio; rispondendo `q`
+ * l'uscita viene interrotta, il resto del testo scartato e uscitaInterrotta()
+ * diventa vero, cosi' l'elenco puo' smettere di formattare righe.
+ *
+ * Uso tipico:
+ *
+ *     Uscita* u = creaUscitaPaginata(RIGHE_PAGINA_PREDEFINITE);
+ *     stampaAllievi(listaA, u);
+ *     chiudiUscita(&u);
+ */
+#ifndef USCITA_H
+#define USCITA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//COSTANTI PUBBLICHE
+#define DIM_BLOCCO_USCITA (256 * 1024) /**< Byte accumulati prima di ogni scrittura */
+#define RIGHE_PAGINA_PREDEFINITE 20    /**< Righe per pagina nei menu */
+
+//FORWARD DECLARATIONS (tipi opachi)
+typedef struct Uscita Uscita;
+
+//FUNZIONI DI CREAZIONE/DISTRUZIONE
+
+/**
+ * @brief Crea un'uscita sul terminale (stdout), scritta a blocchi.
+ * @return Puntatore all'uscita, NULL se la memoria non basta.
+ */
+Uscita* creaUscitaStandard(void);
+
+/**
+ * @brief Crea un'uscita su file, scritta a blocchi.
+ * @param filename File di destinazione (sovrascritto).
+ * @return Puntatore all'uscita, NULL se il file non e' creabile o la memoria non basta.
+ */
+Uscita* creaUscitaFile(const char* filename);
+
+/**
+ * @brief Crea un'uscita che accumula il testo in memoria (vedi getTestoUscita()).
+ * @return Puntatore all'uscita, NULL se la memoria non basta.
+ */
+Uscita* creaUscitaMemoria(void);
+
+/**
+ * @brief Crea un'uscita sul terminale che mostra una pagina alla volta.
+ * @param righe_per_pagina Righe di ogni pagina (se <= 0, RIGHE_PAGINA_PREDEFINITE).
+ * @return Puntatore all'uscita, NULL se la memoria non basta.
+ */
+Uscita* creaUscitaPaginata(int righe_per_pagina);
+
+/**
+ * @brief Scrive il testo rimasto, chiude il file e libera l'uscita.
+ * @param uscita Indirizzo del puntatore all'uscita (azzerato).
+ * @return true se tutto il testo e' stato scritto (un'interruzione non e' un errore).
+ */
+bool chiudiUscita(Uscita** uscita);
+
+//FUNZIONI DI SCRITTURA
+
+/**
+ * @brief Garantisce `n` byte liberi in coda al blocco, per formattarvi direttamente.
+ *
+ * I byte scritti diventano parte dell'uscita solo con avanzaUscita(). Per
+ * le uscite su terminale e su file `n` non deve superare DIM_BLOCCO_USCITA.
+ *
+ * @param uscita Uscita di destinazione.
+ * @param n Byte richiesti.
+ * @return Primo byte libero, NULL se la memoria non basta.
+ */
+char* riservaUscita(Uscita* uscita, size_t n);
+
+/**
+ * @brief Aggiunge all'uscita `n` byte scritti dopo riservaUscita().
+ * @param uscita Uscita di destinazione.
+ * @param n Byte effettivamente scritti.
+ */
+void avanzaUscita(Uscita* uscita, size_t n);
+
+/**
+ * @brief Aggiunge `n` byte all'uscita.
+ * @param uscita Uscita di destinazione.
+ * @param dati Byte da scrivere.
+ * @param n Numero di byte.
+ */
+void scriviUscita(Uscita* uscita, const char* dati, size_t n);
+
+/**
+ * @brief Aggiunge una stringa all'uscita.
+ * @param uscita Uscita di destinazione.
+ * @param testo Stringa terminata da '\0'.
+ */
+void scriviTestoUscita(Uscita* uscita, const char* testo);
+
+/**
+ * @brief Aggiunge un carattere all'uscita.
+ * @param uscita Uscita di destinazione.
+ * @param c Carattere da scrivere.
+ */
+void scriviCarattereUscita(Uscita* uscita, char c);
+
+/**
+ * @brief Scrive subito il testo accumulato (terminale e file).
+ * @param uscita Uscita da svuotare.
+ */
+void svuotaUscita(Uscita* uscita);
+
+//FUNZIONI DI ACCESSO (GETTER)
+
+/**
+ * @brief Indica se l'utente ha interrotto la paginazione o la scrittura e' fallita.
+ * @param uscita Uscita da controllare.
+ * @return true se il resto del testo verrebbe scartato.
+ */
+bool uscitaInterrotta(const Uscita* uscita);
+
+/**
+ * @brief Testo accumulato da un'uscita in memoria.
+ * @param uscita Uscita creata con creaUscitaMemoria().
+ * @param lunghezza Se non NULL, riceve il numero di byte.
+ * @return Testo terminato da '\0', NULL per gli altri tipi di uscita.
+ */
+const char* getTestoUscita(const Uscita* uscita, size_t* lunghezza);
+
+#endif // USCITA_H